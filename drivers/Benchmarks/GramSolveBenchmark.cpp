@@ -0,0 +1,140 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  GramSolveBenchmark.cpp
+//  Camellia
+//
+//  Times the local Gram solves for a Poisson graph norm on one element, comparing double-precision Cholesky with
+//  SerialDenseWrapper::solveSPDSystemMixedPrecision().  The optimal test solve has one right-hand side per trial dof, the
+//  Riesz representation one per cell; the mixed-precision solve is only worth using for the latter.
+//
+
+#include "BF.h"
+#include "BasisCache.h"
+#include "Function.h"
+#include "MeshFactory.h"
+#include "MPIWrapper.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "SerialDenseWrapper.h"
+#include "TypeDefs.h"
+
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_GlobalMPISession.hpp"
+
+#include "Epetra_Time.h"
+
+using namespace Camellia;
+using namespace Intrepid;
+
+int main(int argc, char *argv[])
+{
+  Teuchos::GlobalMPISession mpiSession(&argc, &argv); // initialize MPI
+  int rank = Teuchos::GlobalMPISession::getRank();
+
+  Teuchos::CommandLineProcessor cmdp(false,true); // false: don't throw exceptions; true: do return errors for unrecognized options
+
+  int spaceDim = 2;
+  int polyOrder = 2, delta_k = 2;
+  int numSolves = 100;
+
+  cmdp.setOption("spaceDim", &spaceDim, "space dimensions (2 or 3)");
+  cmdp.setOption("polyOrder", &polyOrder, "polynomial order for field variable u");
+  cmdp.setOption("delta_k", &delta_k, "test space polynomial order enrichment");
+  cmdp.setOption("numSolves", &numSolves, "number of solves to time");
+
+  if (cmdp.parse(argc,argv) != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL)
+  {
+#ifdef HAVE_MPI
+    MPI_Finalize();
+#endif
+    return -1;
+  }
+
+  bool conformingTraces = true;
+  PoissonFormulation form(spaceDim, conformingTraces, PoissonFormulation::ULTRAWEAK);
+  BFPtr bf = form.bf();
+  vector<double> dimensions(spaceDim,1.0);
+  vector<int> elementCounts(spaceDim,1);
+  int H1Order = polyOrder + 1;
+  MeshPtr mesh = MeshFactory::rectilinearMesh(bf, dimensions, elementCounts, H1Order, delta_k);
+  RHSPtr rhs = form.rhs(Function::constant(1.0));
+
+  GlobalIndexType cellID = 0;
+  if (!mesh->myCellsInclude(cellID)) return 0;
+
+  ElementTypePtr elemType = mesh->getElementType(cellID);
+  int numTrialDofs = elemType->trialOrderPtr->totalDofs();
+  int numTestDofs = elemType->testOrderPtr->totalDofs();
+  BasisCachePtr basisCache = BasisCache::basisCacheForCell(mesh, cellID);
+  BasisCachePtr ipBasisCache = BasisCache::basisCacheForCell(mesh, cellID, true);
+  FieldContainer<double> cellSideParities = mesh->cellSideParitiesForCell(cellID);
+
+  FieldContainer<double> gram(1,numTestDofs,numTestDofs), stiffnessEnriched(1,numTrialDofs,numTestDofs), rhsEnriched(1,numTestDofs);
+  bf->graphNorm()->computeInnerProductMatrix(gram, elemType->testOrderPtr, ipBasisCache);
+  bf->stiffnessMatrix(stiffnessEnriched, elemType, cellSideParities, basisCache, true, true);
+  rhs->integrateAgainstStandardBasis(rhsEnriched, elemType->testOrderPtr, basisCache);
+  gram.resize(numTestDofs,numTestDofs);
+  stiffnessEnriched.resize(numTrialDofs,numTestDofs);
+  rhsEnriched.resize(numTestDofs,1);
+
+  Epetra_Time timer(*MPIWrapper::CommSerial());
+  FieldContainer<double> gramCopy, stiffnessEnrichedCopy, rhsEnrichedCopy, stiffness(numTrialDofs,numTrialDofs), load(numTrialDofs,1);
+
+  // optimal test solve, one right-hand side per trial dof: TBF::factoredCholeskySolve()
+  timer.ResetStartTime();
+  for (int i=0; i<numSolves; i++)
+  {
+    gramCopy = gram;
+    stiffnessEnrichedCopy = stiffnessEnriched;
+    rhsEnrichedCopy = rhsEnriched;
+    TBF<double>::factoredCholeskySolve(gramCopy, stiffnessEnrichedCopy, rhsEnrichedCopy, stiffness, load);
+  }
+  double factoredCholeskyTime = timer.ElapsedTime();
+
+  // the same, solving G T = B^T in mixed precision and forming K = B T, l = T^T f
+  FieldContainer<double> optimalTestCoefficients;
+  timer.ResetStartTime();
+  for (int i=0; i<numSolves; i++)
+  {
+    gramCopy = gram;
+    optimalTestCoefficients = stiffnessEnriched;
+    SerialDenseWrapper::solveSPDSystemMixedPrecision(optimalTestCoefficients, gramCopy);
+    SerialDenseWrapper::multiply(stiffness, stiffnessEnriched, optimalTestCoefficients, 'N', 'T');
+    SerialDenseWrapper::multiply(load, optimalTestCoefficients, rhsEnriched, 'N', 'N');
+  }
+  double mixedPrecisionOptimalTestTime = timer.ElapsedTime();
+
+  // Riesz representation, one right-hand side
+  bool usedSinglePrecision;
+  timer.ResetStartTime();
+  for (int i=0; i<numSolves; i++)
+  {
+    gramCopy = gram;
+    rhsEnrichedCopy = rhsEnriched;
+    SerialDenseWrapper::solveSPDSystemLAPACKCholesky(rhsEnrichedCopy, gramCopy);
+  }
+  double choleskyRieszTime = timer.ElapsedTime();
+
+  timer.ResetStartTime();
+  for (int i=0; i<numSolves; i++)
+  {
+    gramCopy = gram;
+    rhsEnrichedCopy = rhsEnriched;
+    SerialDenseWrapper::solveSPDSystemMixedPrecision(rhsEnrichedCopy, gramCopy, 1e6, 10, &usedSinglePrecision);
+  }
+  double mixedPrecisionRieszTime = timer.ElapsedTime();
+
+  if (rank == 0)
+  {
+    cout << "test dofs: " << numTestDofs << ", trial dofs: " << numTrialDofs << endl;
+    cout << "mean optimal test solve time, factored Cholesky:  " << factoredCholeskyTime / numSolves << " s\n";
+    cout << "mean optimal test solve time, mixed precision:    " << mixedPrecisionOptimalTestTime / numSolves << " s\n";
+    cout << "mean Riesz solve time, double Cholesky:           " << choleskyRieszTime / numSolves << " s\n";
+    cout << "mean Riesz solve time, mixed precision:           " << mixedPrecisionRieszTime / numSolves << " s";
+    cout << (usedSinglePrecision ? "\n" : " (fell back to double precision)\n");
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  ImportSolutionBenchmark.cpp
+//  Camellia
+//
+//  Times Solution::importSolution() with and without reuse of the import plan.  Run with varying MPI rank counts
+//  (e.g. mpirun -np 1, 2, 4, ...) to see how the import time scales.
+//
+
+#include "Function.h"
+#include "MeshFactory.h"
+#include "MPIWrapper.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "Solution.h"
+#include "TypeDefs.h"
+
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_GlobalMPISession.hpp"
+
+#include "Epetra_Time.h"
+
+using namespace Camellia;
+
+// returns the maximum (over ranks) time taken by numImports calls to importSolution()
+double timeImports(SolutionPtr soln, int numImports)
+{
+  Epetra_CommPtr Comm = soln->mesh()->Comm();
+  Comm->Barrier();
+  Epetra_Time timer(*Comm);
+  for (int i=0; i<numImports; i++)
+  {
+    soln->importSolution();
+  }
+  double myTime = timer.ElapsedTime(), maxTime;
+  Comm->MaxAll(&myTime, &maxTime, 1);
+  return maxTime;
+}
+
+int main(int argc, char *argv[])
+{
+  Teuchos::GlobalMPISession mpiSession(&argc, &argv); // initialize MPI
+  int rank = Teuchos::GlobalMPISession::getRank();
+  int numProcs = Teuchos::GlobalMPISession::getNProc();
+
+  Teuchos::CommandLineProcessor cmdp(false,true); // false: don't throw exceptions; true: do return errors for unrecognized options
+
+  int spaceDim = 2;
+  int meshWidth = 16;
+  int polyOrder = 2, delta_k = 1;
+  int numImports = 20;
+  bool useCondensedSolve = false;
+
+  cmdp.setOption("spaceDim", &spaceDim, "space dimensions (1, 2, or 3)");
+  cmdp.setOption("meshWidth", &meshWidth, "number of elements in each dimension");
+  cmdp.setOption("polyOrder", &polyOrder, "polynomial order for field variable u");
+  cmdp.setOption("delta_k", &delta_k, "test space polynomial order enrichment");
+  cmdp.setOption("numImports", &numImports, "number of imports to time");
+  cmdp.setOption("useCondensedSolve", "useStandardSolve", &useCondensedSolve);
+
+  if (cmdp.parse(argc,argv) != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL)
+  {
+#ifdef HAVE_MPI
+    MPI_Finalize();
+#endif
+    return -1;
+  }
+
+  bool conformingTraces = true;
+  PoissonFormulation form(spaceDim, conformingTraces);
+  vector<double> dimensions(spaceDim,1.0);
+  vector<int> elementCounts(spaceDim,meshWidth);
+  int H1Order = polyOrder + 1;
+  MeshPtr mesh = MeshFactory::rectilinearMesh(form.bf(), dimensions, elementCounts, H1Order, delta_k);
+
+  BCPtr bc = BC::bc();
+  bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+  RHSPtr rhs = form.rhs(Function::constant(1.0));
+  SolutionPtr soln = Solution::solution(form.bf(), mesh, bc, rhs, form.bf()->graphNorm());
+  soln->setUseCondensedSolve(useCondensedSolve);
+  soln->solve(); // imports once, building the plan
+
+  soln->setReuseImportPlan(true);
+  double reusedPlanTime = timeImports(soln, numImports);
+  soln->setReuseImportPlan(false);
+  double newPlanTime = timeImports(soln, numImports);
+
+  if (rank == 0)
+  {
+    cout << "ranks: " << numProcs << ", global dofs: " << mesh->numGlobalDofs() << ", cells: " << mesh->numActiveElements() << endl;
+    cout << "mean importSolution() time, reusing plan:       " << reusedPlanTime / numImports << " s\n";
+    cout << "mean importSolution() time, rebuilding plan:    " << newPlanTime / numImports << " s\n";
+  }
+
+  return 0;
+}
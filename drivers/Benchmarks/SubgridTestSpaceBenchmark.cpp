@@ -0,0 +1,112 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  SubgridTestSpaceBenchmark.cpp
+//  Camellia
+//
+//  Times the local stiffness computation for an ultraweak Poisson formulation on every cell of a rectilinear mesh, comparing
+//  the SUBGRID optimal test solver with FACTORED_CHOLESKY.  The subgrid Gram matrix's graph and symbolic factorization are
+//  built once per cell topology, so the per-cell SUBGRID cost is the assembly and numeric factorization of the sparse Gram matrix.
+//
+
+#include "BasisCache.h"
+#include "BF.h"
+#include "Function.h"
+#include "IP.h"
+#include "MeshFactory.h"
+#include "MPIWrapper.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "TypeDefs.h"
+
+#include "Teuchos_CommandLineProcessor.hpp"
+#include "Teuchos_GlobalMPISession.hpp"
+
+#include "Epetra_Time.h"
+
+using namespace Camellia;
+using namespace Intrepid;
+
+// returns the time taken by numPasses computations of the local stiffness matrix and RHS on each of the given cells
+double timeLocalStiffness(BFPtr bf, IPPtr ip, RHSPtr rhs, MeshPtr mesh, const vector<BasisCachePtr> &basisCaches,
+                          const vector<BasisCachePtr> &ipBasisCaches, int numPasses)
+{
+  Epetra_Time timer(*MPIWrapper::CommSerial());
+  for (int pass=0; pass<numPasses; pass++)
+  {
+    for (int i=0; i<basisCaches.size(); i++)
+    {
+      GlobalIndexType cellID = basisCaches[i]->cellIDs()[0];
+      int numTrialDofs = mesh->getElementType(cellID)->trialOrderPtr->totalDofs();
+      FieldContainer<double> localStiffness(1,numTrialDofs,numTrialDofs), localRHS(1,numTrialDofs);
+      bf->localStiffnessMatrixAndRHS(localStiffness, localRHS, ip, ipBasisCaches[i], rhs, basisCaches[i]);
+    }
+  }
+  return timer.ElapsedTime();
+}
+
+int main(int argc, char *argv[])
+{
+  Teuchos::GlobalMPISession mpiSession(&argc, &argv); // initialize MPI
+  int rank = Teuchos::GlobalMPISession::getRank();
+
+  Teuchos::CommandLineProcessor cmdp(false,true); // false: don't throw exceptions; true: do return errors for unrecognized options
+
+  int spaceDim = 2;
+  int meshWidth = 4;
+  int polyOrder = 2, delta_k = 2;
+  int numPasses = 5;
+
+  cmdp.setOption("spaceDim", &spaceDim, "space dimensions (2 or 3)");
+  cmdp.setOption("meshWidth", &meshWidth, "number of elements in each dimension");
+  cmdp.setOption("polyOrder", &polyOrder, "polynomial order for field variable u");
+  cmdp.setOption("delta_k", &delta_k, "test space polynomial order enrichment");
+  cmdp.setOption("numPasses", &numPasses, "number of passes over the cells to time");
+
+  if (cmdp.parse(argc,argv) != Teuchos::CommandLineProcessor::PARSE_SUCCESSFUL)
+  {
+#ifdef HAVE_MPI
+    MPI_Finalize();
+#endif
+    return -1;
+  }
+
+  bool conformingTraces = true;
+  PoissonFormulation form(spaceDim, conformingTraces, PoissonFormulation::ULTRAWEAK);
+  BFPtr bf = form.bf();
+  IPPtr ip = bf->graphNorm();
+  RHSPtr rhs = form.rhs(Function::constant(1.0));
+  vector<double> dimensions(spaceDim,1.0);
+  vector<int> elementCounts(spaceDim,meshWidth);
+  int H1Order = polyOrder + 1;
+  MeshPtr mesh = MeshFactory::rectilinearMesh(bf, dimensions, elementCounts, H1Order, delta_k);
+
+  vector<BasisCachePtr> basisCaches, ipBasisCaches;
+  for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+  {
+    basisCaches.push_back(BasisCache::basisCacheForCell(mesh, cellID));
+    ipBasisCaches.push_back(BasisCache::basisCacheForCell(mesh, cellID, true));
+  }
+  int numCells = basisCaches.size();
+  if (numCells == 0) return 0;
+
+  bf->setOptimalTestSolver(TBF<>::FACTORED_CHOLESKY);
+  double factoredCholeskyTime = timeLocalStiffness(bf, ip, rhs, mesh, basisCaches, ipBasisCaches, numPasses);
+
+  // the first SUBGRID computation builds the subgrid test space; leave that out of the timing
+  bf->setOptimalTestSolver(TBF<>::SUBGRID);
+  timeLocalStiffness(bf, ip, rhs, mesh, {basisCaches[0]}, {ipBasisCaches[0]}, 1);
+  double subgridTime = timeLocalStiffness(bf, ip, rhs, mesh, basisCaches, ipBasisCaches, numPasses);
+
+  if (rank == 0)
+  {
+    int numLocalStiffness = numCells * numPasses;
+    int numTestDofs = mesh->getElementType(basisCaches[0]->cellIDs()[0])->testOrderPtr->totalDofs();
+    cout << "cells on rank 0: " << numCells << ", enriched test dofs per cell: " << numTestDofs << endl;
+    cout << "mean local stiffness time, FACTORED_CHOLESKY: " << factoredCholeskyTime / numLocalStiffness << " s\n";
+    cout << "mean local stiffness time, SUBGRID:           " << subgridTime / numLocalStiffness << " s\n";
+  }
+
+  return 0;
+}
@@ -15,10 +15,10 @@
 #include "BasisFactory.h"
 #include "BasisEvaluation.h"
 #include "CamelliaCellTools.h"
-#include "CubatureFactory.h"
 #include "Function.h"
 #include "Mesh.h"
 #include "MeshTransformationFunction.h"
+#include "ReferenceValueRegistry.h"
 #include "SerialDenseWrapper.h"
 #include "SpaceTimeBasisCache.h"
 
@@ -116,32 +116,17 @@ void BasisCache::initVolumeCache(bool createSideCacheToo, bool tensorProductTopo
 
   if (_cellTopo->getDimension() > 0)
   {
-    CubatureFactory cubFactory;
-    Teuchos::RCP<Cubature<double> > cellTopoCub;
-    
-    if (_cubDegree >= 0)
-      cellTopoCub = cubFactory.create(_cellTopo, _cubDegree);
-    else if (_cubDegrees.size() > 0)
-      cellTopoCub = cubFactory.create(_cellTopo, _cubDegrees);
-    
-    int cubDim, numCubPoints;
-    
-    if (cellTopoCub != Teuchos::null)
+    if ((_cubDegree >= 0) || (_cubDegrees.size() > 0))
     {
-      cubDim       = cellTopoCub->getDimension();
-      numCubPoints = cellTopoCub->getNumPoints();
+      int sideOrdinal = -1; // volume
+      _referenceRuleID = ReferenceValueRegistry::cubatureRule(_cellTopo, _cubDegree, _cubDegrees, sideOrdinal, _cubPoints, _cubWeights);
     }
     else
     {
-      cubDim = _cellTopo->getDimension();
-      numCubPoints = 0;
+      _referenceRuleID = -1;
+      _cubPoints = FieldContainer<double>(0, _cellTopo->getDimension());
+      _cubWeights.resize(0);
     }
-
-    _cubPoints = FieldContainer<double>(numCubPoints, cubDim);
-    _cubWeights.resize(numCubPoints);
-
-    if (numCubPoints > 0)
-      cellTopoCub->getCubature(_cubPoints, _cubWeights);
   }
   else
   {
@@ -166,11 +151,10 @@ void BasisCache::initVolumeCache(bool createSideCacheToo, bool tensorProductTopo
   _sideNormalsIsValid = false;
   _physCubPointsIsValid = false;
   
-  // now, create side caches
-  if ( createSideCacheToo )
-  {
-    this->createSideCaches();
-  }
+  // side caches are created lazily, on first side query; until physical nodes are set, there is nothing to bring up to date
+  _sideCachesRequested = createSideCacheToo;
+  _basisCacheSides.clear();
+  _sideCacheIsCurrent.assign(createSideCacheToo ? _cellTopo->getSideCount() : 0, true);
 }
 
 void BasisCache::initVolumeCache(const Intrepid::FieldContainer<double> &refPoints, const Intrepid::FieldContainer<double> &cubWeights)
@@ -182,6 +166,7 @@ void BasisCache::initVolumeCache(const Intrepid::FieldContainer<double> &refPoin
   
   _cubPoints = refPoints;
   _cubWeights = cubWeights;
+  _referenceRuleID = -1;
   
   _maxPointsPerCubaturePhase = -1;
   _cubaturePhase = 0;
@@ -222,6 +207,59 @@ void BasisCache::createSideCaches()
   }
 }
 
+BasisCachePtr BasisCache::sideCache(int sideOrdinal)
+{
+  if (_basisCacheSides.size() == 0)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!_sideCachesRequested, std::invalid_argument, "side caches were not requested for this BasisCache");
+    createSideCaches();
+  }
+  if ((sideOrdinal < _sideCacheIsCurrent.size()) && !_sideCacheIsCurrent[sideOrdinal])
+  {
+    _basisCacheSides[sideOrdinal]->setPhysicalCellNodes(_physicalCellNodes, _cellIDs, false);
+    _sideCacheIsCurrent[sideOrdinal] = true;
+  }
+  return _basisCacheSides[sideOrdinal];
+}
+
+void BasisCache::updateSideCaches()
+{
+  if (!_sideCachesRequested) return;
+  int numSides = _cellTopo->getSideCount();
+  for (int sideOrdinal=0; sideOrdinal<numSides; sideOrdinal++)
+  {
+    sideCache(sideOrdinal);
+  }
+}
+
+int BasisCache::maxCellBatchSize(ElementTypePtr elemType, int maxBytes, int minCells)
+{
+  int numTrialDofs = elemType->trialOrderPtr->totalDofs();
+  int numTestDofs = elemType->testOrderPtr->totalDofs();
+
+  // local stiffness, Gram matrix, and load/optimal-test storage:
+  long doublesPerCell = numTestDofs*numTestDofs + numTestDofs*numTrialDofs + numTrialDofs*numTrialDofs;
+
+  // geometry: Jacobian, its inverse and determinant, weighted measures, and physical points
+  int spaceDim = _cellTopo->getDimension();
+  int numPoints = _cubPoints.dimension(0);
+  int geometryDoublesPerPoint = 2 * spaceDim * spaceDim + spaceDim + 2;
+
+  // transformed basis values (and, for the most part, first derivatives) are live for each dof at each point during integration
+  int valueDoublesPerPointPerDof = 1 + spaceDim;
+  doublesPerCell += (long)numPoints * (geometryDoublesPerPoint + (numTrialDofs + numTestDofs) * valueDoublesPerPointPerDof);
+
+  if (_sideCachesRequested)
+  {
+    // side cubature uses fewer points than the volume, so bounding each side by the volume point count is conservative; sides also store normals
+    int numSides = _cellTopo->getSideCount();
+    doublesPerCell += (long)numSides * numPoints * (geometryDoublesPerPoint + spaceDim);
+  }
+
+  long maxCells = (long)maxBytes / (sizeof(double) * doublesPerCell);
+  return (int) max(maxCells, (long) minCells);
+}
+
 BasisCache::BasisCache(CellTopoPtr cellTopo, int cubDegree, bool createSideCacheToo, bool tensorProductTopologyMeansSpaceTime)
 {
   _cellTopo = cellTopo;
@@ -459,26 +497,21 @@ BasisCache::BasisCache(int sideIndex, BasisCachePtr volumeCache, int trialDegree
 
   if (sideDim > 0)
   {
-    CubatureFactory cubFactory;
-    Teuchos::RCP<Cubature<double> > sideCub;
-    if (_cubDegree >= 0)
-      sideCub = cubFactory.create(side, _cubDegree);
-    else if (_cubDegrees.size() > 0)
-      sideCub = cubFactory.create(side, _cubDegrees);
-
     int numCubPointsSide;
     
-    if (sideCub != Teuchos::null)
-      numCubPointsSide = sideCub->getNumPoints();
-    else
-      numCubPointsSide = 0;
-    
-    _cubPoints.resize(numCubPointsSide, sideDim); // cubature points from the pov of the side (i.e. a (d-1)-dimensional set)
-    _cubWeights.resize(numCubPointsSide);
     if ( multiBasisIfAny.get() == NULL )
     {
-      if (numCubPointsSide > 0)
-        sideCub->getCubature(_cubPoints, _cubWeights);
+      if ((_cubDegree >= 0) || (_cubDegrees.size() > 0))
+      {
+        // cubature points from the pov of the side (i.e. a (d-1)-dimensional set)
+        _referenceRuleID = ReferenceValueRegistry::cubatureRule(_cellTopo, _cubDegree, _cubDegrees, _sideIndex, _cubPoints, _cubWeights);
+      }
+      else
+      {
+        _cubPoints.resize(0, sideDim);
+        _cubWeights.resize(0);
+      }
+      numCubPointsSide = _cubPoints.dimension(0);
     }
     else
     {
@@ -663,6 +696,7 @@ void BasisCache::setMaxPointsPerCubaturePhase(int maxPoints)
     }
     _phasePointOrdinalOffsets[_cubaturePhaseCount] = totalPointCount;
     _cubPoints.resize(0); // should trigger error if setCubaturePhase isn't called
+    _referenceRuleID = -1;
     _cubWeights.resize(0);
   }
   else
@@ -921,8 +955,7 @@ constFCPtr BasisCache::getValues(BasisPtr basis, Camellia::EOperator op,
     if (_knownValues.find(relatedKey) == _knownValues.end() )
     {
       // we can assume relatedResults has dimensions (numPoints,basisCardinality,spaceDim)
-      FCPtr relatedResults = BasisEvaluation::getValues(basis,(Camellia::EOperator)relatedOp,*cubPoints);
-      _knownValues[relatedKey] = relatedResults;
+      _knownValues[relatedKey] = referenceValues(basis,(Camellia::EOperator)relatedOp,useCubPointsSideRefCell,*cubPoints);
     }
 
     constFCPtr relatedResults = _knownValues[relatedKey];
@@ -943,11 +976,21 @@ constFCPtr BasisCache::getValues(BasisPtr basis, Camellia::EOperator op,
   {
     TEUCHOS_TEST_FOR_EXCEPTION(true,std::invalid_argument,"Unknown operator.");
   }
-  FCPtr result = BasisEvaluation::getValues(basis,op,*cubPoints);
+  constFCPtr result = referenceValues(basis,op,useCubPointsSideRefCell,*cubPoints);
   _knownValues[key] = result;
   return result;
 }
 
+constFCPtr BasisCache::referenceValues(BasisPtr basis, Camellia::EOperator op, bool useCubPointsSideRefCell,
+                                       const FieldContainer<double> &cubPoints)
+{
+  if (_referenceRuleID == -1)
+  {
+    return BasisEvaluation::getValues(basis,op,cubPoints);
+  }
+  return ReferenceValueRegistry::referenceValues(basis, op, _referenceRuleID, useCubPointsSideRefCell, cubPoints);
+}
+
 constFCPtr BasisCache::getTransformedValues(BasisPtr basis, Camellia::EOperator op,
     bool useCubPointsSideRefCell)
 {
@@ -1077,7 +1120,7 @@ constFCPtr BasisCache::getTransformedWeightedValues(BasisPtr basis, Camellia::EO
 constFCPtr BasisCache::getValues(BasisPtr basis, Camellia::EOperator op, int sideOrdinal,
                                  bool useCubPointsSideRefCell)
 {
-  return _basisCacheSides[sideOrdinal]->getValues(basis,op,useCubPointsSideRefCell);
+  return sideCache(sideOrdinal)->getValues(basis,op,useCubPointsSideRefCell);
 }
 
 constFCPtr BasisCache::getTransformedValues(BasisPtr basis, Camellia::EOperator op, int sideOrdinal,
@@ -1086,7 +1129,7 @@ constFCPtr BasisCache::getTransformedValues(BasisPtr basis, Camellia::EOperator
   constFCPtr transformedValues;
   if ( ! _isSideCache )
   {
-    transformedValues = _basisCacheSides[sideOrdinal]->getTransformedValues(basis,op,useCubPointsSideRefCell);
+    transformedValues = sideCache(sideOrdinal)->getTransformedValues(basis,op,useCubPointsSideRefCell);
   }
   else
   {
@@ -1098,18 +1141,18 @@ constFCPtr BasisCache::getTransformedValues(BasisPtr basis, Camellia::EOperator
 constFCPtr BasisCache::getTransformedWeightedValues(BasisPtr basis, Camellia::EOperator op,
     int sideOrdinal, bool useCubPointsSideRefCell)
 {
-  return _basisCacheSides[sideOrdinal]->getTransformedWeightedValues(basis,op,useCubPointsSideRefCell);
+  return sideCache(sideOrdinal)->getTransformedWeightedValues(basis,op,useCubPointsSideRefCell);
 }
 
 const FieldContainer<double> & BasisCache::getPhysicalCubaturePointsForSide(int sideOrdinal)
 {
-  return _basisCacheSides[sideOrdinal]->getPhysicalCubaturePoints();
+  return sideCache(sideOrdinal)->getPhysicalCubaturePoints();
 }
 
 BasisCachePtr BasisCache::getSideBasisCache(int sideOrdinal)
 {
-  if (sideOrdinal < _basisCacheSides.size() )
-    return _basisCacheSides[sideOrdinal];
+  if ((_sideCachesRequested || (sideOrdinal < _basisCacheSides.size())) && (sideOrdinal < _cellTopo->getSideCount()))
+    return sideCache(sideOrdinal);
   else
     return Teuchos::rcp((BasisCache *) NULL);
 }
@@ -1131,7 +1174,7 @@ int BasisCache::getSideIndex() const
 
 const FieldContainer<double> & BasisCache::getSideUnitNormals(int sideOrdinal)
 {
-  return _basisCacheSides[sideOrdinal]->getSideNormals();
+  return sideCache(sideOrdinal)->getSideNormals();
 }
 
 const FieldContainer<double>& BasisCache::getRefCellPoints()
@@ -1176,6 +1219,7 @@ void BasisCache::setRefCellPoints(const FieldContainer<double> &pointsRefCell, c
 {
   _cubPoints = pointsRefCell;
   _cubDegree = cubatureDegree;
+  _referenceRuleID = -1; // points are no longer those of a registered cubature rule
   int numPoints = pointsRefCell.dimension(0);
 
   if ( isSideCache() )   // then we need to map pointsRefCell (on side) into volume coordinates, and store in _cubPointsSideRefCell
@@ -1323,6 +1367,105 @@ void BasisCache::determinePhysicalPoints()
   }
 }
 
+// ! Returns true if the reference-to-physical map is affine on every cell in physicalCellNodes: always the case for
+// ! straight-sided simplices; for quadrilaterals, hexahedra, and wedges, each quadrilateral face must be a parallelogram.
+static bool physicalCellsAreAffine(const FieldContainer<double> &physicalCellNodes, CellTopoPtr cellTopo)
+{
+  if (cellTopo->getTensorialDegree() > 0) return false;
+  const shards::CellTopology &shardsTopo = cellTopo->getShardsTopology();
+  if (physicalCellNodes.dimension(1) != shardsTopo.getVertexCount()) return false; // higher-order geometry nodes
+
+  switch (shardsTopo.getKey())
+  {
+  case shards::Line<2>::key:
+  case shards::Triangle<3>::key:
+  case shards::Tetrahedron<4>::key:
+    return true;
+  case shards::Quadrilateral<4>::key:
+  case shards::Hexahedron<8>::key:
+  case shards::Wedge<6>::key:
+    break;
+  default:
+    return false;
+  }
+
+  // vertex ordinals of the quadrilateral faces, in cyclic order
+  vector< vector<unsigned> > quadFaces;
+  int cellDim = shardsTopo.getDimension();
+  if (cellDim == 2)
+  {
+    quadFaces.push_back({0,1,2,3});
+  }
+  else
+  {
+    for (int faceOrdinal=0; faceOrdinal<shardsTopo.getSideCount(); faceOrdinal++)
+    {
+      if (shardsTopo.getVertexCount(2, faceOrdinal) != 4) continue;
+      vector<unsigned> faceVertices(4);
+      for (int i=0; i<4; i++)
+      {
+        faceVertices[i] = shardsTopo.getNodeMap(2, faceOrdinal, i);
+      }
+      quadFaces.push_back(faceVertices);
+    }
+  }
+
+  const double relTol = 1e-12;
+  int numCells = physicalCellNodes.dimension(0);
+  int numVertices = physicalCellNodes.dimension(1);
+  int spaceDim = physicalCellNodes.dimension(2);
+  for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+  {
+    double cellExtent = 0;
+    for (int d=0; d<spaceDim; d++)
+    {
+      double minCoord = physicalCellNodes(cellOrdinal,0,d), maxCoord = minCoord;
+      for (int vertexOrdinal=1; vertexOrdinal<numVertices; vertexOrdinal++)
+      {
+        minCoord = min(minCoord, physicalCellNodes(cellOrdinal,vertexOrdinal,d));
+        maxCoord = max(maxCoord, physicalCellNodes(cellOrdinal,vertexOrdinal,d));
+      }
+      cellExtent = max(cellExtent, maxCoord - minCoord);
+    }
+    for (const vector<unsigned> &face : quadFaces)
+    {
+      for (int d=0; d<spaceDim; d++)
+      {
+        // a quadrilateral is a parallelogram iff x0 - x1 + x2 - x3 = 0
+        double bilinearCoefficient = physicalCellNodes(cellOrdinal,face[0],d) - physicalCellNodes(cellOrdinal,face[1],d)
+                                   + physicalCellNodes(cellOrdinal,face[2],d) - physicalCellNodes(cellOrdinal,face[3],d);
+        if (abs(bilinearCoefficient) > relTol * cellExtent) return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ! Copies values from a (C,1,...) container to every point of a (C,P,...) container.
+static void broadcastFirstPointValues(FieldContainer<double> &pointValues, const FieldContainer<double> &onePointValues)
+{
+  int numCells = pointValues.dimension(0);
+  int numPoints = pointValues.dimension(1);
+  int entriesPerPoint = (numCells * numPoints > 0) ? pointValues.size() / (numCells * numPoints) : 0;
+  for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+  {
+    const double* cellValue = &onePointValues[cellOrdinal * entriesPerPoint];
+    double* pointValue = &pointValues[cellOrdinal * numPoints * entriesPerPoint];
+    for (int pointOrdinal=0; pointOrdinal<numPoints; pointOrdinal++)
+    {
+      for (int i=0; i<entriesPerPoint; i++, pointValue++)
+      {
+        *pointValue = cellValue[i];
+      }
+    }
+  }
+}
+
+bool BasisCache::usesAffineGeometry()
+{
+  return _physicalCellsAreAffine && TFunction<double>::isNull(_transformationFxn);
+}
+
 void BasisCache::determineJacobian()
 {
   int cellDim = _cellTopo->getDimension();
@@ -1346,6 +1489,22 @@ void BasisCache::determineJacobian()
     return;
   }
 
+  if (usesAffineGeometry())
+  {
+    // Jacobian is constant on each cell: compute it at one point, and copy to the rest
+    const FieldContainer<double> *refPoints = isSideCache() ? &_cubPointsSideRefCell : &_cubPoints;
+    FieldContainer<double> firstPoint(1, cellDim);
+    for (int d=0; d<cellDim; d++)
+    {
+      firstPoint(0,d) = (*refPoints)(0,d);
+    }
+    FieldContainer<double> cellJacobianOnePoint(_numCells, 1, cellDim, cellDim);
+    CamelliaCellTools::setJacobian(cellJacobianOnePoint, firstPoint, _physicalCellNodes, _cellTopo);
+    broadcastFirstPointValues(_cellJacobian, cellJacobianOnePoint);
+    _cellJacobianIsValid = true;
+    return;
+  }
+
   if ( TFunction<double>::isNull(_transformationFxn) || _composeTransformationFxnWithMeshTransformation)
   {
     if (!isSideCache())
@@ -1401,7 +1560,31 @@ void BasisCache::determineJacobianInverseAndDeterminant()
   
   _cellJacobInv.resize(_numCells, numCubPoints, cellDim, cellDim);
   _cellJacobDet.resize(_numCells, numCubPoints);
-  SerialDenseWrapper::determinantAndInverse(_cellJacobDet, _cellJacobInv, getJacobian());
+  if (usesAffineGeometry() && (numCubPoints > 0))
+  {
+    // one inversion per cell
+    const FieldContainer<double> *cellJacobian = &getJacobian();
+    FieldContainer<double> cellJacobianOnePoint(_numCells, 1, cellDim, cellDim);
+    for (int cellOrdinal=0; cellOrdinal<_numCells; cellOrdinal++)
+    {
+      for (int d1=0; d1<cellDim; d1++)
+      {
+        for (int d2=0; d2<cellDim; d2++)
+        {
+          cellJacobianOnePoint(cellOrdinal,0,d1,d2) = (*cellJacobian)(cellOrdinal,0,d1,d2);
+        }
+      }
+    }
+    FieldContainer<double> cellJacobInvOnePoint(_numCells, 1, cellDim, cellDim);
+    FieldContainer<double> cellJacobDetOnePoint(_numCells, 1);
+    SerialDenseWrapper::determinantAndInverse(cellJacobDetOnePoint, cellJacobInvOnePoint, cellJacobianOnePoint);
+    broadcastFirstPointValues(_cellJacobInv, cellJacobInvOnePoint);
+    broadcastFirstPointValues(_cellJacobDet, cellJacobDetOnePoint);
+  }
+  else
+  {
+    SerialDenseWrapper::determinantAndInverse(_cellJacobDet, _cellJacobInv, getJacobian());
+  }
   _cellJacobianInverseIsValid = true;
   _cellJacobianDeterminantIsValid = true;
 }
@@ -1420,6 +1603,7 @@ void BasisCache::setPhysicalCellNodes(const FieldContainer<double> &physicalCell
   }
 
   _cellIDs = cellIDs;
+  _physicalCellsAreAffine = physicalCellsAreAffine(physicalCellNodes, _cellTopo);
   // Compute cell Jacobians, their inverses and their determinants
 
   _cellJacobianIsValid = false;
@@ -1439,21 +1623,16 @@ void BasisCache::setPhysicalCellNodes(const FieldContainer<double> &physicalCell
 
   if ( ! isSideCache() && createSideCacheToo )
   {
-    // we only actually create side caches anew if they don't currently exist
-    if (_basisCacheSides.size() == 0)
-    {
-      createSideCaches();
-    }
-    int numSides = _cellTopo->getSideCount();
-    for (int sideOrdinal=0; sideOrdinal<numSides; sideOrdinal++)
-    {
-      _basisCacheSides[sideOrdinal]->setPhysicalCellNodes(physicalCellNodes, cellIDs, false);
-    }
+    // side caches (which we only create anew if they don't currently exist) get the new nodes on first query; see sideCache()
+    _sideCachesRequested = true;
+    _sideCacheIsCurrent.assign(_cellTopo->getSideCount(), false);
   }
   else if (! isSideCache() && ! createSideCacheToo )
   {
     // then we have side caches whose values are going to be stale: we should delete these
     _basisCacheSides.clear();
+    _sideCachesRequested = false;
+    _sideCacheIsCurrent.clear();
   }
 }
 
@@ -15,6 +15,7 @@
 
 #include "BasisCache.h"
 #include "CamelliaCellTools.h"
+#include "CamelliaMemoryUtility.h"
 #include "CamelliaDebugUtility.h" // includes print() methods
 #include "CellTopology.h"
 #include "SerialDenseMatrixUtility.h"
@@ -27,6 +28,23 @@
 using namespace Intrepid;
 using namespace Camellia;
 
+// storage for weights beyond the struct itself: the weight values and the ordinal set nodes
+static long long approximateWeightsHeapSize(const SubBasisReconciliationWeights &weights)
+{
+  long long heapSize = sizeof(double) * weights.weights.size();
+  heapSize += approximateSetSizeLLVM(weights.fineOrdinals) - sizeof(weights.fineOrdinals);
+  heapSize += approximateSetSizeLLVM(weights.coarseOrdinals) - sizeof(weights.coarseOrdinals);
+  return heapSize;
+}
+
+// cost of a cached weights entry: key, value, and the storage each refers to.  Field ops in the term-traced keys are short,
+// and are not counted.
+template<typename Key>
+static long long approximateWeightsEntryCost(const Key &key, const RefinementBranch &refinements, const SubBasisReconciliationWeights &weights)
+{
+  return sizeof(key) + sizeof(weights) + sizeof(RefinementBranch::value_type) * refinements.size() + approximateWeightsHeapSize(weights);
+}
+
 void sizeFCForBasisValues(FieldContainer<double> &fc, BasisPtr basis, int numPoints, bool includeCellDimension = false, int numBasisFieldsToInclude = -1)
 {
   // values should have shape: (F,P[,D,D,...]) where the # of D's = rank of the basis's range
@@ -140,6 +158,64 @@ unsigned vertexPermutation(shards::CellTopology &fineTopo, unsigned fineSideInde
   return -1; // just for compilers that would otherwise warn that we're missing a return value...
 }
 
+BasisReconciliation::BasisReconciliation(bool cacheResults)
+: _termsTraced([](const TermTracedCacheKey &key, const SubBasisReconciliationWeights &weights)
+               {
+                 return approximateWeightsEntryCost(key, key.first.first.first.second, weights);
+               })
+{
+  _cacheResults = cacheResults;
+  _subcellReconcilationWeights = sharedSubcellWeightsCache();
+}
+
+Teuchos::RCP<BasisReconciliation::SubcellWeightsCache> BasisReconciliation::sharedSubcellWeightsCache()
+{
+  static Teuchos::RCP<SubcellWeightsCache> sharedCache;
+  if (sharedCache == Teuchos::null)
+  {
+    sharedCache = Teuchos::rcp( new SubcellWeightsCache([](const SubcellWeightsCacheKey &key, const SubBasisReconciliationWeights &weights)
+                                                        {
+                                                          return approximateWeightsEntryCost(key, key.first.second, weights);
+                                                        }) );
+  }
+  return sharedCache;
+}
+
+map<string, long long> BasisReconciliation::approximateMemoryCosts() const
+{
+  map<string, long long> variableCost;
+  
+  variableCost["_subcellReconcilationWeights"] = _subcellReconcilationWeights->approximateMemoryFootprint();
+  variableCost["_termsTraced"] = _termsTraced.approximateMemoryFootprint();
+  
+  return variableCost;
+}
+
+void BasisReconciliation::setTermTracedWeightsMemoryBudget(long long bytes)
+{
+  _termsTraced.setMemoryBudget(bytes);
+}
+
+LRUCacheStatistics BasisReconciliation::termTracedWeightsCacheStatistics() const
+{
+  return _termsTraced.statistics();
+}
+
+void BasisReconciliation::setSharedSubcellWeightsMemoryBudget(long long bytes)
+{
+  sharedSubcellWeightsCache()->setMemoryBudget(bytes);
+}
+
+LRUCacheStatistics BasisReconciliation::sharedSubcellWeightsCacheStatistics()
+{
+  return sharedSubcellWeightsCache()->statistics();
+}
+
+void BasisReconciliation::clearSharedSubcellWeights()
+{
+  sharedSubcellWeightsCache()->clear();
+}
+
 SubBasisReconciliationWeights BasisReconciliation::composedSubBasisReconciliationWeights(const SubBasisReconciliationWeights &aWeights,
                                                                                          const SubBasisReconciliationWeights &bWeights)
 {
@@ -790,21 +866,19 @@ const SubBasisReconciliationWeights & BasisReconciliation::constrainedWeights(un
                                                                               unsigned vertexNodePermutation)
 {
 
-  SubcellBasisRestriction fineBasisRestriction = make_pair(finerBasis.get(), make_pair(subcellDimension, finerBasisSubcellOrdinal) );
-  SubcellBasisRestriction coarseBasisRestriction = make_pair(coarserBasis.get(), make_pair(subcellDimension, coarserBasisSubcellOrdinal) );
+  SubcellBasisRestriction fineBasisRestriction = make_pair(BasisKey{finerBasis}, make_pair(subcellDimension, finerBasisSubcellOrdinal) );
+  SubcellBasisRestriction coarseBasisRestriction = make_pair(BasisKey{coarserBasis}, make_pair(subcellDimension, coarserBasisSubcellOrdinal) );
   SubcellRefinedBasisPair refinedBasisPair = make_pair(make_pair(fineBasisRestriction, coarseBasisRestriction), refinements);
 
-  pair< SubcellRefinedBasisPair, Permutation> cacheKey = make_pair(refinedBasisPair, vertexNodePermutation);
+  SubcellWeightsCacheKey cacheKey = make_pair(refinedBasisPair, vertexNodePermutation);
 
-  if (_subcellReconcilationWeights.find(cacheKey) == _subcellReconcilationWeights.end())
-  {
-    _subcellReconcilationWeights[cacheKey] = computeConstrainedWeights(subcellDimension, finerBasis, finerBasisSubcellOrdinal, refinements,
-                                                                       coarserBasis, coarserBasisSubcellOrdinal, vertexNodePermutation);
-    // 10-14-15 added filtering:
-    _subcellReconcilationWeights[cacheKey] = filterOutZeroRowsAndColumns(_subcellReconcilationWeights[cacheKey]);
-  }
-
-  return _subcellReconcilationWeights[cacheKey];
+  SubBasisReconciliationWeights* cachedWeights = _subcellReconcilationWeights->find(cacheKey);
+  if (cachedWeights != NULL) return *cachedWeights;
+  
+  SubBasisReconciliationWeights weights = computeConstrainedWeights(subcellDimension, finerBasis, finerBasisSubcellOrdinal, refinements,
+                                                                    coarserBasis, coarserBasisSubcellOrdinal, vertexNodePermutation);
+  // 10-14-15 added filtering:
+  return _subcellReconcilationWeights->insert(cacheKey, filterOutZeroRowsAndColumns(weights));
 }
 
 const SubBasisReconciliationWeights &BasisReconciliation::constrainedWeightsForTermTraced(LinearTermPtr termTraced, int fieldID,
@@ -825,8 +899,8 @@ const SubBasisReconciliationWeights &BasisReconciliation::constrainedWeightsForT
   typedef vector<pair<Function*, Camellia::EOperator>> FieldOps;
   typedef pair<PermutedRefinedBasisPairDomainOrdinals, FieldOps> TermTracedCacheKey;
   
-  SubcellBasisRestriction fineBasisRestriction = make_pair(finerBasis.get(), make_pair(fineSubcellDimension, fineSubcellOrdinalInFineDomain) );
-  SubcellBasisRestriction coarseBasisRestriction = make_pair(coarserBasis.get(), make_pair(coarseSubcellDimension, coarseSubcellOrdinalInCoarseDomain) );
+  SubcellBasisRestriction fineBasisRestriction = make_pair(BasisKey{finerBasis}, make_pair(fineSubcellDimension, fineSubcellOrdinalInFineDomain) );
+  SubcellBasisRestriction coarseBasisRestriction = make_pair(BasisKey{coarserBasis}, make_pair(coarseSubcellDimension, coarseSubcellOrdinalInCoarseDomain) );
   SubcellRefinedBasisPair refinedBasisPair = {{fineBasisRestriction, coarseBasisRestriction}, cellRefinementBranch};
   
   PermutedRefinedBasisPair permutedRefinedBasisPair = make_pair(refinedBasisPair, coarseSubcellPermutation);
@@ -845,7 +919,8 @@ const SubBasisReconciliationWeights &BasisReconciliation::constrainedWeightsForT
 
   TermTracedCacheKey cacheKey = {permutedRefinedBasisPairDomainOrdinals,fieldOps};
   
-  if (_termsTraced.find(cacheKey) == _termsTraced.end())
+  SubBasisReconciliationWeights* cachedWeights = _termsTraced.find(cacheKey);
+  if (cachedWeights == NULL)
   {
     SubBasisReconciliationWeights weights = computeConstrainedWeightsForTermTraced(termTraced, fieldID, fineSubcellDimension,
                                                                                    finerBasis, fineSubcellOrdinalInFineDomain,
@@ -855,10 +930,10 @@ const SubBasisReconciliationWeights &BasisReconciliation::constrainedWeightsForT
                                                                                    coarserBasis, coarseSubcellOrdinalInCoarseDomain,
                                                                                    coarseDomainOrdinalInCoarseCellTopo,
                                                                                    coarseSubcellPermutation);
-    _termsTraced[cacheKey] = filterOutZeroRowsAndColumns(weights); // 10-14-15 added zero-row-and-column filtering
-//    _termsTraced[cacheKey] = weights;
+    return _termsTraced.insert(cacheKey, filterOutZeroRowsAndColumns(weights)); // 10-14-15 added zero-row-and-column filtering
+//    return _termsTraced.insert(cacheKey, weights);
   }
-  return _termsTraced[cacheKey];
+  return *cachedWeights;
 }
 
 bool BasisReconciliation::equalWeights(const SubBasisReconciliationWeights &aWeights, const SubBasisReconciliationWeights &bWeights, double tol)
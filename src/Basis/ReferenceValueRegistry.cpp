@@ -0,0 +1,139 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+
+#include "ReferenceValueRegistry.h"
+
+#include "BasisEvaluation.h"
+#include "CubatureFactory.h"
+
+#include <mutex>
+#include <tuple>
+
+using namespace Intrepid;
+using namespace Camellia;
+using namespace std;
+
+namespace
+{
+  // (cell topology, cubDegree, cubDegrees, sideOrdinal)
+  typedef tuple<CellTopologyKey, int, vector<int>, int> CubatureRuleKey;
+
+  struct CubatureRule
+  {
+    FieldContainer<double> points;
+    FieldContainer<double> weights;
+  };
+
+  // (basis, op, rule, useSideRefCellPoints)
+  typedef tuple<Camellia::Basis<>*, Camellia::EOperator, int, bool> ReferenceValuesKey;
+
+  struct ReferenceValues
+  {
+    BasisPtr basis; // keeps the key's Basis address valid
+    constFCPtr values;
+  };
+
+  mutex registryMutex;
+
+  map<CubatureRuleKey, int> ruleIDs;
+  vector<CubatureRule> rules;
+
+  map<ReferenceValuesKey, ReferenceValues> knownValues;
+
+  long hits = 0, misses = 0;
+}
+
+int ReferenceValueRegistry::cubatureRule(CellTopoPtr cellTopo, int cubDegree, const vector<int> &cubDegrees, int sideOrdinal,
+                                         FieldContainer<double> &cubPoints, FieldContainer<double> &cubWeights)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION((cubDegree < 0) && (cubDegrees.size() == 0), std::invalid_argument, "Either cubDegree or cubDegrees must be specified");
+
+  lock_guard<mutex> lock(registryMutex);
+
+  CubatureRuleKey key(cellTopo->getKey(), cubDegree, (cubDegree >= 0) ? vector<int>() : cubDegrees, sideOrdinal);
+
+  int ruleID;
+  if (ruleIDs.find(key) != ruleIDs.end())
+  {
+    ruleID = ruleIDs[key];
+  }
+  else
+  {
+    CellTopoPtr topo = (sideOrdinal == -1) ? cellTopo : cellTopo->getSubcell(cellTopo->getDimension() - 1, sideOrdinal);
+
+    CubatureFactory cubFactory;
+    Teuchos::RCP<Cubature<double> > cub;
+    if (cubDegree >= 0)
+      cub = cubFactory.create(topo, cubDegree);
+    else
+      cub = cubFactory.create(topo, cubDegrees);
+
+    CubatureRule rule;
+    int numPoints = (cub != Teuchos::null) ? cub->getNumPoints() : 0;
+    int cubDim = (cub != Teuchos::null) ? cub->getDimension() : topo->getDimension();
+    rule.points.resize(numPoints, cubDim);
+    rule.weights.resize(numPoints);
+    if (numPoints > 0)
+      cub->getCubature(rule.points, rule.weights);
+
+    ruleID = rules.size();
+    rules.push_back(rule);
+    ruleIDs[key] = ruleID;
+  }
+
+  cubPoints = rules[ruleID].points;
+  cubWeights = rules[ruleID].weights;
+  return ruleID;
+}
+
+constFCPtr ReferenceValueRegistry::referenceValues(BasisPtr basis, Camellia::EOperator op, int ruleID, bool useSideRefCellPoints,
+                                                   const FieldContainer<double> &points)
+{
+  ReferenceValuesKey key(basis.get(), op, ruleID, useSideRefCellPoints);
+  {
+    lock_guard<mutex> lock(registryMutex);
+    auto entryIt = knownValues.find(key);
+    if (entryIt != knownValues.end())
+    {
+      hits++;
+      return entryIt->second.values;
+    }
+    misses++;
+  }
+
+  // evaluate outside the lock; if another caller got there first, theirs is kept (the values are identical)
+  ReferenceValues entry;
+  entry.basis = basis;
+  entry.values = BasisEvaluation::getValues(basis, op, points);
+
+  lock_guard<mutex> lock(registryMutex);
+  return knownValues.insert(make_pair(key, entry)).first->second.values;
+}
+
+long ReferenceValueRegistry::hitCount()
+{
+  lock_guard<mutex> lock(registryMutex);
+  return hits;
+}
+
+long ReferenceValueRegistry::missCount()
+{
+  lock_guard<mutex> lock(registryMutex);
+  return misses;
+}
+
+void ReferenceValueRegistry::resetCounters()
+{
+  lock_guard<mutex> lock(registryMutex);
+  hits = 0;
+  misses = 0;
+}
+
+void ReferenceValueRegistry::clearValues()
+{
+  lock_guard<mutex> lock(registryMutex);
+  knownValues.clear();
+}
@@ -58,6 +58,7 @@ SpaceTimeBasisCache::SpaceTimeBasisCache(MeshPtr spaceTimeMesh, ElementTypePtr s
 
   bool createSideCache = true;
   _spatialCache->setPhysicalCellNodes(physicalNodesSpatial, cellIDs, createSideCache);
+  _spatialCache->updateSideCaches(); // our side caches hold on to _spatialCache's side caches
   _temporalCache->setPhysicalCellNodes(physicalNodesTemporal, cellIDs, createSideCache);
 
   this->BasisCache::setPhysicalCellNodes(physicalNodesSpaceTime, cellIDs, createSideCache);
@@ -125,6 +126,7 @@ SpaceTimeBasisCache::SpaceTimeBasisCache(const FieldContainer<double> &physicalN
   vector<GlobalIndexType> cellIDs; //empty
 
   _spatialCache->setPhysicalCellNodes(physicalNodesSpatial, cellIDs, createSideCache);
+  _spatialCache->updateSideCaches(); // our side caches hold on to _spatialCache's side caches
   _temporalCache->setPhysicalCellNodes(physicalNodesTemporal, cellIDs, createSideCache);
 
   // create side caches
@@ -665,6 +667,7 @@ void SpaceTimeBasisCache::setPhysicalCellNodes(const Intrepid::FieldContainer<do
     }
   }
   _spatialCache->setPhysicalCellNodes(physicalCellNodesSpace, cellIDs, true); // true: always create side caches for _spatialCache
+  _spatialCache->updateSideCaches(); // our side caches hold on to _spatialCache's side caches
   _temporalCache->setPhysicalCellNodes(physicalCellNodesTime, cellIDs, true); // true: always create side caches for _temporalCache
   this->BasisCache::setPhysicalCellNodes(physicalCellNodes, cellIDs, createSideCacheToo);
 }
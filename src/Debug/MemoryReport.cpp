@@ -0,0 +1,153 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//  MemoryReport.cpp
+//  Camellia
+//
+
+#include "MemoryReport.h"
+
+#include "CamelliaMemoryUtility.h"
+#include "Mesh.h"
+#include "MPIWrapper.h"
+#include "Solution.h"
+
+#include <functional>
+#include <iomanip>
+#include <set>
+#include <vector>
+
+using namespace Camellia;
+using namespace std;
+
+// union over ranks of the keys in localCosts, in sorted order
+static vector<string> allRankKeys(const Epetra_Comm &Comm, const map<string, long long> &localCosts)
+{
+  vector<string> keys;
+  if (Comm.NumProc() == 1)
+  {
+    for (auto &entry : localCosts)
+    {
+      keys.push_back(entry.first);
+    }
+    return keys;
+  }
+
+  // null-terminated keys; the leading null ensures myChars is never empty
+  vector<char> myChars(1,'\0');
+  for (auto &entry : localCosts)
+  {
+    myChars.insert(myChars.end(), entry.first.begin(), entry.first.end());
+    myChars.push_back('\0');
+  }
+  vector<char> allChars;
+  vector<int> offsets;
+  MPIWrapper::allGatherVariable(Comm, allChars, myChars, offsets);
+
+  set<string> keySet;
+  string key;
+  for (char c : allChars)
+  {
+    if (c != '\0')
+    {
+      key.push_back(c);
+    }
+    else if (key.size() > 0)
+    {
+      keySet.insert(key);
+      key.clear();
+    }
+  }
+  keys.insert(keys.end(), keySet.begin(), keySet.end());
+  return keys;
+}
+
+MemoryReport::MemoryReport(Epetra_CommPtr Comm) : _Comm(Comm)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(Comm == Teuchos::null, std::invalid_argument, "Comm may not be null");
+}
+
+void MemoryReport::addCosts(const string &prefix, const map<string, long long> &costs)
+{
+  addMemoryCosts(_localCosts, prefix, costs);
+}
+
+void MemoryReport::addMesh(MeshPtr mesh, const string &prefix)
+{
+  addCosts(prefix, mesh->approximateMemoryCosts());
+}
+
+void MemoryReport::addSolution(SolutionPtr solution, const string &prefix)
+{
+  addCosts(prefix, solution->approximateMemoryCosts());
+}
+
+const map<string, long long> & MemoryReport::localCosts() const
+{
+  return _localCosts;
+}
+
+long long MemoryReport::localTotal() const
+{
+  return totalMemoryCost(_localCosts);
+}
+
+void MemoryReport::globalCosts(map<string, long long> &minCosts, map<string, long long> &maxCosts,
+                               map<string, long long> &sumCosts) const
+{
+  vector<string> keys = allRankKeys(*_Comm, _localCosts);
+
+  // reduce as doubles, which Epetra_Comm supports on all platforms; exact up to 2^53 bytes
+  int numEntries = keys.size() + 1; // last entry: the total
+  vector<double> myCosts(numEntries, 0.0);
+  for (int i=0; i<keys.size(); i++)
+  {
+    auto entry = _localCosts.find(keys[i]);
+    if (entry != _localCosts.end()) myCosts[i] = entry->second;
+  }
+  myCosts[numEntries-1] = localTotal();
+
+  vector<double> minValues(numEntries), maxValues(numEntries), sumValues(numEntries);
+  _Comm->MinAll(&myCosts[0], &minValues[0], numEntries);
+  _Comm->MaxAll(&myCosts[0], &maxValues[0], numEntries);
+  _Comm->SumAll(&myCosts[0], &sumValues[0], numEntries);
+
+  keys.push_back("Total");
+  minCosts.clear();
+  maxCosts.clear();
+  sumCosts.clear();
+  for (int i=0; i<numEntries; i++)
+  {
+    minCosts[keys[i]] = (long long) minValues[i];
+    maxCosts[keys[i]] = (long long) maxValues[i];
+    sumCosts[keys[i]] = (long long) sumValues[i];
+  }
+}
+
+void MemoryReport::print(ostream &out, long long minBytesToReport) const
+{
+  map<string, long long> minCosts, maxCosts, sumCosts;
+  globalCosts(minCosts, maxCosts, sumCosts);
+
+  if (_Comm->MyPID() != 0) return;
+
+  long long minTotal = minCosts["Total"], maxTotal = maxCosts["Total"], sumTotal = sumCosts["Total"];
+  minCosts.erase("Total");
+
+  multimap<long long, string, greater<long long>> keysBySum;
+  for (auto &entry : minCosts)
+  {
+    if (sumCosts[entry.first] < minBytesToReport) continue;
+    keysBySum.insert({sumCosts[entry.first], entry.first});
+  }
+
+  out << "**** Memory Report (" << _Comm->NumProc() << " ranks) ****\n";
+  out << "Memory sizes are in bytes.\n";
+  out << setw(60) << left << "" << right << setw(16) << "min/rank" << setw(16) << "max/rank" << setw(16) << "sum" << endl;
+  for (auto &entry : keysBySum)
+  {
+    const string &key = entry.second;
+    out << setw(60) << left << key << right << setw(16) << minCosts[key] << setw(16) << maxCosts[key] << setw(16) << sumCosts[key] << endl;
+  }
+  out << setw(60) << left << "Total" << right << setw(16) << minTotal << setw(16) << maxTotal << setw(16) << sumTotal << endl;
+}
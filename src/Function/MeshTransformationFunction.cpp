@@ -77,6 +77,7 @@ void roundToOneOrZero(double &value, double tol)
 class CellTransformationFunction : public TFunction<double>
 {
   FieldContainer<double> _basisCoefficients;
+  FieldContainer<double> _componentCoefficients; // (D,F) -- _basisCoefficients, arranged by component of _basis
   VectorBasisPtr _basis;
   Camellia::EOperator _op;
   int _cellIndex; // index into BasisCache's list of cellIDs; must be set prior to each call to values() (there's a reason why this is a private class!)
@@ -134,6 +135,22 @@ protected:
     _basisCoefficients = basisCoefficients;
     _op = op;
     _cellIndex = -1;
+    initializeComponentCoefficients();
+  }
+
+  void initializeComponentCoefficients()
+  {
+    int numComponents = _basis->getNumComponents();
+    int numComponentDofs = _basis->getComponentBasis()->getCardinality();
+    _componentCoefficients.resize(numComponents, numComponentDofs);
+    for (int comp=0; comp<numComponents; comp++)
+    {
+      for (int compDofOrdinal=0; compDofOrdinal<numComponentDofs; compDofOrdinal++)
+      {
+        int dofOrdinal = _basis->getDofOrdinalFromComponentDofOrdinal(compDofOrdinal, comp);
+        _componentCoefficients(comp,compDofOrdinal) = _basisCoefficients(dofOrdinal);
+      }
+    }
   }
 public:
   CellTransformationFunction(MeshPtr mesh, int cellID, const vector< ParametricCurvePtr > &edgeFunctions) : TFunction<double>(1)
@@ -143,6 +160,7 @@ public:
     ElementTypePtr elementType = mesh->getElementType(cellID);
     _basis = basisForTransformation(elementType);
     ParametricSurface::basisWeightsForProjectedInterpolant(_basisCoefficients, _basis, mesh, cellID);
+    initializeComponentCoefficients();
   }
 
   void values(FieldContainer<double> &values, BasisCachePtr basisCache)
@@ -162,7 +180,6 @@ public:
       basisCache = spaceTimeCache->getSpatialBasisCache();
     }
     
-    int numDofs = _basis->getCardinality();
     int spaceDim = basisCache->getSpaceDim();
 
     bool basisIsVolumeBasis = (spaceDim == _basis->domainTopology()->getDimension());
@@ -189,14 +206,8 @@ public:
       }
       return;
     }
-    constFCPtr transformedValues = basisCache->getTransformedValues(_basis, _op, useCubPointsSideRefCell);
-
-    // transformedValues has dimensions (C,F,P,[D,D])
-    // therefore, the rank of the sum is transformedValues->rank() - 3
-    int rank = transformedValues->rank() - 3;
-    TEUCHOS_TEST_FOR_EXCEPTION(rank != values.rank()-2, std::invalid_argument, "values rank is incorrect.");
+    TEUCHOS_TEST_FOR_EXCEPTION(values.rank() != 3, std::invalid_argument, "values rank is incorrect.");
 
-    
     int spaceTimeSideOrdinal = (spaceTimeBasisCache != Teuchos::null) ? spaceTimeBasisCache->getSideIndex() : -1;
     // I'm pretty sure much of this treatment of the time dimension could be simplified by taking advantage of SpaceTimeBasisCache::getTemporalBasisCache()...
     double t0 = -1, t1 = -1;
@@ -263,25 +274,74 @@ public:
       TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Unhandled _op");
     }
 
-    int numSpatialPoints = transformedValues->dimension(2);
-    int numTemporalPoints = numPoints / numSpatialPoints;
-    TEUCHOS_TEST_FOR_EXCEPTION(numTemporalPoints * numSpatialPoints != numPoints, std::invalid_argument, "numPoints is not evenly divisible by numSpatialPoints");
-    
-    for (int i=0; i<numDofs; i++)
+    // Evaluate the expansion for this cell only, against the (cached) reference values of the component basis.
+    // For the H^1 component basis, transformed values are just reference values, and transformed gradients
+    // are the reference gradients multiplied by the transpose of the Jacobian inverse (cf. HGRADtransformGRAD).
+    BasisPtr componentBasis = _basis->getComponentBasis();
+    int numComponentDofs = componentBasis->getCardinality();
+    FieldContainer<double> spatialValues; // (P,D) for this cell
+    if (_op == OP_VALUE)
     {
-      double weight = _basisCoefficients(i);
-      for (int timePointOrdinal=0; timePointOrdinal<numTemporalPoints; timePointOrdinal++)
+      constFCPtr refValues = basisCache->getValues(componentBasis, OP_VALUE, useCubPointsSideRefCell); // (F,P)
+      int numSpatialPoints = refValues->dimension(1);
+      spatialValues.resize(numSpatialPoints,spaceDim);
+      spatialValues.initialize(0.0);
+      for (int compDofOrdinal=0; compDofOrdinal<numComponentDofs; compDofOrdinal++)
       {
         for (int spacePointOrdinal=0; spacePointOrdinal<numSpatialPoints; spacePointOrdinal++)
         {
-          int spaceTimePointOrdinal = TENSOR_POINT_ORDINAL(spacePointOrdinal, timePointOrdinal, numSpatialPoints);
+          double refValue = (*refValues)(compDofOrdinal,spacePointOrdinal);
           for (int d=0; d<spaceDim; d++)
           {
-            values(_cellIndex,spaceTimePointOrdinal,d) += weight * (*transformedValues)(_cellIndex,i,spacePointOrdinal,d);
+            spatialValues(spacePointOrdinal,d) += _componentCoefficients(d,compDofOrdinal) * refValue;
+          }
+        }
+      }
+    }
+    else
+    {
+      constFCPtr refGradients = basisCache->getValues(componentBasis, OP_GRAD, useCubPointsSideRefCell); // (F,P,D)
+      const FieldContainer<double> *jacobianInv = &basisCache->getJacobianInv(); // (C,P,D,D)
+      int numSpatialPoints = refGradients->dimension(1);
+      spatialValues.resize(numSpatialPoints,spaceDim);
+      spatialValues.initialize(0.0);
+      FieldContainer<double> refGradient(spaceDim); // reference-space gradient of one component of the map at one point
+      for (int spacePointOrdinal=0; spacePointOrdinal<numSpatialPoints; spacePointOrdinal++)
+      {
+        for (int d=0; d<spaceDim; d++)
+        {
+          refGradient.initialize(0.0);
+          for (int compDofOrdinal=0; compDofOrdinal<numComponentDofs; compDofOrdinal++)
+          {
+            double weight = _componentCoefficients(d,compDofOrdinal);
+            for (int k=0; k<spaceDim; k++)
+            {
+              refGradient(k) += weight * (*refGradients)(compDofOrdinal,spacePointOrdinal,k);
+            }
+          }
+          for (int k=0; k<spaceDim; k++)
+          {
+            spatialValues(spacePointOrdinal,d) += refGradient(k) * (*jacobianInv)(_cellIndex,spacePointOrdinal,k,component);
           }
         }
       }
     }
+
+    int numSpatialPoints = spatialValues.dimension(0);
+    int numTemporalPoints = numPoints / numSpatialPoints;
+    TEUCHOS_TEST_FOR_EXCEPTION(numTemporalPoints * numSpatialPoints != numPoints, std::invalid_argument, "numPoints is not evenly divisible by numSpatialPoints");
+    
+    for (int timePointOrdinal=0; timePointOrdinal<numTemporalPoints; timePointOrdinal++)
+    {
+      for (int spacePointOrdinal=0; spacePointOrdinal<numSpatialPoints; spacePointOrdinal++)
+      {
+        int spaceTimePointOrdinal = TENSOR_POINT_ORDINAL(spacePointOrdinal, timePointOrdinal, numSpatialPoints);
+        for (int d=0; d<spaceDim; d++)
+        {
+          values(_cellIndex,spaceTimePointOrdinal,d) += spatialValues(spacePointOrdinal,d);
+        }
+      }
+    }
   }
 
   int basisDegree()
@@ -420,18 +480,12 @@ bool MeshTransformationFunction::mapRefCellPointsUsingExactGeometry(FieldContain
 
     ParametricSurfacePtr interpolant = ParametricSurface::transfiniteInterpolant(edgeFunctions);
 
-    for (int ptIndex=0; ptIndex<numPoints; ptIndex++)
-    {
-      double t1 = parametricPoints(ptIndex,0);
-      double t2 = parametricPoints(ptIndex,1);
-
-      double x,y;
-      // transfinite interpolation:
-      interpolant->value(t1, t2, x, y);
+    // transfinite interpolation (fills in the spatial coordinates of cellPoints):
+    interpolant->valuesAtParameters(parametricPoints, cellPoints);
 
-      cellPoints(ptIndex,0) = x;
-      cellPoints(ptIndex,1) = y;
-      if (spaceTime)
+    if (spaceTime)
+    {
+      for (int ptIndex=0; ptIndex<numPoints; ptIndex++)
       {
         // per our assumptions on mesh transformations, we do a linear transform in time dimension
         double t_reference = refCellPoints(ptIndex,2); // goes from -1 to 1
@@ -460,6 +514,10 @@ void MeshTransformationFunction::updateCells(const set<GlobalIndexType> &cellIDs
     _cellTransforms[cellID] = cellTransform;
     _maxPolynomialDegree = std::max(_maxPolynomialDegree,cellTransform->basisDegree());
   }
+  // derivatives share our per-cell coefficients as of their creation; recreate them on next request
+  _dx = Teuchos::null;
+  _dy = Teuchos::null;
+  _dz = Teuchos::null;
 }
 
 void MeshTransformationFunction::values(FieldContainer<double> &values, BasisCachePtr basisCache)
@@ -531,8 +589,12 @@ map< GlobalIndexType, TFunctionPtr<double> > applyOperatorToCellTransforms(const
 
 TFunctionPtr<double> MeshTransformationFunction::dx()
 {
-  Camellia::EOperator op = OP_DX;
-  return Teuchos::rcp( new MeshTransformationFunction(_mesh, applyOperatorToCellTransforms(_cellTransforms, op),op));
+  if (_dx == Teuchos::null)
+  {
+    Camellia::EOperator op = OP_DX;
+    _dx = Teuchos::rcp( new MeshTransformationFunction(_mesh, applyOperatorToCellTransforms(_cellTransforms, op),op));
+  }
+  return _dx;
 }
 
 TFunctionPtr<double> MeshTransformationFunction::dy()
@@ -541,8 +603,12 @@ TFunctionPtr<double> MeshTransformationFunction::dy()
   {
     return TFunction<double>::null();
   }
-  Camellia::EOperator op = OP_DY;
-  return Teuchos::rcp( new MeshTransformationFunction(_mesh, applyOperatorToCellTransforms(_cellTransforms, op),op));
+  if (_dy == Teuchos::null)
+  {
+    Camellia::EOperator op = OP_DY;
+    _dy = Teuchos::rcp( new MeshTransformationFunction(_mesh, applyOperatorToCellTransforms(_cellTransforms, op),op));
+  }
+  return _dy;
 }
 
 TFunctionPtr<double> MeshTransformationFunction::dz()
@@ -551,8 +617,12 @@ TFunctionPtr<double> MeshTransformationFunction::dz()
   {
     return TFunction<double>::null();
   }
-  Camellia::EOperator op = OP_DZ;
-  return Teuchos::rcp( new MeshTransformationFunction(_mesh, applyOperatorToCellTransforms(_cellTransforms, op),op));
+  if (_dz == Teuchos::null)
+  {
+    Camellia::EOperator op = OP_DZ;
+    _dz = Teuchos::rcp( new MeshTransformationFunction(_mesh, applyOperatorToCellTransforms(_cellTransforms, op),op));
+  }
+  return _dz;
 }
 
 void MeshTransformationFunction::didHRefine(const set<GlobalIndexType> &cellIDs)
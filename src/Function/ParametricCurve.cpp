@@ -76,6 +76,25 @@ void ParametricFunction::value(double t, double &x)
   _underlyingFxn->values(oneValue, onePointCache);
   x = oneValue[0];
 }
+void ParametricFunction::valuesAtParameters(const FieldContainer<double> &tValues, FieldContainer<double> &xValues)
+{
+  int numPoints = tValues.size();
+  xValues.resize(numPoints);
+  if (numPoints == 0) return;
+  FieldContainer<double> mappedPoints(1,numPoints,1);
+  for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+  {
+    mappedPoints(0,ptOrdinal,0) = remapForSubCurve(tValues[ptOrdinal]);
+  }
+  BasisCachePtr pointCache = Teuchos::rcp( new PhysicalPointCache(mappedPoints) );
+  FieldContainer<double> pointValues(1,numPoints);
+  _underlyingFxn->values(pointValues, pointCache);
+  for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+  {
+    xValues(ptOrdinal) = pointValues(0,ptOrdinal);
+  }
+}
+
 void ParametricFunction::values(FieldContainer<double> &values, BasisCachePtr basisCache)
 {
   FieldContainer<double> parametricPoints = basisCache->computeParametricPoints();
@@ -202,6 +221,30 @@ public:
       y -= _yDiff;
     }
   }
+  void valuesAtParameters(const FieldContainer<double> &tValues, FieldContainer<double> &points, FieldContainer<double>* dPointsdt)
+  {
+    _edgeCurve->valuesAtParameters(tValues, points, dPointsdt);
+    int numPoints = tValues.size();
+    for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+    {
+      double t = tValues[ptOrdinal];
+      if (! _isDerivative )
+      {
+        points(ptOrdinal,0) -= _x0*(1.0-t) + _x1*t;
+        points(ptOrdinal,1) -= _y0*(1.0-t) + _y1*t;
+        if (dPointsdt != NULL)
+        {
+          (*dPointsdt)(ptOrdinal,0) -= _x1 - _x0;
+          (*dPointsdt)(ptOrdinal,1) -= _y1 - _y0;
+        }
+      }
+      else
+      {
+        points(ptOrdinal,0) -= _xDiff;
+        points(ptOrdinal,1) -= _yDiff;
+      }
+    }
+  }
   ParametricCurvePtr dt_parametric()
   {
     return Teuchos::rcp( new ParametricBubble(_edgeCurve->dt_parametric(),_x1-_x0, _y1-_y0) );
@@ -281,6 +324,45 @@ public:
     _curves[curveIndex]->value(curve_t, x,y);
   }
 
+  void valuesAtParameters(const FieldContainer<double> &tValues, FieldContainer<double> &points, FieldContainer<double>* dPointsdt)
+  {
+    // evaluate each constituent curve once, on all the points that fall on it
+    int numPoints = tValues.size();
+    int spaceDim = points.dimension(1);
+    vector< vector<int> > pointOrdinalsForCurve(_curves.size());
+    for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+    {
+      int curveIndex = matchingCurve(tValues[ptOrdinal]);
+      TEUCHOS_TEST_FOR_EXCEPTION(curveIndex == -1, std::invalid_argument, "t value lies outside [0,1]");
+      pointOrdinalsForCurve[curveIndex].push_back(ptOrdinal);
+    }
+    for (int curveIndex=0; curveIndex<_curves.size(); curveIndex++)
+    {
+      const vector<int>* pointOrdinals = &pointOrdinalsForCurve[curveIndex];
+      int numCurvePoints = pointOrdinals->size();
+      if (numCurvePoints == 0) continue;
+      double curve_t0 = _cutPoints[curveIndex];
+      double curve_t1 = _cutPoints[curveIndex+1];
+      FieldContainer<double> curveTValues(numCurvePoints);
+      for (int i=0; i<numCurvePoints; i++)
+      {
+        curveTValues(i) = (tValues[(*pointOrdinals)[i]] - curve_t0) / (curve_t1 - curve_t0);
+      }
+      FieldContainer<double> curvePoints(numCurvePoints,spaceDim), curveDerivatives;
+      if (dPointsdt != NULL) curveDerivatives.resize(numCurvePoints,spaceDim);
+      _curves[curveIndex]->valuesAtParameters(curveTValues, curvePoints, (dPointsdt != NULL) ? &curveDerivatives : NULL);
+      for (int i=0; i<numCurvePoints; i++)
+      {
+        int ptOrdinal = (*pointOrdinals)[i];
+        for (int d=0; d<spaceDim; d++)
+        {
+          points(ptOrdinal,d) = curvePoints(i,d);
+          if (dPointsdt != NULL) (*dPointsdt)(ptOrdinal,d) = curveDerivatives(i,d) / (curve_t1 - curve_t0);
+        }
+      }
+    }
+  }
+
   ParametricCurvePtr dt_parametric()
   {
     TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Unimplemented method!");
@@ -329,6 +411,61 @@ ParametricCurvePtr ParametricCurve::interpolatingLine()
   return line(x0, y0, x1, y1);
 }
 
+// one component of a curve (or its derivative in x), evaluated at all the points with one valuesAtParameters() call; used by
+// projectionBasedInterpolant() in place of the curve's component Functions
+class ParametricCurveComponent : public TFunction<double>
+{
+  ParametricCurvePtr _curve;
+  int _component;
+  bool _isDerivative;
+public:
+  ParametricCurveComponent(ParametricCurvePtr curve, int component, bool isDerivative = false) : TFunction<double>(0)
+  {
+    _curve = curve;
+    _component = component;
+    _isDerivative = isDerivative;
+  }
+  void values(FieldContainer<double> &values, BasisCachePtr basisCache)
+  {
+    CHECK_VALUES_RANK(values);
+    int numCells = values.dimension(0);
+    int numPoints = values.dimension(1);
+    FieldContainer<double> parametricPoints = basisCache->computeParametricPoints(); // (1,P,1), the same on each cell
+    FieldContainer<double> tValues(numPoints);
+    for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+    {
+      tValues(ptOrdinal) = parametricPoints(0,ptOrdinal,0);
+    }
+    int spaceDim = std::max(2, _component + 1); // bubbles are only defined in 2D
+    FieldContainer<double> points(numPoints,spaceDim);
+    FieldContainer<double> dPointsdt;
+    if (_isDerivative) dPointsdt.resize(numPoints,spaceDim);
+    _curve->valuesAtParameters(tValues, points, _isDerivative ? &dPointsdt : NULL);
+    
+    const FieldContainer<double>* jacobian = _isDerivative ? &basisCache->getJacobian() : NULL;
+    for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+    {
+      for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+      {
+        if (!_isDerivative)
+        {
+          values(cellOrdinal,ptOrdinal) = points(ptOrdinal,_component);
+        }
+        else
+        {
+          // basisCache maps [-1,1] to [x0,x1], while t runs over [0,1], so dt/dx = 1 / (2 J)
+          values(cellOrdinal,ptOrdinal) = dPointsdt(ptOrdinal,_component) / (2.0 * (*jacobian)(cellOrdinal,ptOrdinal,0,0));
+        }
+      }
+    }
+  }
+  TFunctionPtr<double> dx()
+  {
+    if (_isDerivative) return Teuchos::null; // second derivatives are not supported
+    return Teuchos::rcp( new ParametricCurveComponent(_curve, _component, true) );
+  }
+};
+
 void ParametricCurve::projectionBasedInterpolant(FieldContainer<double> &basisCoefficients, BasisPtr basis1D, int component,
     double lengthScale, bool useH1)
 {
@@ -373,22 +510,9 @@ void ParametricCurve::projectionBasedInterpolant(FieldContainer<double> &basisCo
     }
   }
   // project, skipping vertexNodeFieldIndices:
-  TFunctionPtr<double> bubbleComponent, lineComponent;
-  if (component==0)
-  {
-    bubbleComponent = bubble->x();
-    lineComponent = line->x();
-  }
-  else if (component==1)
-  {
-    bubbleComponent = bubble->y();
-    lineComponent = line->y();
-  }
-  else if (component==2)
-  {
-    bubbleComponent = bubble->z();
-    lineComponent = line->z();
-  }
+  TEUCHOS_TEST_FOR_EXCEPTION((component < 0) || (component > 2), std::invalid_argument, "component must be 0, 1, or 2");
+  TFunctionPtr<double> bubbleComponent = Teuchos::rcp( new ParametricCurveComponent(bubble, component) );
+  TFunctionPtr<double> lineComponent = Teuchos::rcp( new ParametricCurveComponent(line, component) );
   Projector<double>::projectFunctionOntoBasis(basisCoefficients, bubbleComponent, basis1D, basisCache, ip_H1, v, vertexNodeFieldIndices);
 
   // the line should live in the space spanned by basis.  It would be a bit cheaper to solve a system
@@ -490,6 +614,51 @@ void ParametricCurve::values(FieldContainer<double> &values, BasisCachePtr basis
   //  }
 }
 
+void ParametricCurve::valuesAtParameters(const FieldContainer<double> &tValues, FieldContainer<double> &points,
+                                         FieldContainer<double>* dPointsdt)
+{
+  int numPoints = tValues.size();
+  int spaceDim = points.dimension(1);
+  TEUCHOS_TEST_FOR_EXCEPTION(points.dimension(0) != numPoints, std::invalid_argument, "points must have dimensions (P,D)");
+  if (_xFxn.get())   // then this curve is defined by some Functions of t (not by overriding the value() methods)
+  {
+    vector<ParametricFunctionPtr> componentFxns = {_xFxn, _yFxn, _zFxn};
+    FieldContainer<double> componentValues;
+    for (int d=0; d<spaceDim; d++)
+    {
+      TEUCHOS_TEST_FOR_EXCEPTION(componentFxns[d].get() == NULL, std::invalid_argument, "curve does not define component " << d);
+      componentFxns[d]->valuesAtParameters(tValues, componentValues);
+      for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+      {
+        points(ptOrdinal,d) = componentValues(ptOrdinal);
+      }
+    }
+  }
+  else
+  {
+    for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+    {
+      double t = tValues[ptOrdinal];
+      if (spaceDim==1)
+        value(t, points(ptOrdinal,0));
+      else if (spaceDim==2)
+        value(t, points(ptOrdinal,0), points(ptOrdinal,1));
+      else if (spaceDim==3)
+        value(t, points(ptOrdinal,0), points(ptOrdinal,1), points(ptOrdinal,2));
+      else
+        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "unsupported spaceDim");
+    }
+  }
+  if (dPointsdt != NULL)
+  {
+    if (_dtCurve == Teuchos::null)
+    {
+      _dtCurve = this->dt_parametric();
+    }
+    _dtCurve->valuesAtParameters(tValues, *dPointsdt);
+  }
+}
+
 TFunctionPtr<double> ParametricCurve::x()
 {
   return _xFxn;
@@ -56,6 +56,10 @@ class TransfiniteInterpolatingSurface : public ParametricSurface
   bool _neglectVertices; // if true, then the value returned by value() is a "bubble" value...
   Camellia::EOperator _op;
 
+  // blends the values of the four (bubble) curves, (x0,y0) at t1 on curve 0, (x1,y1) at t2 on curve 1, etc., according to _op
+  void combineCurveValues(double t1, double t2, double x0, double y0, double x1, double y1,
+                          double x2, double y2, double x3, double y3, double &x, double &y);
+
   void init(const vector< ParametricCurvePtr > &curves, Camellia::EOperator op,
             const vector< pair<double, double> > &vertices)
   {
@@ -132,6 +136,7 @@ public:
     _neglectVertices = value;
   }
   void value(double t1, double t2, double &x, double &y);
+  void valuesAtParameters(const FieldContainer<double> &parametricPoints, FieldContainer<double> &points);
   const vector< pair<double,double> > &vertices()
   {
     return _vertices;
@@ -384,46 +389,7 @@ void TransfiniteInterpolatingSurface::value(double t1, double t2, double &x, dou
     _curves[1]->value(t2, x1,y1);
     _curves[3]->value(t2, x3,y3);
 
-    if (_op == OP_VALUE)
-    {
-      x = x0*(1-t2) + x1 * t1 + x2*t2 + x3*(1-t1);
-      y = y0*(1-t2) + y1 * t1 + y2*t2 + y3*(1-t1);
-    }
-    else if (_op == OP_DX)
-    {
-      x = x0*(1-t2) + x1 + x2*t2 - x3;
-      y = y0*(1-t2) + y1 + y2*t2 - y3;
-    }
-    else if (_op == OP_DY)
-    {
-      x = -x0 + x1 * t1 + x2 + x3*(1-t1);
-      y = -y0 + y1 * t1 + y2 + y3*(1-t1);
-    }
-
-    if (! _neglectVertices)
-    {
-      if (_op == OP_VALUE)
-      {
-        x += _vertices[0].first*(1-t1)*(1-t2) + _vertices[1].first*   t1 *(1-t2)
-             + _vertices[2].first*   t1*    t2  + _vertices[3].first*(1-t1)*   t2;
-        y += _vertices[0].second*(1-t1)*(1-t2) + _vertices[1].second*   t1 *(1-t2)
-             + _vertices[2].second*   t1*    t2  + _vertices[3].second*(1-t1)*   t2;
-      }
-      else if (_op == OP_DX)
-      {
-        x += -_vertices[0].first*(1-t2) + _vertices[1].first*(1-t2)
-             + _vertices[2].first *   t2  - _vertices[3].first*   t2;
-        y += -_vertices[0].second*(1-t2) + _vertices[1].second *(1-t2)
-             + _vertices[2].second*    t2  - _vertices[3].second *   t2;
-      }
-      else if (_op == OP_DY)
-      {
-        x += -_vertices[0].first*(1-t1) - _vertices[1].first*   t1
-             + _vertices[2].first*    t1  + _vertices[3].first*(1-t1);
-        y += -_vertices[0].second*(1-t1) - _vertices[1].second*   t1
-             + _vertices[2].second*    t1  + _vertices[3].second*(1-t1);
-      }
-    }
+    combineCurveValues(t1, t2, x0, y0, x1, y1, x2, y2, x3, y3, x, y);
   }
   else if (_curves.size() == 3)
   {
@@ -434,7 +400,79 @@ void TransfiniteInterpolatingSurface::value(double t1, double t2, double &x, dou
   {
     TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Only quads and (eventually) triangles supported...");
   }
+}
+
+void TransfiniteInterpolatingSurface::valuesAtParameters(const FieldContainer<double> &parametricPoints, FieldContainer<double> &points)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_curves.size() != 4, std::invalid_argument, "Only quads supported for now...");
+  int numPoints = parametricPoints.dimension(0);
+  FieldContainer<double> t1Values(numPoints), t2Values(numPoints);
+  for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+  {
+    t1Values(ptOrdinal) = parametricPoints(ptOrdinal,0);
+    t2Values(ptOrdinal) = parametricPoints(ptOrdinal,1);
+  }
+  // t1 indexes curves 0 and 2, t2 1 and 3
+  int spaceDim = 2;
+  FieldContainer<double> curve0Points(numPoints,spaceDim), curve1Points(numPoints,spaceDim);
+  FieldContainer<double> curve2Points(numPoints,spaceDim), curve3Points(numPoints,spaceDim);
+  _curves[0]->valuesAtParameters(t1Values, curve0Points);
+  _curves[2]->valuesAtParameters(t1Values, curve2Points);
+  _curves[1]->valuesAtParameters(t2Values, curve1Points);
+  _curves[3]->valuesAtParameters(t2Values, curve3Points);
+
+  for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+  {
+    combineCurveValues(t1Values(ptOrdinal), t2Values(ptOrdinal),
+                       curve0Points(ptOrdinal,0), curve0Points(ptOrdinal,1), curve1Points(ptOrdinal,0), curve1Points(ptOrdinal,1),
+                       curve2Points(ptOrdinal,0), curve2Points(ptOrdinal,1), curve3Points(ptOrdinal,0), curve3Points(ptOrdinal,1),
+                       points(ptOrdinal,0), points(ptOrdinal,1));
+  }
+}
+
+void TransfiniteInterpolatingSurface::combineCurveValues(double t1, double t2, double x0, double y0, double x1, double y1,
+                                                         double x2, double y2, double x3, double y3, double &x, double &y)
+{
+  if (_op == OP_VALUE)
+  {
+    x = x0*(1-t2) + x1 * t1 + x2*t2 + x3*(1-t1);
+    y = y0*(1-t2) + y1 * t1 + y2*t2 + y3*(1-t1);
+  }
+  else if (_op == OP_DX)
+  {
+    x = x0*(1-t2) + x1 + x2*t2 - x3;
+    y = y0*(1-t2) + y1 + y2*t2 - y3;
+  }
+  else if (_op == OP_DY)
+  {
+    x = -x0 + x1 * t1 + x2 + x3*(1-t1);
+    y = -y0 + y1 * t1 + y2 + y3*(1-t1);
+  }
 
+  if (! _neglectVertices)
+  {
+    if (_op == OP_VALUE)
+    {
+      x += _vertices[0].first*(1-t1)*(1-t2) + _vertices[1].first*   t1 *(1-t2)
+           + _vertices[2].first*   t1*    t2  + _vertices[3].first*(1-t1)*   t2;
+      y += _vertices[0].second*(1-t1)*(1-t2) + _vertices[1].second*   t1 *(1-t2)
+           + _vertices[2].second*   t1*    t2  + _vertices[3].second*(1-t1)*   t2;
+    }
+    else if (_op == OP_DX)
+    {
+      x += -_vertices[0].first*(1-t2) + _vertices[1].first*(1-t2)
+           + _vertices[2].first *   t2  - _vertices[3].first*   t2;
+      y += -_vertices[0].second*(1-t2) + _vertices[1].second *(1-t2)
+           + _vertices[2].second*    t2  - _vertices[3].second *   t2;
+    }
+    else if (_op == OP_DY)
+    {
+      x += -_vertices[0].first*(1-t1) - _vertices[1].first*   t1
+           + _vertices[2].first*    t1  + _vertices[3].first*(1-t1);
+      y += -_vertices[0].second*(1-t1) - _vertices[1].second*   t1
+           + _vertices[2].second*    t1  + _vertices[3].second*(1-t1);
+    }
+  }
 }
 
 FieldContainer<double> & ParametricSurface::parametricQuadNodes()   // for CellTools cellWorkset argument
@@ -464,18 +502,30 @@ void ParametricSurface::values(FieldContainer<double> &values, BasisCachePtr bas
   int numCells = parametricPoints.dimension(0);
   int numPoints = parametricPoints.dimension(1);
 
+  int spaceDim = 2;
+  FieldContainer<double> cellParametricPoints(numPoints,spaceDim), cellValues(numPoints,spaceDim);
   for (int cellIndex=0; cellIndex<numCells; cellIndex++)
   {
-    double x, y;
     for (int ptIndex=0; ptIndex<numPoints; ptIndex++)
     {
-      double t1, t2;
-      t1 = parametricPoints(cellIndex,ptIndex,0);
-      t2 = parametricPoints(cellIndex,ptIndex,1);
-      this->value(t1, t2, x, y);
-      values(cellIndex,ptIndex,0) = x;
-      values(cellIndex,ptIndex,1) = y;
+      cellParametricPoints(ptIndex,0) = parametricPoints(cellIndex,ptIndex,0);
+      cellParametricPoints(ptIndex,1) = parametricPoints(cellIndex,ptIndex,1);
     }
+    this->valuesAtParameters(cellParametricPoints, cellValues);
+    for (int ptIndex=0; ptIndex<numPoints; ptIndex++)
+    {
+      values(cellIndex,ptIndex,0) = cellValues(ptIndex,0);
+      values(cellIndex,ptIndex,1) = cellValues(ptIndex,1);
+    }
+  }
+}
+
+void ParametricSurface::valuesAtParameters(const FieldContainer<double> &parametricPoints, FieldContainer<double> &points)
+{
+  int numPoints = parametricPoints.dimension(0);
+  for (int ptIndex=0; ptIndex<numPoints; ptIndex++)
+  {
+    this->value(parametricPoints(ptIndex,0), parametricPoints(ptIndex,1), points(ptIndex,0), points(ptIndex,1));
   }
 }
 
@@ -31,6 +31,8 @@
 
 #include "MPIWrapper.h"
 
+#include <limits>
+
 namespace Camellia {
   
   void SerialDenseWrapper::transposeSquareMatrix(Intrepid::FieldContainer<double> &A)
@@ -1059,6 +1061,137 @@ namespace Camellia {
     return result;
   }
   
+  int SerialDenseWrapper::solveSPDSystemMixedPrecision(Intrepid::FieldContainer<double> &bx, Intrepid::FieldContainer<double> &A_SPD,
+                                                       double maxConditionNumber, int maxRefinements, bool* usedSinglePrecision)
+  {
+    int N = A_SPD.dimension(0);
+    TEUCHOS_TEST_FOR_EXCEPTION(N != A_SPD.dimension(1), std::invalid_argument, "A must be square!");
+    
+    if (usedSinglePrecision != NULL) *usedSinglePrecision = false;
+    if (N == 0) return 0;
+    
+    int M = bx.size() / N; // number of right-hand sides
+    TEUCHOS_TEST_FOR_EXCEPTION(M * N != bx.size(), std::invalid_argument, "bx must contain a whole number of right-hand sides");
+    
+    char UPLO = 'L'; // lower-triangular
+    
+    int result = 0;
+    int INFO;
+    
+    Teuchos::LAPACK<int, double> lapack;
+    Teuchos::BLAS<int, double> blas;
+    Teuchos::LAPACK<int, float> lapackSingle;
+    
+    // equilibrate, so that the single-precision factorization sees a unit diagonal
+    Intrepid::FieldContainer<double> scaleFactors(N);
+    double scond, amax;
+    lapack.POEQU(N, &A_SPD[0], N, &scaleFactors[0], &scond, &amax, &INFO);
+    if (INFO != 0) return INFO; // nonpositive diagonal entry
+    
+    double A_norm = 0; // 1-norm of the equilibrated A (max column sum)
+    Intrepid::FieldContainer<float> factor(N,N);
+    for (int i=0; i<N; i++)
+    {
+      double col_sum = 0;
+      for (int j=0; j<N; j++)
+      {
+        A_SPD(i,j) *= scaleFactors[i] * scaleFactors[j];
+        factor(i,j) = (float) A_SPD(i,j);
+        col_sum += abs(A_SPD(i,j));
+      }
+      A_norm = std::max(A_norm, col_sum);
+    }
+    for (int rhsOrdinal=0; rhsOrdinal<M; rhsOrdinal++)
+    {
+      for (int i=0; i<N; i++)
+      {
+        bx[rhsOrdinal*N+i] *= scaleFactors[i];
+      }
+    }
+    
+    lapackSingle.POTRF(UPLO, N, &factor[0], N, &INFO);
+    bool useSinglePrecision = (INFO == 0);
+    if (useSinglePrecision)
+    {
+      Intrepid::FieldContainer<float> WORK(3*N);
+      Intrepid::FieldContainer<int> IWORK(N);
+      float rcond;
+      lapackSingle.POCON(UPLO, N, &factor[0], N, (float) A_norm, &rcond, &WORK[0], &IWORK[0], &INFO);
+      useSinglePrecision = (INFO == 0) && (rcond * maxConditionNumber >= 1.0);
+    }
+    
+    if (useSinglePrecision)
+    {
+      Intrepid::FieldContainer<double> b = bx; // equilibrated right-hand sides
+      Intrepid::FieldContainer<double> residual(M*N);
+      Intrepid::FieldContainer<float> correction(M*N);
+      
+      for (int k=0; k<M*N; k++)
+      {
+        correction[k] = (float) b[k];
+      }
+      lapackSingle.POTRS(UPLO, N, M, &factor[0], N, &correction[0], N, &INFO);
+      for (int k=0; k<M*N; k++)
+      {
+        bx[k] = correction[k];
+      }
+      
+      // stopping criterion as in LAPACK's DSPOSV: ||r|| <= sqrt(N) * eps * ||A|| * ||x||, in max norm for each right-hand side
+      double tol = sqrt((double) N) * std::numeric_limits<double>::epsilon() * A_norm;
+      bool converged = false;
+      for (int refinement=0; refinement <= maxRefinements; refinement++)
+      {
+        residual = b;
+        blas.GEMM(Teuchos::NO_TRANS, Teuchos::NO_TRANS, N, M, N, -1.0, &A_SPD[0], N, &bx[0], N, 1.0, &residual[0], N);
+        
+        converged = true;
+        for (int rhsOrdinal=0; rhsOrdinal<M; rhsOrdinal++)
+        {
+          double residualNorm = 0, xNorm = 0;
+          for (int i=0; i<N; i++)
+          {
+            residualNorm = std::max(residualNorm, abs(residual[rhsOrdinal*N+i]));
+            xNorm = std::max(xNorm, abs(bx[rhsOrdinal*N+i]));
+          }
+          if (residualNorm > tol * xNorm) converged = false;
+        }
+        if (converged || (refinement == maxRefinements)) break;
+        
+        for (int k=0; k<M*N; k++)
+        {
+          correction[k] = (float) residual[k];
+        }
+        lapackSingle.POTRS(UPLO, N, M, &factor[0], N, &correction[0], N, &INFO);
+        for (int k=0; k<M*N; k++)
+        {
+          bx[k] += correction[k];
+        }
+      }
+      useSinglePrecision = converged;
+      if (!useSinglePrecision) bx = b; // start over in double precision
+    }
+    
+    if (!useSinglePrecision)
+    {
+      lapack.POTRF(UPLO, N, &A_SPD[0], N, &INFO);
+      if (INFO != 0) result = INFO;
+      lapack.POTRS(UPLO, N, M, &A_SPD[0], N, &bx[0], N, &INFO);
+      if (INFO != 0) result = INFO;
+    }
+    
+    // undo the equilibration: x = S y, where (S A S) y = S b
+    for (int rhsOrdinal=0; rhsOrdinal<M; rhsOrdinal++)
+    {
+      for (int i=0; i<N; i++)
+      {
+        bx[rhsOrdinal*N+i] *= scaleFactors[i];
+      }
+    }
+    
+    if (usedSinglePrecision != NULL) *usedSinglePrecision = useSinglePrecision;
+    return result;
+  }
+  
   int SerialDenseWrapper::solveSPDSystemMultipleRHS(Intrepid::FieldContainer<double> &x, Intrepid::FieldContainer<double> &A_SPD,
                                                     Intrepid::FieldContainer<double> &b, bool allowOverwriteOfA)
   {
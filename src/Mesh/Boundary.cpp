@@ -39,6 +39,8 @@ void Boundary::setMesh(MeshPtr mesh)
 void Boundary::buildLookupTables()
 {
   _boundaryElements.clear();
+  _boundarySideGroups.clear();
+  _cachedDirichletCoefficients.clear();
 
   const set<GlobalIndexType>* rankLocalCells = &_mesh->cellIDsInPartition();
   for (GlobalIndexType cellID : *rankLocalCells)
@@ -50,6 +52,115 @@ void Boundary::buildLookupTables()
       _boundaryElements.insert(make_pair(cellID, boundarySides[i]));
     }
   }
+  
+  map<pair<ElementType*,unsigned>,int> groupOrdinals;
+  for (pair<GlobalIndexType,unsigned> boundaryElement : _boundaryElements)
+  {
+    GlobalIndexType cellID = boundaryElement.first;
+    unsigned sideOrdinal = boundaryElement.second;
+    ElementTypePtr elemType = _mesh->getElementType(cellID);
+    pair<ElementType*,unsigned> groupKey = {elemType.get(),sideOrdinal};
+    if (groupOrdinals.find(groupKey) == groupOrdinals.end())
+    {
+      groupOrdinals[groupKey] = _boundarySideGroups.size();
+      BoundarySideGroup group;
+      group.elemType = elemType;
+      group.sideOrdinal = sideOrdinal;
+      _boundarySideGroups.push_back(group);
+    }
+    _boundarySideGroups[groupOrdinals[groupKey]].cellIDs.push_back(cellID);
+  }
+  
+  int spaceDim = _mesh->getDimension();
+  for (BoundarySideGroup &group : _boundarySideGroups)
+  {
+    int numCells = group.cellIDs.size();
+    int numVertices = group.elemType->cellTopoPtr->getVertexCount();
+    group.physicalCellNodes.resize(numCells, numVertices, spaceDim);
+    for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+    {
+      FieldContainer<double> cellNodes = _mesh->physicalCellNodesForCell(group.cellIDs[cellOrdinal]);
+      for (int vertexOrdinal=0; vertexOrdinal<numVertices; vertexOrdinal++)
+      {
+        for (int d=0; d<spaceDim; d++)
+        {
+          group.physicalCellNodes(cellOrdinal,vertexOrdinal,d) = cellNodes(0,vertexOrdinal,d);
+        }
+      }
+    }
+  }
+}
+
+template <typename Scalar>
+vector<Boundary::SideGroupCoefficients> Boundary::dirichletCoefficients(TBC<Scalar> &bc, int trialID)
+{
+  BCPtr bcPtr = Teuchos::rcp(&bc, false);
+  Teuchos::RCP<BCFunction<double>> bcFunction = BCFunction<double>::bcFunction(bcPtr, trialID);
+  
+  vector<SideGroupCoefficients> groupCoefficients(_boundarySideGroups.size());
+  for (int groupOrdinal=0; groupOrdinal<_boundarySideGroups.size(); groupOrdinal++)
+  {
+    BoundarySideGroup* group = &_boundarySideGroups[groupOrdinal];
+    DofOrderingPtr trialOrderingPtr = group->elemType->trialOrderPtr;
+    unsigned sideOrdinal = group->sideOrdinal;
+    
+    BasisPtr basis;
+    int numDofsSide;
+    if (trialOrderingPtr->getSidesForVarID(trialID).size() == 1)
+    {
+      // volume basis
+      basis = trialOrderingPtr->getBasis(trialID);
+      // get the dof ordinals for the side (interpreted as a "continuous" basis)
+      numDofsSide = basis->dofOrdinalsForSide(sideOrdinal).size();
+    }
+    else if (! trialOrderingPtr->hasBasisEntry(trialID, sideOrdinal))
+    {
+      continue;
+    }
+    else
+    {
+      basis = trialOrderingPtr->getBasis(trialID,sideOrdinal);
+      numDofsSide = basis->getCardinality();
+    }
+    
+    int numCells = group->cellIDs.size();
+    FieldContainer<double>* dirichletValues = &groupCoefficients[groupOrdinal].coefficients;
+    dirichletValues->resize(numCells,numDofsSide);
+    vector<bool>* imposeOnCell = &groupCoefficients[groupOrdinal].imposeOnCell;
+    imposeOnCell->resize(numCells);
+    
+    if (group->elemType->cellTopoPtr->getTensorialDegree() == 0)
+    {
+      // one BasisCache for all the group's cells; only the side cache we use gets built
+      BasisCachePtr basisCache = Teuchos::rcp( new BasisCache(group->elemType, _mesh) );
+      bool createSideCache = true;
+      basisCache->setPhysicalCellNodes(group->physicalCellNodes, group->cellIDs, createSideCache);
+      
+      // project bc function onto side basis:
+      bcPtr->coefficientsForBC(*dirichletValues, bcFunction, basis, basisCache->getSideBasisCache(sideOrdinal));
+      for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+      {
+        (*imposeOnCell)[cellOrdinal] = bcFunction->imposeOnCell(cellOrdinal);
+      }
+    }
+    else
+    {
+      // basisCacheForCell() gives space-time cells a SpaceTimeBasisCache, which a BasisCache for the group would not reproduce,
+      // so we project one cell at a time, as bcsToImpose(..., cellID, ...) does
+      FieldContainer<double> cellDirichletValues(1,numDofsSide);
+      for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+      {
+        BasisCachePtr basisCache = BasisCache::basisCacheForCell(_mesh, group->cellIDs[cellOrdinal]);
+        bcPtr->coefficientsForBC(cellDirichletValues, bcFunction, basis, basisCache->getSideBasisCache(sideOrdinal));
+        for (int dofOrdinal=0; dofOrdinal<numDofsSide; dofOrdinal++)
+        {
+          (*dirichletValues)(cellOrdinal,dofOrdinal) = cellDirichletValues(0,dofOrdinal);
+        }
+        (*imposeOnCell)[cellOrdinal] = bcFunction->imposeOnCell(0);
+      }
+    }
+  }
+  return groupCoefficients;
 }
 
 template <typename Scalar>
@@ -60,9 +171,64 @@ void Boundary::bcsToImpose(FieldContainer<GlobalIndexType> &globalIndices,
   set< GlobalIndexType > rankLocalCells = _mesh->cellIDsInPartition();
   vector<pair<GlobalIndexType, double>> bcGlobalIndicesAndValues;
 
-  for (GlobalIndexType cellID : rankLocalCells)
+  // Determine global dof indices and values, in one projection per group of like boundary sides
+  vector< int > trialIDs = _mesh->bilinearForm()->trialIDs();
+  for (int trialID : trialIDs)
   {
-    bcsToImpose(bcGlobalIndicesAndValues, bc, cellID, dofInterpreter);
+    if (! bc.bcsImposed(trialID) ) continue;
+    
+    vector<SideGroupCoefficients> uncachedCoefficients;
+    vector<SideGroupCoefficients>* groupCoefficients = &uncachedCoefficients;
+    if (bc.cacheImposedValues() && !bc.isLegacySubclass())
+    {
+      pair< SpatialFilterPtr, TFunctionPtr<Scalar> > dirichletBC = bc.getDirichletBC(trialID);
+      auto cacheEntry = _cachedDirichletCoefficients.find(trialID);
+      bool upToDate = (cacheEntry != _cachedDirichletCoefficients.end()) && (cacheEntry->second.bc == &bc)
+                   && (cacheEntry->second.spatialFilter == dirichletBC.first) && (cacheEntry->second.function == dirichletBC.second)
+                   && (cacheEntry->second.time == bc.getTime());
+      if (!upToDate)
+      {
+        CachedDirichletCoefficients entry;
+        entry.bc = &bc;
+        entry.spatialFilter = dirichletBC.first;
+        entry.function = dirichletBC.second;
+        entry.time = bc.getTime();
+        entry.sideGroupCoefficients = dirichletCoefficients(bc, trialID);
+        _cachedDirichletCoefficients[trialID] = entry;
+      }
+      groupCoefficients = &_cachedDirichletCoefficients[trialID].sideGroupCoefficients;
+    }
+    else
+    {
+      uncachedCoefficients = dirichletCoefficients(bc, trialID);
+    }
+    
+    for (int groupOrdinal=0; groupOrdinal<_boundarySideGroups.size(); groupOrdinal++)
+    {
+      const SideGroupCoefficients* coefficients = &(*groupCoefficients)[groupOrdinal];
+      if (coefficients->coefficients.size() == 0) continue; // no basis for trialID on this side
+      
+      const BoundarySideGroup* group = &_boundarySideGroups[groupOrdinal];
+      int numDofsSide = coefficients->coefficients.dimension(1);
+      FieldContainer<double> dirichletValues(numDofsSide);
+      for (int cellOrdinal=0; cellOrdinal<group->cellIDs.size(); cellOrdinal++)
+      {
+        if (!coefficients->imposeOnCell[cellOrdinal]) continue;
+        
+        for (int dofOrdinal=0; dofOrdinal<numDofsSide; dofOrdinal++)
+        {
+          dirichletValues(dofOrdinal) = coefficients->coefficients(cellOrdinal,dofOrdinal);
+        }
+        FieldContainer<double> globalData;
+        FieldContainer<GlobalIndexType> globalDofIndices;
+        dofInterpreter->interpretLocalBasisCoefficients(group->cellIDs[cellOrdinal], trialID, group->sideOrdinal, dirichletValues,
+                                                        globalData, globalDofIndices);
+        for (int globalDofOrdinal=0; globalDofOrdinal<globalDofIndices.size(); globalDofOrdinal++)
+        {
+          bcGlobalIndicesAndValues.push_back({globalDofIndices(globalDofOrdinal),globalData(globalDofOrdinal)});
+        }
+      }
+    }
   }
   singletonBCsToImpose(bcGlobalIndicesAndValues, bc, dofInterpreter);
   
@@ -0,0 +1,198 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  CellHalo.cpp
+//  Camellia
+//
+
+#include "CellHalo.h"
+
+#include "Mesh.h"
+#include "MPIWrapper.h"
+
+using namespace Camellia;
+using namespace Intrepid;
+using namespace std;
+
+CellHalo::CellHalo(Mesh &mesh)
+{
+  const set<GlobalIndexType>* myCells = &mesh.cellIDsInPartition();
+  MeshTopologyViewPtr meshTopo = mesh.getTopology();
+
+  _cellIDs.insert(_cellIDs.end(), myCells->begin(), myCells->end());
+  _ownedCellCount = _cellIDs.size();
+  for (int cellOrdinal=0; cellOrdinal<_ownedCellCount; cellOrdinal++)
+  {
+    _ordinalForCell[_cellIDs[cellOrdinal]] = cellOrdinal;
+  }
+
+  // ghosts are ordered by owner, so that the requests for each owner are contiguous
+  vector<vector<GlobalIndexType>> neighborIDs(_ownedCellCount);
+  set<pair<int,GlobalIndexType>> ghostOwnersAndIDs;
+  for (int cellOrdinal=0; cellOrdinal<_ownedCellCount; cellOrdinal++)
+  {
+    CellPtr cell = meshTopo->getCell(_cellIDs[cellOrdinal]);
+    set<GlobalIndexType> cellNeighborIDs = cell->getActiveNeighborIndices(meshTopo);
+    neighborIDs[cellOrdinal].insert(neighborIDs[cellOrdinal].end(), cellNeighborIDs.begin(), cellNeighborIDs.end());
+    for (GlobalIndexType neighborID : cellNeighborIDs)
+    {
+      if (myCells->find(neighborID) == myCells->end())
+      {
+        ghostOwnersAndIDs.insert({mesh.partitionForCellID(neighborID),neighborID});
+      }
+    }
+  }
+  for (auto &ghostOwnerAndID : ghostOwnersAndIDs)
+  {
+    _ordinalForCell[ghostOwnerAndID.second] = _cellIDs.size();
+    _cellIDs.push_back(ghostOwnerAndID.second);
+  }
+
+  _neighborOrdinals.resize(_ownedCellCount);
+  for (int cellOrdinal=0; cellOrdinal<_ownedCellCount; cellOrdinal++)
+  {
+    for (GlobalIndexType neighborID : neighborIDs[cellOrdinal])
+    {
+      _neighborOrdinals[cellOrdinal].push_back(_ordinalForCell[neighborID]);
+    }
+  }
+
+  Epetra_CommPtr Comm = mesh.Comm();
+  if (Comm->NumProc() == 1) return; // no ghosts
+
+  // ask each owner for the ghost cells we need
+  int myRank = Comm->MyPID();
+  map<int,vector<pair<int,GlobalIndexType>>> requests; // owning PID -> (myPID, cell we want)
+  for (auto &ghostOwnerAndID : ghostOwnersAndIDs)
+  {
+    requests[ghostOwnerAndID.first].push_back({myRank,ghostOwnerAndID.second});
+  }
+  vector<pair<int,GlobalIndexType>> requestsReceived;
+  MPIWrapper::sendDataVectors(Comm, requests, requestsReceived);
+
+  map<int,vector<GlobalIndexType>> cellsForRequester;
+  for (auto &request : requestsReceived)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(!mesh.myCellsInclude(request.second), std::invalid_argument, "request received for non-owned cellID");
+    cellsForRequester[request.first].push_back(request.second);
+  }
+  vector<int> exportPIDs;
+  vector<GlobalIndexType> exportCellIDs;
+  for (auto &requesterCells : cellsForRequester)
+  {
+    for (GlobalIndexType cellID : requesterCells.second)
+    {
+      exportPIDs.push_back(requesterCells.first);
+      exportCellIDs.push_back(cellID);
+      _sendOrdinals.push_back(_ordinalForCell[cellID]);
+    }
+  }
+
+  _distributor = MPIWrapper::getDistributor(*Comm);
+  int numSends = exportPIDs.size();
+  int numReceives;
+  int* exportPIDsPtr = (numSends > 0) ? &exportPIDs[0] : NULL;
+  bool deterministic = true;
+  int err = _distributor->CreateFromSends(numSends, exportPIDsPtr, deterministic, numReceives);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::CreateFromSends() returned error " << err);
+  TEUCHOS_TEST_FOR_EXCEPTION(numReceives != ghostCellCount(), std::invalid_argument, "ghost count does not match number of cells owners will send");
+
+  // send the cell IDs once, to learn the order in which each exchange's ghost rows will arrive
+  char* exportPtr = (numSends > 0) ? (char *) &exportCellIDs[0] : NULL;
+  err = _distributor->Do(exportPtr, sizeof(GlobalIndexType), _importBufferLength, _importBuffer);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::Do() returned error " << err);
+  const GlobalIndexType* receivedCellIDs = (const GlobalIndexType*) _importBuffer;
+  for (int i=0; i<numReceives; i++)
+  {
+    _receiveOrdinals.push_back(_ordinalForCell[receivedCellIDs[i]]);
+  }
+}
+
+CellHalo::~CellHalo()
+{
+  if (_importBuffer != NULL) delete [] _importBuffer;
+}
+
+int CellHalo::ownedCellCount() const
+{
+  return _ownedCellCount;
+}
+
+int CellHalo::ghostCellCount() const
+{
+  return _cellIDs.size() - _ownedCellCount;
+}
+
+int CellHalo::cellCount() const
+{
+  return _cellIDs.size();
+}
+
+const vector<GlobalIndexType> & CellHalo::cellIDs() const
+{
+  return _cellIDs;
+}
+
+int CellHalo::ordinalForCell(GlobalIndexType cellID) const
+{
+  auto entry = _ordinalForCell.find(cellID);
+  if (entry == _ordinalForCell.end()) return -1;
+  return entry->second;
+}
+
+const vector<int> & CellHalo::neighborOrdinals(int ownedOrdinal) const
+{
+  return _neighborOrdinals[ownedOrdinal];
+}
+
+void CellHalo::beginExchange(const FieldContainer<double> &values)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_exchangeInFlight, std::invalid_argument, "beginExchange() called while another exchange is in flight");
+  TEUCHOS_TEST_FOR_EXCEPTION(values.rank() != 2, std::invalid_argument, "values must have shape (cellCount(), width)");
+  TEUCHOS_TEST_FOR_EXCEPTION(values.dimension(0) != cellCount(), std::invalid_argument, "values must have shape (cellCount(), width)");
+  _exchangeInFlight = true;
+  _width = values.dimension(1);
+  if (_distributor == Teuchos::null) return;
+
+  int numSends = _sendOrdinals.size();
+  _exportBuffer.resize(numSends * _width);
+  for (int i=0; i<numSends; i++)
+  {
+    for (int j=0; j<_width; j++)
+    {
+      _exportBuffer[i * _width + j] = values(_sendOrdinals[i],j);
+    }
+  }
+  char* exportPtr = (numSends * _width > 0) ? (char *) &_exportBuffer[0] : NULL;
+  int err = _distributor->DoPosts(exportPtr, _width * sizeof(double), _importBufferLength, _importBuffer);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::DoPosts() returned error " << err);
+}
+
+void CellHalo::endExchange(FieldContainer<double> &values)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(!_exchangeInFlight, std::invalid_argument, "endExchange() called without a matching beginExchange()");
+  _exchangeInFlight = false;
+  if (_distributor == Teuchos::null) return;
+
+  int err = _distributor->DoWaits();
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::DoWaits() returned error " << err);
+
+  const double* received = (const double*) _importBuffer;
+  int numReceives = _receiveOrdinals.size();
+  for (int i=0; i<numReceives; i++)
+  {
+    for (int j=0; j<_width; j++)
+    {
+      values(_receiveOrdinals[i],j) = received[i * _width + j];
+    }
+  }
+}
+
+void CellHalo::exchange(FieldContainer<double> &values)
+{
+  beginExchange(values);
+  endExchange(values);
+}
@@ -21,10 +21,17 @@
 #include "Epetra_Distributor.h"
 #include "Teuchos_GlobalMPISession.hpp"
 
+#include <algorithm>
+
 using namespace Intrepid;
 using namespace Camellia;
 using namespace std;
 
+map<string, long long> DofInterpreter::approximateMemoryCosts() const
+{
+  return map<string, long long>();
+}
+
 set<GlobalIndexType> DofInterpreter::getGlobalDofIndices(GlobalIndexType cellID, int varID, int sideOrdinal)
 {
   CellTopoPtr topo = _mesh->getElementType(cellID)->cellTopoPtr;
@@ -161,10 +168,90 @@ void DofInterpreter::interpretLocalData(GlobalIndexType cellID, const FieldConta
   }
 }
 
+bool DofInterpreter::globalDofRangeForPartition(PartitionIndexType rank, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount)
+{
+  return false;
+}
+
+GlobalIndexType DofInterpreter::globalDofCountForPartition(PartitionIndexType rank)
+{
+  GlobalIndexType firstDofIndex, dofCount;
+  if (this->globalDofRangeForPartition(rank, firstDofIndex, dofCount)) return dofCount;
+  return this->globalDofIndicesForPartition(rank).size();
+}
+
+void DofInterpreter::sortedGlobalDofIndicesForPartition(PartitionIndexType rank, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  GlobalIndexType firstDofIndex, dofCount;
+  if (this->globalDofRangeForPartition(rank, firstDofIndex, dofCount))
+  {
+    sortedGlobalDofIndices.resize(dofCount);
+    for (GlobalIndexType i=0; i<dofCount; i++)
+    {
+      sortedGlobalDofIndices[i] = firstDofIndex + i;
+    }
+  }
+  else
+  {
+    set<GlobalIndexType> globalDofIndices = this->globalDofIndicesForPartition(rank);
+    sortedGlobalDofIndices.assign(globalDofIndices.begin(), globalDofIndices.end());
+  }
+}
+
+void DofInterpreter::sortedGlobalDofIndicesForCell(GlobalIndexType cellID, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  set<GlobalIndexType> globalDofIndices = this->globalDofIndicesForCell(cellID);
+  sortedGlobalDofIndices.assign(globalDofIndices.begin(), globalDofIndices.end());
+}
+
+vector<vector<GlobalIndexType>> DofInterpreter::cellColorsForAssembly(const vector<GlobalIndexType> &cellIDs)
+{
+  vector<vector<GlobalIndexType>> cellsForColor;
+  vector<set<GlobalIndexType>> dofsForColor; // union of the global dofs touched by the cells in each color
+  
+  for (GlobalIndexType cellID : cellIDs)
+  {
+    // globalDofIndicesForCell() includes any constraining dofs (hanging nodes), so conflicts through constraints are detected as well
+    set<GlobalIndexType> cellDofs = this->globalDofIndicesForCell(cellID);
+    
+    int colorOrdinal;
+    for (colorOrdinal=0; colorOrdinal < cellsForColor.size(); colorOrdinal++)
+    {
+      const set<GlobalIndexType>* colorDofs = &dofsForColor[colorOrdinal];
+      bool conflicts = false;
+      for (GlobalIndexType dofIndex : cellDofs)
+      {
+        if (colorDofs->find(dofIndex) != colorDofs->end())
+        {
+          conflicts = true;
+          break;
+        }
+      }
+      if (!conflicts) break;
+    }
+    if (colorOrdinal == cellsForColor.size())
+    {
+      cellsForColor.push_back(vector<GlobalIndexType>());
+      dofsForColor.push_back(set<GlobalIndexType>());
+    }
+    cellsForColor[colorOrdinal].push_back(cellID);
+    dofsForColor[colorOrdinal].insert(cellDofs.begin(), cellDofs.end());
+  }
+  return cellsForColor;
+}
+
 std::set<GlobalIndexType> DofInterpreter::importGlobalIndicesForCells(const std::vector<GlobalIndexType> &cellIDs)
 {
-  set<GlobalIndexType> dofIndicesSet;
+  vector<GlobalIndexType> sortedGlobalIndices;
+  this->importSortedGlobalIndicesForCells(cellIDs, sortedGlobalIndices);
+  return set<GlobalIndexType>(sortedGlobalIndices.begin(), sortedGlobalIndices.end());
+}
+
+void DofInterpreter::importSortedGlobalIndicesForCells(const std::vector<GlobalIndexType> &cellIDs, std::vector<GlobalIndexType> &sortedGlobalIndices)
+{
+  sortedGlobalIndices.clear();
   int rank = _mesh->Comm()->MyPID();
+  vector<GlobalIndexType> indicesForCell;
 
   // myRequestOwners should be in nondecreasing order (it appears)
   // this is accomplished by requestMap
@@ -175,8 +262,8 @@ std::set<GlobalIndexType> DofInterpreter::importGlobalIndicesForCells(const std:
     int partitionForCell = _mesh->globalDofAssignment()->partitionForCellID(cellID);
     if (partitionForCell == rank)
     {
-      set<GlobalIndexType> dofIndicesForCell = this->globalDofIndicesForCell(cellID);
-      dofIndicesSet.insert(dofIndicesForCell.begin(),dofIndicesForCell.end());
+      this->sortedGlobalDofIndicesForCell(cellID, indicesForCell);
+      sortedGlobalIndices.insert(sortedGlobalIndices.end(), indicesForCell.begin(), indicesForCell.end());
     }
     else
     {
@@ -229,7 +316,7 @@ std::set<GlobalIndexType> DofInterpreter::importGlobalIndicesForCells(const std:
       TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "requested cellID does not belong to this rank!");
     }
 
-    set<GlobalIndexType> indicesForCell = this->globalDofIndicesForCell(cellID);
+    this->sortedGlobalDofIndicesForCell(cellID, indicesForCell);
     indicesToExport.insert(indicesToExport.end(), indicesForCell.begin(), indicesForCell.end());
     sizes[cellOrdinal] = indicesForCell.size();
   }
@@ -249,12 +336,9 @@ std::set<GlobalIndexType> DofInterpreter::importGlobalIndicesForCells(const std:
   const char* copyFromLocation = globalIndexData;
   int numDofsImport = importLength / objSize;
   vector<GlobalIndexTypeToCast> globalIndicesVector(numDofsImport);
-  GlobalIndexTypeToCast* copyToLocation = &globalIndicesVector[0];
-  for (int dofOrdinal=0; dofOrdinal<numDofsImport; dofOrdinal++)
+  if (numDofsImport > 0)
   {
-    memcpy(copyToLocation, copyFromLocation, objSize);
-    copyFromLocation += objSize;
-    copyToLocation++; // copyToLocation has type GlobalIndexTypeToCast*, so this moves the pointer by objSize bytes
+    memcpy(&globalIndicesVector[0], copyFromLocation, objSize * numDofsImport);
   }
 
 //  { // DEBUGGING
@@ -277,9 +361,9 @@ std::set<GlobalIndexType> DofInterpreter::importGlobalIndicesForCells(const std:
   if( exportRecipients != 0 ) delete [] exportRecipients;
   if (globalIndexData != 0 ) delete [] globalIndexData;
 
-  dofIndicesSet.insert(globalIndicesVector.begin(),globalIndicesVector.end());
-
-  return dofIndicesSet;
+  sortedGlobalIndices.insert(sortedGlobalIndices.end(), globalIndicesVector.begin(), globalIndicesVector.end());
+  std::sort(sortedGlobalIndices.begin(), sortedGlobalIndices.end());
+  sortedGlobalIndices.erase(std::unique(sortedGlobalIndices.begin(), sortedGlobalIndices.end()), sortedGlobalIndices.end());
 }
 
 map<GlobalIndexType,set<GlobalIndexType>> DofInterpreter::importGlobalIndicesMap(const set<GlobalIndexType> &cellIDs)
@@ -922,6 +922,17 @@ set<GlobalIndexType> GDAMaximumRule2D::globalDofIndicesForPartition(PartitionInd
   return _partitionedGlobalDofIndices[partitionNumber];
 }
 
+GlobalIndexType GDAMaximumRule2D::globalDofCountForPartition(PartitionIndexType partitionNumber)
+{
+  return _partitionedGlobalDofIndices[partitionNumber].size();
+}
+
+void GDAMaximumRule2D::sortedGlobalDofIndicesForPartition(PartitionIndexType partitionNumber, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  const set<GlobalIndexType>* globalDofIndices = &_partitionedGlobalDofIndices[partitionNumber];
+  sortedGlobalDofIndices.assign(globalDofIndices->begin(), globalDofIndices->end());
+}
+
 bool GDAMaximumRule2D::isLocallyOwnedGlobalDofIndex(GlobalIndexType globalDofIndex) const
 {
   int myRank = _mesh->Comm()->MyPID();
@@ -1518,6 +1529,7 @@ FieldContainer<double> & GDAMaximumRule2D::physicalCellNodesGlobal( ElementTypeP
 void GDAMaximumRule2D::rebuildLookups()
 {
 //  cout << "GDAMaximumRule2D::rebuildLookups().\n";
+  _dofNumberingVersion++;
   _cellSideUpgrades.clear();
   buildTypeLookups(); // build data structures for efficient lookup by element type
   buildLocalToGlobalMap();
@@ -14,12 +14,15 @@
 #include "BasisFactory.h"
 #include "CamelliaCellTools.h"
 #include "CamelliaDebugUtility.h"
+#include "CamelliaMemoryUtility.h"
 #include "MeshTestUtility.h"
 #include "MPIWrapper.h"
 #include "SerialDenseWrapper.h"
 #include "Solution.h"
 #include "TimeLogger.h"
 
+#include <algorithm>
+
 using namespace std;
 using namespace Camellia;
 
@@ -47,9 +50,40 @@ void printDofIndexInfo(GlobalIndexType cellID, SubcellDofIndices &subcellDofIndi
   subcellDofIndices.print(cout);
 }
 
+// in bytes; includes spatialSliceConstraints, if present
+static long long approximateCellConstraintsSize(const CellConstraints &constraints)
+{
+  long long memSize = sizeof(constraints);
+  for (auto &subcellConstraints : constraints.subcellConstraints)
+  {
+    memSize += approximateVectorSizeLLVM(subcellConstraints);
+  }
+  for (auto &owningCellIDs : constraints.owningCellIDForSubcell)
+  {
+    memSize += approximateVectorSizeLLVM(owningCellIDs);
+  }
+  if (constraints.spatialSliceConstraints != Teuchos::null)
+  {
+    memSize += approximateCellConstraintsSize(*constraints.spatialSliceConstraints);
+  }
+  return memSize;
+}
+
+// costs for LRU cache entries, in bytes
+static long long dofMapperCacheEntryCost(const pair< GlobalIndexType, pair<int, int> > &key, const LocalDofMapperPtr &dofMapper)
+{
+  return sizeof(key) + sizeof(dofMapper) + dofMapper->approximateMemoryFootprint();
+}
+
+static long long fittableGlobalIndicesCacheEntryCost(const pair<GlobalIndexType,pair<int,unsigned>> &key, const set<GlobalIndexType> &globalIndices)
+{
+  return sizeof(key) + approximateSetSizeLLVM(globalIndices);
+}
+
 GDAMinimumRule::GDAMinimumRule(MeshPtr mesh, VarFactoryPtr varFactory, DofOrderingFactoryPtr dofOrderingFactory, MeshPartitionPolicyPtr partitionPolicy,
                                unsigned initialH1OrderTrial, unsigned testOrderEnhancement)
-  : GlobalDofAssignment(mesh,varFactory,dofOrderingFactory,partitionPolicy, vector<int>(1,initialH1OrderTrial), testOrderEnhancement, false)
+  : GlobalDofAssignment(mesh,varFactory,dofOrderingFactory,partitionPolicy, vector<int>(1,initialH1OrderTrial), testOrderEnhancement, false),
+    _dofMapperForVariableOnSideCache(dofMapperCacheEntryCost), _fittableGlobalIndicesCache(fittableGlobalIndicesCacheEntryCost)
 {
   _hasSpaceOnlyTrialVariable = varFactory->hasSpaceOnlyTrialVariable();
   TimeLogger::sharedInstance()->createTimeEntry("read SubcellDofIndices");
@@ -58,7 +92,8 @@ GDAMinimumRule::GDAMinimumRule(MeshPtr mesh, VarFactoryPtr varFactory, DofOrderi
 
 GDAMinimumRule::GDAMinimumRule(MeshPtr mesh, VarFactoryPtr varFactory, DofOrderingFactoryPtr dofOrderingFactory, MeshPartitionPolicyPtr partitionPolicy,
                                vector<int> initialH1OrderTrial, unsigned testOrderEnhancement)
-  : GlobalDofAssignment(mesh,varFactory,dofOrderingFactory,partitionPolicy, initialH1OrderTrial, testOrderEnhancement, false)
+  : GlobalDofAssignment(mesh,varFactory,dofOrderingFactory,partitionPolicy, initialH1OrderTrial, testOrderEnhancement, false),
+    _dofMapperForVariableOnSideCache(dofMapperCacheEntryCost), _fittableGlobalIndicesCache(fittableGlobalIndicesCacheEntryCost)
 {
   _hasSpaceOnlyTrialVariable = varFactory->hasSpaceOnlyTrialVariable();
   TimeLogger::sharedInstance()->createTimeEntry("read SubcellDofIndices");
@@ -139,6 +174,71 @@ void GDAMinimumRule::setCheckConstraintConsistency(bool value)
   _checkConstraintConsistency = value;
 }
 
+void GDAMinimumRule::setDofMapperForVariableOnSideCacheMemoryBudget(long long bytes)
+{
+  _dofMapperForVariableOnSideCache.setMemoryBudget(bytes);
+}
+
+void GDAMinimumRule::setFittableGlobalIndicesCacheMemoryBudget(long long bytes)
+{
+  _fittableGlobalIndicesCache.setMemoryBudget(bytes);
+}
+
+LRUCacheStatistics GDAMinimumRule::dofMapperForVariableOnSideCacheStatistics() const
+{
+  return _dofMapperForVariableOnSideCache.statistics();
+}
+
+LRUCacheStatistics GDAMinimumRule::fittableGlobalIndicesCacheStatistics() const
+{
+  return _fittableGlobalIndicesCache.statistics();
+}
+
+map<string, long long> GDAMinimumRule::approximateMemoryCosts() const
+{
+  map<string, long long> variableCost = this->GlobalDofAssignment::approximateMemoryCosts();
+  
+  addMemoryCosts(variableCost, "_br.", _br.approximateMemoryCosts());
+  
+  variableCost["_cellDofOffsets"] = approximateMapSizeLLVM(_cellDofOffsets);
+  variableCost["_globalCellDofOffsets"] = approximateMapSizeLLVM(_globalCellDofOffsets);
+  variableCost["_partitionDofOffsets"] = approximateVectorSizeLLVM(_partitionDofOffsets);
+  
+  variableCost["_constraintsCache"] = approximateMapSizeLLVM(_constraintsCache);
+  for (auto &entry : _constraintsCache)
+  {
+    variableCost["_constraintsCache"] += approximateCellConstraintsSize(entry.second) - sizeof(entry.second);
+  }
+  
+  variableCost["_dofMapperCache"] = approximateMapSizeLLVM(_dofMapperCache);
+  for (auto &entry : _dofMapperCache)
+  {
+    variableCost["_dofMapperCache"] += entry.second->approximateMemoryFootprint();
+  }
+  
+  variableCost["_dofMapperForVariableOnSideCache"] = _dofMapperForVariableOnSideCache.approximateMemoryFootprint();
+  
+  variableCost["_ownedGlobalDofIndicesCache"] = approximateMapSizeLLVM(_ownedGlobalDofIndicesCache);
+  for (auto &entry : _ownedGlobalDofIndicesCache)
+  {
+    variableCost["_ownedGlobalDofIndicesCache"] += entry.second.approximateMemoryFootprint() - sizeof(entry.second);
+  }
+  variableCost["_globalDofIndicesForCellCache"] = approximateMapSizeLLVM(_globalDofIndicesForCellCache);
+  for (auto &entry : _globalDofIndicesForCellCache)
+  {
+    variableCost["_globalDofIndicesForCellCache"] += entry.second.approximateMemoryFootprint() - sizeof(entry.second);
+  }
+  
+  variableCost["_fittableGlobalIndicesCache"] = _fittableGlobalIndicesCache.approximateMemoryFootprint();
+  
+  return variableCost;
+}
+
+BasisReconciliation & GDAMinimumRule::basisReconciliation()
+{
+  return _br;
+}
+
 void GDAMinimumRule::clearCaches()
 {
   _constraintsCache.clear(); // to free up memory, could clear this again after the lookups are rebuilt.  Having the cache is most important during the construction in rebuildLookups().
@@ -512,6 +612,14 @@ set<GlobalIndexType> GDAMinimumRule::globalDofIndicesForCell(GlobalIndexType cel
   return globalDofIndices;
 }
 
+void GDAMinimumRule::sortedGlobalDofIndicesForCell(GlobalIndexType cellID, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  LocalDofMapperPtr dofMapper = getDofMapper(cellID);
+  sortedGlobalDofIndices = dofMapper->globalIndices();
+  std::sort(sortedGlobalDofIndices.begin(), sortedGlobalDofIndices.end());
+  sortedGlobalDofIndices.erase(std::unique(sortedGlobalDofIndices.begin(), sortedGlobalDofIndices.end()), sortedGlobalDofIndices.end());
+}
+
 set<GlobalIndexType> GDAMinimumRule::globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned int dim, unsigned int subcellOrdinal)
 {
   LocalDofMapperPtr dofMapper = getDofMapper(cellID);
@@ -521,22 +629,21 @@ set<GlobalIndexType> GDAMinimumRule::globalDofIndicesForVarOnSubcell(int varID,
 }
 
 set<GlobalIndexType> GDAMinimumRule::globalDofIndicesForPartition(PartitionIndexType partitionNumber)
+{
+  vector<GlobalIndexType> globalDofIndicesVector;
+  sortedGlobalDofIndicesForPartition(partitionNumber, globalDofIndicesVector);
+  return set<GlobalIndexType>(globalDofIndicesVector.begin(),globalDofIndicesVector.end());
+}
+
+bool GDAMinimumRule::globalDofRangeForPartition(PartitionIndexType partitionNumber, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount)
 {
   int rank = _partitionPolicy->Comm()->MyPID();
 
   if (partitionNumber==-1) partitionNumber = rank;
 
-  GlobalIndexType partitionDofOffset = _partitionDofOffsets[partitionNumber];
-  GlobalIndexType nextPartitionDofOffset = _partitionDofOffsets[partitionNumber+1];
-  vector<GlobalIndexType> globalDofIndicesVector(nextPartitionDofOffset - partitionDofOffset);
-  int ordinal = 0;
-  for (IndexType i=partitionDofOffset; i<nextPartitionDofOffset; i++)
-  {
-    globalDofIndicesVector[ordinal] = i;
-    ordinal++;
-  }
-
-  return set<GlobalIndexType>(globalDofIndicesVector.begin(),globalDofIndicesVector.end());
+  firstDofIndex = _partitionDofOffsets[partitionNumber];
+  dofCount = _partitionDofOffsets[partitionNumber+1] - firstDofIndex;
+  return true;
 }
 
 vector<int> GDAMinimumRule::H1Order(GlobalIndexType cellID, unsigned sideOrdinal)
@@ -2764,10 +2871,11 @@ unsigned GDAMinimumRule::getConstraintPermutation(GlobalIndexType cellID, unsign
 
 set<GlobalIndexType> GDAMinimumRule::getFittableGlobalDofIndices(GlobalIndexType cellID, int sideOrdinal, int varID)
 {
-  pair<GlobalIndexType,pair<int,unsigned>> key = {cellID,{varID,sideOrdinal}};
-  if (_fittableGlobalIndicesCache.find(key) != _fittableGlobalIndicesCache.end())
+  FittableGlobalIndicesKey key = {cellID,{varID,sideOrdinal}};
+  set<GlobalIndexType>* cachedIndices = _fittableGlobalIndicesCache.find(key);
+  if (cachedIndices != NULL)
   {
-    return _fittableGlobalIndicesCache[key];
+    return *cachedIndices;
   }
   
   // returns the global dof indices for basis functions which have support on the given side.  This is determined by taking the union of the global dof indices defined on all the constraining sides for the given side (the constraining sides are by definition unconstrained).
@@ -2841,7 +2949,7 @@ set<GlobalIndexType> GDAMinimumRule::getFittableGlobalDofIndices(GlobalIndexType
       }
     }
   }
-  _fittableGlobalIndicesCache[key] = fittableDofIndices;
+  _fittableGlobalIndicesCache.insert(key, fittableDofIndices);
   return fittableDofIndices;
 }
 
@@ -3113,18 +3221,10 @@ LocalDofMapperPtr GDAMinimumRule::getDofMapper(GlobalIndexType cellID, int varID
   }
   else
   {
-    map< GlobalIndexType, map<int, map<int, LocalDofMapperPtr> > >::iterator cellMapEntry = _dofMapperForVariableOnSideCache.find(cellID);
-    if (cellMapEntry != _dofMapperForVariableOnSideCache.end())
+    LocalDofMapperPtr* cachedDofMapper = _dofMapperForVariableOnSideCache.find({cellID,{sideOrdinalToMap,varIDToMap}});
+    if (cachedDofMapper != NULL)
     {
-      map<int, map<int, LocalDofMapperPtr> >::iterator sideMapEntry = cellMapEntry->second.find(sideOrdinalToMap);
-      if (sideMapEntry != cellMapEntry->second.end())
-      {
-        map<int, LocalDofMapperPtr>::iterator varMapEntry = sideMapEntry->second.find(varIDToMap);
-        if (varMapEntry != sideMapEntry->second.end())
-        {
-          return varMapEntry->second;
-        }
-      }
+      return *cachedDofMapper;
     }
   }
 
@@ -3263,7 +3363,7 @@ LocalDofMapperPtr GDAMinimumRule::getDofMapper(GlobalIndexType cellID, int varID
   }
   else
   {
-    _dofMapperForVariableOnSideCache[cellID][sideOrdinalToMap][varIDToMap] = dofMapper;
+    _dofMapperForVariableOnSideCache.insert({cellID,{sideOrdinalToMap,varIDToMap}}, dofMapper);
     return dofMapper;
   }
 }
@@ -3378,6 +3478,7 @@ void GDAMinimumRule::rebuildLookups()
 {
   int timerHandle = TimeLogger::sharedInstance()->startTimer("rebuildLookups");
   
+  _dofNumberingVersion++;
   clearCaches();
   determineMinimumSubcellDimensionForContinuityEnforcement();
   
@@ -19,6 +19,7 @@
 
 #include "CamelliaCellTools.h"
 #include "CamelliaDebugUtility.h"
+#include "CamelliaMemoryUtility.h"
 #include "CondensedDofInterpreter.h"
 #include "ElementType.h"
 #include "Solution.h"
@@ -572,6 +573,34 @@ DofOrderingFactoryPtr GlobalDofAssignment::getDofOrderingFactory()
   return _dofOrderingFactory;
 }
 
+map<string, long long> GlobalDofAssignment::approximateMemoryCosts() const
+{
+  map<string, long long> variableCost;
+  
+  variableCost["_cellSideParitiesForCellID"] = approximateMapSizeLLVM(_cellSideParitiesForCellID);
+  for (auto &entry : _cellSideParitiesForCellID)
+  {
+    variableCost["_cellSideParitiesForCellID"] += sizeof(int) * entry.second.size();
+  }
+  
+  variableCost["_cellPRefinements"] = approximateMapSizeLLVM(_cellPRefinements);
+  variableCost["_elementTypesForCellTopology"] = approximateMapSizeLLVM(_elementTypesForCellTopology);
+  
+  variableCost["_partitions"] = approximateVectorSizeLLVM(_partitions);
+  for (auto &partition : _partitions)
+  {
+    variableCost["_partitions"] += approximateSetSizeLLVM(partition) - sizeof(partition);
+  }
+  variableCost["_partitionForCellID"] = approximateMapSizeLLVM(_partitionForCellID);
+  
+  return variableCost;
+}
+
+unsigned GlobalDofAssignment::dofNumberingVersion() const
+{
+  return _dofNumberingVersion;
+}
+
 ElementTypeFactory & GlobalDofAssignment::getElementTypeFactory()
 {
   return _elementTypeFactory;
@@ -14,6 +14,7 @@
 #include "BasisFactory.h"
 #include "CamelliaCellTools.h"
 #include "CamelliaDebugUtility.h"
+#include "CamelliaMemoryUtility.h"
 #include "SerialDenseWrapper.h"
 #include "SubBasisDofMatrixMapper.h"
 
@@ -1323,6 +1324,53 @@ void LocalDofMapper::mapGlobalCoefficients(const std::map<GlobalIndexType,double
   }
 }
 
+long long LocalDofMapper::approximateMemoryFootprint() const
+{
+  long long memSize = sizeof(*this);
+  
+  memSize += approximateMapSizeLLVM(_volumeMaps) - sizeof(_volumeMaps);
+  for (auto &entry : _volumeMaps)
+  {
+    memSize += sizeof(SubBasisDofMapperPtr) * entry.second.size();
+  }
+  memSize += approximateVectorSizeLLVM(_sideMaps) - sizeof(_sideMaps);
+  for (auto &sideMap : _sideMaps)
+  {
+    memSize += approximateMapSizeLLVM(sideMap) - sizeof(sideMap);
+    for (auto &entry : sideMap)
+    {
+      memSize += sizeof(SubBasisDofMapperPtr) * entry.second.size();
+    }
+  }
+  
+  memSize += approximateMapSizeLLVM(_globalIndexToOrdinal) - sizeof(_globalIndexToOrdinal);
+  memSize += approximateMapSizeLLVM(_globalIndexToVarIDs) - sizeof(_globalIndexToVarIDs);
+  for (auto &entry : _globalIndexToVarIDs)
+  {
+    memSize += sizeof(int) * entry.second.size();
+  }
+  
+  memSize += approximateVectorSizeLLVM(_fittableGlobalDofOrdinalsOnSides) - sizeof(_fittableGlobalDofOrdinalsOnSides);
+  for (auto &ordinals : _fittableGlobalDofOrdinalsOnSides)
+  {
+    memSize += approximateSetSizeLLVM(ordinals) - sizeof(ordinals);
+  }
+  memSize += approximateSetSizeLLVM(_fittableGlobalDofOrdinalsInVolume) - sizeof(_fittableGlobalDofOrdinalsInVolume);
+  memSize += approximateVectorSizeLLVM(_fittableGlobalIndices) - sizeof(_fittableGlobalIndices);
+  
+  memSize += sizeof(double) * _localCoefficientsFitMatrix.size();
+  memSize += approximateVectorSizeLLVM(_globalIndices) - sizeof(_globalIndices);
+  
+  memSize += approximateMapSizeLLVM(_localDofMapperForVarIDAndSide) - sizeof(_localDofMapperForVarIDAndSide);
+  for (auto &entry : _localDofMapperForVarIDAndSide)
+  {
+    memSize += entry.second->approximateMemoryFootprint();
+  }
+  memSize += approximateMapSizeLLVM(_permutationMap) - sizeof(_permutationMap);
+  
+  return memSize;
+}
+
 void LocalDofMapper::printMappingReport()
 {
   //  map< int, BasisMap > _volumeMaps; // keys are var IDs (fields)
@@ -7,6 +7,7 @@
 #include "Mesh.h"
 
 #include "CellDataMigration.h"
+#include "CellHalo.h"
 #include "ElementType.h"
 #include "DofOrderingFactory.h"
 #include "BasisFactory.h"
@@ -17,6 +18,7 @@
 #include "MeshTransformationFunction.h"
 
 #include "CamelliaCellTools.h"
+#include "CamelliaMemoryUtility.h"
 
 #include "GlobalDofAssignment.h"
 
@@ -290,6 +292,26 @@ ElementPtr Mesh::ancestralNeighborForSide(ElementPtr elem, int sideIndex, int &e
   return getElement(neighborInfo.first);
 }
 
+map<string, long long> Mesh::approximateMemoryCosts() const
+{
+  map<string, long long> variableCost;
+  
+  const MeshTopology* meshTopo = dynamic_cast<const MeshTopology*>(_meshTopology.get());
+  if (meshTopo != NULL)
+  {
+    addMemoryCosts(variableCost, "_meshTopology.", meshTopo->approximateMemoryCosts());
+  }
+  else
+  {
+    // a view: the MeshTopology it refers to is not counted here
+    variableCost["_meshTopology"] = _meshTopology->approximateMemoryFootprint();
+  }
+  
+  addMemoryCosts(variableCost, "_gda.", _gda->approximateMemoryCosts());
+  
+  return variableCost;
+}
+
 TBFPtr<double> Mesh::bilinearForm()
 {
   return _bilinearForm;
@@ -335,6 +357,15 @@ const set<GlobalIndexType> & Mesh::cellIDsInPartition()
   return _gda->cellsInPartition(-1);
 }
 
+CellHaloPtr Mesh::cellHalo()
+{
+  if (_cellHalo == Teuchos::null)
+  {
+    _cellHalo = Teuchos::rcp( new CellHalo(*this) );
+  }
+  return _cellHalo;
+}
+
 int Mesh::cellPolyOrder(GlobalIndexType cellID)   // aka H1Order
 {
   return _gda->getH1Order(cellID)[0];
@@ -351,7 +382,7 @@ vector<GlobalIndexType> Mesh::cellIDsForPoints(const FieldContainer<double> &phy
 
   if (minusOnesIfOffRank)
   {
-    set<GlobalIndexType> rankLocalCellIDs = cellIDsInPartition();
+    const set<GlobalIndexType> &rankLocalCellIDs = cellIDsInPartition();
     for (int i=0; i<cellIDs.size(); i++)
     {
       if (rankLocalCellIDs.find(cellIDs[i]) == rankLocalCellIDs.end())
@@ -768,6 +799,11 @@ set<GlobalIndexType> Mesh::globalDofIndicesForCell(GlobalIndexType cellID)
   return _gda->globalDofIndicesForCell(cellID);
 }
 
+void Mesh::sortedGlobalDofIndicesForCell(GlobalIndexType cellID, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  _gda->sortedGlobalDofIndicesForCell(cellID, sortedGlobalDofIndices);
+}
+
 set<GlobalIndexType> Mesh::globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal)
 {
   return _gda->globalDofIndicesForVarOnSubcell(varID, cellID, dim, subcellOrdinal);
@@ -778,6 +814,21 @@ set<GlobalIndexType> Mesh::globalDofIndicesForPartition(PartitionIndexType parti
   return _gda->globalDofIndicesForPartition(partitionNumber);
 }
 
+bool Mesh::globalDofRangeForPartition(PartitionIndexType partitionNumber, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount)
+{
+  return _gda->globalDofRangeForPartition(partitionNumber, firstDofIndex, dofCount);
+}
+
+GlobalIndexType Mesh::globalDofCountForPartition(PartitionIndexType partitionNumber)
+{
+  return _gda->globalDofCountForPartition(partitionNumber);
+}
+
+void Mesh::sortedGlobalDofIndicesForPartition(PartitionIndexType partitionNumber, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  _gda->sortedGlobalDofIndicesForPartition(partitionNumber, sortedGlobalDofIndices);
+}
+
 void Mesh::hRefine(const vector<GlobalIndexType> &cellIDs, bool repartitionAndRebuild)
 {
   set<GlobalIndexType> cellSet(cellIDs.begin(),cellIDs.end());
@@ -1005,6 +1056,7 @@ void Mesh::hUnrefine(const set<GlobalIndexType> &cellIDs, bool repartitionAndReb
   {
     _gda->repartitionAndMigrate();
     _boundary.buildLookupTables();
+    _cellHalo = Teuchos::null;
   }
 }
 
@@ -1240,6 +1292,7 @@ void Mesh::repartitionAndRebuild()
 {
   _gda->repartitionAndMigrate();
   _boundary.buildLookupTables();
+  _cellHalo = Teuchos::null;
   
   MeshTopology* meshTopologyInstance = dynamic_cast<MeshTopology*>(_meshTopology.get());
   
@@ -1363,6 +1416,7 @@ void Mesh::rebuildLookups()
 {
   _gda->repartitionAndMigrate();
   _boundary.buildLookupTables();
+  _cellHalo = Teuchos::null;
 }
 
 int Mesh::rowSizeUpperBound()
@@ -417,6 +417,16 @@ MeshPtr MeshFactory::quadMeshMinRule(TBFPtr<double> bf, int H1Order, int pToAddT
 MeshTopologyPtr MeshFactory::quadMeshTopology(double width, double height, int horizontalElements, int verticalElements, bool divideIntoTriangles,
     double x0, double y0, vector<PeriodicBCPtr> periodicBCs)
 {
+  if (!divideIntoTriangles && (periodicBCs.size() == 0))
+  {
+    // bulk construction yields the same MeshTopology without coordinate-based vertex matching
+    vector<double> dimensions = {width, height};
+    vector<int> elementCounts = {horizontalElements, verticalElements};
+    vector<double> origin = {x0, y0};
+    Epetra_CommPtr nullComm = Teuchos::null;
+    return Teuchos::rcp( new MeshTopology(nullComm, dimensions, elementCounts, origin) );
+  }
+
   vector<vector<double> > vertices;
   vector< vector<IndexType> > allElementVertices;
 
@@ -555,13 +565,21 @@ MeshPtr MeshFactory::rectilinearMesh(TBFPtr<double> bf, vector<double> dimension
     pToAddTest = spaceDim;
   }
 
-  MeshTopologyPtr meshTopology = rectilinearMeshTopology(dimensions, elementCounts, x0);
+  MeshTopologyPtr meshTopology = rectilinearMeshTopology(dimensions, elementCounts, x0, Comm);
+
+  // a distributed topology only knows each rank's contiguous chunk of cells; the default partition policy divides active cells the same way
+  MeshPartitionPolicyPtr partitionPolicy = Teuchos::null;
+  if (Comm != Teuchos::null)
+  {
+    partitionPolicy = Teuchos::rcp( new MeshPartitionPolicy(Comm) );
+  }
 
   return Teuchos::rcp( new Mesh(meshTopology, bf, H1Order, pToAddTest, trialOrderEnhancements, testOrderEnhancements,
-                                Teuchos::null, Comm) );
+                                partitionPolicy, Comm) );
 }
 
-MeshTopologyPtr MeshFactory::rectilinearMeshTopology(vector<double> dimensions, vector<int> elementCounts, vector<double> x0)
+MeshTopologyPtr MeshFactory::rectilinearMeshTopology(vector<double> dimensions, vector<int> elementCounts, vector<double> x0,
+                                                     Epetra_CommPtr Comm)
 {
   int spaceDim = dimensions.size();
 
@@ -579,131 +597,21 @@ MeshTopologyPtr MeshFactory::rectilinearMeshTopology(vector<double> dimensions,
     TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Element count container must match dimensions container in length.\n");
   }
 
-  if (spaceDim == 1)
+  if ((spaceDim == 1) && (Comm == Teuchos::null))
   {
     double xLeft = x0[0];
     double xRight = dimensions[0] + xLeft;
     return MeshFactory::intervalMeshTopology(xLeft, xRight, elementCounts[0]);
   }
 
-  if (spaceDim == 2)
-  {
-    return MeshFactory::quadMeshTopology(dimensions[0], dimensions[1], elementCounts[0], elementCounts[1], false, x0[0], x0[1]);
-  }
-
-  if (spaceDim != 3)
+  if ((spaceDim < 1) || (spaceDim > 3))
   {
     cout << "For now, only spaceDim 1,2,3 are supported by this MeshFactory method.\n";
     TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "For now, only spaceDim 1,2,3 are is supported by this MeshFactory method.");
   }
 
-  CellTopoPtr topo;
-  if (spaceDim==1)
-  {
-    topo = Camellia::CellTopology::line();
-  }
-  else if (spaceDim==2)
-  {
-    topo = Camellia::CellTopology::quad();
-  }
-  else if (spaceDim==3)
-  {
-    topo = Camellia::CellTopology::hexahedron();
-  }
-  else
-  {
-    cout << "Unsupported spatial dimension.\n";
-    TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Unsupported spatial dimension");
-  }
-
-  int numElements = 1;
-  vector<double> elemLinearMeasures(spaceDim);
-  vector<double> origin = x0;
-  for (int d=0; d<spaceDim; d++)
-  {
-    numElements *= elementCounts[d];
-    elemLinearMeasures[d] = dimensions[d] / elementCounts[d];
-  }
-  vector< CellTopoPtr > cellTopos(numElements, topo);
-
-  map< vector<int>, IndexType> vertexLookup;
-  vector< vector<double> > vertices;
-
-  for (int i=0; i<elementCounts[0]+1; i++)
-  {
-    double x = origin[0] + elemLinearMeasures[0] * i;
-
-    for (int j=0; j<elementCounts[1]+1; j++)
-    {
-      double y = origin[1] + elemLinearMeasures[1] * j;
-
-      for (int k=0; k<elementCounts[2]+1; k++)
-      {
-        double z = origin[2] + elemLinearMeasures[2] * k;
-
-        vector<int> vertexIndex;
-        vertexIndex.push_back(i);
-        vertexIndex.push_back(j);
-        vertexIndex.push_back(k);
-
-        vector<double> vertex;
-        vertex.push_back(x);
-        vertex.push_back(y);
-        vertex.push_back(z);
-
-        vertexLookup[vertexIndex] = vertices.size();
-        vertices.push_back(vertex);
-      }
-    }
-  }
-
-  vector< vector<IndexType> > elementVertices;
-  for (int i=0; i<elementCounts[0]; i++)
-  {
-    for (int j=0; j<elementCounts[1]; j++)
-    {
-      for (int k=0; k<elementCounts[2]; k++)
-      {
-        vector< vector<int> > vertexIntCoords(8, vector<int>(3));
-        vertexIntCoords[0][0] = i;
-        vertexIntCoords[0][1] = j;
-        vertexIntCoords[0][2] = k;
-        vertexIntCoords[1][0] = i+1;
-        vertexIntCoords[1][1] = j;
-        vertexIntCoords[1][2] = k;
-        vertexIntCoords[2][0] = i+1;
-        vertexIntCoords[2][1] = j+1;
-        vertexIntCoords[2][2] = k;
-        vertexIntCoords[3][0] = i;
-        vertexIntCoords[3][1] = j+1;
-        vertexIntCoords[3][2] = k;
-        vertexIntCoords[4][0] = i;
-        vertexIntCoords[4][1] = j;
-        vertexIntCoords[4][2] = k+1;
-        vertexIntCoords[5][0] = i+1;
-        vertexIntCoords[5][1] = j;
-        vertexIntCoords[5][2] = k+1;
-        vertexIntCoords[6][0] = i+1;
-        vertexIntCoords[6][1] = j+1;
-        vertexIntCoords[6][2] = k+1;
-        vertexIntCoords[7][0] = i;
-        vertexIntCoords[7][1] = j+1;
-        vertexIntCoords[7][2] = k+1;
-
-        vector<IndexType> elementVertexOrdinals;
-        for (int n=0; n<8; n++)
-        {
-          elementVertexOrdinals.push_back(vertexLookup[vertexIntCoords[n]]);
-        }
-
-        elementVertices.push_back(elementVertexOrdinals);
-      }
-    }
-  }
-
-  MeshGeometryPtr geometry = Teuchos::rcp( new MeshGeometry(vertices, elementVertices, cellTopos));
-
-  MeshTopologyPtr meshTopology = Teuchos::rcp( new MeshTopology(geometry) );
+  // bulk construction: vertices and cells come straight from the grid indices
+  MeshTopologyPtr meshTopology = Teuchos::rcp( new MeshTopology(Comm, dimensions, elementCounts, x0) );
   return meshTopology;
 }
 
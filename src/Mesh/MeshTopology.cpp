@@ -135,6 +135,170 @@ MeshTopology::MeshTopology(Epetra_CommPtr Comm, const MeshGeometryInfo &meshGeom
   _ownedCellIndices.insert(meshGeometryInfo.myCellIDs.begin(), meshGeometryInfo.myCellIDs.end());
 }
 
+// returns the lexicographic index of the specified node of a structured grid cell
+static GlobalIndexType structuredGridVertexIndex(GlobalIndexType cellIndex, const vector<int> &nodeOffsets,
+                                                 const vector<int> &elementCounts, const vector<GlobalIndexType> &cellStrides,
+                                                 const vector<GlobalIndexType> &vertexStrides)
+{
+  GlobalIndexType vertexIndex = 0;
+  int spaceDim = elementCounts.size();
+  for (int d=0; d<spaceDim; d++)
+  {
+    GlobalIndexType cellCoord = (cellIndex / cellStrides[d]) % elementCounts[d];
+    vertexIndex += (cellCoord + nodeOffsets[d]) * vertexStrides[d];
+  }
+  return vertexIndex;
+}
+
+MeshTopology::MeshTopology(Epetra_CommPtr Comm, const vector<double> &dimensions, const vector<int> &elementCounts,
+                           const vector<double> &x0)
+{
+  int spaceDim = dimensions.size();
+  TEUCHOS_TEST_FOR_EXCEPTION((spaceDim < 1) || (spaceDim > 3), std::invalid_argument, "Structured grids are only supported for spaceDim 1, 2, and 3");
+  TEUCHOS_TEST_FOR_EXCEPTION(elementCounts.size() != spaceDim, std::invalid_argument, "elementCounts must have the same length as dimensions");
+  TEUCHOS_TEST_FOR_EXCEPTION(x0.size() != spaceDim, std::invalid_argument, "x0 must have the same length as dimensions");
+
+  init(spaceDim);
+
+  CellTopoPtr cellTopo;
+  if (spaceDim == 1)
+    cellTopo = CellTopology::line();
+  else if (spaceDim == 2)
+    cellTopo = CellTopology::quad();
+  else
+    cellTopo = CellTopology::hexahedron();
+
+  // cells and vertices are numbered lexicographically, with the first coordinate varying slowest
+  vector<GlobalIndexType> cellStrides(spaceDim), vertexStrides(spaceDim);
+  GlobalIndexType numCells = 1, numVertices = 1;
+  for (int d=spaceDim-1; d>=0; d--)
+  {
+    cellStrides[d] = numCells;
+    vertexStrides[d] = numVertices;
+    numCells *= elementCounts[d];
+    numVertices *= elementCounts[d] + 1;
+  }
+  vector<double> elemLinearMeasures(spaceDim);
+  for (int d=0; d<spaceDim; d++)
+  {
+    elemLinearMeasures[d] = dimensions[d] / elementCounts[d];
+  }
+
+  // grid offsets of each cell node, in shards node order: for quads and hexahedra, counter-clockwise in the (x,y) plane, then the z=1 face
+  int nodeCount = cellTopo->getNodeCount();
+  vector< vector<int> > nodeOffsets(nodeCount, vector<int>(spaceDim,0));
+  for (int node=0; node<nodeCount; node++)
+  {
+    int nodeInFace = node % 4;
+    nodeOffsets[node][0] = ((nodeInFace == 1) || (nodeInFace == 2)) ? 1 : 0;
+    if (spaceDim > 1) nodeOffsets[node][1] = (nodeInFace >= 2) ? 1 : 0;
+    if (spaceDim > 2) nodeOffsets[node][2] = (node >= 4) ? 1 : 0;
+  }
+
+  GlobalIndexType myFirstCellIndex = 0, myCellCount = numCells;
+  vector<GlobalIndexType> cellsToConstruct;
+  vector<GlobalIndexType> globalVertexIndices; // only filled in for distributed construction; otherwise, local and global vertex indices agree
+  if (Comm == Teuchos::null)
+  {
+    cellsToConstruct.resize(numCells);
+    for (GlobalIndexType cellIndex=0; cellIndex<numCells; cellIndex++)
+    {
+      cellsToConstruct[cellIndex] = cellIndex;
+    }
+  }
+  else
+  {
+    // same chunking as the default MeshPartitionPolicy
+    GlobalIndexType numProcs = Comm->NumProc(), rank = Comm->MyPID();
+    GlobalIndexType chunkSize = numCells / numProcs;
+    GlobalIndexType remainder = numCells % numProcs;
+    myCellCount = (rank < remainder) ? chunkSize + 1 : chunkSize;
+    myFirstCellIndex = rank * chunkSize + std::min(rank, remainder);
+
+    // the halo contains every cell that shares a vertex with an owned cell: that is, every cell whose
+    // grid coordinates differ from those of an owned cell by at most one in each direction.
+    int stencilSize = 1;
+    for (int d=0; d<spaceDim; d++)
+    {
+      stencilSize *= 3;
+    }
+    for (GlobalIndexType cellIndex=myFirstCellIndex; cellIndex<myFirstCellIndex+myCellCount; cellIndex++)
+    {
+      for (int stencilOrdinal=0; stencilOrdinal<stencilSize; stencilOrdinal++)
+      {
+        int remainingOrdinal = stencilOrdinal;
+        bool inGrid = true;
+        GlobalIndexType neighborIndex = 0;
+        for (int d=0; d<spaceDim; d++)
+        {
+          long long neighborCoord = (cellIndex / cellStrides[d]) % elementCounts[d] + (remainingOrdinal % 3) - 1;
+          remainingOrdinal /= 3;
+          if ((neighborCoord < 0) || (neighborCoord >= elementCounts[d]))
+          {
+            inGrid = false;
+            break;
+          }
+          neighborIndex += neighborCoord * cellStrides[d];
+        }
+        if (inGrid) cellsToConstruct.push_back(neighborIndex);
+      }
+    }
+    std::sort(cellsToConstruct.begin(), cellsToConstruct.end());
+    cellsToConstruct.erase(std::unique(cellsToConstruct.begin(), cellsToConstruct.end()), cellsToConstruct.end());
+
+    for (GlobalIndexType cellIndex : cellsToConstruct)
+    {
+      for (int node=0; node<nodeCount; node++)
+      {
+        globalVertexIndices.push_back(structuredGridVertexIndex(cellIndex, nodeOffsets[node], elementCounts, cellStrides, vertexStrides));
+      }
+    }
+    std::sort(globalVertexIndices.begin(), globalVertexIndices.end());
+    globalVertexIndices.erase(std::unique(globalVertexIndices.begin(), globalVertexIndices.end()), globalVertexIndices.end());
+
+    // as in the MeshGeometryInfo constructor, we know about cells we will not construct
+    _nextCellIndex = numCells;
+    _activeCellCount = numCells;
+  }
+
+  GlobalIndexType localVertexCount = (Comm == Teuchos::null) ? numVertices : globalVertexIndices.size();
+  vector<double> vertex(spaceDim);
+  for (GlobalIndexType localVertexIndex=0; localVertexIndex<localVertexCount; localVertexIndex++)
+  {
+    GlobalIndexType globalVertexIndex = (Comm == Teuchos::null) ? localVertexIndex : globalVertexIndices[localVertexIndex];
+    for (int d=0; d<spaceDim; d++)
+    {
+      GlobalIndexType vertexCoord = (globalVertexIndex / vertexStrides[d]) % (elementCounts[d] + 1);
+      vertex[d] = x0[d] + elemLinearMeasures[d] * vertexCoord;
+    }
+    addVertexWithoutMatching(vertex);
+  }
+
+  vector<IndexType> cellVertices(nodeCount);
+  for (GlobalIndexType cellIndex : cellsToConstruct)
+  {
+    for (int node=0; node<nodeCount; node++)
+    {
+      GlobalIndexType vertexIndex = structuredGridVertexIndex(cellIndex, nodeOffsets[node], elementCounts, cellStrides, vertexStrides);
+      if (Comm != Teuchos::null)
+      {
+        vertexIndex = std::lower_bound(globalVertexIndices.begin(), globalVertexIndices.end(), vertexIndex) - globalVertexIndices.begin();
+      }
+      cellVertices[node] = vertexIndex;
+    }
+    addCell(cellIndex, cellTopo, cellVertices);
+  }
+
+  if (Comm != Teuchos::null)
+  {
+    _Comm = Comm;
+    for (GlobalIndexType cellIndex=myFirstCellIndex; cellIndex<myFirstCellIndex+myCellCount; cellIndex++)
+    {
+      _ownedCellIndices.insert(_ownedCellIndices.end(), cellIndex);
+    }
+  }
+}
+
 IndexType MeshTopology::activeCellCount() const
 {
   return _activeCellCount;
@@ -926,6 +1090,23 @@ void MeshTopology::addSideForEntity(unsigned int entityDim, IndexType entityInde
   }
 }
 
+IndexType MeshTopology::addVertexWithoutMatching(const vector<double> &vertex)
+{
+  IndexType vertexIndex = _vertices.size();
+  _vertices.push_back(vertex);
+  // structured construction adds vertices in sorted order, so the end() hints make these insertions amortized constant-time
+  _vertexMap.insert(_vertexMap.end(), make_pair(vertex, vertexIndex));
+
+  int vertexDim = 0;
+  vector<IndexType> nodeVector(1,vertexIndex);
+  _entities[vertexDim].push_back(nodeVector);
+  CellTopoPtr nodeTopo = CellTopology::point();
+  _entityCellTopologyKeys[vertexDim][nodeTopo->getKey()].insert(vertexIndex);
+  _knownEntities[vertexDim].insert(_knownEntities[vertexDim].end(), make_pair(nodeVector, vertexIndex));
+
+  return vertexIndex;
+}
+
 void MeshTopology::addVertex(const vector<double> &vertex)
 {
   double tol = 1e-15;
@@ -274,6 +274,18 @@ void TBC<Scalar>::setTime(double time)
   }
 }
 
+template <typename Scalar>
+void TBC<Scalar>::setCacheImposedValues(bool value)
+{
+  _cacheImposedValues = value;
+}
+
+template <typename Scalar>
+bool TBC<Scalar>::cacheImposedValues() const
+{
+  return _cacheImposedValues;
+}
+
 template <typename Scalar>
 bool TBC<Scalar>::bcsImposed(int varID)
 {
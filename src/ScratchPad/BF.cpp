@@ -10,6 +10,7 @@
 #include "PreviousSolutionFunction.h"
 #include "LinearTerm.h"
 #include "SerialDenseWrapper.h"
+#include "SubgridTestSpace.h"
 #include "TimeLogger.h"
 #include "VarFactory.h"
 
@@ -87,6 +88,7 @@ namespace Camellia
   void TBF<Scalar>::addTerm( TLinearTermPtr<Scalar> trialTerm, TLinearTermPtr<Scalar> testTerm )
   {
     _terms.push_back( make_pair( trialTerm, testTerm ) );
+    _similarCellFactors.clear();
   }
   
   template <typename Scalar>
@@ -848,6 +850,22 @@ namespace Camellia
     
   }
   
+  // ! Given the Cholesky factor of the Gram matrix and the back-substituted enriched stiffness left by factoredCholeskySolve(),
+  // ! computes the optimal-test load.  rhsEnriched is overwritten.
+  template <typename Scalar>
+  static void factoredCholeskyRHS(const FieldContainer<Scalar> &gramFactor, const FieldContainer<Scalar> &stiffnessEnrichedSolved,
+                                  FieldContainer<Scalar> &rhsEnriched, FieldContainer<Scalar> &rhs)
+  {
+    int N = gramFactor.dimension(0);
+    int oneColumn = 1;
+    double ALPHA = 1.0;
+    Teuchos::BLAS<int, double> blas;
+    blas.TRSM(Teuchos::LEFT_SIDE, Teuchos::LOWER_TRI, Teuchos::NO_TRANS, Teuchos::NON_UNIT_DIAG, N, oneColumn, ALPHA, &gramFactor[0], N,
+              &rhsEnriched[0], N);
+    
+    SerialDenseWrapper::multiply(rhs, stiffnessEnrichedSolved, rhsEnriched, 'N', 'N');
+  }
+  
   template <typename Scalar>
   int TBF<Scalar>::factoredCholeskySolve(FieldContainer<Scalar> &ipMatrix, FieldContainer<Scalar> &stiffnessEnriched,
                                          FieldContainer<Scalar> &rhsEnriched, FieldContainer<Scalar> &stiffness,
@@ -936,12 +954,7 @@ namespace Camellia
     
     // need also to take cellRectangularStiffness and do back-substitution with L^T, so that what's left in there is the
     // cellOptimalWeights
-    int oneColumn = 1;
-
-    blas.TRSM(Teuchos::LEFT_SIDE, Teuchos::LOWER_TRI, Teuchos::NO_TRANS, Teuchos::NON_UNIT_DIAG, N, oneColumn, ALPHA, &ipMatrix[0], N,
-              &rhsEnriched[0], N);
-    
-    SerialDenseWrapper::multiply(rhs, stiffnessEnriched, rhsEnriched, 'N', 'N');
+    factoredCholeskyRHS(ipMatrix, stiffnessEnriched, rhsEnriched, rhs);
     return result;
   }
   
@@ -1071,122 +1084,110 @@ namespace Camellia
     Epetra_Time timer(*MPIWrapper::CommSerial());
     bool printTimings = false;
     
-    if (! _useSubgridMeshForOptimalTestSolve)
+    // localStiffness should have dim. (numCells, numTrialFields, numTestFields)
+    MeshPtr mesh = basisCache->mesh();
+    if (mesh.get() == NULL)
     {
-      // localStiffness should have dim. (numCells, numTrialFields, numTestFields)
-      MeshPtr mesh = basisCache->mesh();
-      if (mesh.get() == NULL)
-      {
-        cout << "localStiffnessMatrix requires BasisCache to have mesh set.\n";
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires BasisCache to have mesh set.");
-      }
-      const vector<GlobalIndexType>* cellIDs = &basisCache->cellIDs();
-      int numCells = cellIDs->size();
-      if (numCells != stiffnessEnriched.dimension(0))
-      {
-        cout << "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness\n";
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness");
-      }
-      
-      ElementTypePtr elemType = mesh->getElementType((*cellIDs)[0]); // we assume all cells provided are of the same type
-      DofOrderingPtr trialOrder = elemType->trialOrderPtr;
-      DofOrderingPtr testOrder = elemType->testOrderPtr;
+      cout << "localStiffnessMatrix requires BasisCache to have mesh set.\n";
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires BasisCache to have mesh set.");
+    }
+    const vector<GlobalIndexType>* cellIDs = &basisCache->cellIDs();
+    int numCells = cellIDs->size();
+    if (numCells != stiffnessEnriched.dimension(0))
+    {
+      cout << "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness\n";
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness");
+    }
+    
+    ElementTypePtr elemType = mesh->getElementType((*cellIDs)[0]); // we assume all cells provided are of the same type
+    DofOrderingPtr trialOrder = elemType->trialOrderPtr;
+    DofOrderingPtr testOrder = elemType->testOrderPtr;
+    int numTestDofs = testOrder->totalDofs();
+    int numTrialDofs = trialOrder->totalDofs();
+    if ((numTrialDofs != stiffnessEnriched.dimension(1)) || (numTestDofs != stiffnessEnriched.dimension(2)))
+    {
+      cout << "localStiffness should have dimensions (C,numTestFields,numTrialFields).\n";
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffness should have dimensions (C,numTrialFields,numTestFields).");
+    }
+    
+    if (printTimings)
+    {
+      cout << "numCells: " << numCells << endl;
+      cout << "numTestDofs: " << numTestDofs << endl;
+      cout << "numTrialDofs: " << numTrialDofs << endl;
+    }
+    
+    timer.ResetStartTime();
+    FieldContainer<double> cellSideParities = basisCache->getCellSideParities();
+    
+    if (ip == Teuchos::null)
+    {
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "BF: ip is null in localStiffnessMatrixAndRHS_DLS (for which we can't do Bubnov-Galerkin).");
+    }
+    else
+    {
+      int numCells = basisCache->getPhysicalCubaturePoints().dimension(0);
       int numTestDofs = testOrder->totalDofs();
       int numTrialDofs = trialOrder->totalDofs();
-      if ((numTrialDofs != stiffnessEnriched.dimension(1)) || (numTestDofs != stiffnessEnriched.dimension(2)))
-      {
-        cout << "localStiffness should have dimensions (C,numTestFields,numTrialFields).\n";
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffness should have dimensions (C,numTrialFields,numTestFields).");
-      }
       
-      if (printTimings)
-      {
-        cout << "numCells: " << numCells << endl;
-        cout << "numTestDofs: " << numTestDofs << endl;
-        cout << "numTrialDofs: " << numTrialDofs << endl;
-      }
+      Epetra_Time timer(*MPIWrapper::CommSerial());
+      
+      double timeG, timeB, timeT, timeK; // time to compute Gram matrix, the right-hand side B, time to solve GT = B, and time to compute K = B^T T.
       
       timer.ResetStartTime();
-      FieldContainer<double> cellSideParities = basisCache->getCellSideParities();
+      // RHS:
+      this->stiffnessMatrix(stiffnessEnriched, elemType, cellSideParities, basisCache, true, true);
+      timeB = timer.ElapsedTime();
       
-      if (ip == Teuchos::null)
-      {
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "BF: ip is null in localStiffnessMatrixAndRHS_DLS (for which we can't do Bubnov-Galerkin).");
-      }
-      else
+      Teuchos::Array<int> localIPDim(2);
+      localIPDim[0] = numTestDofs;
+      localIPDim[1] = numTestDofs;
+      Teuchos::Array<int> localStiffnessEnrichedDim(2);
+      localStiffnessEnrichedDim[0] = stiffnessEnriched.dimension(1);
+      localStiffnessEnrichedDim[1] = stiffnessEnriched.dimension(2);
+      
+      FieldContainer<Scalar> ipMatrix(numCells,numTestDofs,numTestDofs);
+      DofOrderingPtr testOrder = elemType->testOrderPtr;
+      timer.ResetStartTime();
+      ip->computeInnerProductMatrix(ipMatrix, testOrder, ipBasisCache);
+      timeG = timer.ElapsedTime();
+      
+      rhs->integrateAgainstStandardBasis(rhsEnriched,testOrder,basisCache);
+      
+      Teuchos::Array<int> localRHSEnrichedDim(2);
+      localRHSEnrichedDim[0] = rhsEnriched.dimension(1);
+      localRHSEnrichedDim[1] = 1;
+      
+      Teuchos::Array<int> localRHSDim(2);
+      localRHSDim[0] = numTrialDofs;
+      localRHSDim[1] = 1;
+      
+      timeT = 0;
+      timeK = 0;
+      timer.ResetStartTime();
+      
+      FieldContainer<Scalar> dummyStiffness(numTrialDofs,numTrialDofs); // computed in factoredCholeskySolve, but ignored
+      FieldContainer<Scalar> dummyRHS(numTrialDofs,1); // computed in factoredCholeskySolve, but ignored
+      for (int cellIndex=0; cellIndex < numCells; cellIndex++)
       {
-        int numCells = basisCache->getPhysicalCubaturePoints().dimension(0);
-        int numTestDofs = testOrder->totalDofs();
-        int numTrialDofs = trialOrder->totalDofs();
-        
-        Epetra_Time timer(*MPIWrapper::CommSerial());
-        
-        double timeG, timeB, timeT, timeK; // time to compute Gram matrix, the right-hand side B, time to solve GT = B, and time to compute K = B^T T.
-        
-        timer.ResetStartTime();
-        // RHS:
-        this->stiffnessMatrix(stiffnessEnriched, elemType, cellSideParities, basisCache, true, true);
-        timeB = timer.ElapsedTime();
-        
-        Teuchos::Array<int> localIPDim(2);
-        localIPDim[0] = numTestDofs;
-        localIPDim[1] = numTestDofs;
-        Teuchos::Array<int> localStiffnessEnrichedDim(2);
-        localStiffnessEnrichedDim[0] = stiffnessEnriched.dimension(1);
-        localStiffnessEnrichedDim[1] = stiffnessEnriched.dimension(2);
-        
-        FieldContainer<Scalar> ipMatrix(numCells,numTestDofs,numTestDofs);
-        DofOrderingPtr testOrder = elemType->testOrderPtr;
-        timer.ResetStartTime();
-        ip->computeInnerProductMatrix(ipMatrix, testOrder, ipBasisCache);
-        timeG = timer.ElapsedTime();
-        
-        rhs->integrateAgainstStandardBasis(rhsEnriched,testOrder,basisCache);
-        
-        Teuchos::Array<int> localRHSEnrichedDim(2);
-        localRHSEnrichedDim[0] = rhsEnriched.dimension(1);
-        localRHSEnrichedDim[1] = 1;
-        
-        Teuchos::Array<int> localRHSDim(2);
-        localRHSDim[0] = numTrialDofs;
-        localRHSDim[1] = 1;
-        
-        timeT = 0;
-        timeK = 0;
-        timer.ResetStartTime();
-        
-        FieldContainer<Scalar> dummyStiffness(numTrialDofs,numTrialDofs); // computed in factoredCholeskySolve, but ignored
-        FieldContainer<Scalar> dummyRHS(numTrialDofs,1); // computed in factoredCholeskySolve, but ignored
-        for (int cellIndex=0; cellIndex < numCells; cellIndex++)
-        {
-          int result = 0;
-          FieldContainer<Scalar> cellIPMatrix(localIPDim, &ipMatrix(cellIndex,0,0));
-          FieldContainer<Scalar> cellStiffnessEnriched(localStiffnessEnrichedDim, &stiffnessEnriched(cellIndex,0,0));
-          FieldContainer<Scalar> cellRHSEnriched(localRHSEnrichedDim, &rhsEnriched(cellIndex,0));
-          
-          result = factoredCholeskySolve(cellIPMatrix, cellStiffnessEnriched, cellRHSEnriched, dummyStiffness, dummyRHS);
-        }
-        timeK = timer.ElapsedTime();
+        int result = 0;
+        FieldContainer<Scalar> cellIPMatrix(localIPDim, &ipMatrix(cellIndex,0,0));
+        FieldContainer<Scalar> cellStiffnessEnriched(localStiffnessEnrichedDim, &stiffnessEnriched(cellIndex,0,0));
+        FieldContainer<Scalar> cellRHSEnriched(localRHSEnrichedDim, &rhsEnriched(cellIndex,0));
         
-        if (_optimalTestTimingCallback)
-        {
-          _optimalTestTimingCallback(numCells,timeG,timeB,timeT,timeK,elemType);
-        }
+        result = factoredCholeskySolve(cellIPMatrix, cellStiffnessEnriched, cellRHSEnriched, dummyStiffness, dummyRHS);
       }
+      timeK = timer.ElapsedTime();
       
-      if (_rhsTimingCallback)
+      if (_optimalTestTimingCallback)
       {
-        _rhsTimingCallback(numCells,rhsDeterminationTime,elemType);
+        _optimalTestTimingCallback(numCells,timeG,timeB,timeT,timeK,elemType);
       }
     }
-    else
+    
+    if (_rhsTimingCallback)
     {
-      // 1. set up a (serial) Mesh for IP.  Ultimately, can/should cache these (one per ElementType), and simply relabel the vertices
-      // 2. set up a SerialComm-based dof Epetra_Map (Tpetra_Map?), and create FECrsMatrix and RHSVector
-      // 3. Fill both LHS and RHS using appropriate LinearTerms.
-      // 4. Solve.  (Direct solver to start, but ultimately, I want to try GMG.  Can reuse the prolongation operator, too.)
-      // 5. Compute the local stiffness matrix and RHS.
-      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Subgrid mesh optimal test solve implementation not yet complete!");
+      _rhsTimingCallback(numCells,rhsDeterminationTime,elemType);
     }
     
     TimeLogger::sharedInstance()->stopTimer(timerHandle);
@@ -1210,173 +1211,180 @@ namespace Camellia
     Epetra_Time timer(*MPIWrapper::CommSerial());
     bool printTimings = false;
 
-    if (! _useSubgridMeshForOptimalTestSolve)
+    // localStiffness should have dim. (numCells, numTrialFields, numTrialFields)
+    MeshPtr mesh = basisCache->mesh();
+    if (mesh.get() == NULL)
     {
-      // localStiffness should have dim. (numCells, numTrialFields, numTrialFields)
-      MeshPtr mesh = basisCache->mesh();
-      if (mesh.get() == NULL)
-      {
-        cout << "localStiffnessMatrix requires BasisCache to have mesh set.\n";
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires BasisCache to have mesh set.");
-      }
-      const vector<GlobalIndexType>* cellIDs = &basisCache->cellIDs();
-      int numCells = cellIDs->size();
-      if (numCells != localStiffness.dimension(0))
-      {
-        cout << "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness\n";
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness");
-      }
+      cout << "localStiffnessMatrix requires BasisCache to have mesh set.\n";
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires BasisCache to have mesh set.");
+    }
+    const vector<GlobalIndexType>* cellIDs = &basisCache->cellIDs();
+    int numCells = cellIDs->size();
+    if (numCells != localStiffness.dimension(0))
+    {
+      cout << "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness\n";
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffnessMatrix requires basisCache->cellIDs() to have the same # of cells as the first dimension of localStiffness");
+    }
+    
+    ElementTypePtr elemType = mesh->getElementType((*cellIDs)[0]); // we assume all cells provided are of the same type
+    DofOrderingPtr trialOrder = elemType->trialOrderPtr;
+    DofOrderingPtr testOrder = elemType->testOrderPtr;
+    int numTestDofs = testOrder->totalDofs();
+    int numTrialDofs = trialOrder->totalDofs();
+    if ((numTrialDofs != localStiffness.dimension(1)) || (numTrialDofs != localStiffness.dimension(2)))
+    {
+      cout << "localStiffness should have dimensions (C,numTrialFields,numTrialFields).\n";
+      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffness should have dimensions (C,numTrialFields,numTrialFields).");
+    }
+    
+    if (printTimings)
+    {
+      cout << "numCells: " << numCells << endl;
+      cout << "numTestDofs: " << numTestDofs << endl;
+      cout << "numTrialDofs: " << numTrialDofs << endl;
+    }
+    
+    timer.ResetStartTime();
+    FieldContainer<double> cellSideParities = basisCache->getCellSideParities();
+
+    if (ip == Teuchos::null)
+    {
+      // can we interpret as a Bubnov-Galerkin setting?
+      TEUCHOS_TEST_FOR_EXCEPTION(numTestDofs != numTrialDofs, std::invalid_argument, "BF: ip is null, but the number of test dofs is different from the number of trial dofs (can't do Bubnov-Galerkin).");
+      this->stiffnessMatrix(localStiffness, elemType, cellSideParities, basisCache);
       
-      ElementTypePtr elemType = mesh->getElementType((*cellIDs)[0]); // we assume all cells provided are of the same type
-      DofOrderingPtr trialOrder = elemType->trialOrderPtr;
-      DofOrderingPtr testOrder = elemType->testOrderPtr;
-      int numTestDofs = testOrder->totalDofs();
-      int numTrialDofs = trialOrder->totalDofs();
-      if ((numTrialDofs != localStiffness.dimension(1)) || (numTrialDofs != localStiffness.dimension(2)))
+      // the above stores in (trial, test) order; we want (test, trial) -- so we transpose cell-wise:
+      Teuchos::Array<int> dim;
+      dim.push_back(numTrialDofs);
+      dim.push_back(numTrialDofs);
+      
+      for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
       {
-        cout << "localStiffness should have dimensions (C,numTrialFields,numTrialFields).\n";
-        TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "localStiffness should have dimensions (C,numTrialFields,numTrialFields).");
+        FieldContainer<double> cellLocalStiffness(dim, &localStiffness(cellOrdinal,0,0));
+        SerialDenseWrapper::transposeSquareMatrix(cellLocalStiffness); // transposes data in place
       }
       
-      if (printTimings)
+      localStiffnessDeterminationTime += timer.ElapsedTime();
+      // "timeB" is basically the localStiffnessDeterminationTime
+      if (_optimalTestTimingCallback)
       {
-        cout << "numCells: " << numCells << endl;
-        cout << "numTestDofs: " << numTestDofs << endl;
-        cout << "numTrialDofs: " << numTrialDofs << endl;
+        _optimalTestTimingCallback(numCells,0,localStiffnessDeterminationTime,0,0,elemType);
       }
       
       timer.ResetStartTime();
-      FieldContainer<double> cellSideParities = basisCache->getCellSideParities();
-
-      if (ip == Teuchos::null)
+      rhs->integrateAgainstStandardBasis(rhsVector, testOrder, basisCache);
+      rhsDeterminationTime += timer.ElapsedTime();
+    }
+    else if ((_optimalTestSolver == FACTORED_CHOLESKY) && _useStiffnessReuseForSimilarCells
+             && stiffnessReuseApplies(ip, ipBasisCache, basisCache))
+    {
+      timer.ResetStartTime();
+      localStiffnessMatrixAndRHSReusingSimilarCells(localStiffness, rhsVector, ip, ipBasisCache, rhs, basisCache, elemType);
+      localStiffnessDeterminationTime += timer.ElapsedTime();
+    }
+    else if ((_optimalTestSolver == SUBGRID) && SubgridTestSpace::supportsCells(basisCache))
+    {
+      timer.ResetStartTime();
+      subgridTestSpace(elemType)->localStiffnessMatrixAndRHS(localStiffness, rhsVector, _terms, ip, rhs->linearTerm(),
+                                                             trialOrder, basisCache);
+      localStiffnessDeterminationTime += timer.ElapsedTime();
+      if (_optimalTestTimingCallback)
       {
-        // can we interpret as a Bubnov-Galerkin setting?
-        TEUCHOS_TEST_FOR_EXCEPTION(numTestDofs != numTrialDofs, std::invalid_argument, "BF: ip is null, but the number of test dofs is different from the number of trial dofs (can't do Bubnov-Galerkin).");
-        this->stiffnessMatrix(localStiffness, elemType, cellSideParities, basisCache);
-        
-        // the above stores in (trial, test) order; we want (test, trial) -- so we transpose cell-wise:
-        Teuchos::Array<int> dim;
-        dim.push_back(numTrialDofs);
-        dim.push_back(numTrialDofs);
-        
-        for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
-        {
-          FieldContainer<double> cellLocalStiffness(dim, &localStiffness(cellOrdinal,0,0));
-          SerialDenseWrapper::transposeSquareMatrix(cellLocalStiffness); // transposes data in place
-        }
-        
-        localStiffnessDeterminationTime += timer.ElapsedTime();
-        // "timeB" is basically the localStiffnessDeterminationTime
-        if (_optimalTestTimingCallback)
-        {
-          _optimalTestTimingCallback(numCells,0,localStiffnessDeterminationTime,0,0,elemType);
-        }
-        
-        timer.ResetStartTime();
-        rhs->integrateAgainstStandardBasis(rhsVector, testOrder, basisCache);
-        rhsDeterminationTime += timer.ElapsedTime();
+        _optimalTestTimingCallback(numCells,0,0,localStiffnessDeterminationTime,0,elemType);
       }
-      else if (_optimalTestSolver == FACTORED_CHOLESKY)
+    }
+    else if ((_optimalTestSolver == FACTORED_CHOLESKY) || (_optimalTestSolver == SUBGRID))
+    {
+      // SUBGRID falls back to FACTORED_CHOLESKY on cells that SubgridTestSpace does not support
+      int numCells = basisCache->getPhysicalCubaturePoints().dimension(0);
+      int numTestDofs = testOrder->totalDofs();
+      int numTrialDofs = trialOrder->totalDofs();
+      
+      Epetra_Time timer(*MPIWrapper::CommSerial());
+      
+      double timeG, timeB, timeT, timeK; // time to compute Gram matrix, the right-hand side B, time to solve GT = B, and time to compute K = B^T T.
+      
+      FieldContainer<Scalar> stiffnessEnriched(numCells,numTrialDofs,numTestDofs);
+      
+      timer.ResetStartTime();
+      // RHS:
+      this->stiffnessMatrix(stiffnessEnriched, elemType, cellSideParities, basisCache, true, true);
+      timeB = timer.ElapsedTime();
+      
+      Teuchos::Array<int> localIPDim(2);
+      localIPDim[0] = numTestDofs;
+      localIPDim[1] = numTestDofs;
+      Teuchos::Array<int> localStiffnessEnrichedDim(2);
+      localStiffnessEnrichedDim[0] = stiffnessEnriched.dimension(1);
+      localStiffnessEnrichedDim[1] = stiffnessEnriched.dimension(2);
+      Teuchos::Array<int> localStiffnessDim(2);
+      localStiffnessDim[0] = localStiffness.dimension(1);
+      localStiffnessDim[1] = localStiffness.dimension(2);
+      
+      FieldContainer<Scalar> ipMatrix(numCells,numTestDofs,numTestDofs);
+      DofOrderingPtr testOrder = elemType->testOrderPtr;
+      timer.ResetStartTime();
+      ip->computeInnerProductMatrix(ipMatrix, testOrder, ipBasisCache);
+      timeG = timer.ElapsedTime();
+      
+      FieldContainer<Scalar> rhsEnriched(numCells,numTestDofs);
+      rhs->integrateAgainstStandardBasis(rhsEnriched,testOrder,basisCache);
+      
+      Teuchos::Array<int> localRHSEnrichedDim(2);
+      localRHSEnrichedDim[0] = rhsEnriched.dimension(1);
+      localRHSEnrichedDim[1] = 1;
+      
+      Teuchos::Array<int> localRHSDim(2);
+      localRHSDim[0] = numTrialDofs;
+      localRHSDim[1] = 1;
+      
+      timeT = 0;
+      timeK = 0;
+      timer.ResetStartTime();
+      for (int cellIndex=0; cellIndex < numCells; cellIndex++)
       {
-        int numCells = basisCache->getPhysicalCubaturePoints().dimension(0);
-        int numTestDofs = testOrder->totalDofs();
-        int numTrialDofs = trialOrder->totalDofs();
-        
-        Epetra_Time timer(*MPIWrapper::CommSerial());
-        
-        double timeG, timeB, timeT, timeK; // time to compute Gram matrix, the right-hand side B, time to solve GT = B, and time to compute K = B^T T.
-        
-        FieldContainer<Scalar> stiffnessEnriched(numCells,numTrialDofs,numTestDofs);
-        
-        timer.ResetStartTime();
-        // RHS:
-        this->stiffnessMatrix(stiffnessEnriched, elemType, cellSideParities, basisCache, true, true);
-        timeB = timer.ElapsedTime();
-        
-        Teuchos::Array<int> localIPDim(2);
-        localIPDim[0] = numTestDofs;
-        localIPDim[1] = numTestDofs;
-        Teuchos::Array<int> localStiffnessEnrichedDim(2);
-        localStiffnessEnrichedDim[0] = stiffnessEnriched.dimension(1);
-        localStiffnessEnrichedDim[1] = stiffnessEnriched.dimension(2);
-        Teuchos::Array<int> localStiffnessDim(2);
-        localStiffnessDim[0] = localStiffness.dimension(1);
-        localStiffnessDim[1] = localStiffness.dimension(2);
-        
-        FieldContainer<Scalar> ipMatrix(numCells,numTestDofs,numTestDofs);
-        DofOrderingPtr testOrder = elemType->testOrderPtr;
-        timer.ResetStartTime();
-        ip->computeInnerProductMatrix(ipMatrix, testOrder, ipBasisCache);
-        timeG = timer.ElapsedTime();
-        
-        FieldContainer<Scalar> rhsEnriched(numCells,numTestDofs);
-        rhs->integrateAgainstStandardBasis(rhsEnriched,testOrder,basisCache);
-        
-        Teuchos::Array<int> localRHSEnrichedDim(2);
-        localRHSEnrichedDim[0] = rhsEnriched.dimension(1);
-        localRHSEnrichedDim[1] = 1;
-        
-        Teuchos::Array<int> localRHSDim(2);
-        localRHSDim[0] = numTrialDofs;
-        localRHSDim[1] = 1;
-        
-        timeT = 0;
-        timeK = 0;
-        timer.ResetStartTime();
-        for (int cellIndex=0; cellIndex < numCells; cellIndex++)
-        {
-          int result = 0;
-          FieldContainer<Scalar> cellIPMatrix(localIPDim, &ipMatrix(cellIndex,0,0));
-          FieldContainer<Scalar> cellStiffnessEnriched(localStiffnessEnrichedDim, &stiffnessEnriched(cellIndex,0,0));
-          FieldContainer<Scalar> cellStiffness(localStiffnessDim, &localStiffness(cellIndex,0,0));
-          FieldContainer<Scalar> cellRHSEnriched(localRHSEnrichedDim, &rhsEnriched(cellIndex,0));
-          FieldContainer<Scalar> cellRHS(localRHSDim, &rhsVector(cellIndex,0));
+        int result = 0;
+        FieldContainer<Scalar> cellIPMatrix(localIPDim, &ipMatrix(cellIndex,0,0));
+        FieldContainer<Scalar> cellStiffnessEnriched(localStiffnessEnrichedDim, &stiffnessEnriched(cellIndex,0,0));
+        FieldContainer<Scalar> cellStiffness(localStiffnessDim, &localStiffness(cellIndex,0,0));
+        FieldContainer<Scalar> cellRHSEnriched(localRHSEnrichedDim, &rhsEnriched(cellIndex,0));
+        FieldContainer<Scalar> cellRHS(localRHSDim, &rhsVector(cellIndex,0));
 
-          result = factoredCholeskySolve(cellIPMatrix, cellStiffnessEnriched, cellRHSEnriched, cellStiffness, cellRHS);
-        }
-        timeK = timer.ElapsedTime();
-        
-        if (_optimalTestTimingCallback)
-        {
-          _optimalTestTimingCallback(numCells,timeG,timeB,timeT,timeK,elemType);
-        }
+        result = factoredCholeskySolve(cellIPMatrix, cellStiffnessEnriched, cellRHSEnriched, cellStiffness, cellRHS);
       }
-      else
+      timeK = timer.ElapsedTime();
+      
+      if (_optimalTestTimingCallback)
       {
-        //      cout << "ipMatrix:\n" << ipMatrix;
-        
-        timer.ResetStartTime();
-        FieldContainer<Scalar> optTestCoeffs(numCells,numTrialDofs,numTestDofs);
-        
-        int optSuccess = this->optimalTestWeightsAndStiffness(optTestCoeffs, localStiffness, elemType,
-                                                              cellSideParities, basisCache, ip, ipBasisCache);
-
-        localStiffnessDeterminationTime += timer.ElapsedTime();
-        //      cout << "optTestCoeffs:\n" << optTestCoeffs;
-        
-        if ( optSuccess != 0 )
-        {
-          cout << "**** WARNING: in BilinearForm::localStiffnessMatrixAndRHS(), optimal test function computation failed with error code " << optSuccess << ". ****\n";
-        }
-        
-        timer.ResetStartTime();
-        rhs->integrateAgainstOptimalTests(rhsVector, optTestCoeffs, testOrder, basisCache);
-        rhsDeterminationTime += timer.ElapsedTime();
+        _optimalTestTimingCallback(numCells,timeG,timeB,timeT,timeK,elemType);
       }
+    }
+    else
+    {
+      //      cout << "ipMatrix:\n" << ipMatrix;
+      
+      timer.ResetStartTime();
+      FieldContainer<Scalar> optTestCoeffs(numCells,numTrialDofs,numTestDofs);
+      
+      int optSuccess = this->optimalTestWeightsAndStiffness(optTestCoeffs, localStiffness, elemType,
+                                                            cellSideParities, basisCache, ip, ipBasisCache);
+
+      localStiffnessDeterminationTime += timer.ElapsedTime();
+      //      cout << "optTestCoeffs:\n" << optTestCoeffs;
       
-      if (_rhsTimingCallback)
+      if ( optSuccess != 0 )
       {
-        _rhsTimingCallback(numCells,rhsDeterminationTime,elemType);
+        cout << "**** WARNING: in BilinearForm::localStiffnessMatrixAndRHS(), optimal test function computation failed with error code " << optSuccess << ". ****\n";
       }
+      
+      timer.ResetStartTime();
+      rhs->integrateAgainstOptimalTests(rhsVector, optTestCoeffs, testOrder, basisCache);
+      rhsDeterminationTime += timer.ElapsedTime();
     }
-    else
+    
+    if (_rhsTimingCallback)
     {
-      // 1. set up a (serial) Mesh for IP.  Ultimately, can/should cache these (one per ElementType), and simply relabel the vertices
-      // 2. set up a SerialComm-based dof Epetra_Map (Tpetra_Map?), and create FECrsMatrix and RHSVector
-      // 3. Fill both LHS and RHS using appropriate LinearTerms.
-      // 4. Solve.  (Direct solver to start, but ultimately, I want to try GMG.  Can reuse the prolongation operator, too.)
-      // 5. Compute the local stiffness matrix and RHS.
-      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Subgrid mesh optimal test solve implementation not yet complete!");
+      _rhsTimingCallback(numCells,rhsDeterminationTime,elemType);
     }
     
     TimeLogger::sharedInstance()->stopTimer(timerHandle);
@@ -1593,7 +1601,10 @@ namespace Camellia
   template <typename Scalar>
   void TBF<Scalar>::setUseSubgridMeshForOptimalTestFunctions(bool value)
   {
-    _useSubgridMeshForOptimalTestSolve = value;
+    if (value)
+      _optimalTestSolver = SUBGRID;
+    else if (_optimalTestSolver == SUBGRID)
+      _optimalTestSolver = FACTORED_CHOLESKY;
   }
   
   template <typename Scalar>
@@ -1608,6 +1619,269 @@ namespace Camellia
     _warnAboutZeroRowsAndColumns = value;
   }
   
+  template <typename Scalar>
+  void TBF<Scalar>::setUseStiffnessReuseForSimilarCells(bool value)
+  {
+    _useStiffnessReuseForSimilarCells = value;
+    if (!value) clearSimilarCellCache();
+  }
+  
+  template <typename Scalar>
+  bool TBF<Scalar>::useStiffnessReuseForSimilarCells() const
+  {
+    return _useStiffnessReuseForSimilarCells;
+  }
+  
+  template <typename Scalar>
+  int TBF<Scalar>::similarCellHitCount() const
+  {
+    return _similarCellHitCount;
+  }
+  
+  template <typename Scalar>
+  int TBF<Scalar>::similarCellMissCount() const
+  {
+    return _similarCellMissCount;
+  }
+  
+  template <typename Scalar>
+  void TBF<Scalar>::clearSimilarCellCache()
+  {
+    _similarCellFactors.clear();
+    _similarCellFactorsIP = Teuchos::null;
+  }
+  
+  template <typename Scalar>
+  Teuchos::RCP<SubgridTestSpace> TBF<Scalar>::subgridTestSpace(ElementTypePtr elemType)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(_isLegacySubclass, std::invalid_argument, "the SUBGRID optimal test solver requires a VarFactory-based BF");
+    // subcells have half the width of the element, so we halve the test degree
+    int testDegree = elemType->testOrderPtr->maxBasisDegree();
+    int subcellH1Order = max(1, (testDegree + 1) / 2);
+    pair<CellTopologyKey,int> key = {elemType->cellTopoPtr->getKey(), subcellH1Order};
+    if (_subgridTestSpaces.find(key) == _subgridTestSpaces.end())
+    {
+      _subgridTestSpaces[key] = Teuchos::rcp( new SubgridTestSpace(elemType->cellTopoPtr, _varFactory, subcellH1Order) );
+    }
+    return _subgridTestSpaces[key];
+  }
+  
+  template <typename Scalar>
+  bool TBF<Scalar>::stiffnessReuseApplies(TIPPtr<Scalar> ip, BasisCachePtr ipBasisCache, BasisCachePtr basisCache)
+  {
+    if (_isLegacySubclass) return false;
+    if (!basisCache->usesAffineGeometry() || !ipBasisCache->usesAffineGeometry()) return false;
+    if (basisCache->getRefCellPoints().dimension(0) == 0) return false;
+    if (!ip->hasTranslationInvariantWeights()) return false;
+    for (const TBilinearTerm<Scalar> &term : _terms)
+    {
+      if (!term.first->hasTranslationInvariantWeights() || !term.second->hasTranslationInvariantWeights()) return false;
+    }
+    return true;
+  }
+  
+  template <typename Scalar>
+  void TBF<Scalar>::localStiffnessMatrixAndRHSReusingSimilarCells(FieldContainer<Scalar> &localStiffness, FieldContainer<Scalar> &rhsVector,
+                                                                   TIPPtr<Scalar> ip, BasisCachePtr ipBasisCache,
+                                                                   TRHSPtr<Scalar> rhs, BasisCachePtr basisCache, ElementTypePtr elemType)
+  {
+    if (_similarCellFactorsIP.get() != ip.get())
+    {
+      _similarCellFactors.clear();
+      _similarCellFactorsIP = ip;
+    }
+    
+    DofOrderingPtr testOrder = elemType->testOrderPtr;
+    int numCells = basisCache->cellIDs().size();
+    int numTestDofs = testOrder->totalDofs();
+    int numTrialDofs = elemType->trialOrderPtr->totalDofs();
+    
+    // the load is computed for every cell
+    FieldContainer<Scalar> rhsEnriched(numCells,numTestDofs);
+    rhs->integrateAgainstStandardBasis(rhsEnriched,testOrder,basisCache);
+    
+    // key each cell by its (constant) Jacobian and side parities
+    FieldContainer<double> cellSideParities = basisCache->getCellSideParities();
+    const FieldContainer<double>* jacobian = &basisCache->getJacobian();
+    int cellDim = jacobian->dimension(2);
+    int numSides = cellSideParities.dimension(1);
+    const double JACOBIAN_RELATIVE_TOL = 1e-12;
+    
+    // the same BF may be used with different cubature (e.g. on GMG levels), so the cubature is part of the key
+    vector<long> cubatureKey = {basisCache->cubatureDegree(), basisCache->getRefCellPoints().dimension(0),
+                                ipBasisCache->cubatureDegree(), ipBasisCache->getRefCellPoints().dimension(0)};
+    
+    vector<SimilarCellKey> cellKeys(numCells);
+    vector<int> representativeCells; // one cell per key that we have not seen before; these get the full computation
+    map<SimilarCellKey, int> representativeOrdinals;
+    for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+    {
+      double jacobianScale = 0;
+      for (int d1=0; d1<cellDim; d1++)
+      {
+        for (int d2=0; d2<cellDim; d2++)
+        {
+          jacobianScale = max(jacobianScale, abs((*jacobian)(cellOrdinal,0,d1,d2)));
+        }
+      }
+      double quantum = JACOBIAN_RELATIVE_TOL * jacobianScale;
+      SimilarCellKey key;
+      key.elemType = elemType;
+      key.values = cubatureKey;
+      for (int d1=0; d1<cellDim; d1++)
+      {
+        for (int d2=0; d2<cellDim; d2++)
+        {
+          key.values.push_back(llround((*jacobian)(cellOrdinal,0,d1,d2) / quantum));
+        }
+      }
+      for (int sideOrdinal=0; sideOrdinal<numSides; sideOrdinal++)
+      {
+        key.values.push_back(lround(cellSideParities(cellOrdinal,sideOrdinal)));
+      }
+      if ((_similarCellFactors.find(key) == _similarCellFactors.end()) && (representativeOrdinals.find(key) == representativeOrdinals.end()))
+      {
+        representativeOrdinals[key] = representativeCells.size();
+        representativeCells.push_back(cellOrdinal);
+      }
+      cellKeys[cellOrdinal] = key;
+    }
+    
+    int numRepresentatives = representativeCells.size();
+    vector<SimilarCellFactors> representativeFactors(numRepresentatives);
+    if (numRepresentatives > 0)
+    {
+      // compute Gram and enriched stiffness matrices only for the representative cells, restricting the BasisCaches to these
+      bool restrictCaches = (numRepresentatives < numCells);
+      FieldContainer<double> physicalCellNodes = basisCache->getPhysicalCellNodes();
+      vector<GlobalIndexType> cellIDs = basisCache->cellIDs();
+      FieldContainer<double> ipCellSideParities = ipBasisCache->getCellSideParities();
+      FieldContainer<double> representativeParities = cellSideParities;
+      if (restrictCaches)
+      {
+        int numNodes = physicalCellNodes.dimension(1);
+        int spaceDim = physicalCellNodes.dimension(2);
+        FieldContainer<double> representativeNodes(numRepresentatives,numNodes,spaceDim);
+        representativeParities.resize(numRepresentatives,numSides);
+        vector<GlobalIndexType> representativeCellIDs(numRepresentatives);
+        for (int repOrdinal=0; repOrdinal<numRepresentatives; repOrdinal++)
+        {
+          int cellOrdinal = representativeCells[repOrdinal];
+          representativeCellIDs[repOrdinal] = cellIDs[cellOrdinal];
+          for (int node=0; node<numNodes; node++)
+          {
+            for (int d=0; d<spaceDim; d++)
+            {
+              representativeNodes(repOrdinal,node,d) = physicalCellNodes(cellOrdinal,node,d);
+            }
+          }
+          for (int sideOrdinal=0; sideOrdinal<numSides; sideOrdinal++)
+          {
+            representativeParities(repOrdinal,sideOrdinal) = cellSideParities(cellOrdinal,sideOrdinal);
+          }
+        }
+        bool createSideCache = true; // side caches are built lazily, so this costs nothing if they aren't used
+        basisCache->setPhysicalCellNodes(representativeNodes, representativeCellIDs, createSideCache);
+        basisCache->setCellSideParities(representativeParities);
+        ipBasisCache->setPhysicalCellNodes(representativeNodes, representativeCellIDs, createSideCache);
+        ipBasisCache->setCellSideParities(representativeParities);
+      }
+      
+      FieldContainer<Scalar> stiffnessEnriched(numRepresentatives,numTrialDofs,numTestDofs);
+      this->stiffnessMatrix(stiffnessEnriched, elemType, representativeParities, basisCache, true, true);
+      FieldContainer<Scalar> ipMatrix(numRepresentatives,numTestDofs,numTestDofs);
+      ip->computeInnerProductMatrix(ipMatrix, testOrder, ipBasisCache);
+      
+      if (restrictCaches)
+      {
+        bool createSideCache = true;
+        basisCache->setPhysicalCellNodes(physicalCellNodes, cellIDs, createSideCache);
+        basisCache->setCellSideParities(cellSideParities);
+        ipBasisCache->setPhysicalCellNodes(physicalCellNodes, cellIDs, createSideCache);
+        if (ipCellSideParities.rank() == 2) ipBasisCache->setCellSideParities(ipCellSideParities);
+      }
+      
+      for (int repOrdinal=0; repOrdinal<numRepresentatives; repOrdinal++)
+      {
+        int cellOrdinal = representativeCells[repOrdinal];
+        SimilarCellFactors* factors = &representativeFactors[repOrdinal];
+        factors->gramFactor.resize(numTestDofs,numTestDofs);
+        factors->stiffnessEnrichedSolved.resize(numTrialDofs,numTestDofs);
+        factors->stiffness.resize(numTrialDofs,numTrialDofs);
+        for (int i=0; i<factors->gramFactor.size(); i++)
+        {
+          factors->gramFactor[i] = ipMatrix[repOrdinal * factors->gramFactor.size() + i];
+        }
+        for (int i=0; i<factors->stiffnessEnrichedSolved.size(); i++)
+        {
+          factors->stiffnessEnrichedSolved[i] = stiffnessEnriched[repOrdinal * factors->stiffnessEnrichedSolved.size() + i];
+        }
+        FieldContainer<Scalar> cellRHSEnriched(numTestDofs,1);
+        FieldContainer<Scalar> cellRHS(numTrialDofs,1);
+        for (int i=0; i<numTestDofs; i++)
+        {
+          cellRHSEnriched[i] = rhsEnriched(cellOrdinal,i);
+        }
+        int result = factoredCholeskySolve(factors->gramFactor, factors->stiffnessEnrichedSolved, cellRHSEnriched,
+                                           factors->stiffness, cellRHS);
+        if (result != 0)
+        {
+          cout << "**** WARNING: in BilinearForm::localStiffnessMatrixAndRHS(), factored Cholesky solve failed with error code " << result << ". ****\n";
+        }
+        for (int i=0; i<numTrialDofs; i++)
+        {
+          rhsVector(cellOrdinal,i) = cellRHS[i];
+        }
+        for (int i=0; i<factors->stiffness.size(); i++)
+        {
+          localStiffness[cellOrdinal * factors->stiffness.size() + i] = factors->stiffness[i];
+        }
+      }
+    }
+    
+    // copy the stiffness for the remaining cells, and compute their load using the stored factors
+    const int MAX_SIMILAR_CELL_CACHE_ENTRIES = 256;
+    FieldContainer<Scalar> cellRHSEnriched(numTestDofs,1);
+    FieldContainer<Scalar> cellRHS(numTrialDofs,1);
+    for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+    {
+      const SimilarCellKey* key = &cellKeys[cellOrdinal];
+      auto repEntry = representativeOrdinals.find(*key);
+      if ((repEntry != representativeOrdinals.end()) && (representativeCells[repEntry->second] == cellOrdinal))
+      {
+        _similarCellMissCount++;
+        continue; // already computed above
+      }
+      _similarCellHitCount++;
+      const SimilarCellFactors* factors;
+      if (repEntry != representativeOrdinals.end())
+        factors = &representativeFactors[repEntry->second];
+      else
+        factors = &_similarCellFactors[*key];
+      
+      for (int i=0; i<factors->stiffness.size(); i++)
+      {
+        localStiffness[cellOrdinal * factors->stiffness.size() + i] = factors->stiffness[i];
+      }
+      for (int i=0; i<numTestDofs; i++)
+      {
+        cellRHSEnriched[i] = rhsEnriched(cellOrdinal,i);
+      }
+      factoredCholeskyRHS(factors->gramFactor, factors->stiffnessEnrichedSolved, cellRHSEnriched, cellRHS);
+      for (int i=0; i<numTrialDofs; i++)
+      {
+        rhsVector(cellOrdinal,i) = cellRHS[i];
+      }
+    }
+    
+    // remember the new factors for later batches, up to a fixed number of entries
+    for (auto repEntry : representativeOrdinals)
+    {
+      if (_similarCellFactors.size() >= MAX_SIMILAR_CELL_CACHE_ENTRIES) break;
+      _similarCellFactors[repEntry.first] = representativeFactors[repEntry.second];
+    }
+  }
+  
   template <typename Scalar>
   TLinearTermPtr<Scalar> TBF<Scalar>::testFunctional(TSolutionPtr<Scalar> trialSolution, bool excludeBoundaryTerms, bool overrideMeshCheck,
                                                      int solutionOrdinal)
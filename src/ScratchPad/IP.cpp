@@ -361,6 +361,25 @@ bool TIP<Scalar>::hasBoundaryTerms()
   else return _boundaryTerms.size() > 0;
 }
 
+template <typename Scalar>
+bool TIP<Scalar>::hasTranslationInvariantWeights()
+{
+  if (_isLegacySubclass) return false;
+  for (TLinearTermPtr<Scalar> &term : _linearTerms)
+  {
+    if (!term->hasTranslationInvariantWeights()) return false;
+  }
+  for (TLinearTermPtr<Scalar> &term : _boundaryTerms)
+  {
+    if (!term->hasTranslationInvariantWeights()) return false;
+  }
+  for (TLinearTermPtr<Scalar> &term : _zeroMeanTerms)
+  {
+    if (!term->hasTranslationInvariantWeights()) return false;
+  }
+  return true;
+}
+
 // ! returns the number of potential nonzeros for the given trial ordering and test ordering
 template <typename Scalar>
 int TIP<Scalar>::nonZeroEntryCount(DofOrderingPtr testOrdering)
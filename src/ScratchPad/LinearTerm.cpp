@@ -11,8 +11,10 @@
 #include "MPIWrapper.h"
 #include "RieszRep.h"
 #include "SerialDenseWrapper.h"
+#include "SideParityFunction.h"
 #include "Solution.h"
 #include "TensorBasis.h"
+#include "UnitNormalFunction.h"
 
 #include "Epetra_CrsMatrix.h"
 #include "Intrepid_FunctionSpaceTools.hpp"
@@ -210,8 +212,6 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
 
   set<int> varIDs = this->varIDs();
 
-  int numCells  = basisCache->getPhysicalCubaturePoints().dimension(0);
-
   BasisPtr basis;
   bool thisFluxOrTrace  = (this->termType() == FLUX) || (this->termType() == TRACE);
   bool boundaryTerm = thisFluxOrTrace || forceBoundaryTerm || basisCache->isSideCache();
@@ -222,11 +222,8 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
   // we ONLY evaluate on the boundary; !boundaryTerm allows the possibility of "mixed-type" terms
   int numSides = basisCache->cellTopology()->getSideCount();
 
-  Teuchos::Array<int> ltValueDim;
-  ltValueDim.push_back(numCells);
-  ltValueDim.push_back(0); // # fields -- empty until we have a particular basis
-  ltValueDim.push_back(0); // # points -- empty until we know whether we're on side
-  Intrepid::FieldContainer<Scalar> ltValues;
+  // weight function values, shared across variables (keys include the basis cache)
+  map<pair<TFunction<Scalar>*,BasisCache*>, Intrepid::FieldContainer<Scalar>> functionValues;
 
   for (set<int>::iterator varIt = varIDs.begin(); varIt != varIDs.end(); varIt++)
   {
@@ -234,37 +231,18 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
     if (! boundaryTerm )
     {
       // first, compute volume integral
-      int numPoints = basisCache->getPhysicalCubaturePoints().dimension(1);
-
       const vector<int>* sidesForVar = &thisOrdering->getSidesForVarID(varID);
 
-      bool applyCubatureWeights = true;
-      int basisCardinality = -1;
       vector<int> varDofIndices;
+      bool applyFluxParity = false;
       
       if (sidesForVar->size() == 1)   // volume variable
       {
         varDofIndices = thisOrdering->getDofIndices(varID);
         
         basis = thisOrdering->getBasis(varID);
-        basisCardinality = basis->getCardinality();
-        ltValueDim[1] = basisCardinality;
-        ltValueDim[2] = numPoints;
-        ltValues.resize(ltValueDim);
-        this->values(ltValues, varID, basis, basisCache, applyCubatureWeights);
-
-        // compute integrals:
-        for (int cellIndex = 0; cellIndex<numCells; cellIndex++)
-        {
-          for (int basisOrdinal = 0; basisOrdinal < basisCardinality; basisOrdinal++)
-          {
-            int varDofIndex = varDofIndices[basisOrdinal];
-            for (int ptIndex = 0; ptIndex < numPoints; ptIndex++)
-            {
-              values(cellIndex,varDofIndex) += ltValues(cellIndex,basisOrdinal,ptIndex);
-            }
-          }
-        }
+        bool naturalBoundaryValuesOnly = false;
+        integrateVar(values, varDofIndices, varID, basis, basisCache, naturalBoundaryValuesOnly, applyFluxParity, functionValues);
       }
 
       // now, compute boundary integrals
@@ -278,26 +256,9 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
             if (! thisOrdering->hasBasisEntry(varID, sideIndex)) continue;
             varDofIndices = thisOrdering->getDofIndices(varID,sideIndex);
             basis = thisOrdering->getBasis(varID, sideIndex);
-            basisCardinality = basis->getCardinality();
-            ltValueDim[1] = basisCardinality;
           }
-          numPoints = sideBasisCache->getPhysicalCubaturePoints().dimension(1);
-          ltValueDim[2] = numPoints;
-          ltValues.resize(ltValueDim);
           bool naturalBoundaryValuesOnly = true; // don't restrict volume summands to boundary
-          this->values(ltValues, varID, basis, sideBasisCache, applyCubatureWeights, naturalBoundaryValuesOnly);
-          // compute integrals:
-          for (int cellIndex = 0; cellIndex<numCells; cellIndex++)
-          {
-            for (int basisOrdinal = 0; basisOrdinal < basisCardinality; basisOrdinal++)
-            {
-              int varDofIndex = varDofIndices[basisOrdinal];
-              for (int ptIndex = 0; ptIndex < numPoints; ptIndex++)
-              {
-                values(cellIndex,varDofIndex) += ltValues(cellIndex,basisOrdinal,ptIndex);
-              }
-            }
-          }
+          integrateVar(values, varDofIndices, varID, basis, sideBasisCache, naturalBoundaryValuesOnly, applyFluxParity, functionValues);
 
 //          bool DEBUGGING = true;
 //          if (DEBUGGING) {
@@ -351,8 +312,6 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
       }
       for (int sideOrdinal : sideOrdinals )
       {
-        int numPoints = volumeCache->getPhysicalCubaturePointsForSide(sideOrdinal).dimension(1);
-
         if (thisFluxOrTrace)
         {
           if (! thisOrdering->hasBasisEntry(varID, sideOrdinal)) continue;
@@ -363,32 +322,12 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
           basis = thisOrdering->getBasis(varID);
         }
 
-        int basisCardinality = basis->getCardinality();
-        ltValueDim[1] = basisCardinality;
-        ltValueDim[2] = numPoints;
-        ltValues.resize(ltValueDim);
         BasisCachePtr sideBasisCache = volumeCache->getSideBasisCache(sideOrdinal);
-        bool applyCubatureWeights = true;
         bool naturalBoundaryValuesOnly = false; // DO include volume summands restricted to boundary
-        this->values(ltValues, varID, basis, sideBasisCache, applyCubatureWeights, naturalBoundaryValuesOnly);
-        if ( this->termType() == FLUX )
-        {
-          multiplyFluxValuesByParity(ltValues, sideBasisCache);
-        }
+        bool applyFluxParity = ( this->termType() == FLUX );
         vector<int> varDofIndices = thisFluxOrTrace ? thisOrdering->getDofIndices(varID,sideOrdinal)
                                     : thisOrdering->getDofIndices(varID);
-        // compute integrals:
-        for (int cellIndex = 0; cellIndex<numCells; cellIndex++)
-        {
-          for (int basisOrdinal = 0; basisOrdinal < basisCardinality; basisOrdinal++)
-          {
-            int varDofIndex = varDofIndices[basisOrdinal];
-            for (int ptIndex = 0; ptIndex < numPoints; ptIndex++)
-            {
-              values(cellIndex,varDofIndex) += ltValues(cellIndex,basisOrdinal,ptIndex);
-            }
-          }
-        }
+        integrateVar(values, varDofIndices, varID, basis, sideBasisCache, naturalBoundaryValuesOnly, applyFluxParity, functionValues);
         //        bool DEBUGGING = true;
         //        if (DEBUGGING) {
         //          if (basisCache->cellIDs().size() > 0) {
@@ -415,6 +354,96 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
   }
 }
 
+template<typename Scalar>
+void TLinearTerm<Scalar>::integrateVar(Intrepid::FieldContainer<Scalar> &values, const vector<int> &varDofIndices, int varID, BasisPtr basis,
+                                       BasisCachePtr basisCache, bool naturalBoundaryTermsOnly, bool applyFluxParity,
+                                       map<pair<TFunction<Scalar>*,BasisCache*>, Intrepid::FieldContainer<Scalar>> &functionValues)
+{
+  int sideIndex = basisCache->getSideIndex();
+  int numCells = basisCache->getPhysicalCubaturePoints().dimension(0);
+  int numPoints = basisCache->getPhysicalCubaturePoints().dimension(1);
+  int numFields = basis->getCardinality();
+  int spaceDim = basisCache->getSpaceDim();
+  if (numCells * numPoints * numFields == 0) return;
+
+  // sum the weights of summands that share an operator; key is (op, useVolumeCoords)
+  map<pair<Camellia::EOperator,bool>, Intrepid::FieldContainer<Scalar>> combinedWeights;
+  for (TLinearSummand<Scalar> &ls : _summands)
+  {
+    if (ls.second->ID() != varID) continue;
+    // skip if this is a volume term, and we're only interested in the pure-boundary terms
+    if (naturalBoundaryTermsOnly && !linearSummandIsBoundaryValueOnly(ls)) continue;
+    // skip if this is a boundary term, and we're doing a volume integration:
+    if ((sideIndex == -1) && linearSummandIsBoundaryValueOnly(ls)) continue;
+    // skip if the function weighting this term can attest to being zero at each point in basisCache:
+    if (ls.first->isZero(basisCache)) continue;
+
+    TEUCHOS_TEST_FOR_EXCEPTION(ls.first->rank() != ls.second->rank(), std::invalid_argument,
+                               "integrate() requires a scalar-valued LinearTerm");
+
+    pair<TFunction<Scalar>*,BasisCache*> fxnKey = {ls.first.get(), basisCache.get()};
+    auto fxnValuesIt = functionValues.find(fxnKey);
+    if (fxnValuesIt == functionValues.end())
+    {
+      Teuchos::Array<int> fDim;
+      fDim.append(numCells);
+      fDim.append(numPoints);
+      for (int d=0; d<ls.first->rank(); d++)
+      {
+        fDim.append(spaceDim);
+      }
+      Intrepid::FieldContainer<Scalar> fValues(fDim);
+      ls.first->values(fValues, basisCache);
+      fxnValuesIt = functionValues.insert({fxnKey, fValues}).first;
+    }
+
+    // on sides, we use volume coords for test and field values
+    bool useVolumeCoords = (sideIndex != -1) && ((ls.second->varType() == TEST) || (ls.second->varType() == FIELD));
+    Intrepid::FieldContainer<Scalar>* weight = &combinedWeights[{ls.second->op(), useVolumeCoords}];
+    if (weight->size() == 0)
+    {
+      *weight = fxnValuesIt->second;
+    }
+    else
+    {
+      const Intrepid::FieldContainer<Scalar>* fValues = &fxnValuesIt->second;
+      for (int i=0; i<weight->size(); i++)
+      {
+        (*weight)[i] += (*fValues)[i];
+      }
+    }
+  }
+
+  // contract each combined weight against the weighted basis values: values(cell,field) += sum_{pt,comp} b(cell,field,pt,comp) * w(cell,pt,comp)
+  for (auto &entry : combinedWeights)
+  {
+    Camellia::EOperator op = entry.first.first;
+    bool useVolumeCoords = entry.first.second;
+    const Intrepid::FieldContainer<Scalar>* weight = &entry.second;
+    constFCPtr basisValues = basisCache->getTransformedWeightedValues(basis, op, useVolumeCoords);
+
+    int entriesPerField = weight->size() / numCells; // points times components
+    TEUCHOS_TEST_FOR_EXCEPTION(basisValues->size() != numCells * numFields * entriesPerField, std::invalid_argument,
+                               "Error: transformed basisValues doesn't have the correct # of points.");
+    for (int cellIndex=0; cellIndex<numCells; cellIndex++)
+    {
+      double parity = applyFluxParity ? basisCache->getVolumeBasisCache()->getCellSideParities()(cellIndex,sideIndex) : 1.0;
+      const Scalar* w = &(*weight)[cellIndex * entriesPerField];
+      const double* b = &(*basisValues)[cellIndex * numFields * entriesPerField];
+      for (int fieldIndex=0; fieldIndex<numFields; fieldIndex++)
+      {
+        Scalar integral = 0.0;
+        for (int i=0; i<entriesPerField; i++)
+        {
+          integral += b[i] * w[i];
+        }
+        values(cellIndex,varDofIndices[fieldIndex]) += parity * integral;
+        b += entriesPerField;
+      }
+    }
+  }
+}
+
 template<typename Scalar>
 void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values,
                                     TLinearTermPtr<Scalar> u, DofOrderingPtr uOrdering,
@@ -613,7 +642,7 @@ void TLinearTerm<Scalar>::integrate(Epetra_CrsMatrix* valuesCrsMatrix, Intrepid:
         }
         for (int j=0; j < vBasisCardinality; j++)
         {
-          vDofIndicesFC[j] = vDofIndicesFC[j];
+          vDofIndicesFC[j] = vDofIndices[j];
         }
         for (int i=0; i < uBasisCardinality; i++)
         {
@@ -763,6 +792,21 @@ void TLinearTerm<Scalar>::integrate(Intrepid::FieldContainer<Scalar> &values, Do
   }
   
   template<typename Scalar>
+  bool TLinearTerm<Scalar>::hasTranslationInvariantWeights() const
+  {
+    for (const TLinearSummand<Scalar> &ls : _summands)
+    {
+      TFunction<Scalar>* f = ls.first.get();
+      if (dynamic_cast<ConstantScalarFunction<Scalar>*>(f) != NULL) continue;
+      if (dynamic_cast<ConstantVectorFunction<Scalar>*>(f) != NULL) continue;
+      if (dynamic_cast<UnitNormalFunction*>(f) != NULL) continue;
+      if (dynamic_cast<SideParityFunction*>(f) != NULL) continue;
+      return false;
+    }
+    return true;
+  }
+  
+  template <typename Scalar>
   bool TLinearTerm<Scalar>::isPureVolumeTerm() const
   {
     for (typename vector< TLinearSummand<Scalar> >::const_iterator lsIt = _summands.begin(); lsIt != _summands.end(); lsIt++)
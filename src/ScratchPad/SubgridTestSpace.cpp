@@ -0,0 +1,435 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  SubgridTestSpace.cpp
+//  Camellia
+//
+
+#include "SubgridTestSpace.h"
+
+#include "BasisCache.h"
+#include "CamelliaCellTools.h"
+#include "Cell.h"
+#include "DofOrdering.h"
+#include "ElementType.h"
+#include "IP.h"
+#include "LinearTerm.h"
+#include "Mesh.h"
+#include "MeshTopology.h"
+#include "MPIWrapper.h"
+#include "RefinementPattern.h"
+#include "SerialDenseWrapper.h"
+#include "VarFactory.h"
+
+#include "Amesos2.hpp"
+
+#include "Epetra_CrsGraph.h"
+#include "Epetra_FECrsMatrix.h"
+#include "Epetra_LocalMap.h"
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+
+#include "Intrepid_FunctionSpaceTools.hpp"
+
+using namespace Camellia;
+using namespace Intrepid;
+using namespace std;
+
+namespace
+{
+  // maps points in the volume reference coordinates of cellTopo, lying on side sideOrdinal, to that side's reference coordinates.
+  // The sides of reference cells are affine images of their reference sides, so we invert that map by least squares.
+  void mapToSideReferenceCoordinates(FieldContainer<double> &sidePoints, const FieldContainer<double> &volumePoints,
+                                     int sideOrdinal, CellTopoPtr cellTopo)
+  {
+    int numPoints = volumePoints.dimension(0);
+    int dim = cellTopo->getDimension();
+    int sideDim = dim - 1;
+    FieldContainer<double> basePoints(sideDim + 1, sideDim), baseImages(sideDim + 1, dim);
+    for (int d=0; d<sideDim; d++)
+    {
+      basePoints(d+1,d) = 1.0;
+    }
+    CamelliaCellTools::mapToReferenceSubcell(baseImages, basePoints, sideDim, sideOrdinal, cellTopo);
+
+    // columns of A are the images of the side's unit vectors; we solve A^T A eta = A^T (x - x0)
+    FieldContainer<double> A(dim, sideDim);
+    for (int d=0; d<dim; d++)
+    {
+      for (int k=0; k<sideDim; k++)
+      {
+        A(d,k) = baseImages(k+1,d) - baseImages(0,d);
+      }
+    }
+    double ATA[2][2] = {{0,0},{0,0}};
+    for (int k=0; k<sideDim; k++)
+    {
+      for (int l=0; l<sideDim; l++)
+      {
+        for (int d=0; d<dim; d++)
+        {
+          ATA[k][l] += A(d,k) * A(d,l);
+        }
+      }
+    }
+    double det = (sideDim == 1) ? ATA[0][0] : ATA[0][0] * ATA[1][1] - ATA[0][1] * ATA[1][0];
+    TEUCHOS_TEST_FOR_EXCEPTION(abs(det) < 1e-14, std::invalid_argument, "degenerate reference side");
+
+    sidePoints.resize(numPoints, sideDim);
+    for (int pointOrdinal=0; pointOrdinal<numPoints; pointOrdinal++)
+    {
+      double ATx[2] = {0,0};
+      for (int k=0; k<sideDim; k++)
+      {
+        for (int d=0; d<dim; d++)
+        {
+          ATx[k] += A(d,k) * (volumePoints(pointOrdinal,d) - baseImages(0,d));
+        }
+      }
+      if (sideDim == 1)
+      {
+        sidePoints(pointOrdinal,0) = ATx[0] / det;
+      }
+      else
+      {
+        sidePoints(pointOrdinal,0) = ( ATA[1][1] * ATx[0] - ATA[0][1] * ATx[1]) / det;
+        sidePoints(pointOrdinal,1) = (-ATA[1][0] * ATx[0] + ATA[0][0] * ATx[1]) / det;
+      }
+    }
+  }
+
+  // maps reference points of a subcell (P,D) to the parent's reference coordinates
+  FieldContainer<double> mapToParentReferenceCoordinates(const FieldContainer<double> &subcellRefPoints,
+                                                         const FieldContainer<double> &subcellRefNodes, CellTopoPtr cellTopo)
+  {
+    int numPoints = subcellRefPoints.dimension(0);
+    int dim = subcellRefPoints.dimension(1);
+    FieldContainer<double> parentRefPoints(1, numPoints, dim);
+    CamelliaCellTools::mapToPhysicalFrame(parentRefPoints, subcellRefPoints, subcellRefNodes, cellTopo);
+    parentRefPoints.resize(numPoints, dim);
+    return parentRefPoints;
+  }
+
+  // sums (u, v) into values(vDofOrdinal, uDofOrdinal), where u is evaluated in uCache and v, with cubature weights, in vCache.
+  // The two caches must have the same physical points.  This follows the single-cache TLinearTerm::integrate().
+  void integrateTerms(FieldContainer<double> &values, LinearTermPtr u, DofOrderingPtr uOrdering, BasisCachePtr uCache,
+                      LinearTermPtr v, DofOrderingPtr vOrdering, BasisCachePtr vCache)
+  {
+    if (u->isZero() || v->isZero()) return;
+    int numPoints = vCache->getPhysicalCubaturePoints().dimension(1);
+    int spaceDim = vCache->getSpaceDim();
+    Teuchos::Array<int> ltValueDim;
+    ltValueDim.push_back(1);
+    ltValueDim.push_back(0); // # fields -- set per basis
+    ltValueDim.push_back(numPoints);
+    for (int i=0; i<u->rank(); i++)
+    {
+      ltValueDim.push_back(spaceDim);
+    }
+
+    int uSideOrdinal = uCache->getSideIndex();
+    for (int uID : u->varIDs())
+    {
+      bool uVolVar = (uOrdering->getNumSidesForVarID(uID) == 1);
+      int uSideIndex = uVolVar ? DofOrdering::VOLUME_INTERIOR_SIDE_ORDINAL : uSideOrdinal;
+      if (!uOrdering->hasBasisEntry(uID, uSideIndex)) continue; // this variable doesn't live on this side
+      BasisPtr uBasis = uOrdering->getBasis(uID, uSideIndex);
+      ltValueDim[1] = uBasis->getCardinality();
+      FieldContainer<double> uValues(ltValueDim);
+      u->values(uValues, uID, uBasis, uCache, false);
+      if (u->termType() == FLUX)
+      {
+        // as in TLinearTerm, the flux implicitly contains the outward normal of the side
+        double parity = uCache->getVolumeBasisCache()->getCellSideParities()(0,uSideOrdinal);
+        for (int i=0; i<uValues.size(); i++)
+        {
+          uValues[i] *= parity;
+        }
+      }
+      const vector<int>* uDofIndices = &uOrdering->getDofIndices(uID, uSideIndex);
+
+      for (int vID : v->varIDs())
+      {
+        BasisPtr vBasis = vOrdering->getBasis(vID);
+        ltValueDim[1] = vBasis->getCardinality();
+        FieldContainer<double> vValues(ltValueDim);
+        v->values(vValues, vID, vBasis, vCache, true);
+
+        FieldContainer<double> miniMatrix(1, uBasis->getCardinality(), vBasis->getCardinality());
+        FunctionSpaceTools::integrate<double>(miniMatrix, uValues, vValues, COMP_BLAS);
+
+        const vector<int>* vDofIndices = &vOrdering->getDofIndices(vID);
+        for (int i=0; i<uDofIndices->size(); i++)
+        {
+          for (int j=0; j<vDofIndices->size(); j++)
+          {
+            values((*vDofIndices)[j], (*uDofIndices)[i]) += miniMatrix(0,i,j);
+          }
+        }
+      }
+    }
+  }
+}
+
+SubgridTestSpace::SubgridTestSpace(CellTopoPtr cellTopo, VarFactoryPtr testVarFactory, int subcellH1Order)
+{
+  _cellTopo = cellTopo;
+  TEUCHOS_TEST_FOR_EXCEPTION(subcellH1Order < 1, std::invalid_argument, "subcellH1Order must be at least 1");
+
+  // the subgrid's field variables stand in for the test variables, with the same IDs
+  VarFactoryPtr subgridVarFactory = VarFactory::varFactory();
+  map<int, VarPtr> testVars = testVarFactory->testVars();
+  for (auto &testVarEntry : testVars)
+  {
+    VarPtr testVar = testVarEntry.second;
+    subgridVarFactory->fieldVar(testVar->name(), testVar->space(), testVar->ID());
+  }
+
+  int dim = cellTopo->getDimension();
+  MeshTopologyPtr meshTopo = Teuchos::rcp( new MeshTopology(dim) );
+  vector< vector<double> > refCellNodes;
+  CamelliaCellTools::refCellNodesForTopology(refCellNodes, cellTopo);
+  CellPtr rootCell = meshTopo->addCell(cellTopo, refCellNodes);
+
+  int pToAddTest = 0;
+  map<int,int> trialOrderEnhancements, testOrderEnhancements;
+  MeshPartitionPolicyPtr partitionPolicy = Teuchos::null;
+  _subgridMesh = Teuchos::rcp( new Mesh(meshTopo, subgridVarFactory, subcellH1Order, pToAddTest, trialOrderEnhancements,
+                                        testOrderEnhancements, partitionPolicy, MPIWrapper::CommSerial()) );
+  _subgridMesh->hRefine(set<GlobalIndexType>{rootCell->cellIndex()}, RefinementPattern::regularRefinementPattern(cellTopo));
+
+  const vector<CellPtr>* children = &rootCell->children();
+  map<GlobalIndexType, int> subcellOrdinals;
+  for (CellPtr child : *children)
+  {
+    Subcell subcell;
+    subcell.cellID = child->cellIndex();
+    subcell.refNodes = _subgridMesh->physicalCellNodesForCell(subcell.cellID);
+
+    // determine the subgrid's local-to-global map on this subcell by interpreting each local dof in turn
+    int numLocalDofs = _subgridMesh->getElementType(subcell.cellID)->trialOrderPtr->totalDofs();
+    FieldContainer<double> unitVector(numLocalDofs), globalData;
+    FieldContainer<GlobalIndexType> globalDofIndices;
+    for (int localDofOrdinal=0; localDofOrdinal<numLocalDofs; localDofOrdinal++)
+    {
+      unitVector.initialize(0.0);
+      unitVector(localDofOrdinal) = 1.0;
+      _subgridMesh->interpretLocalData(subcell.cellID, unitVector, globalData, globalDofIndices);
+      if (localDofOrdinal == 0)
+      {
+        subcell.localToGlobal.resize(numLocalDofs, globalDofIndices.size());
+        for (int i=0; i<globalDofIndices.size(); i++)
+        {
+          subcell.globalDofIndices.push_back(globalDofIndices(i));
+        }
+      }
+      TEUCHOS_TEST_FOR_EXCEPTION(globalDofIndices.size() != subcell.globalDofIndices.size(), std::invalid_argument,
+                                 "global dof count for a subcell varies with the local dof interpreted");
+      for (int i=0; i<globalDofIndices.size(); i++)
+      {
+        subcell.localToGlobal(localDofOrdinal,i) = globalData(i);
+      }
+    }
+    subcellOrdinals[subcell.cellID] = _subcells.size();
+    _subcells.push_back(subcell);
+  }
+
+  int sideCount = cellTopo->getSideCount();
+  for (int parentSide=0; parentSide<sideCount; parentSide++)
+  {
+    vector< pair<GlobalIndexType, unsigned> > childrenForSide = rootCell->childrenForSide(parentSide);
+    for (auto &childEntry : childrenForSide)
+    {
+      _subcells[subcellOrdinals[childEntry.first]].parentSides.push_back({childEntry.second, parentSide});
+    }
+  }
+
+  // the Gram matrix couples the global dofs of each subcell
+  _subgridMap = Teuchos::rcp( new Epetra_Map((GlobalIndexTypeToCast)dofCount(), 0, *MPIWrapper::CommSerial()) );
+  Epetra_CrsGraph gramGraph(Copy, *_subgridMap, 0);
+  for (Subcell &subcell : _subcells)
+  {
+    int numGlobalDofs = subcell.globalDofIndices.size();
+    for (GlobalIndexTypeToCast globalDofIndex : subcell.globalDofIndices)
+    {
+      gramGraph.InsertGlobalIndices(globalDofIndex, numGlobalDofs, &subcell.globalDofIndices[0]);
+    }
+  }
+  gramGraph.FillComplete();
+  _gramMatrix = Teuchos::rcp( new Epetra_FECrsMatrix(Copy, gramGraph) );
+  _gramMatrix->FillComplete();
+
+  Teuchos::RCP<const Epetra_CrsMatrix> gramCrsMatrix = _gramMatrix;
+  _gramSolver = Amesos2::create<Epetra_CrsMatrix,Epetra_MultiVector>("klu", gramCrsMatrix);
+  _gramSolver->symbolicFactorization();
+}
+
+GlobalIndexType SubgridTestSpace::dofCount() const
+{
+  return _subgridMesh->numGlobalDofs();
+}
+
+void SubgridTestSpace::localStiffnessMatrixAndRHS(FieldContainer<double> &localStiffness, FieldContainer<double> &rhsVector,
+                                                  const vector< TBilinearTerm<double> > &terms, IPPtr ip, LinearTermPtr rhs,
+                                                  DofOrderingPtr trialOrder, BasisCachePtr basisCache)
+{
+  int numCells = basisCache->getPhysicalCellNodes().dimension(0);
+  int numParentNodes = basisCache->getPhysicalCellNodes().dimension(1);
+  int dim = _cellTopo->getDimension();
+  int sideCount = _cellTopo->getSideCount();
+  int numTrialDofs = trialOrder->totalDofs();
+
+  LinearTermPtr rhsVolumePart = rhs->getNonBoundaryOnlyPart();
+  LinearTermPtr rhsBoundaryPart = rhs->getBoundaryOnlyPart();
+
+  Epetra_LocalMap productMap(numTrialDofs + 1, 0, *MPIWrapper::CommSerial());
+  Teuchos::RCP<Epetra_MultiVector> stiffnessAndLoad = Teuchos::rcp( new Epetra_MultiVector(*_subgridMap, numTrialDofs + 1) );
+  Teuchos::RCP<Epetra_MultiVector> solvedStiffnessAndLoad = Teuchos::rcp( new Epetra_MultiVector(*_subgridMap, numTrialDofs + 1) );
+  _gramSolver->setX(solvedStiffnessAndLoad);
+  _gramSolver->setB(stiffnessAndLoad);
+
+  const vector<GlobalIndexType>* cellIDs = &basisCache->cellIDs();
+  for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+  {
+    FieldContainer<double> parentNodes(1, numParentNodes, dim);
+    for (int node=0; node<numParentNodes; node++)
+    {
+      for (int d=0; d<dim; d++)
+      {
+        parentNodes(0,node,d) = basisCache->getPhysicalCellNodes()(cellOrdinal,node,d);
+      }
+    }
+    FieldContainer<double> cellSideParities(1, sideCount);
+    for (int sideOrdinal=0; sideOrdinal<sideCount; sideOrdinal++)
+    {
+      cellSideParities(0,sideOrdinal) = basisCache->getCellSideParities()(cellOrdinal,sideOrdinal);
+    }
+
+    // the Gram matrix G, and the columns of [B^T l], on the subgrid
+    _gramMatrix->PutScalar(0.0);
+    stiffnessAndLoad->PutScalar(0.0);
+
+    for (Subcell &subcell : _subcells)
+    {
+      DofOrderingPtr testOrder = _subgridMesh->getElementType(subcell.cellID)->trialOrderPtr;
+      int numTestDofs = testOrder->totalDofs();
+      CellTopoPtr subcellTopo = _subgridMesh->getElementType(subcell.cellID)->cellTopoPtr;
+
+      int numSubcellNodes = subcell.refNodes.dimension(1);
+      FieldContainer<double> subcellRefVertices = subcell.refNodes;
+      subcellRefVertices.resize(numSubcellNodes, dim);
+      FieldContainer<double> subcellNodes(1, numSubcellNodes, dim);
+      CamelliaCellTools::mapToPhysicalFrame(subcellNodes, subcellRefVertices, parentNodes, _cellTopo);
+      int testDegree = testOrder->maxBasisDegree();
+      int cubatureDegree = testDegree + max(testDegree, trialOrder->maxBasisDegree());
+      bool createSideCache = true;
+      BasisCachePtr testCache = Teuchos::rcp( new BasisCache(subcellNodes, subcellTopo, cubatureDegree, createSideCache) );
+
+      FieldContainer<double> subcellGram(1, numTestDofs, numTestDofs);
+      ip->computeInnerProductMatrix(subcellGram, testOrder, testCache);
+
+      FieldContainer<double> subcellLoad(1, numTestDofs);
+      rhsVolumePart->integrate(subcellLoad, testOrder, testCache);
+
+      // the trial functions are evaluated in the parent cell at the subcell's cubature points
+      FieldContainer<double> noWeights;
+      FieldContainer<double> trialPoints = mapToParentReferenceCoordinates(testCache->getRefCellPoints(), subcell.refNodes, subcellTopo);
+      BasisCachePtr trialCache = Teuchos::rcp( new BasisCache(parentNodes, _cellTopo, trialPoints, noWeights) );
+      trialCache->setCellSideParities(cellSideParities);
+      if (cellIDs->size() == numCells) trialCache->setCellIDs({(*cellIDs)[cellOrdinal]});
+
+      // (u, v) in the volume; as in TLinearTerm::integrate(), boundary-only parts are integrated on the sides below
+      FieldContainer<double> subcellStiffness(numTestDofs, numTrialDofs); // test x trial
+      for (const TBilinearTerm<double> &term : terms)
+      {
+        integrateTerms(subcellStiffness, term.first->getNonBoundaryOnlyPart(), trialOrder, trialCache,
+                       term.second->getNonBoundaryOnlyPart(), testOrder, testCache);
+      }
+
+      // (u + du, dv) + (du, v) on the subcell sides that lie on the element boundary; interior subcell sides contribute nothing
+      for (auto &sideEntry : subcell.parentSides)
+      {
+        unsigned subcellSide = sideEntry.first, parentSide = sideEntry.second;
+        BasisCachePtr testSideCache = testCache->getSideBasisCache(subcellSide);
+        FieldContainer<double> volumePoints = mapToParentReferenceCoordinates(testSideCache->getSideRefCellPointsInVolumeCoordinates(),
+                                                                              subcell.refNodes, subcellTopo);
+        FieldContainer<double> sidePoints;
+        mapToSideReferenceCoordinates(sidePoints, volumePoints, parentSide, _cellTopo);
+        BasisCachePtr trialSideCache = Teuchos::rcp( new BasisCache(parentSide, trialCache, sidePoints, noWeights) );
+
+        for (const TBilinearTerm<double> &term : terms)
+        {
+          LinearTermPtr trialTerm = term.first, testTerm = term.second;
+          integrateTerms(subcellStiffness, trialTerm, trialOrder, trialSideCache,
+                         testTerm->getBoundaryOnlyPart(), testOrder, testSideCache);
+          integrateTerms(subcellStiffness, trialTerm->getBoundaryOnlyPart(), trialOrder, trialSideCache,
+                         testTerm->getNonBoundaryOnlyPart(), testOrder, testSideCache);
+        }
+        rhsBoundaryPart->integrate(subcellLoad, testOrder, testSideCache);
+      }
+
+      // map to the subgrid's global dofs: P^T G P, P^T B^T, P^T l
+      int numGlobalDofs = subcell.globalDofIndices.size();
+      FieldContainer<double> globalGram(numGlobalDofs, numGlobalDofs);
+      FieldContainer<double> gramTimesMap(numTestDofs, numGlobalDofs);
+      subcellGram.resize(numTestDofs, numTestDofs);
+      SerialDenseWrapper::multiply(gramTimesMap, subcellGram, subcell.localToGlobal);
+      SerialDenseWrapper::multiply(globalGram, subcell.localToGlobal, gramTimesMap, 'T', 'N');
+      _gramMatrix->SumIntoGlobalValues(numGlobalDofs, &subcell.globalDofIndices[0], numGlobalDofs, &subcell.globalDofIndices[0], &globalGram[0]);
+
+      for (int i=0; i<numGlobalDofs; i++)
+      {
+        int localRow = _subgridMap->LID(subcell.globalDofIndices[i]);
+        for (int localDofOrdinal=0; localDofOrdinal<numTestDofs; localDofOrdinal++)
+        {
+          double weight = subcell.localToGlobal(localDofOrdinal,i);
+          if (weight == 0.0) continue;
+          for (int trialOrdinal=0; trialOrdinal<numTrialDofs; trialOrdinal++)
+          {
+            (*stiffnessAndLoad)[trialOrdinal][localRow] += weight * subcellStiffness(localDofOrdinal,trialOrdinal);
+          }
+          (*stiffnessAndLoad)[numTrialDofs][localRow] += weight * subcellLoad(0,localDofOrdinal);
+        }
+      }
+    }
+    // solve G X = [B^T l]; then [B^T l]^T X holds B G^{-1} B^T, and (in its last row) l^T G^{-1} B^T.
+    // Every entry is in the serial map, so nothing needs to be assembled across ranks.
+    _gramSolver->numericFactorization();
+    _gramSolver->solve();
+
+    Epetra_MultiVector product(productMap, numTrialDofs + 1);
+    product.Multiply('T', 'N', 1.0, *stiffnessAndLoad, *solvedStiffnessAndLoad, 0.0);
+    for (int i=0; i<numTrialDofs; i++)
+    {
+      for (int j=0; j<numTrialDofs; j++)
+      {
+        localStiffness(cellOrdinal,i,j) = product[j][i];
+      }
+      rhsVector(cellOrdinal,i) = product[i][numTrialDofs];
+    }
+  }
+}
+
+MeshPtr SubgridTestSpace::subgridMesh()
+{
+  return _subgridMesh;
+}
+
+int SubgridTestSpace::subcellCount() const
+{
+  return _subcells.size();
+}
+
+bool SubgridTestSpace::supportsCells(BasisCachePtr basisCache)
+{
+  CellTopoPtr cellTopo = basisCache->cellTopology();
+  if (cellTopo->getTensorialDegree() > 0) return false;
+  int dim = cellTopo->getDimension();
+  if ((dim < 2) || (dim > 3)) return false;
+  MeshPtr mesh = basisCache->mesh();
+  if ((mesh != Teuchos::null) && (mesh->getTransformationFunction() != Teuchos::null)) return false;
+  return true;
+}
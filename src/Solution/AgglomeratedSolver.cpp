@@ -0,0 +1,239 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  AgglomeratedSolver.cpp
+//  Camellia
+//
+
+#include "AgglomeratedSolver.h"
+
+#include "MPIWrapper.h"
+
+using namespace Camellia;
+using namespace std;
+
+AgglomeratedSolver::AgglomeratedSolver(SolverPtr solver, int rankCount, int dofsPerRank)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(solver == Teuchos::null, std::invalid_argument, "solver may not be null");
+  TEUCHOS_TEST_FOR_EXCEPTION(dofsPerRank <= 0, std::invalid_argument, "dofsPerRank must be positive");
+  _solver = solver;
+  _rankCount = rankCount;
+  _dofsPerRank = dofsPerRank;
+}
+
+AgglomeratedSolver::~AgglomeratedSolver()
+{
+  clearAgglomeratedProblem();
+}
+
+int AgglomeratedSolver::agglomeratedRankCount(GlobalIndexType globalDofCount, int numRanks, int dofsPerRank)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(dofsPerRank <= 0, std::invalid_argument, "dofsPerRank must be positive");
+  GlobalIndexType rankCount = (globalDofCount + dofsPerRank - 1) / dofsPerRank;
+  rankCount = min(rankCount, (GlobalIndexType) numRanks);
+  return max((int) rankCount, 1);
+}
+
+void AgglomeratedSolver::clearAgglomeratedProblem()
+{
+  if (!_haveAgglomeratedProblem) return;
+  _haveAgglomeratedProblem = false;
+
+  // release the wrapped solver's hold on the matrix (and any factorization) before freeing the communicator they use
+  _solver->setProblem(Teuchos::RCP<Epetra_CrsMatrix>(), Teuchos::RCP<Epetra_MultiVector>(), Teuchos::RCP<Epetra_MultiVector>());
+  _subMatrix = Teuchos::null;
+  _subLHS = Teuchos::null;
+  _subRHS = Teuchos::null;
+  _importer = Teuchos::null;
+  _agglomeratedMap = Teuchos::null;
+#ifdef HAVE_MPI
+  if (_subComm != Teuchos::null)
+  {
+    MPI_Comm subMPIComm = dynamic_cast<Epetra_MpiComm*>(_subComm.get())->GetMpiComm();
+    _subComm = Teuchos::null;
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (!finalized) MPI_Comm_free(&subMPIComm);
+  }
+#endif
+  _subComm = Teuchos::null;
+}
+
+int AgglomeratedSolver::getAgglomeratedRankCount() const
+{
+  return _agglomeratedRankCount;
+}
+
+SolverPtr AgglomeratedSolver::getSolver()
+{
+  return _solver;
+}
+
+bool AgglomeratedSolver::isIterative()
+{
+  return _solver->isIterative();
+}
+
+int AgglomeratedSolver::resolve()
+{
+  if (!_haveAgglomeratedProblem) return solve();
+  return solveAgglomerated(true);
+}
+
+void AgglomeratedSolver::setTolerance(double tol)
+{
+  _solver->setTolerance(tol);
+}
+
+double AgglomeratedSolver::tolerance()
+{
+  return _solver->tolerance();
+}
+
+void AgglomeratedSolver::setUpAgglomeratedProblem()
+{
+  const Epetra_Map* rowMap = &_stiffnessMatrix->RowMap();
+  const Epetra_Comm* Comm = &rowMap->Comm();
+  int numRanks = Comm->NumProc();
+  int rank = Comm->MyPID();
+
+  if (_rankCount > 0)
+    _agglomeratedRankCount = min(_rankCount, numRanks);
+  else
+    _agglomeratedRankCount = agglomeratedRankCount(rowMap->NumGlobalElements(), numRanks, _dofsPerRank);
+  _haveAgglomeratedProblem = true;
+
+  if (_agglomeratedRankCount == numRanks)
+  {
+    // nothing to gather: hand the problem to the wrapped solver as is
+    _solver->setProblem(_stiffnessMatrix, _lhs, _rhs);
+    return;
+  }
+
+#ifdef HAVE_MPI
+  // each rank sends all its rows to one of the first _agglomeratedRankCount ranks, so that neighboring ranks' rows stay together
+  int destination = (rank * _agglomeratedRankCount) / numRanks;
+  int numMyRows = rowMap->NumMyElements();
+  vector<int> destinations(numMyRows, destination);
+  Teuchos::RCP<Epetra_Distributor> distributor = MPIWrapper::getDistributor(*Comm);
+  int numReceivedRows;
+  bool deterministic = true;
+  int* destinationsPtr = (numMyRows > 0) ? &destinations[0] : NULL;
+  int err = distributor->CreateFromSends(numMyRows, destinationsPtr, deterministic, numReceivedRows);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::CreateFromSends() returned error " << err);
+
+  char* exportPtr = (char*) rowMap->MyGlobalElements();
+  int importBufferLength = 0;
+  char* importBuffer = NULL;
+  err = distributor->Do(exportPtr, sizeof(GlobalIndexTypeToCast), importBufferLength, importBuffer);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::Do() returned error " << err);
+  vector<GlobalIndexTypeToCast> receivedRows((GlobalIndexTypeToCast*) importBuffer, (GlobalIndexTypeToCast*) importBuffer + numReceivedRows);
+  if (importBuffer != NULL) delete [] importBuffer;
+  GlobalIndexTypeToCast* receivedRowsPtr = (numReceivedRows > 0) ? &receivedRows[0] : NULL;
+
+  _agglomeratedMap = Teuchos::rcp( new Epetra_Map(-1, numReceivedRows, receivedRowsPtr, rowMap->IndexBase(), *Comm) );
+  _importer = Teuchos::rcp( new Epetra_Import(*_agglomeratedMap, *rowMap) );
+  Epetra_CrsMatrix agglomeratedMatrix(Copy, *_agglomeratedMap, 0);
+  err = agglomeratedMatrix.Import(*_stiffnessMatrix, *_importer, Insert);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_CrsMatrix::Import() returned error " << err);
+  agglomeratedMatrix.FillComplete();
+
+  // the agglomerated matrix lives on the full communicator; the wrapped solver should only involve the ranks that hold rows
+  const Epetra_MpiComm* mpiComm = dynamic_cast<const Epetra_MpiComm*>(Comm);
+  TEUCHOS_TEST_FOR_EXCEPTION(mpiComm == NULL, std::invalid_argument, "agglomeration requires an Epetra_MpiComm");
+  int color = (rank < _agglomeratedRankCount) ? 0 : MPI_UNDEFINED;
+  MPI_Comm subMPIComm;
+  MPI_Comm_split(mpiComm->GetMpiComm(), color, rank, &subMPIComm);
+  if (subMPIComm == MPI_COMM_NULL) return;
+  _subComm = Teuchos::rcp( new Epetra_MpiComm(subMPIComm) );
+
+  Epetra_Map subMap(-1, numReceivedRows, receivedRowsPtr, rowMap->IndexBase(), *_subComm);
+  _subMatrix = Teuchos::rcp( new Epetra_CrsMatrix(Copy, subMap, 0) );
+  vector<GlobalIndexTypeToCast> globalColumns;
+  for (int localRow=0; localRow<numReceivedRows; localRow++)
+  {
+    int numEntries;
+    double* values;
+    int* localColumns;
+    agglomeratedMatrix.ExtractMyRowView(localRow, numEntries, values, localColumns);
+    if (numEntries == 0) continue;
+    globalColumns.resize(numEntries);
+    for (int i=0; i<numEntries; i++)
+    {
+      globalColumns[i] = agglomeratedMatrix.GCID(localColumns[i]);
+    }
+    _subMatrix->InsertGlobalValues(receivedRows[localRow], numEntries, values, &globalColumns[0]);
+  }
+  _subMatrix->FillComplete();
+
+  int numVectors = _rhs->NumVectors();
+  _subLHS = Teuchos::rcp( new Epetra_MultiVector(subMap, numVectors) );
+  _subRHS = Teuchos::rcp( new Epetra_MultiVector(subMap, numVectors) );
+  _solver->setProblem(_subMatrix, _subLHS, _subRHS);
+#else
+  TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "agglomeration onto fewer ranks requires MPI");
+#endif
+}
+
+int AgglomeratedSolver::solve()
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_stiffnessMatrix.get() == NULL, std::invalid_argument, "stiffness matrix is unset.");
+  TEUCHOS_TEST_FOR_EXCEPTION(_lhs.get() == NULL, std::invalid_argument, "lhs is unset.");
+  TEUCHOS_TEST_FOR_EXCEPTION(_rhs.get() == NULL, std::invalid_argument, "rhs is unset.");
+
+  // the matrix values may have changed since the last solve(), so gather them again
+  clearAgglomeratedProblem();
+  setUpAgglomeratedProblem();
+  return solveAgglomerated(false);
+}
+
+int AgglomeratedSolver::solveAgglomerated(bool callResolveInsteadOfSolve)
+{
+  if (_importer == Teuchos::null)
+  {
+    _solver->setLHS(_lhs);
+    _solver->setRHS(_rhs);
+    return callResolveInsteadOfSolve ? _solver->resolve() : _solver->solve();
+  }
+
+  int numVectors = _rhs->NumVectors();
+  Epetra_MultiVector agglomeratedLHS(*_agglomeratedMap, numVectors), agglomeratedRHS(*_agglomeratedMap, numVectors);
+  agglomeratedRHS.Import(*_rhs, *_importer, Insert);
+  agglomeratedLHS.Import(*_lhs, *_importer, Insert); // initial guess, for iterative solvers
+
+  int err = 0;
+  int numMyRows = _agglomeratedMap->NumMyElements();
+  if (_subComm != Teuchos::null)
+  {
+    TEUCHOS_TEST_FOR_EXCEPTION(_subRHS->NumVectors() != numVectors, std::invalid_argument, "rhs vector count changed without a new solve()");
+    // _subLHS and _subRHS have the same local rows as the agglomerated vectors
+    for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+    {
+      for (int localRow=0; localRow<numMyRows; localRow++)
+      {
+        (*_subRHS)[vectorOrdinal][localRow] = agglomeratedRHS[vectorOrdinal][localRow];
+        (*_subLHS)[vectorOrdinal][localRow] = agglomeratedLHS[vectorOrdinal][localRow];
+      }
+    }
+    err = callResolveInsteadOfSolve ? _solver->resolve() : _solver->solve();
+    for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+    {
+      for (int localRow=0; localRow<numMyRows; localRow++)
+      {
+        agglomeratedLHS[vectorOrdinal][localRow] = (*_subLHS)[vectorOrdinal][localRow];
+      }
+    }
+  }
+
+  _lhs->Export(agglomeratedLHS, *_importer, Insert);
+  _lhs->Comm().Broadcast(&err, 1, 0);
+  return err;
+}
+
+void AgglomeratedSolver::stiffnessMatrixChanged()
+{
+  clearAgglomeratedProblem();
+}
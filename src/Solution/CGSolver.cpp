@@ -24,6 +24,16 @@ void CGSolver::setTolerance(double tol)
   _tol = tol;
 }
 
+double CGSolver::tolerance()
+{
+  return _tol;
+}
+
+void CGSolver::setOperator(Teuchos::RCP<Epetra_Operator> op)
+{
+  _operator = op;
+}
+
 int CGSolver::solve()
 {
   // compute some statistics for the original problem
@@ -40,7 +50,13 @@ int CGSolver::solve()
 //    cout << "Condition number estimate: " << condest << endl;
 //  }
 
-  Epetra_LinearProblem problem(_stiffnessMatrix.get(), _lhs.get(), _rhs.get());
+  Epetra_LinearProblem problem;
+  if (_operator != Teuchos::null)
+    problem.SetOperator(_operator.get());
+  else
+    problem.SetOperator(_stiffnessMatrix.get());
+  problem.SetLHS(_lhs.get());
+  problem.SetRHS(_rhs.get());
   AztecOO solver(problem);
 
   // COMBO KNOWN TO WORK FOR STOKES (at least): GMRES + Jacobi.  It can be slow to converge, though.
@@ -54,6 +70,10 @@ int CGSolver::solve()
 //  solver.SetAztecOption(AZ_scaling, AZ_Jacobi);
 //  solver.SetAztecOption(AZ_precond, AZ_none);     // no preconditioner
 //  solver.SetAztecOption(AZ_precond, AZ_Jacobi);   // Jacobi preconditioner
+  if (_operator != Teuchos::null)
+  {
+    solver.SetAztecOption(AZ_precond, AZ_none); // matrix-free: no entries to build a preconditioner from
+  }
 
   int solveResult = solver.Iterate(_maxIters,_tol);
 
@@ -84,15 +104,18 @@ int CGSolver::solve()
   }
 
   Epetra_RowMatrix *A = problem.GetMatrix();
-  double norminf = A->NormInf();
-  double normone = A->NormOne();
 
   int numIters = solver.NumIters();
 
   if (_printToConsole)
   {
-    cout << "\n Inf-norm of stiffness matrix after scaling = " << norminf;
-    cout << "\n One-norm of stiffness matrix after scaling = " << normone << endl << endl;
+    if (A != NULL)
+    {
+      double norminf = A->NormInf();
+      double normone = A->NormOne();
+      cout << "\n Inf-norm of stiffness matrix after scaling = " << norminf;
+      cout << "\n One-norm of stiffness matrix after scaling = " << normone << endl << endl;
+    }
     cout << "Num iterations: " << numIters << endl;
   }
 
@@ -13,12 +13,15 @@
 #include "Epetra_SerialComm.h"
 
 #include "CamelliaDebugUtility.h"
+#include "CamelliaMemoryUtility.h"
 #include "GDAMinimumRule.h"
 #include "GlobalDofAssignment.h"
 #include "MPIWrapper.h"
 #include "RHS.h"
 #include "SerialDenseWrapper.h"
 
+#include <algorithm>
+
 using namespace Intrepid;
 using namespace Camellia;
 
@@ -86,6 +89,40 @@ long long CondensedDofInterpreter<Scalar>::approximateStiffnessAndLoadMemoryCost
   return memoryCost;
 }
 
+template <typename Scalar>
+map<string, long long> CondensedDofInterpreter<Scalar>::approximateMemoryCosts() const
+{
+  map<string, long long> variableCost;
+  
+  variableCost["_localStiffnessMatrices"] = approximateFieldContainerMapSize(_localStiffnessMatrices);
+  variableCost["_localLoadVectors"] = approximateFieldContainerMapSize(_localLoadVectors);
+  variableCost["_localInterpretedDofIndices"] = approximateFieldContainerMapSize(_localInterpretedDofIndices);
+  
+  variableCost["_fluxToFieldMapForIterativeSolves"] = approximateMapSizeLLVM(_fluxToFieldMapForIterativeSolves);
+  for (auto &entry : _fluxToFieldMapForIterativeSolves)
+  {
+    variableCost["_fluxToFieldMapForIterativeSolves"] += sizeof(Epetra_SerialDenseMatrix) + sizeof(double) * entry.second->M() * entry.second->N();
+  }
+  
+  variableCost["_cellLocalUncondensibleDofIndices"] = approximateMapSizeLLVM(_cellLocalUncondensibleDofIndices);
+  for (auto &entry : _cellLocalUncondensibleDofIndices)
+  {
+    variableCost["_cellLocalUncondensibleDofIndices"] += sizeof(int) * entry.second.size();
+  }
+  variableCost["_fieldRowIndices"] = approximateMapSizeLLVM(_fieldRowIndices);
+  for (auto &entry : _fieldRowIndices)
+  {
+    variableCost["_fieldRowIndices"] += sizeof(int) * entry.second.size();
+  }
+  
+  variableCost["_offRankCellsToInclude"] = approximateSetSizeLLVM(_offRankCellsToInclude);
+  variableCost["_globalDofIndexOffsets"] = approximateVectorSizeLLVM(_globalDofIndexOffsets);
+  variableCost["_interpretedFluxDofIndices"] = approximateSetSizeLLVM(_interpretedFluxDofIndices);
+  variableCost["_interpretedToGlobalDofIndexMap"] = approximateMapSizeLLVM(_interpretedToGlobalDofIndexMap);
+  
+  return variableCost;
+}
+
 template <typename Scalar>
 void CondensedDofInterpreter<Scalar>::clearStiffnessAndLoad()
 {
@@ -495,6 +532,25 @@ set<GlobalIndexType> CondensedDofInterpreter<Scalar>::globalDofIndicesForCell(Gl
   return globalDofIndicesForCell;
 }
 
+template <typename Scalar>
+void CondensedDofInterpreter<Scalar>::sortedGlobalDofIndicesForCell(GlobalIndexType cellID, vector<GlobalIndexType> &sortedGlobalDofIndices)
+{
+  vector<GlobalIndexType> interpretedDofIndicesForCell;
+  _mesh->sortedGlobalDofIndicesForCell(cellID, interpretedDofIndicesForCell);
+
+  sortedGlobalDofIndices.clear();
+  for (GlobalIndexType interpretedDofIndex : interpretedDofIndicesForCell)
+  {
+    auto entry = _interpretedToGlobalDofIndexMap.find(interpretedDofIndex);
+    if (entry != _interpretedToGlobalDofIndexMap.end()) // fields are skipped
+    {
+      sortedGlobalDofIndices.push_back(entry->second);
+    }
+  }
+  // the map to the condensed numbering is one-to-one, but need not preserve order
+  std::sort(sortedGlobalDofIndices.begin(), sortedGlobalDofIndices.end());
+}
+
 template <typename Scalar>
 set<GlobalIndexType> CondensedDofInterpreter<Scalar>::globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal)
 {
@@ -928,29 +984,28 @@ GlobalIndexType CondensedDofInterpreter<Scalar>::globalDofCount()
 
 template <typename Scalar>
 set<GlobalIndexType> CondensedDofInterpreter<Scalar>::globalDofIndicesForPartition(PartitionIndexType rank)
+{
+  vector<GlobalIndexType> myGlobalDofIndicesVector;
+  this->sortedGlobalDofIndicesForPartition(rank, myGlobalDofIndicesVector);
+  return set<GlobalIndexType>(myGlobalDofIndicesVector.begin(),myGlobalDofIndicesVector.end());
+}
+
+template <typename Scalar>
+bool CondensedDofInterpreter<Scalar>::globalDofRangeForPartition(PartitionIndexType rank, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount)
 {
   if (rank == -1)
   {
     // default to current partition, just as Mesh does.
     rank = _mesh->Comm()->MyPID();
   }
-  if (rank == _mesh->Comm()->MyPID())
-  {
-    vector<GlobalIndexType> myGlobalDofIndicesVector(_myGlobalDofIndexCount);
-    GlobalIndexType nextOffset = _myGlobalDofIndexOffset + _myGlobalDofIndexCount;
-    int ordinal = 0;
-    for (GlobalIndexType dofIndex = _myGlobalDofIndexOffset; dofIndex < nextOffset; dofIndex++)
-    {
-      myGlobalDofIndicesVector[ordinal] = dofIndex;
-      ordinal++;
-    }
-    return set<GlobalIndexType>(myGlobalDofIndicesVector.begin(),myGlobalDofIndicesVector.end());
-  }
-  else
+  if (rank != _mesh->Comm()->MyPID())
   {
     cout << "globalDofIndicesForPartition() requires that rank be the local MPI rank!\n";
     TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "globalDofIndicesForPartition() requires that rank be the local MPI rank!");
   }
+  firstDofIndex = _myGlobalDofIndexOffset;
+  dofCount = _myGlobalDofIndexCount;
+  return true;
 }
 
 template <typename Scalar>
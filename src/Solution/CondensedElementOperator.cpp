@@ -0,0 +1,234 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  CondensedElementOperator.cpp
+//  Camellia
+//
+
+#include "CondensedElementOperator.h"
+
+#include "Boundary.h"
+#include "Mesh.h"
+#include "Solution.h"
+
+#include "Epetra_Export.h"
+#include "Epetra_Vector.h"
+
+#include "Teuchos_BLAS.hpp"
+
+using namespace Camellia;
+using namespace Intrepid;
+using namespace std;
+
+CondensedElementOperator::CondensedElementOperator(SolutionPtr solution) : _partitionMap(solution->getPartitionMap())
+{
+  _solution = solution;
+  _dofInterpreter = Teuchos::rcp_dynamic_cast<CondensedDofInterpreter<double>>(solution->getDofInterpreter());
+  TEUCHOS_TEST_FOR_EXCEPTION(_dofInterpreter == Teuchos::null, std::invalid_argument,
+                             "CondensedElementOperator requires a Solution that uses a condensed solve");
+  TEUCHOS_TEST_FOR_EXCEPTION(_partitionMap.NumGlobalElements() != (int)_dofInterpreter->globalDofCount(), std::invalid_argument,
+                             "CondensedElementOperator does not support Lagrange or zero-mean constraints");
+  update();
+}
+
+void CondensedElementOperator::update()
+{
+  MeshPtr mesh = _solution->mesh();
+  const set<GlobalIndexType>* myCellIDs = &mesh->cellIDsInPartition();
+
+  // condense each rank-local element, recording its global indices
+  vector<vector<GlobalIndexTypeToCast>> elementGIDs;
+  elementGIDs.reserve(myCellIDs->size());
+  _elementMatrixOffsets.clear();
+  _elementMatrices.clear();
+  set<GlobalIndexTypeToCast> overlapGIDs;
+  for (GlobalIndexType cellID : *myCellIDs)
+  {
+    const FieldContainer<double>* localStiffness = &_dofInterpreter->storedLocalStiffnessForCell(cellID);
+    FieldContainer<double> localLoad = _dofInterpreter->storedLocalLoadForCell(cellID);
+    FieldContainer<double> condensedStiffness, condensedLoad;
+    FieldContainer<GlobalIndexType> condensedDofIndices;
+    _dofInterpreter->interpretLocalData(cellID, *localStiffness, localLoad, condensedStiffness, condensedLoad, condensedDofIndices);
+
+    int n = condensedDofIndices.size();
+    elementGIDs.push_back(vector<GlobalIndexTypeToCast>(n));
+    for (int i=0; i<n; i++)
+    {
+      elementGIDs.back()[i] = condensedDofIndices(i);
+      overlapGIDs.insert(condensedDofIndices(i));
+    }
+    _elementMatrixOffsets.push_back(_elementMatrices.size());
+    _elementMatrices.insert(_elementMatrices.end(), &condensedStiffness[0], &condensedStiffness[0] + n * n);
+  }
+
+  vector<GlobalIndexTypeToCast> overlapGIDVector(overlapGIDs.begin(), overlapGIDs.end());
+  GlobalIndexTypeToCast* overlapGIDPtr = (overlapGIDVector.size() > 0) ? &overlapGIDVector[0] : NULL;
+  _overlapMap = Teuchos::rcp( new Epetra_Map(-1, overlapGIDVector.size(), overlapGIDPtr, 0, _partitionMap.Comm()) );
+  _importer = Teuchos::rcp( new Epetra_Import(*_overlapMap, _partitionMap) );
+
+  _elementOffsets.assign(1, 0);
+  _elementLIDs.clear();
+  for (const vector<GlobalIndexTypeToCast> &gids : elementGIDs)
+  {
+    for (GlobalIndexTypeToCast gid : gids)
+    {
+      _elementLIDs.push_back(_overlapMap->LID(gid));
+    }
+    _elementOffsets.push_back(_elementLIDs.size());
+  }
+
+  // Dirichlet dofs: bcsToImpose() may report dofs owned by other ranks, so mark them and export to the owners
+  FieldContainer<GlobalIndexType> bcGlobalIndicesFC;
+  FieldContainer<double> bcGlobalValuesFC;
+  mesh->boundary().bcsToImpose(bcGlobalIndicesFC, bcGlobalValuesFC, *_solution->bc(), _dofInterpreter.get());
+  set<GlobalIndexTypeToCast> bcGIDs;
+  for (int i=0; i<bcGlobalIndicesFC.size(); i++)
+  {
+    bcGIDs.insert(bcGlobalIndicesFC[i]);
+  }
+  vector<GlobalIndexTypeToCast> bcGIDVector(bcGIDs.begin(), bcGIDs.end());
+  GlobalIndexTypeToCast* bcGIDPtr = (bcGIDVector.size() > 0) ? &bcGIDVector[0] : NULL;
+  Epetra_Map bcMap(-1, bcGIDVector.size(), bcGIDPtr, 0, _partitionMap.Comm());
+  Epetra_Vector bcMarkers(bcMap);
+  bcMarkers.PutScalar(1.0);
+  Epetra_Vector ownedBCMarkers(_partitionMap);
+  Epetra_Export bcExporter(bcMap, _partitionMap);
+  ownedBCMarkers.Export(bcMarkers, bcExporter, Add);
+
+  _bcLIDs.clear();
+  for (int lid=0; lid<ownedBCMarkers.MyLength(); lid++)
+  {
+    if (ownedBCMarkers[lid] != 0.0) _bcLIDs.push_back(lid);
+  }
+}
+
+int CondensedElementOperator::Apply(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const
+{
+  if (X.NumVectors() != Y.NumVectors()) return -1;
+  int numVectors = X.NumVectors();
+
+  // BC columns are zero; BC rows are the identity
+  int numBCs = _bcLIDs.size();
+  vector<double> bcValues(numBCs * numVectors);
+  Epetra_MultiVector Xmasked(X); // X and Y may alias
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    double* x = Xmasked[vectorOrdinal];
+    for (int i=0; i<numBCs; i++)
+    {
+      bcValues[i + vectorOrdinal * numBCs] = x[_bcLIDs[i]];
+      x[_bcLIDs[i]] = 0.0;
+    }
+  }
+
+  Epetra_MultiVector Xoverlap(*_overlapMap, numVectors), Yoverlap(*_overlapMap, numVectors);
+  int err = Xoverlap.Import(Xmasked, *_importer, Insert);
+  if (err != 0) return err;
+
+  Teuchos::BLAS<int, double> blas;
+  vector<double> xElement, yElement;
+  int numElements = _elementMatrixOffsets.size();
+  for (int elementOrdinal=0; elementOrdinal<numElements; elementOrdinal++)
+  {
+    const int* lids = &_elementLIDs[_elementOffsets[elementOrdinal]];
+    int n = _elementOffsets[elementOrdinal+1] - _elementOffsets[elementOrdinal];
+    if (n == 0) continue;
+
+    // gather, column-major n x numVectors
+    xElement.resize(n * numVectors);
+    yElement.resize(n * numVectors);
+    for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+    {
+      const double* x = Xoverlap[vectorOrdinal];
+      for (int i=0; i<n; i++)
+      {
+        xElement[i + vectorOrdinal * n] = x[lids[i]];
+      }
+    }
+
+    // element matrix is row-major, so as a column-major array it is the transpose
+    blas.GEMM(Teuchos::TRANS, Teuchos::NO_TRANS, n, numVectors, n, 1.0, &_elementMatrices[_elementMatrixOffsets[elementOrdinal]], n,
+              &xElement[0], n, 0.0, &yElement[0], n);
+
+    for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+    {
+      double* y = Yoverlap[vectorOrdinal];
+      for (int i=0; i<n; i++)
+      {
+        y[lids[i]] += yElement[i + vectorOrdinal * n];
+      }
+    }
+  }
+
+  Y.PutScalar(0.0);
+  err = Y.Export(Yoverlap, *_importer, Add);
+  if (err != 0) return err;
+
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    double* y = Y[vectorOrdinal];
+    for (int i=0; i<numBCs; i++)
+    {
+      y[_bcLIDs[i]] = bcValues[i + vectorOrdinal * numBCs];
+    }
+  }
+  return 0;
+}
+
+int CondensedElementOperator::ApplyInverse(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const
+{
+  return -1;
+}
+
+long long CondensedElementOperator::elementMatrixMemoryCost() const
+{
+  return _elementMatrices.size() * sizeof(double) + _elementLIDs.size() * sizeof(int);
+}
+
+int CondensedElementOperator::NumMyElements() const
+{
+  return _elementMatrixOffsets.size();
+}
+
+int CondensedElementOperator::SetUseTranspose(bool UseTranspose)
+{
+  return -1;
+}
+
+double CondensedElementOperator::NormInf() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Unsupported method.");
+}
+
+const char * CondensedElementOperator::Label() const
+{
+  return "Camellia CondensedElementOperator";
+}
+
+bool CondensedElementOperator::UseTranspose() const
+{
+  return false;
+}
+
+bool CondensedElementOperator::HasNormInf() const
+{
+  return false;
+}
+
+const Epetra_Comm & CondensedElementOperator::Comm() const
+{
+  return _partitionMap.Comm();
+}
+
+const Epetra_Map & CondensedElementOperator::OperatorDomainMap() const
+{
+  return _partitionMap;
+}
+
+const Epetra_Map & CondensedElementOperator::OperatorRangeMap() const
+{
+  return _partitionMap;
+}
@@ -302,8 +302,9 @@ int DLS<Scalar>::assemble()
     DofOrderingPtr testOrderingPtr = elemTypePtr->testOrderPtr;
     int numTrialDofs = trialOrderingPtr->totalDofs();
     int numTestDofs = testOrderingPtr->totalDofs();
-    int maxCellBatch = MAX_BATCH_SIZE_IN_BYTES / 8 / (numTestDofs*numTestDofs + numTestDofs*numTrialDofs + numTrialDofs*numTrialDofs);
-    maxCellBatch = max( maxCellBatch, MIN_BATCH_SIZE_IN_CELLS );
+    // batch size accounts for matrix storage as well as the geometry and basis values held by the BasisCaches
+    int maxCellBatch = min(basisCache->maxCellBatchSize(elemTypePtr, MAX_BATCH_SIZE_IN_BYTES, MIN_BATCH_SIZE_IN_CELLS),
+                           ipBasisCache->maxCellBatchSize(elemTypePtr, MAX_BATCH_SIZE_IN_BYTES, MIN_BATCH_SIZE_IN_CELLS));
     
     Array<int> nodeDimensions, parityDimensions;
     myPhysicalCellNodesForType.dimensions(nodeDimensions);
@@ -335,7 +336,8 @@ int DLS<Scalar>::assemble()
       basisCache->setPhysicalCellNodes(physicalCellNodes,cellIDs,createSideCacheToo);
       basisCache->setCellSideParities(cellSideParities);
       
-      // hard-coding creating side cache for IP for now, since _ip->hasBoundaryTerms() only recognizes terms explicitly passed in as boundary terms:
+      // requesting side cache for IP even though _ip->hasBoundaryTerms() may be false, since that only recognizes terms explicitly
+      // passed in as boundary terms.  Side caches are built lazily, so an IP without boundary terms never pays for them.
       ipBasisCache->setPhysicalCellNodes(physicalCellNodes,cellIDs,true);//_ip->hasBoundaryTerms()); // create side cache if ip has boundary values
       ipBasisCache->setCellSideParities(cellSideParities); // I don't anticipate these being needed, though
       
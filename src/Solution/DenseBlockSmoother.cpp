@@ -0,0 +1,315 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  DenseBlockSmoother.cpp
+//  Camellia
+//
+
+#include "DenseBlockSmoother.h"
+
+#include "Mesh.h"
+#include "OverlappingRowMatrix.h"
+
+#include "Teuchos_BLAS.hpp"
+#include "Teuchos_LAPACK.hpp"
+
+using namespace Camellia;
+using namespace std;
+
+DenseBlockSmoother::DenseBlockSmoother(Epetra_RowMatrix* A, MeshPtr mesh, Teuchos::RCP<DofInterpreter> dofInterpreter,
+                                       SweepType sweepType, int overlapLevel, bool hierarchical, int dimensionForNeighborRelationship)
+{
+  _A = A;
+  _mesh = mesh;
+  _dofInterpreter = dofInterpreter;
+  _sweepType = sweepType;
+  _overlapLevel = overlapLevel;
+  _hierarchical = hierarchical;
+  _dimensionForNeighborRelationship = dimensionForNeighborRelationship;
+}
+
+int DenseBlockSmoother::Compute()
+{
+  const Epetra_Map* rowMap = &_A->RowMatrixRowMap();
+  const Epetra_Map* colMap = &_A->RowMatrixColMap();
+  int numMyRows = _A->NumMyRows();
+
+  // rank-local copy of A, in terms of row LIDs
+  int maxEntries = _A->MaxNumEntries();
+  vector<double> values(maxEntries);
+  vector<int> indices(maxEntries);
+  _rowOffsets.assign(1, 0);
+  _rowColumns.clear();
+  _rowValues.clear();
+  for (int rowLID=0; rowLID<numMyRows; rowLID++)
+  {
+    int numEntries;
+    _A->ExtractMyRowCopy(rowLID, maxEntries, numEntries, &values[0], &indices[0]);
+    for (int entryOrdinal=0; entryOrdinal<numEntries; entryOrdinal++)
+    {
+      GlobalIndexTypeToCast colGID = colMap->GID(indices[entryOrdinal]);
+      int colRowLID = rowMap->LID(colGID);
+      if (colRowLID == -1) continue; // not locally owned
+      _rowColumns.push_back(colRowLID);
+      _rowValues.push_back(values[entryOrdinal]);
+    }
+    _rowOffsets.push_back(_rowColumns.size());
+  }
+
+  // determine the blocks: one per rank-local cell (or per cell's overlap patch)
+  const set<GlobalIndexType>* myCellIDs = &_mesh->cellIDsInPartition();
+  vector<set<GlobalIndexType>> patches;
+  set<GlobalIndexType> remoteCells;
+  for (GlobalIndexType cellID : *myCellIDs)
+  {
+    if (_overlapLevel == 0)
+    {
+      patches.push_back({cellID});
+    }
+    else
+    {
+      patches.push_back(OverlappingRowMatrix::overlappingCells(cellID, _mesh, _overlapLevel, _hierarchical,
+                                                               _dimensionForNeighborRelationship));
+      for (GlobalIndexType patchCellID : patches.back())
+      {
+        if (myCellIDs->find(patchCellID) == myCellIDs->end()) remoteCells.insert(patchCellID);
+      }
+    }
+  }
+  map<GlobalIndexType,set<GlobalIndexType>> remoteCellDofs;
+  if (_overlapLevel > 0)
+  {
+    // the dof interpreter only knows the dofs for rank-local cells; collective call
+    remoteCellDofs = _dofInterpreter->importGlobalIndicesMap(remoteCells);
+  }
+
+  _blockRows.clear();
+  vector<bool> rowIsCovered(numMyRows, false);
+  for (const set<GlobalIndexType> &patch : patches)
+  {
+    set<int> rowLIDs;
+    for (GlobalIndexType patchCellID : patch)
+    {
+      set<GlobalIndexType> cellDofs;
+      if (myCellIDs->find(patchCellID) != myCellIDs->end())
+        cellDofs = _dofInterpreter->globalDofIndicesForCell(patchCellID);
+      else
+        cellDofs = remoteCellDofs[patchCellID];
+      for (GlobalIndexType dofIndex : cellDofs)
+      {
+        int rowLID = rowMap->LID((GlobalIndexTypeToCast)dofIndex);
+        if (rowLID != -1) rowLIDs.insert(rowLID);
+      }
+    }
+    if (rowLIDs.size() == 0) continue;
+    _blockRows.push_back(vector<int>(rowLIDs.begin(), rowLIDs.end()));
+    for (int rowLID : rowLIDs)
+    {
+      rowIsCovered[rowLID] = true;
+    }
+  }
+  for (int rowLID=0; rowLID<numMyRows; rowLID++)
+  {
+    if (!rowIsCovered[rowLID]) _blockRows.push_back({rowLID});
+  }
+
+  _incidenceCounts.assign(numMyRows, 0);
+  int numBlocks = _blockRows.size();
+  _blockInverseOffsets.resize(numBlocks);
+  int totalSize = 0;
+  for (int blockOrdinal=0; blockOrdinal<numBlocks; blockOrdinal++)
+  {
+    int n = _blockRows[blockOrdinal].size();
+    _blockInverseOffsets[blockOrdinal] = totalSize;
+    totalSize += n * n;
+    for (int rowLID : _blockRows[blockOrdinal])
+    {
+      _incidenceCounts[rowLID]++;
+    }
+  }
+
+  // extract and invert each block
+  _blockInverses.assign(totalSize, 0.0);
+  Teuchos::LAPACK<int, double> lapack;
+  vector<int> positionInBlock(numMyRows, -1);
+  int err = 0;
+  for (int blockOrdinal=0; blockOrdinal<numBlocks; blockOrdinal++)
+  {
+    const vector<int>* rows = &_blockRows[blockOrdinal];
+    int n = rows->size();
+    double* blockValues = &_blockInverses[_blockInverseOffsets[blockOrdinal]];
+
+    for (int i=0; i<n; i++)
+    {
+      positionInBlock[(*rows)[i]] = i;
+    }
+    for (int i=0; i<n; i++)
+    {
+      int rowLID = (*rows)[i];
+      for (int entryOrdinal=_rowOffsets[rowLID]; entryOrdinal<_rowOffsets[rowLID+1]; entryOrdinal++)
+      {
+        int j = positionInBlock[_rowColumns[entryOrdinal]];
+        if (j != -1) blockValues[i + j * n] += _rowValues[entryOrdinal];
+      }
+    }
+    for (int i=0; i<n; i++)
+    {
+      positionInBlock[(*rows)[i]] = -1;
+    }
+
+    if (n == 1)
+    {
+      // zero diagonal (e.g. a Lagrange constraint row): leave the smoother zero there
+      blockValues[0] = (blockValues[0] != 0.0) ? 1.0 / blockValues[0] : 0.0;
+      continue;
+    }
+
+    vector<int> pivots(n);
+    vector<double> work(n);
+    int info;
+    lapack.GETRF(n, n, blockValues, n, &pivots[0], &info);
+    if (info == 0)
+    {
+      lapack.GETRI(n, blockValues, n, &pivots[0], &work[0], n, &info);
+    }
+    if (info != 0)
+    {
+      // singular block: drop it from the smoother, and report
+      err = info;
+      for (int i=0; i<n*n; i++)
+      {
+        blockValues[i] = 0.0;
+      }
+    }
+  }
+  return err;
+}
+
+void DenseBlockSmoother::applyBlock(int blockOrdinal, const Epetra_MultiVector &X, Epetra_MultiVector &Y, bool useResidual) const
+{
+  const vector<int>* rows = &_blockRows[blockOrdinal];
+  int n = rows->size();
+  int numVectors = X.NumVectors();
+
+  // gather the (residual) right-hand sides, column-major n x numVectors
+  vector<double> rhs(n * numVectors);
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    const double* x = X[vectorOrdinal];
+    const double* y = Y[vectorOrdinal];
+    for (int i=0; i<n; i++)
+    {
+      int rowLID = (*rows)[i];
+      double value = x[rowLID];
+      if (useResidual)
+      {
+        for (int entryOrdinal=_rowOffsets[rowLID]; entryOrdinal<_rowOffsets[rowLID+1]; entryOrdinal++)
+        {
+          value -= _rowValues[entryOrdinal] * y[_rowColumns[entryOrdinal]];
+        }
+      }
+      rhs[i + vectorOrdinal * n] = value;
+    }
+  }
+
+  vector<double> correction(n * numVectors);
+  Teuchos::BLAS<int, double> blas;
+  blas.GEMM(Teuchos::NO_TRANS, Teuchos::NO_TRANS, n, numVectors, n, 1.0, &_blockInverses[_blockInverseOffsets[blockOrdinal]], n,
+            &rhs[0], n, 0.0, &correction[0], n);
+
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    double* y = Y[vectorOrdinal];
+    for (int i=0; i<n; i++)
+    {
+      y[(*rows)[i]] += correction[i + vectorOrdinal * n];
+    }
+  }
+}
+
+int DenseBlockSmoother::ApplyInverse(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const
+{
+  if (X.NumVectors() != Y.NumVectors()) return -1;
+
+  Epetra_MultiVector Xcopy(X); // X and Y may alias
+  Y.PutScalar(0.0);
+
+  int numBlocks = _blockRows.size();
+  if (_sweepType == JACOBI)
+  {
+    for (int blockOrdinal=0; blockOrdinal<numBlocks; blockOrdinal++)
+    {
+      applyBlock(blockOrdinal, Xcopy, Y, false);
+    }
+  }
+  else
+  {
+    for (int blockOrdinal=0; blockOrdinal<numBlocks; blockOrdinal++)
+    {
+      applyBlock(blockOrdinal, Xcopy, Y, true);
+    }
+    for (int blockOrdinal=numBlocks-1; blockOrdinal>=0; blockOrdinal--)
+    {
+      applyBlock(blockOrdinal, Xcopy, Y, true);
+    }
+  }
+  return 0;
+}
+
+int DenseBlockSmoother::Apply(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const
+{
+  return -1;
+}
+
+const vector<int> & DenseBlockSmoother::LocalIncidenceCounts() const
+{
+  return _incidenceCounts;
+}
+
+int DenseBlockSmoother::NumBlocks() const
+{
+  return _blockRows.size();
+}
+
+int DenseBlockSmoother::SetUseTranspose(bool UseTranspose)
+{
+  return -1;
+}
+
+double DenseBlockSmoother::NormInf() const
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Unsupported method.");
+}
+
+const char * DenseBlockSmoother::Label() const
+{
+  return "Camellia DenseBlockSmoother";
+}
+
+bool DenseBlockSmoother::UseTranspose() const
+{
+  return false;
+}
+
+bool DenseBlockSmoother::HasNormInf() const
+{
+  return false;
+}
+
+const Epetra_Comm & DenseBlockSmoother::Comm() const
+{
+  return _A->Comm();
+}
+
+const Epetra_Map & DenseBlockSmoother::OperatorDomainMap() const
+{
+  return _A->OperatorDomainMap();
+}
+
+const Epetra_Map & DenseBlockSmoother::OperatorRangeMap() const
+{
+  return _A->OperatorRangeMap();
+}
@@ -10,17 +10,57 @@
 
 #include "ErrorIndicator.h"
 
+#include "CamelliaCellTools.h"
 #include "EnergyErrorIndicator.h"
 #include "GradientErrorIndicator.h"
 #include "HessianErrorIndicator.h"
 
 using namespace Camellia;
+using namespace Intrepid;
 
 ErrorIndicator::ErrorIndicator(MeshPtr mesh)
 {
   _mesh = mesh;
 }
 
+BasisCachePtr ErrorIndicator::centroidBasisCache(MeshPtr mesh, ElementTypePtr elemType, const FieldContainer<double> &physicalCellNodes,
+                                                 const vector<GlobalIndexType> &cellIDs)
+{
+  CellTopoPtr cellTopo = elemType->cellTopoPtr;
+  int spaceDim = cellTopo->getDimension();
+  int onePoint = 1;
+  FieldContainer<double> centroid(onePoint,spaceDim);
+  int nodeCount = cellTopo->getNodeCount();
+  FieldContainer<double> cellNodes(nodeCount,spaceDim);
+  CamelliaCellTools::refCellNodesForTopology(cellNodes, cellTopo);
+  for (int node=0; node<nodeCount; node++)
+  {
+    for (int d=0; d<spaceDim; d++)
+    {
+      centroid(0,d) += cellNodes(node,d);
+    }
+  }
+  for (int d=0; d<spaceDim; d++)
+  {
+    centroid(0,d) /= nodeCount;
+  }
+  BasisCachePtr basisCache = BasisCache::basisCacheForReferenceCell(cellTopo, 0); // 0 cubature degree
+  basisCache->setRefCellPoints(centroid);
+  basisCache->setMesh(mesh);
+  bool createSideCache = false;
+  basisCache->setPhysicalCellNodes(physicalCellNodes, cellIDs, createSideCache);
+  return basisCache;
+}
+
+FieldContainer<double> ErrorIndicator::cellMeasures(MeshPtr mesh, ElementTypePtr elemType, const FieldContainer<double> &physicalCellNodes,
+                                                    const vector<GlobalIndexType> &cellIDs)
+{
+  BasisCachePtr basisCache = Teuchos::rcp( new BasisCache(elemType, mesh) );
+  bool createSideCache = false;
+  basisCache->setPhysicalCellNodes(physicalCellNodes, cellIDs, createSideCache);
+  return basisCache->getCellMeasures();
+}
+
 void ErrorIndicator::localCellsAboveErrorThreshold(double threshold, vector<GlobalIndexType> &cellsAboveThreshold)
 {
   for (auto measureEntry : _localErrorMeasures) {
@@ -12,6 +12,7 @@
 #include "GMGOperator.h"
 
 #include "AdditiveSchwarz.h"
+#include "AgglomeratedSolver.h"
 #include "BasisFactory.h"
 #include "DofOrdering.h"
 #include "GlobalDofAssignment.h"
@@ -19,6 +20,7 @@
 #include "CamelliaCellTools.h"
 #include "CondensedDofInterpreter.h"
 #include "CubatureFactory.h"
+#include "DenseBlockSmoother.h"
 #include "GDAMinimumRule.h"
 #include "SerialDenseWrapper.h"
 #include "TimeLogger.h"
@@ -30,8 +32,6 @@
 
 #include "Epetra_SerialComm.h"
 
-#include "Ifpack_BlockRelaxation.h"
-#include "Ifpack_SparseContainer.h"
 #include "Ifpack_AdditiveSchwarz.h"
 #include "Ifpack_PointRelaxation.h"
 #include "Ifpack_Amesos.h"
@@ -42,9 +42,7 @@
 #include "Ifpack_Graph_Epetra_RowMatrix.h"
 
 #include "Ifpack_AdditiveSchwarz.h"
-#include "Ifpack_BlockRelaxation.h"
 #include "Ifpack_Graph_Epetra_RowMatrix.h"
-#include "Ifpack_DenseContainer.h"
 
 #include "Epetra_Operator_to_Epetra_Matrix.h"
 
@@ -367,10 +365,14 @@ void GMGOperator::computeCoarseStiffnessMatrix(Epetra_CrsMatrix *fineStiffnessMa
 void GMGOperator::computeResidual(const Epetra_MultiVector& Y, Epetra_MultiVector& res, Epetra_MultiVector& A_Y) const
 {
   Epetra_Time timer(Comm());
-  int err = _fineStiffnessMatrix->Apply(Y, A_Y);
+  int err;
+  if (_fineStiffnessOperator != Teuchos::null)
+    err = _fineStiffnessOperator->Apply(Y, A_Y);
+  else
+    err = _fineStiffnessMatrix->Apply(Y, A_Y);
   if (err != 0)
   {
-    cout << "_fineStiffnessMatrix->Apply returned non-zero error code " << err << endl;
+    cout << "fine stiffness Apply returned non-zero error code " << err << endl;
   }
   res.Update(-1.0, A_Y, 1.0);
   _timeApplyFineStiffness += timer.ElapsedTime();
@@ -2104,6 +2106,19 @@ void GMGOperator::setCoarseSolver(SolverPtr coarseSolver)
   _coarseSolver = coarseSolver;
 }
 
+void GMGOperator::setCoarseSolveAgglomeration(int rankCount)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_coarseSolver == Teuchos::null, std::invalid_argument, "coarse solve agglomeration requires a coarse solver (i.e., the coarsest GMGOperator)");
+  AgglomeratedSolver* agglomeratedSolver = dynamic_cast<AgglomeratedSolver*>(_coarseSolver.get());
+  SolverPtr coarseSolver = (agglomeratedSolver != NULL) ? agglomeratedSolver->getSolver() : _coarseSolver;
+  if (rankCount != 0)
+  {
+    coarseSolver = Teuchos::rcp( new AgglomeratedSolver(coarseSolver, rankCount) );
+  }
+  _coarseSolver = coarseSolver;
+  _haveSolvedOnCoarseMesh = false; // the new solver will need to see the coarse problem
+}
+
 void GMGOperator::setDebugMode(bool value)
 {
   _debugMode = value;
@@ -2143,6 +2158,11 @@ void GMGOperator::setFineStiffnessMatrix(Epetra_CrsMatrix *fineStiffness)
   }
 }
 
+void GMGOperator::setFineStiffnessOperator(Teuchos::RCP<Epetra_Operator> fineStiffnessOperator)
+{
+  _fineStiffnessOperator = fineStiffnessOperator;
+}
+
 void GMGOperator::setFillRatio(double fillRatio)
 {
   _fillRatio = fillRatio;
@@ -2251,67 +2271,38 @@ void GMGOperator::setUpSmoother(Epetra_CrsMatrix *fineStiffnessMatrix)
   }
   break;
   case BLOCK_JACOBI:
-  {
-    // TODO: work out how we're supposed to specify partitioning scheme.
-    //      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Block Gauss-Seidel smoother not yet supported.");
-
-    smoother = Teuchos::rcp(new Ifpack_BlockRelaxation<Ifpack_SparseContainer<Ifpack_Amesos> >(fineStiffnessMatrix) );
-    Teuchos::ParameterList List;
-    // TODO: work out what the various parameters do, and how they should depend on the problem...
-    int overlapBlocks = _smootherOverlap;
-    int sweeps = 2;
-    int localParts = 4;
-
-    List.set("relaxation: type", "Jacobi");
-    List.set("relaxation: sweeps", sweeps);
-    List.set("amesos: solver type", "Amesos_Klu");
-
-    List.set("partitioner: overlap", overlapBlocks);
-#ifdef HAVE_IFPACK_METIS
-    // use METIS to create the blocks. This requires --enable-ifpack-metis.
-    // If METIS is not installed, the user may select "linear".
-    List.set("partitioner: type", "metis");
-#else
-    // or a simple greedy algorithm is METIS is not enabled
-    List.set("partitioner: type", "greedy");
-#endif
-    // defines here the number of local blocks. If 1,
-    // and only one process is used in the computation, then
-    // the preconditioner must converge in one iteration.
-    List.set("partitioner: local parts", localParts);
-  }
-  break;
   case BLOCK_SYMMETRIC_GAUSS_SEIDEL:
   {
-    // TODO: work out how we're supposed to specify partitioning scheme.
-//      TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "Block Gauss-Seidel smoother not yet supported.");
-
-    smoother = Teuchos::rcp(new Ifpack_BlockRelaxation<Ifpack_SparseContainer<Ifpack_Amesos> >(fineStiffnessMatrix) );
-    Teuchos::ParameterList List;
-    // TODO: work out what the various parameters do, and how they should depend on the problem...
-    int overlapBlocks = _smootherOverlap;
-    int sweeps = 2;
-    int localParts = 4;
-
-    List.set("relaxation: type", "symmetric Gauss-Seidel");
-    List.set("relaxation: sweeps", sweeps);
-    List.set("amesos: solver type", "Amesos_Klu"); // default
-
-    List.set("partitioner: overlap", overlapBlocks);
-#ifdef HAVE_IFPACK_METIS
-    // use METIS to create the blocks. This requires --enable-ifpack-metis.
-    // If METIS is not installed, the user may select "linear".
-    List.set("partitioner: type", "metis");
-#else
-    // or a simple greedy algorithm if METIS is not enabled
-    List.set("partitioner: type", "greedy");
-#endif
-    // defines here the number of local blocks. If 1,
-    // and only one process is used in the computation, then
-    // the preconditioner must converge in one iteration.
-    List.set("partitioner: local parts", localParts);
+    // dense cell (or overlap patch) blocks, taken from the dof interpreter, inverted with LAPACK
+    DenseBlockSmoother::SweepType sweepType = (choice == BLOCK_JACOBI) ? DenseBlockSmoother::JACOBI : DenseBlockSmoother::SYMMETRIC_GAUSS_SEIDEL;
+    Teuchos::RCP<DenseBlockSmoother> blockSmoother = Teuchos::rcp( new DenseBlockSmoother(fineStiffnessMatrix, _fineMesh, _fineDofInterpreter, sweepType,
+                                                                                          _smootherOverlap, _hierarchicalNeighborsForSchwarz,
+                                                                                          _dimensionForSchwarzNeighborRelationship) );
+    int err = blockSmoother->Compute();
+    if (err != 0)
+    {
+      cout << "WARNING: In GMGOperator (level " << getOperatorLevel() << "), DenseBlockSmoother::Compute() returned with err = " << err << endl;
+    }
+    
+    if (_useSchwarzDiagonalWeight)
+    {
+      // blocks are rank-local, so the incidence counts are final as they stand
+      const vector<int>* myIncidenceCounts = &blockSmoother->LocalIncidenceCounts();
+      _smootherDiagonalWeight = Teuchos::rcp(new Epetra_MultiVector(fineStiffnessMatrix->RowMap(), 1) );
+      for (int LID=0; LID < myIncidenceCounts->size(); LID++)
+      {
+        (*_smootherDiagonalWeight)[0][LID] = 1.0 / (*myIncidenceCounts)[LID];
+      }
+    }
+    if (_useSchwarzScalingWeight && (choice == BLOCK_JACOBI))
+    {
+      _smootherWeight = computeSchwarzSmootherWeight();
+    }
+    
+    _smoother = blockSmoother;
+    _timeSetUpSmoother = smootherSetupTimer.ElapsedTime();
+    return;
   }
-  break;
   case IFPACK_ADDITIVE_SCHWARZ:
   case CAMELLIA_ADDITIVE_SCHWARZ:
   {
@@ -521,6 +521,11 @@ void GMGSolver::setTolerance(double tol)
   _tol = tol;
 }
 
+double GMGSolver::tolerance()
+{
+  return _tol;
+}
+
 int GMGSolver::resolve()
 {
   bool buildCoarseStiffness = false; // won't have changed since solve() was called
@@ -549,7 +554,8 @@ int GMGSolver::solve(bool buildCoarseStiffness)
     typedef Epetra_Operator OP;
     typedef Belos::LinearProblem<Scalar, MV, OP> BelosProblem;
     typedef RCP<BelosProblem> BelosProblemPtr;
-    BelosProblemPtr problem = rcp( new BelosProblem(_stiffnessMatrix, _lhs, _rhs) );
+    RCP<OP> A = (_fineOperator != Teuchos::null) ? _fineOperator : RCP<OP>(_stiffnessMatrix);
+    BelosProblemPtr problem = rcp( new BelosProblem(A, _lhs, _rhs) );
     
     Belos::SolverFactory<Scalar, MV, OP> factory;
     RCP<Belos::SolverManager<Scalar, MV, OP> > solver;
@@ -558,6 +564,7 @@ int GMGSolver::solve(bool buildCoarseStiffness)
     {
       _gmgOperator->setFineStiffnessMatrix(_stiffnessMatrix.get());
     }
+    _gmgOperator->setFineStiffnessOperator(_fineOperator);
     
     RCP<ParameterList> solverParams = parameterList();
     
@@ -658,6 +665,7 @@ int GMGSolver::solve(bool buildCoarseStiffness)
   }
   else
   {
+    TEUCHOS_TEST_FOR_EXCEPTION(_fineOperator != Teuchos::null, std::invalid_argument, "setFineOperator() is only supported with Belos");
     Epetra_LinearProblem problem(_stiffnessMatrix.get(), _lhs.get(), _rhs.get());
     AztecOO solver(problem);
 
@@ -835,6 +843,17 @@ void GMGSolver::setSmootherApplicationCount(int count)
   }
 }
 
+void GMGSolver::setCoarseSolveAgglomeration(int rankCount)
+{
+  auto opStack = getOperatorStack(true);
+  opStack[0]->setCoarseSolveAgglomeration(rankCount);
+}
+
+void GMGSolver::setFineOperator(Teuchos::RCP<Epetra_Operator> fineOperator)
+{
+  _fineOperator = fineOperator;
+}
+
 void GMGSolver::setSmootherType(GMGOperator::SmootherChoice smootherType)
 {
   auto opStack = getOperatorStack(false);
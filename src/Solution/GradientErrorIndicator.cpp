@@ -11,7 +11,7 @@
 
 #include "GradientErrorIndicator.h"
 
-#include "CamelliaCellTools.h"
+#include "CellHalo.h"
 #include "SerialDenseWrapper.h"
 
 using namespace Camellia;
@@ -52,106 +52,74 @@ void GradientErrorIndicator<Scalar>::measureError()
   TEUCHOS_TEST_FOR_EXCEPTION(_var->rank() != 0, std::invalid_argument, "varForGradient must be a scalar variable");
   TEUCHOS_TEST_FOR_EXCEPTION(_var->varType() != FIELD, std::invalid_argument, "varForGradient must be a field variable");
 
-  auto myCells = &_mesh->cellIDsInPartition();
+  // owned cells and their off-rank neighbors
+  CellHaloPtr halo = _mesh->cellHalo();
+  const vector<GlobalIndexType> &cellIDs = halo->cellIDs();
+  int ownedCellCount = halo->ownedCellCount();
   
   int onePoint = 1;
   MeshTopologyViewPtr meshTopo = _solution->mesh()->getTopology();
   int spaceDim = meshTopo->getDimension();
   
-  set<GlobalIndexType> cellsAndNeighborsSet;
-  for (GlobalIndexType myCellID : *myCells)
-  {
-    cellsAndNeighborsSet.insert(myCellID);
-    CellPtr cell = meshTopo->getCell(myCellID);
-    set<GlobalIndexType> neighborIDs = cell->getActiveNeighborIndices(meshTopo);
-    cellsAndNeighborsSet.insert(neighborIDs.begin(),neighborIDs.end());
-  }
-  vector<GlobalIndexType> cellsAndNeighbors(cellsAndNeighborsSet.begin(),cellsAndNeighborsSet.end());
-
-  // get any off-rank solution data we may need:
-  _solution->importSolutionForOffRankCells(cellsAndNeighborsSet);
-  
-  int cellsAndNeighborsCount = cellsAndNeighbors.size();
-  
-  FieldContainer<double> cellValues(cellsAndNeighborsCount,onePoint); // values at cell centers
-  FieldContainer<double> cellCenters(cellsAndNeighborsCount,spaceDim);
-  FieldContainer<double> cellDiameter(cellsAndNeighborsCount,onePoint); // h-values
-  
-  map<CellTopologyKey,BasisCachePtr> basisCacheForTopology;
+  // per-cell data: value at the cell center, h, and the cell center.  Computed for owned cells, and exchanged for the rest.
+  const int VALUE = 0, DIAMETER = 1, CENTER = 2;
+  FieldContainer<double> cellData(halo->cellCount(), CENTER + spaceDim);
   
-  FunctionPtr hFunction = Function::h();
   FunctionPtr solnFunction = Function::solution(_var, _solution);
-  Teuchos::Array<int> cellValueDim;
-  cellValueDim.push_back(1);
-  cellValueDim.push_back(1);
   
-  map<GlobalIndexType,int> cellIDToOrdinal; // lookup table for value access
-  
-  // setup: compute cell centers, and solution values at those points
-  for (int cellOrdinal=0; cellOrdinal<cellsAndNeighborsCount; cellOrdinal++)
+  // setup: compute cell centers, solution values at those points, and cell measures, for all the cells of each type at once
+  int rank = _mesh->Comm()->MyPID();
+  for (ElementTypePtr elemType : _mesh->elementTypes(rank))
   {
-    GlobalIndexType cellID = cellsAndNeighbors[cellOrdinal];
-    cellIDToOrdinal[cellID] = cellOrdinal;
-    CellPtr cell = meshTopo->getCell(cellID);
-    CellTopoPtr cellTopo = cell->topology();
-    if (basisCacheForTopology.find(cellTopo->getKey()) == basisCacheForTopology.end())
+    vector<GlobalIndexType> cellIDsOfType = _mesh->cellIDsOfType(elemType);
+    FieldContainer<double> physicalCellNodes = _mesh->physicalCellNodes(elemType);
+    int numCells = cellIDsOfType.size();
+    if (numCells == 0) continue;
+    
+    BasisCachePtr basisCache = centroidBasisCache(_mesh, elemType, physicalCellNodes, cellIDsOfType);
+    FieldContainer<double> values(numCells,onePoint);
+    solnFunction->values(values, basisCache);
+    const FieldContainer<double>* centers = &basisCache->getPhysicalCubaturePoints();
+    FieldContainer<double> measures;
+    if (_hPower != 0)
+    {
+      measures = cellMeasures(_mesh, elemType, physicalCellNodes, cellIDsOfType);
+    }
+    
+    for (int i=0; i<numCells; i++)
     {
-      FieldContainer<double> centroid(onePoint,spaceDim);
-      int nodeCount = cellTopo->getNodeCount();
-      FieldContainer<double> cellNodes(nodeCount,spaceDim);
-      CamelliaCellTools::refCellNodesForTopology(cellNodes, cellTopo);
-      for (int node=0; node<nodeCount; node++)
+      int cellOrdinal = halo->ordinalForCell(cellIDsOfType[i]);
+      cellData(cellOrdinal,VALUE) = values(i,0);
+      for (int d=0; d<spaceDim; d++)
       {
-        for (int d=0; d<spaceDim; d++)
-        {
-          centroid(0,d) += cellNodes(node,d);
-        }
+        cellData(cellOrdinal,CENTER+d) = (*centers)(i,0,d);
       }
-      for (int d=0; d<spaceDim; d++)
+      if (_hPower != 0)
       {
-        centroid(0,d) /= nodeCount;
+        cellData(cellOrdinal,DIAMETER) = measures(i);
       }
-      basisCacheForTopology[cellTopo->getKey()] = BasisCache::basisCacheForReferenceCell(cellTopo, 0); // 0 cubature degree
-      basisCacheForTopology[cellTopo->getKey()]->setRefCellPoints(centroid);
-      basisCacheForTopology[cellTopo->getKey()]->setMesh(_solution->mesh());
-    }
-    BasisCachePtr basisCache = basisCacheForTopology[cellTopo->getKey()];
-    basisCache->setPhysicalCellNodes(_solution->mesh()->physicalCellNodesForCell(cellID), {cellID}, false);
-    
-    FieldContainer<double> cellValue(cellValueDim,&cellValues(cellOrdinal,0));
-    solnFunction->values(cellValue, basisCache);
-    for (int d=0; d<spaceDim; d++)
-    {
-      cellCenters(cellOrdinal,d) = basisCache->getPhysicalCubaturePoints()(0,0,d);
-    }
-    if (_hPower != 0)
-    {
-      cellDiameter(cellOrdinal,0) = _solution->mesh()->getCellMeasure(cellID);
     }
   }
+  halo->exchange(cellData);
   
   // now compute the gradients requested
   FieldContainer<double> Y(spaceDim,spaceDim); // the matrix we'll invert to compute the gradient
   FieldContainer<double> b(spaceDim); // RHS for matrix problem
   FieldContainer<double> grad(spaceDim); // LHS for matrix problem
   vector<double> distanceVector(spaceDim);
-  for (GlobalIndexType myCellID : *myCells)
+  for (int cellOrdinal=0; cellOrdinal<ownedCellCount; cellOrdinal++)
   {
     Y.initialize(0.0);
     b.initialize(0.0);
-    CellPtr cell = meshTopo->getCell(myCellID);
-    int myOrdinalInCellAndNeighbors = cellIDToOrdinal[myCellID];
-    double myValue = cellValues(myOrdinalInCellAndNeighbors,0);
-    set<GlobalIndexType> neighborIDs = cell->getActiveNeighborIndices(meshTopo);
-    for (GlobalIndexType neighborID : neighborIDs)
+    double myValue = cellData(cellOrdinal,VALUE);
+    for (int neighborOrdinal : halo->neighborOrdinals(cellOrdinal))
     {
-      int neighborOrdinalInCellAndNeighbors = cellIDToOrdinal[neighborID];
-      double neighborValue = cellValues(neighborOrdinalInCellAndNeighbors,0);
+      double neighborValue = cellData(neighborOrdinal,VALUE);
       
       double dist_squared = 0;
       for (int d=0; d<spaceDim; d++)
       {
-        distanceVector[d] = cellCenters(neighborOrdinalInCellAndNeighbors,d) - cellCenters(myOrdinalInCellAndNeighbors,d);
+        distanceVector[d] = cellData(neighborOrdinal,CENTER+d) - cellData(cellOrdinal,CENTER+d);
         dist_squared += distanceVector[d] * distanceVector[d];
       }
       
@@ -170,13 +138,14 @@ void GradientErrorIndicator<Scalar>::measureError()
     {
       l2_value_squared += grad(d) * grad(d);
     }
+    GlobalIndexType myCellID = cellIDs[cellOrdinal];
     if (_hPower == 0)
     {
       _localErrorMeasures[myCellID] = sqrt(l2_value_squared);
     }
     else
     {
-      _localErrorMeasures[myCellID] = sqrt(l2_value_squared) * pow(cellDiameter(myOrdinalInCellAndNeighbors,0), _hPower);
+      _localErrorMeasures[myCellID] = sqrt(l2_value_squared) * pow(cellData(cellOrdinal,DIAMETER), _hPower);
     }
   }
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  HaloImportPlan.cpp
+//  Camellia
+//
+
+#include "HaloImportPlan.h"
+
+#include "Epetra_Distributor.h"
+
+#include <algorithm>
+
+using namespace Camellia;
+using namespace std;
+
+HaloImportPlan::HaloImportPlan(const set<GlobalIndexType> &cellIDs, DofInterpreter* dofInterpreter, const Epetra_BlockMap &sourceMap)
+{
+  vector<vector<GlobalIndexType>> globalDofsForCells(cellIDs.size());
+  vector<GlobalIndexTypeToCast> myDofs;
+  int cellOrdinal = 0;
+  for (GlobalIndexType cellID : cellIDs)
+  {
+    dofInterpreter->sortedGlobalDofIndicesForCell(cellID, globalDofsForCells[cellOrdinal]);
+    myDofs.insert(myDofs.end(), globalDofsForCells[cellOrdinal].begin(), globalDofsForCells[cellOrdinal].end());
+    cellOrdinal++;
+  }
+  std::sort(myDofs.begin(), myDofs.end());
+  myDofs.erase(std::unique(myDofs.begin(), myDofs.end()), myDofs.end());
+
+  GlobalIndexTypeToCast* myDofsPtr = (myDofs.size() > 0) ? &myDofs[0] : NULL;
+  _targetMap = Teuchos::rcp( new Epetra_Map(-1, myDofs.size(), myDofsPtr, 0, sourceMap.Comm()) ); // 0: IndexBase
+  _importer = Teuchos::rcp( new Epetra_Import(*_targetMap, sourceMap) );
+
+  vector<bool> isRemote(myDofs.size(), false);
+  int* remoteLIDs = _importer->RemoteLIDs();
+  for (int i=0; i<_importer->NumRemoteIDs(); i++)
+  {
+    isRemote[remoteLIDs[i]] = true;
+  }
+
+  cellOrdinal = 0;
+  for (GlobalIndexType cellID : cellIDs)
+  {
+    bool allOwned = true;
+    for (GlobalIndexType globalDofIndex : globalDofsForCells[cellOrdinal])
+    {
+      if (isRemote[_targetMap->LID((GlobalIndexTypeToCast)globalDofIndex)])
+      {
+        allOwned = false;
+        break;
+      }
+    }
+    if (allOwned)
+      _ownedCellIDs.push_back(cellID);
+    else
+      _haloCellIDs.push_back(cellID);
+    cellOrdinal++;
+  }
+}
+
+HaloImportPlan::~HaloImportPlan()
+{
+  if (_importBuffer != NULL) delete [] _importBuffer;
+}
+
+const Epetra_Map & HaloImportPlan::targetMap() const
+{
+  return *_targetMap;
+}
+
+bool HaloImportPlan::isCompatibleSource(const Epetra_BlockMap &map) const
+{
+  const Epetra_BlockMap* sourceMap = &_importer->SourceMap();
+  if (sourceMap->SameBlockMapDataAs(map)) return true;
+  if (sourceMap->NumGlobalElements() != map.NumGlobalElements()) return false;
+  if (sourceMap->NumMyElements() != map.NumMyElements()) return false;
+  int numMyElements = map.NumMyElements();
+  if (numMyElements == 0) return true;
+  return std::equal(map.MyGlobalElements(), map.MyGlobalElements() + numMyElements, sourceMap->MyGlobalElements());
+}
+
+const vector<GlobalIndexType> & HaloImportPlan::ownedCellIDs() const
+{
+  return _ownedCellIDs;
+}
+
+const vector<GlobalIndexType> & HaloImportPlan::haloCellIDs() const
+{
+  return _haloCellIDs;
+}
+
+int HaloImportPlan::remoteEntryCount() const
+{
+  return _importer->NumRemoteIDs();
+}
+
+void HaloImportPlan::beginImport(const Epetra_MultiVector &source, Epetra_MultiVector &target)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_numVectorsInFlight != -1, std::invalid_argument, "beginImport() called while another import is in flight");
+  TEUCHOS_TEST_FOR_EXCEPTION(source.NumVectors() != target.NumVectors(), std::invalid_argument, "source and target must have the same number of vectors");
+  TEUCHOS_TEST_FOR_EXCEPTION(target.MyLength() != _targetMap->NumMyElements(), std::invalid_argument, "target does not match targetMap()");
+  int numVectors = source.NumVectors();
+
+  // entries owned here: the first NumSameIDs() share LIDs; the rest are permuted
+  int numSame = _importer->NumSameIDs();
+  int numPermute = _importer->NumPermuteIDs();
+  int* permuteFromLIDs = _importer->PermuteFromLIDs();
+  int* permuteToLIDs = _importer->PermuteToLIDs();
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    const double* x = source[vectorOrdinal];
+    double* y = target[vectorOrdinal];
+    std::copy(x, x + numSame, y);
+    for (int i=0; i<numPermute; i++)
+    {
+      y[permuteToLIDs[i]] = x[permuteFromLIDs[i]];
+    }
+  }
+
+  _numVectorsInFlight = numVectors;
+  if (_targetMap->Comm().NumProc() == 1) return;
+
+  int numExports = _importer->NumExportIDs();
+  int* exportLIDs = _importer->ExportLIDs();
+  _exportBuffer.resize(numExports * numVectors);
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    const double* x = source[vectorOrdinal];
+    for (int i=0; i<numExports; i++)
+    {
+      _exportBuffer[i * numVectors + vectorOrdinal] = x[exportLIDs[i]];
+    }
+  }
+
+  char* exportPtr = (numExports > 0) ? (char *) &_exportBuffer[0] : NULL;
+  int objSize = numVectors * sizeof(double);
+  int err = _importer->Distributor().DoPosts(exportPtr, objSize, _importBufferLength, _importBuffer);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::DoPosts() returned error " << err);
+}
+
+void HaloImportPlan::endImport(Epetra_MultiVector &target)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_numVectorsInFlight == -1, std::invalid_argument, "endImport() called without a matching beginImport()");
+  TEUCHOS_TEST_FOR_EXCEPTION(target.NumVectors() != _numVectorsInFlight, std::invalid_argument, "target does not match the one passed to beginImport()");
+  int numVectors = _numVectorsInFlight;
+  _numVectorsInFlight = -1;
+  if (_targetMap->Comm().NumProc() == 1) return;
+
+  int err = _importer->Distributor().DoWaits();
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::DoWaits() returned error " << err);
+
+  int numRemote = _importer->NumRemoteIDs();
+  int* remoteLIDs = _importer->RemoteLIDs();
+  const double* imports = (const double*) _importBuffer;
+  for (int vectorOrdinal=0; vectorOrdinal<numVectors; vectorOrdinal++)
+  {
+    double* y = target[vectorOrdinal];
+    for (int i=0; i<numRemote; i++)
+    {
+      y[remoteLIDs[i]] = imports[i * numVectors + vectorOrdinal];
+    }
+  }
+}
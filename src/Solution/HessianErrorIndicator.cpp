@@ -10,7 +10,7 @@
 //
 
 #include "HessianErrorIndicator.h"
-#include "CamelliaCellTools.h"
+#include "CellHalo.h"
 #include "SerialDenseWrapper.h"
 
 using namespace Camellia;
@@ -51,246 +51,171 @@ void HessianErrorIndicator<Scalar>::measureError()
   TEUCHOS_TEST_FOR_EXCEPTION(_var->rank() != 0, std::invalid_argument, "varForHessian must be a scalar variable");
   TEUCHOS_TEST_FOR_EXCEPTION(_var->varType() != FIELD, std::invalid_argument, "varForHessian must be a field variable");
   
-  auto myCells = &_mesh->cellIDsInPartition();
+  // owned cells and their off-rank neighbors
+  CellHaloPtr halo = _mesh->cellHalo();
+  const vector<GlobalIndexType> &cellIDs = halo->cellIDs();
+  int ownedCellCount = halo->ownedCellCount();
   
   int onePoint = 1;
   MeshTopologyViewPtr meshTopo = _solution->mesh()->getTopology();
   int spaceDim = meshTopo->getDimension();
   
-  set<GlobalIndexType> cellsAndNeighborsSet;
-  for (GlobalIndexType myCellID : *myCells)
-  {
-    cellsAndNeighborsSet.insert(myCellID);
-    CellPtr cell = meshTopo->getCell(myCellID);
-    set<GlobalIndexType> neighborIDs = cell->getActiveNeighborIndices(meshTopo);
-    cellsAndNeighborsSet.insert(neighborIDs.begin(),neighborIDs.end());
-  }
-  vector<GlobalIndexType> cellsAndNeighbors(cellsAndNeighborsSet.begin(),cellsAndNeighborsSet.end());
-  
-  set<GlobalIndexType> remoteNeighbors; // neighbors that are not in myCells
-  for (GlobalIndexType cellID : cellsAndNeighbors)
-  {
-    if (myCells->find(cellID) == myCells->end())
-    {
-      remoteNeighbors.insert(cellID);
-    }
-  }
-  
-  // get any off-rank solution data we may need for gradient computation:
-  _solution->importSolutionForOffRankCells(cellsAndNeighborsSet);
-  
-  int cellsAndNeighborsCount = cellsAndNeighbors.size();
-  
-  FieldContainer<double> cellValues(cellsAndNeighborsCount,onePoint); // values at cell centers
-  FieldContainer<double> cellCenters(cellsAndNeighborsCount,spaceDim);
-  FieldContainer<double> cellDiameter(cellsAndNeighborsCount,onePoint); // h-values
-  
-  map<CellTopologyKey,BasisCachePtr> basisCacheForTopology;
+  // per-cell data: value at the cell center, h, and the cell center.  Computed for owned cells, and exchanged for the rest.
+  const int VALUE = 0, DIAMETER = 1, CENTER = 2;
+  FieldContainer<double> cellData(halo->cellCount(), CENTER + spaceDim);
   
-  FunctionPtr hFunction = Function::h();
   FunctionPtr solnFunction = Function::solution(_var, _solution);
-  Teuchos::Array<int> cellValueDim, cellGradDim, cellHessianDim;
-  cellValueDim.push_back(1);
-  cellValueDim.push_back(1);
   
-  cellGradDim = cellValueDim;
-  cellGradDim.push_back(spaceDim);
+  // if the cells of a type are at least 1st order in the variable, then we compute their derivatives exactly
+  FieldContainer<double> gradients(halo->cellCount(), spaceDim); // zero where we cannot compute one
+  FieldContainer<double> exactHessians(ownedCellCount, spaceDim, spaceDim);
+  vector<bool> hasExactDerivatives(ownedCellCount, false);
   
-  cellHessianDim = cellGradDim;
-  cellHessianDim.push_back(spaceDim);
-  
-  map<GlobalIndexType,int> cellIDToOrdinal; // lookup table for value access
-  
-  // setup: compute cell centers, and solution values at those points
-  for (int cellOrdinal=0; cellOrdinal<cellsAndNeighborsCount; cellOrdinal++)
+  // setup: compute cell centers, solution values at those points, and cell measures, for all the cells of each type at once
+  int rank = _mesh->Comm()->MyPID();
+  for (ElementTypePtr elemType : _mesh->elementTypes(rank))
   {
-    GlobalIndexType cellID = cellsAndNeighbors[cellOrdinal];
-    cellIDToOrdinal[cellID] = cellOrdinal;
-    CellPtr cell = meshTopo->getCell(cellID);
-    CellTopoPtr cellTopo = cell->topology();
-    if (basisCacheForTopology.find(cellTopo->getKey()) == basisCacheForTopology.end())
+    vector<GlobalIndexType> cellIDsOfType = _mesh->cellIDsOfType(elemType);
+    FieldContainer<double> physicalCellNodes = _mesh->physicalCellNodes(elemType);
+    int numCells = cellIDsOfType.size();
+    if (numCells == 0) continue;
+    
+    BasisCachePtr basisCache = centroidBasisCache(_mesh, elemType, physicalCellNodes, cellIDsOfType);
+    FieldContainer<double> values(numCells,onePoint);
+    solnFunction->values(values, basisCache);
+    const FieldContainer<double>* centers = &basisCache->getPhysicalCubaturePoints();
+    FieldContainer<double> measures;
+    if (_hPower != 0)
     {
-      FieldContainer<double> centroid(onePoint,spaceDim);
-      int nodeCount = cellTopo->getNodeCount();
-      FieldContainer<double> cellNodes(nodeCount,spaceDim);
-      CamelliaCellTools::refCellNodesForTopology(cellNodes, cellTopo);
-      for (int node=0; node<nodeCount; node++)
-      {
-        for (int d=0; d<spaceDim; d++)
-        {
-          centroid(0,d) += cellNodes(node,d);
-        }
-      }
-      for (int d=0; d<spaceDim; d++)
-      {
-        centroid(0,d) /= nodeCount;
-      }
-      basisCacheForTopology[cellTopo->getKey()] = BasisCache::basisCacheForReferenceCell(cellTopo, 0); // 0 cubature degree
-      basisCacheForTopology[cellTopo->getKey()]->setRefCellPoints(centroid);
-      basisCacheForTopology[cellTopo->getKey()]->setMesh(_solution->mesh());
+      measures = cellMeasures(_mesh, elemType, physicalCellNodes, cellIDsOfType);
     }
-    BasisCachePtr basisCache = basisCacheForTopology[cellTopo->getKey()];
-    basisCache->setPhysicalCellNodes(_solution->mesh()->physicalCellNodesForCell(cellID), {cellID}, false);
     
-    FieldContainer<double> cellValue(cellValueDim,&cellValues(cellOrdinal,0));
-    solnFunction->values(cellValue, basisCache);
-    for (int d=0; d<spaceDim; d++)
+    BasisPtr basis = elemType->trialOrderPtr->getBasis(_var->ID());
+    bool exactDerivatives = (basis->getDegree() >= 1);
+    FieldContainer<double> cellGradients, cellHessians;
+    if (exactDerivatives)
     {
-      cellCenters(cellOrdinal,d) = basisCache->getPhysicalCubaturePoints()(0,0,d);
+      cellGradients.resize(numCells,onePoint,spaceDim);
+      solnFunction->grad(spaceDim)->values(cellGradients, basisCache);
+      cellHessians.resize(numCells,onePoint,spaceDim,spaceDim);
+      solnFunction->hessian(spaceDim)->values(cellHessians, basisCache);
     }
-    if (_hPower != 0)
+    
+    for (int i=0; i<numCells; i++)
     {
-      cellDiameter(cellOrdinal,0) = pow(_solution->mesh()->getCellMeasure(cellID), 1.0 / spaceDim);
+      int cellOrdinal = halo->ordinalForCell(cellIDsOfType[i]);
+      cellData(cellOrdinal,VALUE) = values(i,0);
+      for (int d=0; d<spaceDim; d++)
+      {
+        cellData(cellOrdinal,CENTER+d) = (*centers)(i,0,d);
+      }
+      if (_hPower != 0)
+      {
+        cellData(cellOrdinal,DIAMETER) = pow(measures(i), 1.0 / spaceDim);
+      }
+      if (exactDerivatives)
+      {
+        hasExactDerivatives[cellOrdinal] = true;
+        for (int d1=0; d1<spaceDim; d1++)
+        {
+          gradients(cellOrdinal,d1) = cellGradients(i,0,d1);
+          for (int d2=0; d2<spaceDim; d2++)
+          {
+            exactHessians(cellOrdinal,d1,d2) = cellHessians(i,0,d1,d2);
+          }
+        }
+      }
     }
   }
+  halo->exchange(cellData);
   
-  // compute the gradients for owned cells
+  // compute the remaining gradients for owned cells
   FieldContainer<double> Y(spaceDim,spaceDim); // the matrix we'll invert to compute the gradient
   FieldContainer<double> b(spaceDim); // RHS for matrix problem
   FieldContainer<double> grad(spaceDim); // LHS for matrix problem
   vector<double> distanceVector(spaceDim);
-  map<GlobalIndexType,vector<double>> gradients;
-  for (GlobalIndexType myCellID : *myCells)
+  for (int cellOrdinal=0; cellOrdinal<ownedCellCount; cellOrdinal++)
   {
-    vector<double> gradVector(spaceDim);
-    // if the cell is at least 1st order in the variable, then compute gradient exactly
-    ElementTypePtr elemType = _solution->mesh()->getElementType(myCellID);
-    BasisPtr basis = elemType->trialOrderPtr->getBasis(_var->ID());
-    CellTopoPtr cellTopo = elemType->cellTopoPtr;
-    if (basis->getDegree() >= 1)
+    if (hasExactDerivatives[cellOrdinal]) continue;
+    
+    Y.initialize(0.0);
+    b.initialize(0.0);
+    double myValue = cellData(cellOrdinal,VALUE);
+    const vector<int> &neighborOrdinals = halo->neighborOrdinals(cellOrdinal);
+    if (neighborOrdinals.size() <= 1)
     {
-      BasisCachePtr basisCache = basisCacheForTopology[cellTopo->getKey()];
-      basisCache->setPhysicalCellNodes(_solution->mesh()->physicalCellNodesForCell(myCellID), {myCellID}, false);
-      
-      FieldContainer<double> cellGrad(cellGradDim,&gradVector[0]);
-      solnFunction->grad(spaceDim)->values(cellGrad, basisCache);
+      // then the problem will be singular --> just assign a zero gradient
+      continue;
     }
-    else
+    for (int neighborOrdinal : neighborOrdinals)
     {
-      Y.initialize(0.0);
-      b.initialize(0.0);
-      CellPtr cell = meshTopo->getCell(myCellID);
-      int myOrdinalInCellAndNeighbors = cellIDToOrdinal[myCellID];
-      double myValue = cellValues(myOrdinalInCellAndNeighbors,0);
-      set<GlobalIndexType> neighborIDs = cell->getActiveNeighborIndices(meshTopo);
-      if (neighborIDs.size() <= 1)
+      double neighborValue = cellData(neighborOrdinal,VALUE);
+      
+      double dist_squared = 0;
+      for (int d=0; d<spaceDim; d++)
       {
-        // then the problem will be singular --> just assign a zero gradient
-        gradients[myCellID] = vector<double>(spaceDim);
-        continue;
+        distanceVector[d] = cellData(neighborOrdinal,CENTER+d) - cellData(cellOrdinal,CENTER+d);
+        dist_squared += distanceVector[d] * distanceVector[d];
       }
-      for (GlobalIndexType neighborID : neighborIDs)
+      
+      for (int d1=0; d1<spaceDim; d1++)
       {
-        int neighborOrdinalInCellAndNeighbors = cellIDToOrdinal[neighborID];
-        double neighborValue = cellValues(neighborOrdinalInCellAndNeighbors,0);
-        
-        double dist_squared = 0;
-        for (int d=0; d<spaceDim; d++)
+        b(d1) += distanceVector[d1] * (neighborValue - myValue) / dist_squared;
+        for (int d2=0; d2<spaceDim; d2++)
         {
-          distanceVector[d] = cellCenters(neighborOrdinalInCellAndNeighbors,d) - cellCenters(myOrdinalInCellAndNeighbors,d);
-          dist_squared += distanceVector[d] * distanceVector[d];
-        }
-        
-        for (int d1=0; d1<spaceDim; d1++)
-        {
-          b(d1) += distanceVector[d1] * (neighborValue - myValue) / dist_squared;
-          for (int d2=0; d2<spaceDim; d2++)
-          {
-            Y(d1,d2) += distanceVector[d1] * distanceVector[d2] / dist_squared;
-          }
+          Y(d1,d2) += distanceVector[d1] * distanceVector[d2] / dist_squared;
         }
       }
-
-      int result = SerialDenseWrapper::solveSystem(grad, Y, b);
-      if (result == 0) // if we get an error code, just leave gradVector as a zero vector
+    }
+    
+    int result = SerialDenseWrapper::solveSystem(grad, Y, b);
+    if (result == 0) // if we get an error code, just leave the gradient as a zero vector
+    {
+      for (int d=0; d<spaceDim; d++)
       {
-        for (int d=0; d<spaceDim; d++)
-        {
-          gradVector[d] = grad[d];
-        }
+        gradients(cellOrdinal,d) = grad[d];
       }
     }
-    gradients[myCellID] = gradVector;
-  }
-  
-  // request remote neighbors' gradients
-  Epetra_CommPtr Comm = _mesh->Comm();
-  
-  int myRank = Comm->MyPID();
-  std::map<int,std::vector<std::pair<int,GlobalIndexType>>> requests; // owning PID -> (myPID, cell whose gradient we want)
-  for (GlobalIndexType remoteCellID : remoteNeighbors)
-  {
-    int rank = _mesh->partitionForCellID(remoteCellID);
-    requests[rank].push_back({myRank,remoteCellID});
   }
   
-  std::vector<std::pair<int,GlobalIndexType>> requestsReceived;
-  MPIWrapper::sendDataVectors(Comm, requests, requestsReceived);
-  
-  std::map<int,std::vector<std::pair<GlobalIndexType,double>>> responsesToSend;
-  std::vector<std::pair<GlobalIndexType,double>> responsesReceived;
-  for (pair<int,GlobalIndexType> request : requestsReceived)
-  {
-    int remotePID = request.first;
-    GlobalIndexType myCellID = request.second;
-    TEUCHOS_TEST_FOR_EXCEPTION(!_mesh->myCellsInclude(myCellID),std::invalid_argument, "request received for non-owned cellID");
-    vector<double> gradient = gradients[myCellID];
-    for (double gradient_comp : gradient)
-    {
-      responsesToSend[remotePID].push_back({myCellID,gradient_comp});
-    }
-  }
-  MPIWrapper::sendDataVectors(Comm, responsesToSend, responsesReceived);
-  for (pair<GlobalIndexType,double> response : responsesReceived)
-  {
-    GlobalIndexType remoteCellID = response.first;
-    double gradient_comp = response.second;
-    gradients[remoteCellID].push_back(gradient_comp);
-  }
+  // get remote neighbors' gradients
+  halo->exchange(gradients);
   
   // now, compute Hessian as Y^{-1} * sum_{K'} (y_K' / norm{y_K'} \tensor (grad u(x_K') - grad u(x_K)) / norm{y_K'})
   b.resize(spaceDim, spaceDim); // RHS for matrix problem -- now matrix-valued
   FieldContainer<double> hessian(spaceDim, spaceDim); // LHS for matrix problem -- now matrix-valued
-  for (GlobalIndexType myCellID : *myCells)
+  for (int cellOrdinal=0; cellOrdinal<ownedCellCount; cellOrdinal++)
   {
-    // if the cell is at least 1st order in the variable, then compute gradient exactly
-    ElementTypePtr elemType = _solution->mesh()->getElementType(myCellID);
-    BasisPtr basis = elemType->trialOrderPtr->getBasis(_var->ID());
-    CellTopoPtr cellTopo = elemType->cellTopoPtr;
+    GlobalIndexType myCellID = cellIDs[cellOrdinal];
     int result = 0;
-    int myOrdinalInCellAndNeighbors = cellIDToOrdinal[myCellID];
-    if (basis->getDegree() >= 1)
+    if (hasExactDerivatives[cellOrdinal])
     {
-      BasisCachePtr basisCache = basisCacheForTopology[cellTopo->getKey()];
-      basisCache->setPhysicalCellNodes(_solution->mesh()->physicalCellNodesForCell(myCellID), {myCellID}, false);
-      
-      FieldContainer<double> cellHessian(cellHessianDim,&hessian[0]);
-      FunctionPtr solnHessian = solnFunction->hessian(spaceDim);
-      solnHessian->values(cellHessian, basisCache);
+      for (int d1=0; d1<spaceDim; d1++)
+      {
+        for (int d2=0; d2<spaceDim; d2++)
+        {
+          hessian(d1,d2) = exactHessians(cellOrdinal,d1,d2);
+        }
+      }
     }
     else
     {
       Y.initialize(0.0);
       b.initialize(0.0);
-      CellPtr cell = meshTopo->getCell(myCellID);
-      vector<double> myGradient = gradients[myCellID];
-      set<GlobalIndexType> neighborIDs = cell->getActiveNeighborIndices(meshTopo);
-      if (neighborIDs.size() <= 1)
+      const vector<int> &neighborOrdinals = halo->neighborOrdinals(cellOrdinal);
+      if (neighborOrdinals.size() <= 1)
       {
         // system will be singular...
         result = 1;
       }
       else
       {
-        for (GlobalIndexType neighborID : neighborIDs)
+        for (int neighborOrdinal : neighborOrdinals)
         {
-          int neighborOrdinalInCellAndNeighbors = cellIDToOrdinal[neighborID];
-          vector<double> neighborGradient = gradients[neighborID];
-          
           double dist_squared = 0;
           for (int d=0; d<spaceDim; d++)
           {
-            distanceVector[d] = cellCenters(neighborOrdinalInCellAndNeighbors,d) - cellCenters(myOrdinalInCellAndNeighbors,d);
+            distanceVector[d] = cellData(neighborOrdinal,CENTER+d) - cellData(cellOrdinal,CENTER+d);
             dist_squared += distanceVector[d] * distanceVector[d];
           }
           
@@ -298,7 +223,7 @@ void HessianErrorIndicator<Scalar>::measureError()
           {
             for (int d2=0; d2<spaceDim; d2++)
             {
-              b(d1,d2) += distanceVector[d1] * (neighborGradient[d2] - myGradient[d2]) / dist_squared;
+              b(d1,d2) += distanceVector[d1] * (gradients(neighborOrdinal,d2) - gradients(cellOrdinal,d2)) / dist_squared;
               
               Y(d1,d2) += distanceVector[d1] * distanceVector[d2] / dist_squared;
             }
@@ -345,7 +270,7 @@ void HessianErrorIndicator<Scalar>::measureError()
     }
     else
     {
-      _localErrorMeasures[myCellID] = hessian_2norm * pow(cellDiameter(myOrdinalInCellAndNeighbors,0), _hPower);
+      _localErrorMeasures[myCellID] = hessian_2norm * pow(cellData(cellOrdinal,DIAMETER), _hPower);
     }
   }
 }
\ No newline at end of file
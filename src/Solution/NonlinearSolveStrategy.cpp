@@ -4,8 +4,18 @@
 
 #include "NonlinearSolveStrategy.h"
 
+#include "Solver.h"
+
 using namespace Camellia;
 
+static double rhsNorm(TSolutionPtr<double> solution)
+{
+  Teuchos::RCP<Epetra_FEVector> rhs = solution->getRHSVector();
+  vector<double> norms(rhs->NumVectors());
+  rhs->Norm2(&norms[0]);
+  return norms[0];
+}
+
 NonlinearSolveStrategy::NonlinearSolveStrategy(TSolutionPtr<double> backgroundFlow, TSolutionPtr<double> solution, Teuchos::RCP<NonlinearStepSize> stepSize, double relativeEnergyTolerance)
 {
   _backgroundFlow = backgroundFlow;
@@ -13,6 +23,9 @@ NonlinearSolveStrategy::NonlinearSolveStrategy(TSolutionPtr<double> backgroundFl
   _stepSize = stepSize;
   _relativeEnergyTolerance = relativeEnergyTolerance;
   _usePicardIteration = false; // Newton-Raphson by default
+  _useInexactNewton = false;
+  _finalLinearTolerance = 1e-10;
+  _maxForcingTerm = 0.9;
 }
 
 void NonlinearSolveStrategy::setUsePicardIteration(bool value)
@@ -20,8 +33,27 @@ void NonlinearSolveStrategy::setUsePicardIteration(bool value)
   _usePicardIteration = value;
 }
 
+void NonlinearSolveStrategy::setSolver(SolverPtr solver)
+{
+  _solver = solver;
+}
+
+void NonlinearSolveStrategy::setUseInexactNewton(bool value, double finalLinearTolerance, double maxForcingTerm)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(maxForcingTerm >= 1.0, std::invalid_argument, "maxForcingTerm must be less than 1");
+  _useInexactNewton = value;
+  _finalLinearTolerance = finalLinearTolerance;
+  _maxForcingTerm = maxForcingTerm;
+}
+
 void NonlinearSolveStrategy::solve(bool printToConsole)
 {
+  if (_useInexactNewton)
+  {
+    solveInexactNewton(printToConsole);
+    return;
+  }
+
   Teuchos::RCP< Mesh > mesh = _solution->mesh();
 
   int i = 0;
@@ -30,7 +62,10 @@ void NonlinearSolveStrategy::solve(bool printToConsole)
   while (!converged)   // while energy error has not stabilized
   {
 
-    _solution->solve(false);
+    if (_solver != Teuchos::null)
+      _solution->solve(_solver);
+    else
+      _solution->solve(false);
 
     double totalErrorSquareRoot = _solution->energyErrorTotal();
     double totalError = totalErrorSquareRoot * totalErrorSquareRoot; // NVR 9-17-14: this is the energy error squared.  Is that what we want??
@@ -69,3 +104,66 @@ void NonlinearSolveStrategy::solve(bool printToConsole)
   }
 
 }
+
+void NonlinearSolveStrategy::solveInexactNewton(bool printToConsole)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_usePicardIteration, std::invalid_argument, "inexact Newton does not apply to Picard iteration");
+  TEUCHOS_TEST_FOR_EXCEPTION((_solver == Teuchos::null) || !_solver->isIterative(), std::invalid_argument,
+                             "inexact Newton requires an iterative solver; see setSolver()");
+  int rank = _solution->mesh()->Comm()->MyPID();
+  double callerTolerance = _solver->tolerance(); // restored on return
+
+  // Eisenstat-Walker "choice 2" forcing terms
+  const double gamma = 0.9, alpha = 2.0;
+
+  double initialResidual = 0.0, prevResidual = 0.0;
+  double forcingTerm = _maxForcingTerm;
+  int i = 0;
+  while (true)
+  {
+    // the assembled right-hand side for the Newton increment is the residual at the background flow
+    _solution->assembleSystem(_solver);
+    double residual = rhsNorm(_solution);
+    if (i == 0)
+    {
+      initialResidual = residual;
+    }
+    else
+    {
+      double nextForcingTerm = gamma * pow(residual / prevResidual, alpha);
+      // safeguard against the forcing terms decreasing too quickly
+      double previousForcingTermBound = gamma * pow(forcingTerm, alpha);
+      if (previousForcingTermBound > 0.1) nextForcingTerm = max(nextForcingTerm, previousForcingTermBound);
+      forcingTerm = min(nextForcingTerm, _maxForcingTerm);
+    }
+    double convergenceThreshold = _relativeEnergyTolerance * initialResidual;
+    // no point in solving much more accurately than the nonlinear tolerance requires
+    if (residual > 0.0) forcingTerm = min(_maxForcingTerm, max(forcingTerm, 0.5 * convergenceThreshold / residual));
+
+    if (printToConsole && (rank == 0))
+    {
+      cout << "on iter = " << i << ", nonlinear residual is " << residual;
+      if (initialResidual > 0.0) cout << " (relative: " << residual / initialResidual << ")";
+      cout << endl;
+    }
+    if (residual <= convergenceThreshold)
+    {
+      break;
+    }
+
+    double linearTolerance = max(forcingTerm, _finalLinearTolerance);
+    if (printToConsole && (rank == 0))
+    {
+      cout << "linear tolerance for iter " << i << ": " << linearTolerance << endl;
+    }
+    _solver->setTolerance(linearTolerance);
+    _solution->solveAssembledSystem(_solver);
+
+    double stepLength = _stepSize->stepSize(_solution,_backgroundFlow);
+    _backgroundFlow->addSolution(_solution,stepLength);
+
+    prevResidual = residual;
+    i++;
+  }
+  _solver->setTolerance(callerTolerance);
+}
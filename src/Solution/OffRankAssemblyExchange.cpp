@@ -0,0 +1,184 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  OffRankAssemblyExchange.cpp
+//  Camellia
+//
+
+#include "OffRankAssemblyExchange.h"
+
+#include "MPIWrapper.h"
+
+using namespace Camellia;
+using namespace std;
+
+OffRankAssemblyExchange::OffRankAssemblyExchange(const Epetra_Map &rowMap) : _rowMap(rowMap) {}
+
+OffRankAssemblyExchange::~OffRankAssemblyExchange()
+{
+  if (_importBuffer != NULL) delete [] _importBuffer;
+}
+
+bool OffRankAssemblyExchange::ownsRow(GlobalIndexType globalRow) const
+{
+  return _rowMap.MyGID((GlobalIndexTypeToCast)globalRow);
+}
+
+void OffRankAssemblyExchange::sumIntoMatrix(Epetra_FECrsMatrix &matrix, int numDofs, const GlobalIndexTypeToCast* dofIndices,
+                                            const double* values)
+{
+  vector<int> ownedOrdinals;
+  for (int i=0; i<numDofs; i++)
+  {
+    if (_rowMap.MyGID(dofIndices[i]))
+    {
+      ownedOrdinals.push_back(i);
+      continue;
+    }
+    for (int j=0; j<numDofs; j++)
+    {
+      _offRankEntries[{dofIndices[i],dofIndices[j]}] += values[j * numDofs + i];
+    }
+  }
+
+  int numOwned = ownedOrdinals.size();
+  if (numOwned == numDofs)
+  {
+    matrix.InsertGlobalValues(numDofs, dofIndices, numDofs, dofIndices, values);
+  }
+  else if (numOwned > 0)
+  {
+    vector<GlobalIndexTypeToCast> ownedRows(numOwned);
+    vector<double> ownedValues(numOwned * numDofs); // column-major, like values
+    for (int k=0; k<numOwned; k++)
+    {
+      ownedRows[k] = dofIndices[ownedOrdinals[k]];
+      for (int j=0; j<numDofs; j++)
+      {
+        ownedValues[j * numOwned + k] = values[j * numDofs + ownedOrdinals[k]];
+      }
+    }
+    matrix.InsertGlobalValues(numOwned, &ownedRows[0], numDofs, dofIndices, &ownedValues[0]);
+  }
+}
+
+void OffRankAssemblyExchange::sumIntoVector(Epetra_FEVector &feVector, int vectorOrdinal, int numDofs,
+                                            const GlobalIndexTypeToCast* dofIndices, const double* values)
+{
+  for (int i=0; i<numDofs; i++)
+  {
+    if (_rowMap.MyGID(dofIndices[i]))
+    {
+      feVector.SumIntoGlobalValues(1, &dofIndices[i], &values[i], vectorOrdinal);
+    }
+    else
+    {
+      _offRankEntries[{dofIndices[i],-1-vectorOrdinal}] += values[i];
+    }
+  }
+}
+
+int OffRankAssemblyExchange::bufferedEntryCount() const
+{
+  return _offRankEntries.size();
+}
+
+void OffRankAssemblyExchange::beginExchange()
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(_exchangeInFlight, std::invalid_argument, "beginExchange() called while another exchange is in flight");
+
+  // distinct off-rank rows, in order
+  vector<GlobalIndexTypeToCast> rows;
+  for (auto &entry : _offRankEntries)
+  {
+    if (rows.empty() || (rows.back() != entry.first.first)) rows.push_back(entry.first.first);
+  }
+  int numRows = rows.size();
+  vector<int> rowOwners(numRows), rowLIDs(numRows);
+  GlobalIndexTypeToCast* rowsPtr = (numRows > 0) ? &rows[0] : NULL;
+  int* rowOwnersPtr = (numRows > 0) ? &rowOwners[0] : NULL;
+  int* rowLIDsPtr = (numRows > 0) ? &rowLIDs[0] : NULL;
+  int err = _rowMap.RemoteIDList(numRows, rowsPtr, rowOwnersPtr, rowLIDsPtr); // collective when the map's directory is distributed
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "some assembled rows do not belong to any rank");
+
+  // group by owner, so that each destination's entries are contiguous
+  map<int, vector<Entry>> entriesForOwner;
+  int rowOrdinal = -1;
+  for (auto &entry : _offRankEntries)
+  {
+    if ((rowOrdinal == -1) || (rows[rowOrdinal] != entry.first.first)) rowOrdinal++;
+    entriesForOwner[rowOwners[rowOrdinal]].push_back({entry.first.first, entry.first.second, entry.second});
+  }
+  _offRankEntries.clear();
+
+  _exportBuffer.clear();
+  vector<int> exportOwners;
+  for (auto &ownerEntries : entriesForOwner)
+  {
+    _exportBuffer.insert(_exportBuffer.end(), ownerEntries.second.begin(), ownerEntries.second.end());
+    exportOwners.insert(exportOwners.end(), ownerEntries.second.size(), ownerEntries.first);
+  }
+  _sentEntryCount = _exportBuffer.size();
+  _receivedEntryCount = 0;
+  _exchangeInFlight = true;
+  if (_rowMap.Comm().NumProc() == 1) return;
+
+  _distributor = MPIWrapper::getDistributor(_rowMap.Comm());
+  int* exportOwnersPtr = (_sentEntryCount > 0) ? &exportOwners[0] : NULL;
+  bool deterministic = true;
+  err = _distributor->CreateFromSends(_sentEntryCount, exportOwnersPtr, deterministic, _receivedEntryCount);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::CreateFromSends() returned error " << err);
+
+  char* exportPtr = (_sentEntryCount > 0) ? (char *) &_exportBuffer[0] : NULL;
+  err = _distributor->DoPosts(exportPtr, sizeof(Entry), _importBufferLength, _importBuffer);
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::DoPosts() returned error " << err);
+}
+
+void OffRankAssemblyExchange::endExchange(Epetra_FECrsMatrix &matrix, Epetra_FEVector &feVector)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(!_exchangeInFlight, std::invalid_argument, "endExchange() called without a matching beginExchange()");
+  _exchangeInFlight = false;
+  if (_rowMap.Comm().NumProc() == 1) return;
+
+  int err = _distributor->DoWaits();
+  TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "Epetra_Distributor::DoWaits() returned error " << err);
+
+  // each sender's entries are ordered by row, with a row's vector entries ahead of its matrix entries
+  const Entry* received = (const Entry*) _importBuffer;
+  vector<GlobalIndexTypeToCast> cols;
+  vector<double> values;
+  int i = 0;
+  while (i < _receivedEntryCount)
+  {
+    const Entry* entry = &received[i];
+    if (entry->col < 0)
+    {
+      int vectorOrdinal = -1 - entry->col;
+      feVector.SumIntoGlobalValues(1, &entry->row, &entry->value, vectorOrdinal);
+      i++;
+      continue;
+    }
+    cols.clear();
+    values.clear();
+    while ((i < _receivedEntryCount) && (received[i].row == entry->row) && (received[i].col >= 0))
+    {
+      cols.push_back(received[i].col);
+      values.push_back(received[i].value);
+      i++;
+    }
+    matrix.InsertGlobalValues(1, &entry->row, cols.size(), &cols[0], &values[0]);
+  }
+}
+
+int OffRankAssemblyExchange::sentEntryCount() const
+{
+  return _sentEntryCount;
+}
+
+int OffRankAssemblyExchange::receivedEntryCount() const
+{
+  return _receivedEntryCount;
+}
@@ -36,8 +36,8 @@ map<GlobalIndexType,FieldContainer<Scalar> > TRieszRep<Scalar>::integrateFunctio
   // NVR: changed this to only return integrated values for rank-local cells.
 
   map<GlobalIndexType,FieldContainer<Scalar> > cellRHS;
-  set<GlobalIndexType> cellIDs = _mesh->cellIDsInPartition();
-  for (set<GlobalIndexType>::iterator cellIDIt=cellIDs.begin(); cellIDIt !=cellIDs.end(); cellIDIt++)
+  const set<GlobalIndexType> &cellIDs = _mesh->cellIDsInPartition();
+  for (set<GlobalIndexType>::const_iterator cellIDIt=cellIDs.begin(); cellIDIt !=cellIDs.end(); cellIDIt++)
   {
     GlobalIndexType cellID = *cellIDIt;
     ElementTypePtr elemTypePtr = _mesh->getElementType(cellID);
@@ -64,8 +64,8 @@ template <typename Scalar>
 void TRieszRep<Scalar>::computeRieszRep(int cubatureEnrichment)
 {
   _rieszRepNormSquared.clear();
-  set<GlobalIndexType> cellIDs = _mesh->cellIDsInPartition();
-  for (set<GlobalIndexType>::iterator cellIDIt=cellIDs.begin(); cellIDIt !=cellIDs.end(); cellIDIt++)
+  const set<GlobalIndexType> &cellIDs = _mesh->cellIDsInPartition();
+  for (set<GlobalIndexType>::const_iterator cellIDIt=cellIDs.begin(); cellIDIt !=cellIDs.end(); cellIDIt++)
   {
     GlobalIndexType cellID = *cellIDIt;
 
@@ -97,7 +97,11 @@ void TRieszRep<Scalar>::computeRieszRep(int cubatureEnrichment)
     FieldContainer<Scalar> rieszRepDofs = rhsValues; // copy so we can do the dot product below after solving
     ipMatrix.resize(numTestDofs,numTestDofs);
     rhsValues.resize(numTestDofs,1);
-    int success = SerialDenseWrapper::solveSPDSystemLAPACKCholesky(rieszRepDofs, ipMatrix);// solveSystemUsingQR(rieszRepDofs, ipMatrix, rhsValues);
+    int success;
+    if (_useMixedPrecisionGramSolve)
+      success = SerialDenseWrapper::solveSPDSystemMixedPrecision(rieszRepDofs, ipMatrix);
+    else
+      success = SerialDenseWrapper::solveSPDSystemLAPACKCholesky(rieszRepDofs, ipMatrix);// solveSystemUsingQR(rieszRepDofs, ipMatrix, rhsValues);
 
     if (success != 0)
     {
@@ -238,7 +242,7 @@ void TRieszRep<Scalar>::distributeDofs()
 
   // distribute norms as well
   GlobalIndexType numElems = _mesh->numActiveElements();
-  set<GlobalIndexType> rankLocalCellIDs = _mesh->cellIDsInPartition();
+  const set<GlobalIndexType> &rankLocalCellIDs = _mesh->cellIDsInPartition();
   IndexType numMyElems = rankLocalCellIDs.size();
   GlobalIndexType myElems[numMyElems];
   // build cell index
@@ -246,7 +250,7 @@ void TRieszRep<Scalar>::distributeDofs()
 
   double rankLocalRieszNorms[numMyElems];
 
-  for (set<GlobalIndexType>::iterator cellIDIt = rankLocalCellIDs.begin(); cellIDIt != rankLocalCellIDs.end(); cellIDIt++)
+  for (set<GlobalIndexType>::const_iterator cellIDIt = rankLocalCellIDs.begin(); cellIDIt != rankLocalCellIDs.end(); cellIDIt++)
   {
     GlobalIndexType cellID = *cellIDIt;
     myElems[myCellOrdinal] = ordinalForCellID[cellID];
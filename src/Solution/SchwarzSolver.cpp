@@ -25,6 +25,11 @@ void SchwarzSolver::setTolerance(double tol)
   _tol = tol;
 }
 
+double SchwarzSolver::tolerance()
+{
+  return _tol;
+}
+
 int SchwarzSolver::solve()
 {
   // compute some statistics for the original problem
@@ -50,6 +50,7 @@
 #include "BasisCache.h"
 #include "BasisSumFunction.h"
 #include "CamelliaCellTools.h"
+#include "CamelliaMemoryUtility.h"
 #include "CondensedDofInterpreter.h"
 #include "CubatureFactory.h"
 #include "Function.h"
@@ -59,6 +60,7 @@
 #include "Mesh.h"
 #include "MeshFactory.h"
 #include "MPIWrapper.h"
+#include "OffRankAssemblyExchange.h"
 #include "PreviousSolutionFunction.h"
 #include "Projector.h"
 #include "RHS.h"
@@ -111,6 +113,34 @@ void TSolution<Scalar>::setCubatureEnrichmentDegree(int value)
 static const int MAX_BATCH_SIZE_IN_BYTES = 3*1024*1024; // 3 MB
 static const int MIN_BATCH_SIZE_IN_CELLS = 1; // overrides the above, if it results in too-small batches
 
+// physical cell nodes and side parities for cellIDs, laid out as by Mesh::physicalCellNodes() and Mesh::cellSideParities()
+static void cellNodesAndSideParities(MeshPtr mesh, ElementTypePtr elemType, const vector<GlobalIndexType> &cellIDs,
+                                     FieldContainer<double> &physicalCellNodes, FieldContainer<double> &cellSideParities)
+{
+  int numCells = cellIDs.size();
+  int numVertices = elemType->cellTopoPtr->getVertexCount();
+  int numSides = elemType->cellTopoPtr->getSideCount();
+  int spaceDim = mesh->getDimension();
+  physicalCellNodes.resize(numCells, numVertices, spaceDim);
+  cellSideParities.resize(numCells, numSides);
+  for (int cellOrdinal=0; cellOrdinal<numCells; cellOrdinal++)
+  {
+    FieldContainer<double> cellNodes = mesh->physicalCellNodesForCell(cellIDs[cellOrdinal]);
+    for (int vertexOrdinal=0; vertexOrdinal<numVertices; vertexOrdinal++)
+    {
+      for (int d=0; d<spaceDim; d++)
+      {
+        physicalCellNodes(cellOrdinal,vertexOrdinal,d) = cellNodes(0,vertexOrdinal,d);
+      }
+    }
+    FieldContainer<double> sideParities = mesh->cellSideParitiesForCell(cellIDs[cellOrdinal]);
+    for (int sideOrdinal=0; sideOrdinal<numSides; sideOrdinal++)
+    {
+      cellSideParities(cellOrdinal,sideOrdinal) = sideParities(0,sideOrdinal);
+    }
+  }
+}
+
 // copy constructor:
 template <typename Scalar>
 TSolution<Scalar>::TSolution(const TSolution<Scalar> &soln) : Narrator("Solution")
@@ -213,7 +243,7 @@ void TSolution<Scalar>::addSolution(Teuchos::RCP< TSolution<Scalar> > otherSoln,
   // (expanded, basically) coefficients together, and then glean the condensed representation from that using the private
   // setGlobalSolutionFromCellLocalCoefficients() method.
 
-  set<GlobalIndexType> myCellIDs = _mesh->cellIDsInPartition();
+  const set<GlobalIndexType> &myCellIDs = _mesh->cellIDsInPartition();
 
   int myLHSCount    = this->numSolutions();
   int otherLHSCount = otherSoln->numSolutions();
@@ -433,7 +463,7 @@ void TSolution<Scalar>::applyDGJumpTerms()
   
   MeshTopologyViewPtr meshTopo = _mesh->getTopology();
   set<GlobalIndexType> activeCellIDs = meshTopo->getLocallyKnownActiveCellIndices();
-  set<GlobalIndexType> myCellIDs = _mesh->cellIDsInPartition();
+  const set<GlobalIndexType> &myCellIDs = _mesh->cellIDsInPartition();
   int sideDim = meshTopo->getDimension() - 1;
   
   FieldContainer<double> emptyRefPointsVolume(0,meshTopo->getDimension()); // (P,D)
@@ -1054,157 +1084,223 @@ void TSolution<Scalar>::populateStiffnessAndLoad()
     TEUCHOS_TEST_FOR_EXCEPTION(true, std::invalid_argument, "populateStiffnessAndLoad() requires that _globalStiffMatrix be an Epetra_FECrsMatrix");
   }
 
-  set<GlobalIndexType> myGlobalIndicesSet = _dofInterpreter->globalDofIndicesForPartition(rank);
+  GlobalIndexType myGlobalDofCount = _dofInterpreter->globalDofCountForPartition(rank);
   Epetra_Map partMap = getPartitionMap();
 
   vector< ElementTypePtr > elementTypes = _mesh->elementTypes(rank);
   vector< ElementTypePtr >::iterator elemTypeIt;
+  int numElementTypes = elementTypes.size();
 
   //cout << "process " << rank << " about to loop over elementTypes.\n";
   int indexBase = 0;
   Epetra_Map timeMap(numProcs,indexBase,*Comm);
   Epetra_Time timer(*Comm);
   Epetra_Time subTimer(*Comm);
+  Epetra_Time exchangeTimer(*Comm);
 
   double localStiffnessInterpretationTime = 0, filterApplicationTime = 0;
+  double timeExchangeOverlap = 0, timeExchangeWait = 0;
 
-  int localStiffnessTimerHandle = TimeLogger::sharedInstance()->startTimer("local stiffness/load");
-  //  cout << "Computing local matrices" << endl;
-  for (elemTypeIt = elementTypes.begin(); elemTypeIt != elementTypes.end(); elemTypeIt++)
-  {
-    //cout << "Solution: elementType loop, iteration: " << elemTypeNumber++ << endl;
-    ElementTypePtr elemTypePtr = *(elemTypeIt);
+  TBFPtr<Scalar> bf = (_bf != Teuchos::null) ? _bf : _mesh->bilinearForm();
+  int similarCellHitCountBefore = bf->similarCellHitCount();
+  int similarCellMissCountBefore = bf->similarCellMissCount();
 
-    Intrepid::FieldContainer<double> myPhysicalCellNodesForType = _mesh->physicalCellNodes(elemTypePtr);
-    Intrepid::FieldContainer<double> myCellSideParitiesForType = _mesh->cellSideParities(elemTypePtr);
-    int totalCellsForType = myPhysicalCellNodesForType.dimension(0);
-    int startCellIndexForBatch = 0;
+  int localStiffnessTimerHandle = TimeLogger::sharedInstance()->startTimer("local stiffness/load");
 
-    if (totalCellsForType == 0) continue;
-    // if we get here, there is at least one, so we find a sample cellID to help us set up prototype BasisCaches:
-    
-    // determine cellIDs
-    vector<GlobalIndexType> cellIDsOfType = _mesh->globalDofAssignment()->cellIDsOfElementType(rank, elemTypePtr);
-    
-    GlobalIndexType sampleCellID = cellIDsOfType[0];
-    BasisCachePtr basisCache = BasisCache::basisCacheForCell(_mesh,sampleCellID,false,_cubatureEnrichmentDegree);
-    BasisCachePtr ipBasisCache = BasisCache::basisCacheForCell(_mesh,sampleCellID,true,_cubatureEnrichmentDegree);
-
-    DofOrderingPtr trialOrderingPtr = elemTypePtr->trialOrderPtr;
-    DofOrderingPtr testOrderingPtr = elemTypePtr->testOrderPtr;
-    int numTrialDofs = trialOrderingPtr->totalDofs();
-    int numTestDofs = testOrderingPtr->totalDofs();
-    int maxCellBatch = MAX_BATCH_SIZE_IN_BYTES / 8 / (numTestDofs*numTestDofs + numTestDofs*numTrialDofs + numTrialDofs*numTrialDofs);
-    maxCellBatch = max( maxCellBatch, MIN_BATCH_SIZE_IN_CELLS );
-    //cout << "numTestDofs^2:" << numTestDofs*numTestDofs << endl;
-    //cout << "maxCellBatch: " << maxCellBatch << endl;
-
-    Teuchos::Array<int> nodeDimensions, parityDimensions;
-    myPhysicalCellNodesForType.dimensions(nodeDimensions);
-    myCellSideParitiesForType.dimensions(parityDimensions);
-    
-    Intrepid::FieldContainer<Scalar> localStiffness(maxCellBatch,numTrialDofs,numTrialDofs);
-    Intrepid::FieldContainer<Scalar> localRHSVector(maxCellBatch,numTrialDofs);
-    Intrepid::FieldContainer<double> goalOrientedRHSValues;
-    
-    while (startCellIndexForBatch < totalCellsForType)
+  // With pipelined assembly, cells with global dofs owned by other ranks ("halo" cells) are assembled first (phase 0);
+  // their off-rank contributions are then sent while the interior cells are assembled (phase 1).  Otherwise, all cells
+  // are assembled in a single phase, and off-rank contributions are communicated by GlobalAssemble(), below.
+  Teuchos::RCP<OffRankAssemblyExchange> exchange;
+  int numPhases = 1;
+  vector<vector<vector<GlobalIndexType>>> cellIDsForPhase; // (phase, element type ordinal) -> cellIDs; used when pipelining
+  if (_usePipelinedAssembly)
+  {
+    exchange = Teuchos::rcp( new OffRankAssemblyExchange(globalStiffness->RowMap()) );
+    numPhases = 2;
+    cellIDsForPhase.resize(numPhases, vector<vector<GlobalIndexType>>(numElementTypes));
+    vector<GlobalIndexType> cellDofs;
+    for (int elemTypeOrdinal=0; elemTypeOrdinal<numElementTypes; elemTypeOrdinal++)
     {
-      int cellsLeft = totalCellsForType - startCellIndexForBatch;
-      int numCells = min(maxCellBatch,cellsLeft);
-      localStiffness.resize(numCells,numTrialDofs,numTrialDofs);
-      localRHSVector.resize(numCells,numTrialDofs);
-
-      vector<GlobalIndexType> cellIDs;
-      for (int cellIndex=0; cellIndex<numCells; cellIndex++)
+      vector<GlobalIndexType> cellIDsOfType = _mesh->globalDofAssignment()->cellIDsOfElementType(rank, elementTypes[elemTypeOrdinal]);
+      for (GlobalIndexType cellID : cellIDsOfType)
       {
-        GlobalIndexType cellID = cellIDsOfType[cellIndex+startCellIndexForBatch];
-        cellIDs.push_back(cellID);
+        _dofInterpreter->sortedGlobalDofIndicesForCell(cellID, cellDofs);
+        bool isHaloCell = false;
+        for (GlobalIndexType dofIndex : cellDofs)
+        {
+          if (!exchange->ownsRow(dofIndex))
+          {
+            isHaloCell = true;
+            break;
+          }
+        }
+        int phase = isHaloCell ? 0 : 1;
+        cellIDsForPhase[phase][elemTypeOrdinal].push_back(cellID);
       }
-      nodeDimensions[0] = numCells;
-      parityDimensions[0] = numCells;
-      Intrepid::FieldContainer<double> physicalCellNodes(nodeDimensions,&myPhysicalCellNodesForType(startCellIndexForBatch,0,0));
-      Intrepid::FieldContainer<double> cellSideParities(parityDimensions,&myCellSideParitiesForType(startCellIndexForBatch,0));
-
-      bool createSideCacheToo = true;
-      basisCache->setPhysicalCellNodes(physicalCellNodes,cellIDs,createSideCacheToo);
-      basisCache->setCellSideParities(cellSideParities);
-
-      // hard-coding creating side cache for IP for now, since _ip->hasBoundaryTerms() only recognizes terms explicitly passed in as boundary terms:
-      ipBasisCache->setPhysicalCellNodes(physicalCellNodes,cellIDs,true);//_ip->hasBoundaryTerms()); // create side cache if ip has boundary values
-      ipBasisCache->setCellSideParities(cellSideParities); // I don't anticipate these being needed, though
+    }
+    _pipelinedHaloCellCount = 0;
+    for (auto &haloCellIDs : cellIDsForPhase[0]) _pipelinedHaloCellCount += haloCellIDs.size();
+  }
 
-      if (_bf != Teuchos::null)
-        _bf->localStiffnessMatrixAndRHS(localStiffness, localRHSVector, _ip, ipBasisCache, _rhs, basisCache);
-      else
-        _mesh->bilinearForm()->localStiffnessMatrixAndRHS(localStiffness, localRHSVector, _ip, ipBasisCache, _rhs, basisCache);
+  //  cout << "Computing local matrices" << endl;
+  for (int phase=0; phase<numPhases; phase++)
+  {
+    if (phase == 1)
+    {
+      exchange->beginExchange();
+      exchangeTimer.ResetStartTime();
+    }
+    for (int elemTypeOrdinal=0; elemTypeOrdinal<numElementTypes; elemTypeOrdinal++)
+    {
+      //cout << "Solution: elementType loop, iteration: " << elemTypeNumber++ << endl;
+      ElementTypePtr elemTypePtr = elementTypes[elemTypeOrdinal];
 
-      if (_goalOrientedRHS != Teuchos::null)
+      vector<GlobalIndexType> cellIDsOfType;
+      Intrepid::FieldContainer<double> myPhysicalCellNodesForType, myCellSideParitiesForType;
+      if (_usePipelinedAssembly)
       {
-        goalOrientedRHSValues.resize(numCells,numTrialDofs);
-        bool forceBoundaryTerm = false;
-        bool sumInto = false;
-        _goalOrientedRHS->integrate(goalOrientedRHSValues, trialOrderingPtr, basisCache, forceBoundaryTerm, sumInto);
+        cellIDsOfType = cellIDsForPhase[phase][elemTypeOrdinal];
+        cellNodesAndSideParities(_mesh, elemTypePtr, cellIDsOfType, myPhysicalCellNodesForType, myCellSideParitiesForType);
       }
-      
-      // apply filter(s) (e.g. penalty method, preconditioners, etc.)
-      if (_filter.get())
+      else
       {
-        subTimer.ResetStartTime();
-        _filter->filter(localStiffness,localRHSVector,basisCache,_mesh,_bc);
-        filterApplicationTime += subTimer.ElapsedTime();
-        //        _filter->filter(localRHSVector,physicalCellNodes,cellIDs,_mesh,_bc);
+        cellIDsOfType = _mesh->globalDofAssignment()->cellIDsOfElementType(rank, elemTypePtr);
+        myPhysicalCellNodesForType = _mesh->physicalCellNodes(elemTypePtr);
+        myCellSideParitiesForType = _mesh->cellSideParities(elemTypePtr);
       }
+      int totalCellsForType = cellIDsOfType.size();
+      int startCellIndexForBatch = 0;
+
+      if (totalCellsForType == 0) continue;
+      // if we get here, there is at least one, so we find a sample cellID to help us set up prototype BasisCaches:
+      GlobalIndexType sampleCellID = cellIDsOfType[0];
+      BasisCachePtr basisCache = BasisCache::basisCacheForCell(_mesh,sampleCellID,false,_cubatureEnrichmentDegree);
+      BasisCachePtr ipBasisCache = BasisCache::basisCacheForCell(_mesh,sampleCellID,true,_cubatureEnrichmentDegree);
+
+      DofOrderingPtr trialOrderingPtr = elemTypePtr->trialOrderPtr;
+      DofOrderingPtr testOrderingPtr = elemTypePtr->testOrderPtr;
+      int numTrialDofs = trialOrderingPtr->totalDofs();
+      int numTestDofs = testOrderingPtr->totalDofs();
+      // batch size accounts for matrix storage as well as the geometry and basis values held by the BasisCaches
+      int maxCellBatch = min(basisCache->maxCellBatchSize(elemTypePtr, MAX_BATCH_SIZE_IN_BYTES, MIN_BATCH_SIZE_IN_CELLS),
+                             ipBasisCache->maxCellBatchSize(elemTypePtr, MAX_BATCH_SIZE_IN_BYTES, MIN_BATCH_SIZE_IN_CELLS));
+      //cout << "numTestDofs^2:" << numTestDofs*numTestDofs << endl;
+      //cout << "maxCellBatch: " << maxCellBatch << endl;
+
+      Teuchos::Array<int> nodeDimensions, parityDimensions;
+      myPhysicalCellNodesForType.dimensions(nodeDimensions);
+      myCellSideParitiesForType.dimensions(parityDimensions);
+
+      Intrepid::FieldContainer<Scalar> localStiffness(maxCellBatch,numTrialDofs,numTrialDofs);
+      Intrepid::FieldContainer<Scalar> localRHSVector(maxCellBatch,numTrialDofs);
+      Intrepid::FieldContainer<double> goalOrientedRHSValues;
+
+      while (startCellIndexForBatch < totalCellsForType)
+      {
+        int cellsLeft = totalCellsForType - startCellIndexForBatch;
+        int numCells = min(maxCellBatch,cellsLeft);
+        localStiffness.resize(numCells,numTrialDofs,numTrialDofs);
+        localRHSVector.resize(numCells,numTrialDofs);
 
-      subTimer.ResetStartTime();
+        vector<GlobalIndexType> cellIDs;
+        for (int cellIndex=0; cellIndex<numCells; cellIndex++)
+        {
+          GlobalIndexType cellID = cellIDsOfType[cellIndex+startCellIndexForBatch];
+          cellIDs.push_back(cellID);
+        }
+        nodeDimensions[0] = numCells;
+        parityDimensions[0] = numCells;
+        Intrepid::FieldContainer<double> physicalCellNodes(nodeDimensions,&myPhysicalCellNodesForType(startCellIndexForBatch,0,0));
+        Intrepid::FieldContainer<double> cellSideParities(parityDimensions,&myCellSideParitiesForType(startCellIndexForBatch,0));
 
-      Intrepid::FieldContainer<GlobalIndexType> globalDofIndices;
+        bool createSideCacheToo = true;
+        basisCache->setPhysicalCellNodes(physicalCellNodes,cellIDs,createSideCacheToo);
+        basisCache->setCellSideParities(cellSideParities);
 
-      Intrepid::FieldContainer<GlobalIndexTypeToCast> globalDofIndicesCast;
+        // requesting side cache for IP even though _ip->hasBoundaryTerms() may be false, since that only recognizes terms explicitly
+        // passed in as boundary terms.  Side caches are built lazily, so an IP without boundary terms never pays for them.
+        ipBasisCache->setPhysicalCellNodes(physicalCellNodes,cellIDs,true);//_ip->hasBoundaryTerms()); // create side cache if ip has boundary values
+        ipBasisCache->setCellSideParities(cellSideParities); // I don't anticipate these being needed, though
 
-      Teuchos::Array<int> localStiffnessDim(2,numTrialDofs);
-      Teuchos::Array<int> localRHSDim(1,numTrialDofs);
+        bf->localStiffnessMatrixAndRHS(localStiffness, localRHSVector, _ip, ipBasisCache, _rhs, basisCache);
 
-      Intrepid::FieldContainer<Scalar> interpretedStiffness;
-      Intrepid::FieldContainer<Scalar> interpretedRHS;
+        if (_goalOrientedRHS != Teuchos::null)
+        {
+          goalOrientedRHSValues.resize(numCells,numTrialDofs);
+          bool forceBoundaryTerm = false;
+          bool sumInto = false;
+          _goalOrientedRHS->integrate(goalOrientedRHSValues, trialOrderingPtr, basisCache, forceBoundaryTerm, sumInto);
+        }
 
-      Teuchos::Array<int> dim;
-      // determine cellIDs
-      vector<GlobalIndexType> cellIDsOfType = _mesh->globalDofAssignment()->cellIDsOfElementType(rank, elemTypePtr);
-      
-      for (int cellIndex=0; cellIndex<numCells; cellIndex++)
-      {
-        GlobalIndexType cellID = cellIDsOfType[cellIndex+startCellIndexForBatch];
-        
-        Intrepid::FieldContainer<Scalar> cellStiffness(localStiffnessDim,&localStiffness(cellIndex,0,0)); // shallow copy
-        Intrepid::FieldContainer<Scalar> cellRHS(localRHSDim,&localRHSVector(cellIndex,0)); // shallow copy
+        // apply filter(s) (e.g. penalty method, preconditioners, etc.)
+        if (_filter.get())
+        {
+          subTimer.ResetStartTime();
+          _filter->filter(localStiffness,localRHSVector,basisCache,_mesh,_bc);
+          filterApplicationTime += subTimer.ElapsedTime();
+          //        _filter->filter(localRHSVector,physicalCellNodes,cellIDs,_mesh,_bc);
+        }
 
-        _dofInterpreter->interpretLocalData(cellID, cellStiffness, cellRHS, interpretedStiffness, interpretedRHS, globalDofIndices);
+        subTimer.ResetStartTime();
 
-        // cast whatever the global index type is to a type that Epetra supports
-        globalDofIndices.dimensions(dim);
-        globalDofIndicesCast.resize(dim);
+        Intrepid::FieldContainer<GlobalIndexType> globalDofIndices;
 
-        for (int dofOrdinal = 0; dofOrdinal < globalDofIndices.size(); dofOrdinal++)
-        {
-          globalDofIndicesCast[dofOrdinal] = globalDofIndices[dofOrdinal];
-        }
+        Intrepid::FieldContainer<GlobalIndexTypeToCast> globalDofIndicesCast;
 
-        globalStiffness->InsertGlobalValues(globalDofIndices.size(),&globalDofIndicesCast(0),
-                                            globalDofIndices.size(),&globalDofIndicesCast(0),&interpretedStiffness[0]);
-        const int STANDARD_RHS_INDEX = 0; // to distinguish from the "goal-oriented" index...
-        _rhsVector->SumIntoGlobalValues(globalDofIndices.size(),&globalDofIndicesCast(0),&interpretedRHS[0],STANDARD_RHS_INDEX);
-        
-        if (_goalOrientedRHS != Teuchos::null)
+        Teuchos::Array<int> localStiffnessDim(2,numTrialDofs);
+        Teuchos::Array<int> localRHSDim(1,numTrialDofs);
+
+        Intrepid::FieldContainer<Scalar> interpretedStiffness;
+        Intrepid::FieldContainer<Scalar> interpretedRHS;
+
+        Teuchos::Array<int> dim;
+
+        for (int cellIndex=0; cellIndex<numCells; cellIndex++)
         {
-          Intrepid::FieldContainer<Scalar> cellGoalOrientedRHS(localRHSDim,&goalOrientedRHSValues(cellIndex,0)); // shallow copy
-          _dofInterpreter->interpretLocalData(cellID, cellGoalOrientedRHS, interpretedRHS, globalDofIndices);
-          const int GOAL_ORIENTED_RHS_INDEX = 1;
-          _rhsVector->SumIntoGlobalValues(globalDofIndices.size(),&globalDofIndicesCast(0),&interpretedRHS[0],GOAL_ORIENTED_RHS_INDEX);
+          GlobalIndexType cellID = cellIDsOfType[cellIndex+startCellIndexForBatch];
+
+          Intrepid::FieldContainer<Scalar> cellStiffness(localStiffnessDim,&localStiffness(cellIndex,0,0)); // shallow copy
+          Intrepid::FieldContainer<Scalar> cellRHS(localRHSDim,&localRHSVector(cellIndex,0)); // shallow copy
+
+          _dofInterpreter->interpretLocalData(cellID, cellStiffness, cellRHS, interpretedStiffness, interpretedRHS, globalDofIndices);
+
+          // cast whatever the global index type is to a type that Epetra supports
+          globalDofIndices.dimensions(dim);
+          globalDofIndicesCast.resize(dim);
+
+          for (int dofOrdinal = 0; dofOrdinal < globalDofIndices.size(); dofOrdinal++)
+          {
+            globalDofIndicesCast[dofOrdinal] = globalDofIndices[dofOrdinal];
+          }
+
+          const int STANDARD_RHS_INDEX = 0; // to distinguish from the "goal-oriented" index...
+          if (exchange != Teuchos::null)
+          {
+            exchange->sumIntoMatrix(*globalStiffness, globalDofIndices.size(), &globalDofIndicesCast(0), &interpretedStiffness[0]);
+            exchange->sumIntoVector(*_rhsVector, STANDARD_RHS_INDEX, globalDofIndices.size(), &globalDofIndicesCast(0), &interpretedRHS[0]);
+          }
+          else
+          {
+            globalStiffness->InsertGlobalValues(globalDofIndices.size(),&globalDofIndicesCast(0),
+                                                globalDofIndices.size(),&globalDofIndicesCast(0),&interpretedStiffness[0]);
+            _rhsVector->SumIntoGlobalValues(globalDofIndices.size(),&globalDofIndicesCast(0),&interpretedRHS[0],STANDARD_RHS_INDEX);
+          }
+
+          if (_goalOrientedRHS != Teuchos::null)
+          {
+            Intrepid::FieldContainer<Scalar> cellGoalOrientedRHS(localRHSDim,&goalOrientedRHSValues(cellIndex,0)); // shallow copy
+            _dofInterpreter->interpretLocalData(cellID, cellGoalOrientedRHS, interpretedRHS, globalDofIndices);
+            const int GOAL_ORIENTED_RHS_INDEX = 1;
+            if (exchange != Teuchos::null)
+              exchange->sumIntoVector(*_rhsVector, GOAL_ORIENTED_RHS_INDEX, globalDofIndices.size(), &globalDofIndicesCast(0), &interpretedRHS[0]);
+            else
+              _rhsVector->SumIntoGlobalValues(globalDofIndices.size(),&globalDofIndicesCast(0),&interpretedRHS[0],GOAL_ORIENTED_RHS_INDEX);
+          }
         }
-      }
-      localStiffnessInterpretationTime += subTimer.ElapsedTime();
+        localStiffnessInterpretationTime += subTimer.ElapsedTime();
 
-      startCellIndexForBatch += numCells;
+        startCellIndexForBatch += numCells;
+      }
     }
   }
   {
@@ -1216,13 +1312,30 @@ void TSolution<Scalar>::populateStiffnessAndLoad()
         cout << "filterApplicationTime: " << filterApplicationTime << " seconds.\n";*/
   }
 
+  if (exchange != Teuchos::null)
+  {
+    timeExchangeOverlap = exchangeTimer.ElapsedTime(); // interior assembly, during which the exchange is in flight
+  }
   TimeLogger::sharedInstance()->stopTimer(localStiffnessTimerHandle);
   double timeLocalStiffness = timer.ElapsedTime();
+
+  if (_reportTimingResults && bf->useStiffnessReuseForSimilarCells())
+  {
+    int localCounts[2] = {bf->similarCellHitCount() - similarCellHitCountBefore, bf->similarCellMissCount() - similarCellMissCountBefore};
+    int globalCounts[2];
+    Comm->SumAll(localCounts, globalCounts, 2);
+    int totalCells = globalCounts[0] + globalCounts[1];
+    if ((rank == 0) && (totalCells > 0))
+    {
+      cout << "stiffness reuse for similar cells: " << globalCounts[0] << " of " << totalCells << " cells (";
+      cout << (100.0 * globalCounts[0]) / totalCells << "%) copied their local stiffness.\n";
+    }
+  }
   //  cout << "Done computing local matrices" << endl;
   Epetra_Vector timeLocalStiffnessVector(timeMap);
   timeLocalStiffnessVector[0] = timeLocalStiffness;
 
-  int localRowIndex = myGlobalIndicesSet.size(); // starts where the dofs left off
+  int localRowIndex = myGlobalDofCount; // starts where the dofs left off
 
   // order is: element-lagrange, then (on rank 0) global lagrange and ZMC
   for (int elementConstraintIndex = 0; elementConstraintIndex < _lagrangeConstraints->numElementConstraints();
@@ -1388,6 +1501,18 @@ void TSolution<Scalar>::populateStiffnessAndLoad()
   }
   // end of ZMC imposition
 
+  if (exchange != Teuchos::null)
+  {
+    // time spent here is the part of the exchange not hidden behind interior assembly (and the Lagrange constraints above)
+    exchangeTimer.ResetStartTime();
+    exchange->endExchange(*globalStiffness, *_rhsVector);
+    timeExchangeWait = exchangeTimer.ElapsedTime();
+    _pipelinedSentEntryCount = exchange->sentEntryCount();
+  }
+  Epetra_Vector timeExchangeOverlapVector(timeMap), timeExchangeWaitVector(timeMap);
+  timeExchangeOverlapVector[0] = timeExchangeOverlap;
+  timeExchangeWaitVector[0] = timeExchangeWait;
+
   Comm->Barrier();  // for cleaner time measurements, let everyone else catch up before calling ResetStartTime() and GlobalAssemble()
   timer.ResetStartTime();
 
@@ -1450,6 +1575,16 @@ void TSolution<Scalar>::populateStiffnessAndLoad()
   err = timeLocalStiffnessVector.MaxValue( &_maxTimeLocalStiffness );
   err = timeGlobalAssemblyVector.MaxValue( &_maxTimeGlobalAssembly );
   err = timeBCImpositionVector.MaxValue( &_maxTimeBCImposition );
+
+  err = timeExchangeOverlapVector.Norm1( &_totalTimeExchangeOverlap );
+  err = timeExchangeOverlapVector.MeanValue( &_meanTimeExchangeOverlap );
+  err = timeExchangeOverlapVector.MinValue( &_minTimeExchangeOverlap );
+  err = timeExchangeOverlapVector.MaxValue( &_maxTimeExchangeOverlap );
+
+  err = timeExchangeWaitVector.Norm1( &_totalTimeExchangeWait );
+  err = timeExchangeWaitVector.MeanValue( &_meanTimeExchangeWait );
+  err = timeExchangeWaitVector.MinValue( &_minTimeExchangeWait );
+  err = timeExchangeWaitVector.MaxValue( &_maxTimeExchangeWait );
 }
 
 template <typename Scalar>
@@ -1527,6 +1662,13 @@ int TSolution<Scalar>::solveWithPrepopulatedStiffnessAndLoad(TSolverPtr<Scalar>
 
 template <typename Scalar>
 int TSolution<Scalar>::solve(TSolverPtr<Scalar> solver)
+{
+  assembleSystem(solver);
+  return solveAssembledSystem(solver);
+}
+
+template <typename Scalar>
+void TSolution<Scalar>::assembleSystem(TSolverPtr<Scalar> solver)
 {
   if (_oldDofInterpreter.get() != NULL)   // proxy for having a condensation interpreter
   {
@@ -1542,6 +1684,11 @@ int TSolution<Scalar>::solve(TSolverPtr<Scalar> solver)
   setProblem(solver);
   applyDGJumpTerms();
   populateStiffnessAndLoad();
+}
+
+template <typename Scalar>
+int TSolution<Scalar>::solveAssembledSystem(TSolverPtr<Scalar> solver)
+{
   int solveSuccess = solveWithPrepopulatedStiffnessAndLoad(solver);
 //  cout << "about to call importSolution on rank " << rank << endl;
   importSolution();
@@ -1569,6 +1716,11 @@ void TSolution<Scalar>::reportTimings()
     cout << "****** SUM OF TIMING REPORTS ******\n";
     cout << "localStiffness: " << _totalTimeLocalStiffness << " sec." << endl;
     cout << "globalAssembly: " << _totalTimeGlobalAssembly << " sec." << endl;
+    if (_usePipelinedAssembly)
+    {
+      cout << "exch. overlap:  " << _totalTimeExchangeOverlap << " sec." << endl;
+      cout << "exch. wait:     " << _totalTimeExchangeWait << " sec." << endl;
+    }
     cout << "impose BCs:     " << _totalTimeBCImposition << " sec." << endl;
     cout << "solve:          " << _totalTimeSolve << " sec." << endl;
     cout << "dist. solution: " << _totalTimeDistributeSolution << " sec." << endl << endl;
@@ -1576,6 +1728,11 @@ void TSolution<Scalar>::reportTimings()
     cout << "****** MEAN OF TIMING REPORTS ******\n";
     cout << "localStiffness: " << _meanTimeLocalStiffness << " sec." << endl;
     cout << "globalAssembly: " << _meanTimeGlobalAssembly << " sec." << endl;
+    if (_usePipelinedAssembly)
+    {
+      cout << "exch. overlap:  " << _meanTimeExchangeOverlap << " sec." << endl;
+      cout << "exch. wait:     " << _meanTimeExchangeWait << " sec." << endl;
+    }
     cout << "impose BCs:     " << _meanTimeBCImposition << " sec." << endl;
     cout << "solve:          " << _meanTimeSolve << " sec." << endl;
     cout << "dist. solution: " << _meanTimeDistributeSolution << " sec." << endl << endl;
@@ -1583,6 +1740,11 @@ void TSolution<Scalar>::reportTimings()
     cout << "****** MAX OF TIMING REPORTS ******\n";
     cout << "localStiffness: " << _maxTimeLocalStiffness << " sec." << endl;
     cout << "globalAssembly: " << _maxTimeGlobalAssembly << " sec." << endl;
+    if (_usePipelinedAssembly)
+    {
+      cout << "exch. overlap:  " << _maxTimeExchangeOverlap << " sec." << endl;
+      cout << "exch. wait:     " << _maxTimeExchangeWait << " sec." << endl;
+    }
     cout << "impose BCs:     " << _maxTimeBCImposition << " sec." << endl;
     cout << "solve:          " << _maxTimeSolve << " sec." << endl;
     cout << "dist. solution: " << _maxTimeDistributeSolution << " sec." << endl << endl;
@@ -1590,6 +1752,11 @@ void TSolution<Scalar>::reportTimings()
     cout << "****** MIN OF TIMING REPORTS ******\n";
     cout << "localStiffness: " << _minTimeLocalStiffness << " sec." << endl;
     cout << "globalAssembly: " << _minTimeGlobalAssembly << " sec." << endl;
+    if (_usePipelinedAssembly)
+    {
+      cout << "exch. overlap:  " << _minTimeExchangeOverlap << " sec." << endl;
+      cout << "exch. wait:     " << _minTimeExchangeWait << " sec." << endl;
+    }
     cout << "impose BCs:     " << _minTimeBCImposition << " sec." << endl;
     cout << "solve:          " << _minTimeSolve << " sec." << endl;
     cout << "dist. solution: " << _minTimeDistributeSolution << " sec." << endl;
@@ -1623,88 +1790,72 @@ TRHSPtr<Scalar> TSolution<Scalar>::rhs() const
   return _rhs;
 }
 
+template <typename Scalar>
+void TSolution<Scalar>::importCellCoefficients(GlobalIndexType cellID, const Epetra_MultiVector &globalCoefficients)
+{
+  int numSolutions = this->numSolutions();
+  int numDofs = _mesh->getElementType(cellID)->trialOrderPtr->totalDofs();
+  if (numSolutions == 1)
+  {
+    Intrepid::FieldContainer<Scalar> cellDofs(numDofs);
+    _dofInterpreter->interpretGlobalCoefficients(cellID,cellDofs,globalCoefficients);
+    _solutionForCellID[0][cellID] = cellDofs;
+  }
+  else
+  {
+    Intrepid::FieldContainer<Scalar> cellDofs(numSolutions,numDofs);
+    _dofInterpreter->interpretGlobalCoefficients(cellID,cellDofs,globalCoefficients);
+    for (int solutionOrdinal=0; solutionOrdinal<numSolutions; solutionOrdinal++)
+    {
+      _solutionForCellID[solutionOrdinal][cellID].resize(numDofs);
+      auto & solutionForCell = _solutionForCellID[solutionOrdinal][cellID];
+      for (int dofOrdinal=0; dofOrdinal<numDofs; dofOrdinal++)
+      {
+        solutionForCell(dofOrdinal) = cellDofs(solutionOrdinal,dofOrdinal);
+      }
+    }
+  }
+}
+
 template <typename Scalar>
 void TSolution<Scalar>::importSolution()
 {
   Epetra_CommPtr Comm = _mesh->Comm();
   Epetra_Time timer(*Comm);
 
-//  cout << "on rank " << rank << ", about to determine globalDofIndicesForPartition\n";
-
-  set<GlobalIndexType> globalDofIndicesForMyCells;
-  const set<GlobalIndexType>* myCellIDs = &_mesh->globalDofAssignment()->cellsInPartition(-1);
-  for (GlobalIndexType cellID : *myCellIDs)
+  // The import plan depends on the rank-local cells and their global dofs, so it only needs rebuilding when the
+  // dof numbering (or partitioning) changes, or when the dof interpreter is swapped.  Building it is collective,
+  // so ranks must agree on whether to rebuild.
+  GlobalDofAssignmentPtr gda = _mesh->globalDofAssignment();
+  bool planIsValid = _reuseImportPlan && (_importPlan != Teuchos::null)
+                     && (_importPlanDofInterpreter.get() == _dofInterpreter.get())
+                     && (_importPlanGDA.get() == gda.get())
+                     && (_importPlanDofNumberingVersion == gda->dofNumberingVersion())
+                     && _importPlan->isCompatibleSource(_lhsVector->Map());
+  int myRebuild = planIsValid ? 0 : 1, anyRebuild;
+  Comm->MaxAll(&myRebuild, &anyRebuild, 1);
+  if (anyRebuild)
   {
-    set<GlobalIndexType> globalDofsForCell = _dofInterpreter->globalDofIndicesForCell(cellID);
-//    cout << "globalDofs for cell " << cellID << ":\n";
-//    Camellia::print("globalDofIndices", globalDofsForCell);
-
-    globalDofIndicesForMyCells.insert(globalDofsForCell.begin(),globalDofsForCell.end());
+    const set<GlobalIndexType>* myCellIDs = &gda->cellsInPartition(-1);
+    _importPlan = Teuchos::null; // free the old plan before building the new one
+    _importPlan = Teuchos::rcp( new HaloImportPlan(*myCellIDs, _dofInterpreter.get(), _lhsVector->Map()) );
+    _importPlanDofInterpreter = _dofInterpreter;
+    _importPlanGDA = gda;
+    _importPlanDofNumberingVersion = gda->dofNumberingVersion();
   }
 
-//  cout << "on rank " << rank << ", about to create myDofs container of size "<< globalDofIndicesForMyCells.size() << "\n";
-  GlobalIndexTypeToCast myDofs[globalDofIndicesForMyCells.size()];
-  GlobalIndexTypeToCast* myDof = (globalDofIndicesForMyCells.size() > 0) ? &myDofs[0] : NULL;
-  for (set<GlobalIndexType>::iterator dofIndexIt = globalDofIndicesForMyCells.begin();
-       dofIndexIt != globalDofIndicesForMyCells.end(); dofIndexIt++)
+  // Import solution onto current processor, interpreting the cells whose coefficients we own while the halo exchange is in flight
+  Epetra_MultiVector solnCoeff(_importPlan->targetMap(), _lhsVector->NumVectors());
+  _importPlan->beginImport(*_lhsVector, solnCoeff);
+  for (GlobalIndexType cellID : _importPlan->ownedCellIDs())
   {
-    *myDof = *dofIndexIt;
-    myDof++;
+    importCellCoefficients(cellID, solnCoeff);
   }
-//  cout << "on rank " << rank << ", about to create myCellsMap\n";
-  Epetra_Map     myCellsMap = Epetra_Map(-1, globalDofIndicesForMyCells.size(), myDofs, 0, *Comm); // 0: IndexBase
-
-  // Import solution onto current processor
-  Epetra_Map partMap = getPartitionMap();
-  Epetra_Import  solnImporter(myCellsMap, partMap);
-  Epetra_MultiVector  solnCoeff(myCellsMap, _lhsVector->NumVectors());
-//  cout << "on rank " << rank << ", about to Import\n";
-  solnCoeff.Import(*_lhsVector, solnImporter, Insert);
-//  cout << "on rank " << rank << ", returned from Import\n";
-
-  // copy the dof coefficients into our data structure
-  for (GlobalIndexType cellID : *myCellIDs)
+  _importPlan->endImport(solnCoeff);
+  for (GlobalIndexType cellID : _importPlan->haloCellIDs())
   {
-//    cout << "on rank " << rank << ", about to interpret data for cell " << cellID << "\n";
-    int numSolutions = this->numSolutions();
-    if (numSolutions == 1)
-    {
-      Intrepid::FieldContainer<Scalar> cellDofs(_mesh->getElementType(cellID)->trialOrderPtr->totalDofs());
-      _dofInterpreter->interpretGlobalCoefficients(cellID,cellDofs,solnCoeff);
-      _solutionForCellID[0][cellID] = cellDofs;
-    }
-    else
-    {
-//      { // DEBUGGING
-//        cout << "For multi-solution, passing solnCoeff to interpretGlobalCoefficients:\n";
-//        int myLength = solnCoeff.MyLength();
-//        int myRank = Comm->MyPID();
-//        for (int solutionOrdinal=0; solutionOrdinal<numSolutions; solutionOrdinal++)
-//        {
-//          for (int localOrdinal=0; localOrdinal<myLength; localOrdinal++)
-//          {
-//            cout << "On rank " << myRank << ", solnCoeff[" << solutionOrdinal << "][" << localOrdinal << "] = ";
-//            cout << solnCoeff[solutionOrdinal][localOrdinal] << endl;;
-//          }
-//        }
-//      }
-      
-      Intrepid::FieldContainer<Scalar> cellDofs(numSolutions,_mesh->getElementType(cellID)->trialOrderPtr->totalDofs());
-      _dofInterpreter->interpretGlobalCoefficients(cellID,cellDofs,solnCoeff);
-//      cout << "cellDofs returned by interpretGlobalCoefficients (for multi-solution):\n" << cellDofs;
-      int numDofs = _mesh->getElementType(cellID)->trialOrderPtr->totalDofs();
-      for (int solutionOrdinal=0; solutionOrdinal<numSolutions; solutionOrdinal++)
-      {
-        _solutionForCellID[solutionOrdinal][cellID].resize(numDofs);
-        auto & solutionForCell = _solutionForCellID[solutionOrdinal][cellID];
-        for (int dofOrdinal=0; dofOrdinal<numDofs; dofOrdinal++)
-        {
-          solutionForCell(dofOrdinal) = cellDofs(solutionOrdinal,dofOrdinal);
-        }
-      }
-    }
+    importCellCoefficients(cellID, solnCoeff);
   }
-//  cout << "on rank " << rank << ", finished interpretation\n";
   double timeDistributeSolution = timer.ElapsedTime();
 
   int numProcs = Teuchos::GlobalMPISession::getNProc();
@@ -1739,48 +1890,72 @@ void TSolution<Scalar>::importSolutionForOffRankCells(std::set<GlobalIndexType>
     }
   }
   
-  // it appears to be important that the requests be sorted by MPI rank number
-  // the requestMap below accomplishes that.
-  
-  map<int, vector<GlobalIndexTypeToCast>> requestMap;
-  
-  for (GlobalIndexType cellID : cellIDs)
+  // The communication plan depends only on the requested cells and the partitioning, so we reuse it until either changes.
+  // Building it is collective, so ranks must agree on whether to rebuild.
+  GlobalDofAssignmentPtr gda = _mesh->globalDofAssignment();
+  bool planIsValid = _reuseImportPlan && (_offRankImportDistributor != Teuchos::null)
+                     && (_offRankImportGDA.get() == gda.get())
+                     && (_offRankImportDofNumberingVersion == gda->dofNumberingVersion())
+                     && (_offRankImportCellIDs == cellIDs);
+  int myRebuild = planIsValid ? 0 : 1, anyRebuild;
+  Comm->MaxAll(&myRebuild, &anyRebuild, 1);
+  if (anyRebuild)
   {
-    int partitionForCell = _mesh->globalDofAssignment()->partitionForCellID(cellID);
-    if (partitionForCell != rank)
+    // it appears to be important that the requests be sorted by MPI rank number
+    // the requestMap below accomplishes that.
+    
+    map<int, vector<GlobalIndexTypeToCast>> requestMap;
+    
+    for (GlobalIndexType cellID : cellIDs)
     {
-      requestMap[partitionForCell].push_back(cellID);
+      int partitionForCell = gda->partitionForCellID(cellID);
+      if (partitionForCell != rank)
+      {
+        requestMap[partitionForCell].push_back(cellID);
+      }
     }
-  }
-  
-  vector<int> myRequestOwners;
-  vector<GlobalIndexTypeToCast> myRequest;
+    
+    vector<int> myRequestOwners;
+    vector<GlobalIndexTypeToCast> myRequest;
 
-  for (auto entry : requestMap)
-  {
-    int partition = entry.first;
-    for (auto cellIDInPartition : entry.second)
+    for (auto entry : requestMap)
     {
-      myRequest.push_back(cellIDInPartition);
-      myRequestOwners.push_back(partition);
+      int partition = entry.first;
+      for (auto cellIDInPartition : entry.second)
+      {
+        myRequest.push_back(cellIDInPartition);
+        myRequestOwners.push_back(partition);
+      }
     }
-  }
 
-  int myRequestCount = myRequest.size();
-  Teuchos::RCP<Epetra_Distributor> distributor = MPIWrapper::getDistributor(*_mesh->Comm());
+    int myRequestCount = myRequest.size();
+    Teuchos::RCP<Epetra_Distributor> distributor = MPIWrapper::getDistributor(*_mesh->Comm());
 
-  GlobalIndexTypeToCast* myRequestPtr = NULL;
-  int *myRequestOwnersPtr = NULL;
-  if (myRequest.size() > 0)
-  {
-    myRequestPtr = &myRequest[0];
-    myRequestOwnersPtr = &myRequestOwners[0];
-  }
-  int numCellsToExport = 0;
-  GlobalIndexTypeToCast* cellIDsToExport = NULL;  // we are responsible for deleting the allocated arrays
-  int* exportRecipients = NULL;
+    GlobalIndexTypeToCast* myRequestPtr = NULL;
+    int *myRequestOwnersPtr = NULL;
+    if (myRequest.size() > 0)
+    {
+      myRequestPtr = &myRequest[0];
+      myRequestOwnersPtr = &myRequestOwners[0];
+    }
+    int numCellsToExport = 0;
+    GlobalIndexTypeToCast* cellIDsToExport = NULL;  // we are responsible for deleting the allocated arrays
+    int* exportRecipients = NULL;
 
-  distributor->CreateFromRecvs(myRequestCount, myRequestPtr, myRequestOwnersPtr, true, numCellsToExport, cellIDsToExport, exportRecipients);
+    distributor->CreateFromRecvs(myRequestCount, myRequestPtr, myRequestOwnersPtr, true, numCellsToExport, cellIDsToExport, exportRecipients);
+
+    _offRankImportCellsToExport.assign(cellIDsToExport, cellIDsToExport + numCellsToExport);
+    if( cellIDsToExport != 0 ) delete [] cellIDsToExport;
+    if( exportRecipients != 0 ) delete [] exportRecipients;
+
+    _offRankImportDistributor = distributor;
+    _offRankImportRequest = myRequest;
+    _offRankImportCellIDs = cellIDs;
+    _offRankImportGDA = gda;
+    _offRankImportDofNumberingVersion = gda->dofNumberingVersion();
+  }
+  Teuchos::RCP<Epetra_Distributor> distributor = _offRankImportDistributor;
+  int numCellsToExport = _offRankImportCellsToExport.size();
 
   const std::set<GlobalIndexType>* myCells = &_mesh->globalDofAssignment()->cellsInPartition(-1);
   
@@ -1793,7 +1968,7 @@ void TSolution<Scalar>::importSolutionForOffRankCells(std::set<GlobalIndexType>
   {
     for (int cellOrdinal=0; cellOrdinal<numCellsToExport; cellOrdinal++)
     {
-      GlobalIndexType cellID = cellIDsToExport[cellOrdinal];
+      GlobalIndexType cellID = _offRankImportCellsToExport[cellOrdinal];
       if (myCells->find(cellID) == myCells->end())
       {
         cout << "cellID " << cellID << " does not belong to rank " << rank << endl;
@@ -1829,7 +2004,7 @@ void TSolution<Scalar>::importSolutionForOffRankCells(std::set<GlobalIndexType>
   int dofsImported = 0;
   for (int solutionOrdinal=0; solutionOrdinal < solutionCount; solutionOrdinal++)
   {
-    for (vector<GlobalIndexTypeToCast>::iterator cellIDIt = myRequest.begin(); cellIDIt != myRequest.end(); cellIDIt++)
+    for (vector<GlobalIndexTypeToCast>::iterator cellIDIt = _offRankImportRequest.begin(); cellIDIt != _offRankImportRequest.end(); cellIDIt++)
     {
       GlobalIndexType cellID = *cellIDIt;
       Intrepid::FieldContainer<Scalar> cellDofs(_mesh->getElementType(cellID)->trialOrderPtr->totalDofs());
@@ -1848,8 +2023,6 @@ void TSolution<Scalar>::importSolutionForOffRankCells(std::set<GlobalIndexType>
     }
   }
 
-  if( cellIDsToExport != 0 ) delete [] cellIDsToExport;
-  if( exportRecipients != 0 ) delete [] exportRecipients;
   if (importedData != 0 ) delete [] importedData;
 }
 
@@ -2132,8 +2305,7 @@ void TSolution<Scalar>::imposeZMCsUsingLagrange()
 
   Epetra_Map partMap = getPartitionMap();
 
-  set<GlobalIndexType> myGlobalIndicesSet = _dofInterpreter->globalDofIndicesForPartition(rank);
-  int localRowIndex = myGlobalIndicesSet.size();
+  int localRowIndex = _dofInterpreter->globalDofCountForPartition(rank);
   int numLocalActiveElements = _mesh->globalDofAssignment()->cellsInPartition(rank).size();
   localRowIndex += numLocalActiveElements * _lagrangeConstraints->numElementConstraints() + _lagrangeConstraints->numGlobalConstraints();
 
@@ -2236,6 +2408,47 @@ Teuchos::RCP<LocalStiffnessMatrixFilter> TSolution<Scalar>::filter() const
   return _filter;
 }
 
+template <typename Scalar>
+map<string, long long> TSolution<Scalar>::approximateMemoryCosts() const
+{
+  map<string, long long> variableCost;
+  
+  variableCost["_solutionForCellID"] = approximateVectorSizeLLVM(_solutionForCellID);
+  for (auto &solutionMap : _solutionForCellID)
+  {
+    variableCost["_solutionForCellID"] += approximateFieldContainerMapSize(solutionMap) - sizeof(solutionMap);
+  }
+  variableCost["_energyErrorForCell"] = approximateMapSizeLLVM(_energyErrorForCell);
+  variableCost["_residualForCell"] = approximateFieldContainerMapSize(_residualForCell);
+  variableCost["_errorRepresentationForCell"] = approximateFieldContainerMapSize(_errorRepresentationForCell);
+  variableCost["_rhsRepresentationForCell"] = approximateFieldContainerMapSize(_rhsRepresentationForCell);
+  variableCost["_refinementTransferMatrices"] = approximateFieldContainerMapSize(_refinementTransferMatrices);
+  
+  // global matrix and vectors: values and column indices, ignoring Epetra's maps and graph overhead
+  variableCost["_globalStiffMatrix"] = 0;
+  if (_globalStiffMatrix != Teuchos::null)
+  {
+    variableCost["_globalStiffMatrix"] = (sizeof(double) + sizeof(int)) * (long long) _globalStiffMatrix->NumMyNonzeros();
+  }
+  variableCost["_rhsVector"] = 0;
+  if (_rhsVector != Teuchos::null)
+  {
+    variableCost["_rhsVector"] = sizeof(double) * (long long) _rhsVector->MyLength() * _rhsVector->NumVectors();
+  }
+  variableCost["_lhsVector"] = 0;
+  if (_lhsVector != Teuchos::null)
+  {
+    variableCost["_lhsVector"] = sizeof(double) * (long long) _lhsVector->MyLength() * _lhsVector->NumVectors();
+  }
+  
+  if (_dofInterpreter.get() != _mesh.get())
+  {
+    addMemoryCosts(variableCost, "_dofInterpreter.", _dofInterpreter->approximateMemoryCosts());
+  }
+  
+  return variableCost;
+}
+
 template <typename Scalar>
 Teuchos::RCP<DofInterpreter> TSolution<Scalar>::getDofInterpreter() const
 {
@@ -2554,8 +2767,8 @@ const map<GlobalIndexType,double> & TSolution<Scalar>::rankLocalEnergyError()
 
   computeErrorRepresentation();
 
-  set<GlobalIndexType> rankLocalCells = _mesh->cellIDsInPartition();
-  for (set<GlobalIndexType>::iterator cellIDIt = rankLocalCells.begin(); cellIDIt != rankLocalCells.end(); cellIDIt++)
+  const set<GlobalIndexType> &rankLocalCells = _mesh->cellIDsInPartition();
+  for (set<GlobalIndexType>::const_iterator cellIDIt = rankLocalCells.begin(); cellIDIt != rankLocalCells.end(); cellIDIt++)
   {
     GlobalIndexType cellID = *cellIDIt;
 
@@ -2624,8 +2837,8 @@ void TSolution<Scalar>::computeResiduals()
   // I'm not sure what we'll need for the influence function (this will depend on the error indicator selected,
   // and for that we may not even use a residual).
   const int solutionOrdinal = 0; // primary solution
-  set<GlobalIndexType> rankLocalCells = _mesh->cellIDsInPartition();
-  for (set<GlobalIndexType>::iterator cellIDIt = rankLocalCells.begin(); cellIDIt != rankLocalCells.end(); cellIDIt++)
+  const set<GlobalIndexType> &rankLocalCells = _mesh->cellIDsInPartition();
+  for (set<GlobalIndexType>::const_iterator cellIDIt = rankLocalCells.begin(); cellIDIt != rankLocalCells.end(); cellIDIt++)
   {
     GlobalIndexType cellID = *cellIDIt;
 
@@ -3119,6 +3332,11 @@ void TSolution<Scalar>::writeStatsToFile(const string &filePath, int precision)
   fout << "stat.\tmean\tmin\tmax\ttotal\n";
   fout << "localStiffness\t" << _meanTimeLocalStiffness << "\t" <<_minTimeLocalStiffness << "\t" <<_maxTimeLocalStiffness << "\t" << _totalTimeLocalStiffness << endl;
   fout << "globalAssembly\t" <<  _meanTimeGlobalAssembly << "\t" <<_minTimeGlobalAssembly << "\t" <<_maxTimeGlobalAssembly << "\t" << _totalTimeGlobalAssembly << endl;
+  if (_usePipelinedAssembly)
+  {
+    fout << "exch. overlap\t" << _meanTimeExchangeOverlap << "\t" << _minTimeExchangeOverlap << "\t" << _maxTimeExchangeOverlap << "\t" << _totalTimeExchangeOverlap << endl;
+    fout << "exch. wait\t" << _meanTimeExchangeWait << "\t" << _minTimeExchangeWait << "\t" << _maxTimeExchangeWait << "\t" << _totalTimeExchangeWait << endl;
+  }
   fout << "impose BCs\t" <<  _meanTimeBCImposition << "\t" <<_minTimeBCImposition << "\t" <<_maxTimeBCImposition << "\t" << _totalTimeBCImposition << endl;
   fout << "solve\t" << _meanTimeSolve << "\t" <<_minTimeSolve << "\t" <<_maxTimeSolve << "\t" << _totalTimeSolve << endl;
   fout << "dist. solution\t" <<  _meanTimeDistributeSolution << "\t" << _minTimeDistributeSolution << "\t" <<_maxTimeDistributeSolution << "\t" << _totalTimeDistributeSolution << endl;
@@ -3454,6 +3672,18 @@ double TSolution<Scalar>::totalTimeDistributeSolution()
   return _totalTimeDistributeSolution;
 }
 
+template <typename Scalar>
+double TSolution<Scalar>::totalTimeExchangeOverlap()
+{
+  return _totalTimeExchangeOverlap;
+}
+
+template <typename Scalar>
+double TSolution<Scalar>::totalTimeExchangeWait()
+{
+  return _totalTimeExchangeWait;
+}
+
 template <typename Scalar>
 double TSolution<Scalar>::meanTimeApplyJumpTerms()
 {
@@ -3490,6 +3720,18 @@ double TSolution<Scalar>::meanTimeDistributeSolution()
   return _meanTimeDistributeSolution;
 }
 
+template <typename Scalar>
+double TSolution<Scalar>::meanTimeExchangeOverlap()
+{
+  return _meanTimeExchangeOverlap;
+}
+
+template <typename Scalar>
+double TSolution<Scalar>::meanTimeExchangeWait()
+{
+  return _meanTimeExchangeWait;
+}
+
 template <typename Scalar>
 double TSolution<Scalar>::maxTimeApplyJumpTerms()
 {
@@ -3526,6 +3768,18 @@ double TSolution<Scalar>::maxTimeDistributeSolution()
   return _maxTimeDistributeSolution;
 }
 
+template <typename Scalar>
+double TSolution<Scalar>::maxTimeExchangeOverlap()
+{
+  return _maxTimeExchangeOverlap;
+}
+
+template <typename Scalar>
+double TSolution<Scalar>::maxTimeExchangeWait()
+{
+  return _maxTimeExchangeWait;
+}
+
 template <typename Scalar>
 double TSolution<Scalar>::minTimeApplyJumpTerms()
 {
@@ -3562,6 +3816,18 @@ double TSolution<Scalar>::minTimeDistributeSolution()
   return _minTimeDistributeSolution;
 }
 
+template <typename Scalar>
+double TSolution<Scalar>::minTimeExchangeOverlap()
+{
+  return _minTimeExchangeOverlap;
+}
+
+template <typename Scalar>
+double TSolution<Scalar>::minTimeExchangeWait()
+{
+  return _minTimeExchangeWait;
+}
+
 template <typename Scalar>
 int TSolution<Scalar>::numSolutions() const
 {
@@ -3577,10 +3843,11 @@ Epetra_Map TSolution<Scalar>::getPartitionMap()
 
   vector<int> zeroMeanConstraints = getZeroMeanConstraints();
   GlobalIndexType numGlobalDofs = _dofInterpreter->globalDofCount();
-  set<GlobalIndexType> myGlobalIndicesSet = _dofInterpreter->globalDofIndicesForPartition(rank);
+  vector<GlobalIndexType> myGlobalIndices;
+  _dofInterpreter->sortedGlobalDofIndicesForPartition(rank, myGlobalIndices);
   int numZMCDofs = _zmcsAsRankOneUpdate ? 0 : zeroMeanConstraints.size();
 
-  Epetra_Map partMap = getPartitionMap(rank, myGlobalIndicesSet,numGlobalDofs,numZMCDofs,Comm.get());
+  Epetra_Map partMap = getPartitionMap(rank, myGlobalIndices,numGlobalDofs,numZMCDofs,Comm.get());
   return partMap;
 }
 
@@ -3607,6 +3874,14 @@ Epetra_Map TSolution<Scalar>::getPartitionMap()
 template <typename Scalar>
 Epetra_Map TSolution<Scalar>::getPartitionMap(PartitionIndexType rank, set<GlobalIndexType> & myGlobalIndicesSet, GlobalIndexType numGlobalDofs,
     int zeroMeanConstraintsSize, Epetra_Comm* Comm )
+{
+  vector<GlobalIndexType> myGlobalIndicesVector(myGlobalIndicesSet.begin(), myGlobalIndicesSet.end());
+  return getPartitionMap(rank, myGlobalIndicesVector, numGlobalDofs, zeroMeanConstraintsSize, Comm);
+}
+
+template <typename Scalar>
+Epetra_Map TSolution<Scalar>::getPartitionMap(PartitionIndexType rank, const vector<GlobalIndexType> & myGlobalIndicesVector, GlobalIndexType numGlobalDofs,
+    int zeroMeanConstraintsSize, Epetra_Comm* Comm )
 {
   int numGlobalLagrange = _lagrangeConstraints->numGlobalConstraints();
   const set<GlobalIndexType>* cellIDsInPartition = &_mesh->globalDofAssignment()->cellsInPartition(rank);
@@ -3621,7 +3896,7 @@ Epetra_Map TSolution<Scalar>::getPartitionMap(PartitionIndexType rank, set<Globa
   // - zero-mean constraints
 
   // determine the local dofs we have, and what their global indices are:
-  int localDofsSize = myGlobalIndicesSet.size() + numElementLagrange;
+  int localDofsSize = myGlobalIndicesVector.size() + numElementLagrange;
   if (rank == 0)
   {
     // global Lagrange and zero-mean constraints belong to rank 0
@@ -3638,11 +3913,11 @@ Epetra_Map TSolution<Scalar>::getPartitionMap(PartitionIndexType rank, set<Globa
     myGlobalIndices = NULL;
   }
 
-  // copy from set object into the allocated array
+  // copy from vector into the allocated array
   GlobalIndexType offset = 0;
-  for (set<GlobalIndexType>::iterator indexIt = myGlobalIndicesSet.begin(); indexIt != myGlobalIndicesSet.end(); indexIt++ )
+  for (GlobalIndexType globalIndex : myGlobalIndicesVector)
   {
-    myGlobalIndices[offset++] = *indexIt;
+    myGlobalIndices[offset++] = globalIndex;
   }
   GlobalIndexType cellOffset = _mesh->activeCellOffset() * _lagrangeConstraints->numElementConstraints();
   GlobalIndexType globalIndex = cellOffset + numGlobalDofs;
@@ -3696,10 +3971,11 @@ MapPtr TSolution<Scalar>::getPartitionMap2()
   
   vector<int> zeroMeanConstraints = getZeroMeanConstraints();
   GlobalIndexType numGlobalDofs = _dofInterpreter->globalDofCount();
-  set<GlobalIndexType> myGlobalIndicesSet = _dofInterpreter->globalDofIndicesForPartition(rank);
+  vector<GlobalIndexType> myGlobalIndices;
+  _dofInterpreter->sortedGlobalDofIndicesForPartition(rank, myGlobalIndices);
   int numZMCDofs = _zmcsAsRankOneUpdate ? 0 : zeroMeanConstraints.size();
 
-  MapPtr partMap = getPartitionMap2(rank, myGlobalIndicesSet,numGlobalDofs,numZMCDofs,Comm);
+  MapPtr partMap = getPartitionMap2(rank, myGlobalIndices,numGlobalDofs,numZMCDofs,Comm);
   return partMap;
 }
 
@@ -3722,6 +3998,14 @@ MapPtr TSolution<Scalar>::getPartitionMap2()
 template <typename Scalar>
 MapPtr TSolution<Scalar>::getPartitionMap2(PartitionIndexType rank, set<GlobalIndexType> & myGlobalIndicesSet, GlobalIndexType numGlobalDofs,
     int zeroMeanConstraintsSize, Teuchos_CommPtr Comm )
+{
+  vector<GlobalIndexType> myGlobalIndicesVector(myGlobalIndicesSet.begin(), myGlobalIndicesSet.end());
+  return getPartitionMap2(rank, myGlobalIndicesVector, numGlobalDofs, zeroMeanConstraintsSize, Comm);
+}
+
+template <typename Scalar>
+MapPtr TSolution<Scalar>::getPartitionMap2(PartitionIndexType rank, const vector<GlobalIndexType> & myGlobalIndicesVector, GlobalIndexType numGlobalDofs,
+    int zeroMeanConstraintsSize, Teuchos_CommPtr Comm )
 {
   int numGlobalLagrange = _lagrangeConstraints->numGlobalConstraints();
   vector< ElementPtr > elements = _mesh->elementsInPartition(rank);
@@ -3736,7 +4020,7 @@ MapPtr TSolution<Scalar>::getPartitionMap2(PartitionIndexType rank, set<GlobalIn
   // - zero-mean constraints
 
   // determine the local dofs we have, and what their global indices are:
-  int localDofsSize = myGlobalIndicesSet.size() + numElementLagrange;
+  int localDofsSize = myGlobalIndicesVector.size() + numElementLagrange;
   if (rank == 0)
   {
     // global Lagrange and zero-mean constraints belong to rank 0
@@ -3753,11 +4037,11 @@ MapPtr TSolution<Scalar>::getPartitionMap2(PartitionIndexType rank, set<GlobalIn
     myGlobalIndices = NULL;
   }
 
-  // copy from set object into the allocated array
+  // copy from vector into the allocated array
   GlobalIndexType offset = 0;
-  for (set<GlobalIndexType>::iterator indexIt = myGlobalIndicesSet.begin(); indexIt != myGlobalIndicesSet.end(); indexIt++ )
+  for (GlobalIndexType globalIndex : myGlobalIndicesVector)
   {
-    myGlobalIndices[offset++] = *indexIt;
+    myGlobalIndices[offset++] = globalIndex;
   }
   GlobalIndexType cellOffset = _mesh->activeCellOffset() * _lagrangeConstraints->numElementConstraints();
   GlobalIndexType globalIndex = cellOffset + numGlobalDofs;
@@ -3961,6 +4245,24 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
   projectOldCellOntoNewCells(cellID, oldElemType, oldData, childIDs, solutionOrdinal);
 }
 
+// childCoefficients(0,i) = weight * sum_j transfer(i,j) * parentCoefficients(j)
+template <typename Scalar>
+static void applyRefinementTransfer(const Intrepid::FieldContainer<Scalar> &transfer, const Intrepid::FieldContainer<Scalar> &parentCoefficients,
+                                    Intrepid::FieldContainer<Scalar> &childCoefficients, double weight)
+{
+  int childCardinality = transfer.dimension(0);
+  int parentCardinality = transfer.dimension(1);
+  for (int i=0; i<childCardinality; i++)
+  {
+    Scalar value = 0.0;
+    for (int j=0; j<parentCardinality; j++)
+    {
+      value += transfer(i,j) * parentCoefficients(j);
+    }
+    childCoefficients(0,i) = weight * value;
+  }
+}
+
 template <typename Scalar>
 void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, ElementTypePtr oldElemType,
                                                    const Intrepid::FieldContainer<Scalar> &oldData,
@@ -3978,6 +4280,7 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
   TEUCHOS_TEST_FOR_EXCEPTION(oldTrialOrdering->totalDofs() != oldData.size(), std::invalid_argument,
                              "oldElemType trial space does not match old data coefficients size");
   map<int, TFunctionPtr<Scalar> > fieldMap;
+  map<int, Intrepid::FieldContainer<Scalar>> fieldCoefficients; // for use with transfer matrices
 
   CellPtr parentCell = _mesh->getTopology()->getCell(cellID);
   int dummyCubatureDegree = 1;
@@ -4004,6 +4307,7 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
 
       TFunctionPtr<Scalar> oldTrialFunction = Teuchos::rcp( new BasisSumFunction(basis, basisCoefficients, parentRefCellCache) );
       fieldMap[trialID] = oldTrialFunction;
+      fieldCoefficients[trialID] = basisCoefficients;
     }
   }
 
@@ -4028,10 +4332,13 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
 
   int sideCount = parentCell->topology()->getSideCount();
   vector< map<int, TFunctionPtr<Scalar>> > traceMap(sideCount);
+  vector< map<int, Intrepid::FieldContainer<Scalar>> > traceCoefficients(sideCount); // for use with transfer matrices
+  vector<BasisCachePtr> parentSideTopoBasisCaches(sideCount);
   for (int sideOrdinal=0; sideOrdinal<sideCount; sideOrdinal++)
   {
     CellTopoPtr sideTopo = parentCell->topology()->getSubcell(sideDim, sideOrdinal);
     BasisCachePtr parentSideTopoBasisCache = BasisCache::basisCacheForReferenceCell(sideTopo, dummyCubatureDegree);
+    parentSideTopoBasisCaches[sideOrdinal] = parentSideTopoBasisCache;
     for (set<int>::iterator trialIDIt = trialIDs.begin(); trialIDIt != trialIDs.end(); trialIDIt++)
     {
       int trialID = *trialIDIt;
@@ -4049,12 +4356,19 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
         }
         TFunctionPtr<Scalar> oldTrialFunction = Teuchos::rcp( new BasisSumFunction(basis, basisCoefficients, parentSideTopoBasisCache) );
         traceMap[sideOrdinal][trialID] = oldTrialFunction;
+        traceCoefficients[sideOrdinal][trialID] = basisCoefficients;
       }
     }
   }
 
   int parent_p_order = _mesh->getElementType(cellID)->trialOrderPtr->maxBasisDegree();
 
+  RefinementPatternKey refPatternKey;
+  if (parentCell->children().size() > 0)
+    refPatternKey = parentCell->refinementPattern()->getKey();
+  else
+    refPatternKey = {parentCell->topology()->getKey(), -1};
+
   for (int childOrdinal=0; childOrdinal < childIDs.size(); childOrdinal++)
   {
     GlobalIndexType childID = childIDs[childOrdinal];
@@ -4112,7 +4426,17 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
       TFunctionPtr<Scalar> fieldFxn = fieldFxnIt->second;
       BasisPtr childBasis = childType->trialOrderPtr->getBasis(varID);
       basisCoefficients.resize(1,childBasis->getCardinality());
-      Projector<Scalar>::projectFunctionOntoBasisInterpolating(basisCoefficients, fieldFxn, childBasis, volumeBasisCache);
+      if (_useRefinementTransferMatrices)
+      {
+        BasisPtr parentBasis = oldTrialOrdering->getBasis(varID);
+        RefinementTransferKey key(parentBasis.get(), childBasis.get(), refPatternKey, childOrdinal, -1, -1, cubatureDegree);
+        const Intrepid::FieldContainer<Scalar>* transfer = &refinementTransferMatrix(key, parentBasis, parentRefCellCache, childBasis, volumeBasisCache);
+        applyRefinementTransfer(*transfer, fieldCoefficients[varID], basisCoefficients, 1.0);
+      }
+      else
+      {
+        Projector<Scalar>::projectFunctionOntoBasisInterpolating(basisCoefficients, fieldFxn, childBasis, volumeBasisCache);
+      }
 
 //      cout << "projected basisCoefficients for child volume trialID " << varID << ":\n" << basisCoefficients;
 
@@ -4173,7 +4497,19 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
         if (! childType->trialOrderPtr->hasBasisEntry(varID, sideOrdinal)) continue;
         BasisPtr childBasis = childType->trialOrderPtr->getBasis(varID, sideOrdinal);
         basisCoefficients.resize(1,childBasis->getCardinality());
-        Projector<Scalar>::projectFunctionOntoBasisInterpolating(basisCoefficients, traceFxn, childBasis, basisCacheForSide);
+        if (_useRefinementTransferMatrices && (parentSideOrdinal != -1))
+        {
+          // trace data on the parent side maps linearly to the child side; interior traces depend on parities, so we project those
+          BasisPtr parentBasis = oldTrialOrdering->getBasis(varID, parentSideOrdinal);
+          RefinementTransferKey key(parentBasis.get(), childBasis.get(), refPatternKey, childOrdinal, sideOrdinal, parentSideOrdinal, cubatureDegree);
+          const Intrepid::FieldContainer<Scalar>* transfer = &refinementTransferMatrix(key, parentBasis, parentSideTopoBasisCaches[parentSideOrdinal],
+                                                                                     childBasis, basisCacheForSide);
+          applyRefinementTransfer(*transfer, traceCoefficients[parentSideOrdinal][varID], basisCoefficients, shouldNegate ? -1.0 : 1.0);
+        }
+        else
+        {
+          Projector<Scalar>::projectFunctionOntoBasisInterpolating(basisCoefficients, traceFxn, childBasis, basisCacheForSide);
+        }
         
         auto &childSolutionCoefficients = _solutionForCellID[solutionOrdinal][childID];
 
@@ -4242,6 +4578,70 @@ void TSolution<Scalar>::projectOldCellOntoNewCells(GlobalIndexType cellID, Eleme
 //  fin.close();
 //}
 
+template <typename Scalar>
+const Intrepid::FieldContainer<Scalar> & TSolution<Scalar>::refinementTransferMatrix(const RefinementTransferKey &key, BasisPtr parentBasis,
+                                                                                   BasisCachePtr parentBasisCache, BasisPtr childBasis,
+                                                                                   BasisCachePtr childBasisCache)
+{
+  auto entryIt = _refinementTransferMatrices.find(key);
+  if (entryIt != _refinementTransferMatrices.end()) return entryIt->second;
+
+  // column j is the projection of parent basis function j
+  int parentCardinality = parentBasis->getCardinality();
+  int childCardinality = childBasis->getCardinality();
+  Intrepid::FieldContainer<Scalar> transfer(childCardinality, parentCardinality);
+  Intrepid::FieldContainer<Scalar> parentCoefficients(parentCardinality);
+  Intrepid::FieldContainer<Scalar> childCoefficients(1, childCardinality);
+  for (int parentOrdinal=0; parentOrdinal<parentCardinality; parentOrdinal++)
+  {
+    parentCoefficients.initialize(0.0);
+    parentCoefficients(parentOrdinal) = 1.0;
+    TFunctionPtr<Scalar> parentFxn = Teuchos::rcp( new BasisSumFunction(parentBasis, parentCoefficients, parentBasisCache) );
+    Projector<Scalar>::projectFunctionOntoBasisInterpolating(childCoefficients, parentFxn, childBasis, childBasisCache);
+    for (int childBasisOrdinal=0; childBasisOrdinal<childCardinality; childBasisOrdinal++)
+    {
+      transfer(childBasisOrdinal, parentOrdinal) = childCoefficients(0,childBasisOrdinal);
+    }
+  }
+  return _refinementTransferMatrices[key] = transfer;
+}
+
+template <typename Scalar>
+void TSolution<Scalar>::setUseRefinementTransferMatrices(bool value)
+{
+  _useRefinementTransferMatrices = value;
+}
+
+template <typename Scalar>
+void TSolution<Scalar>::setReuseImportPlan(bool value)
+{
+  _reuseImportPlan = value;
+}
+
+template <typename Scalar>
+void TSolution<Scalar>::setUsePipelinedAssembly(bool value)
+{
+  _usePipelinedAssembly = value;
+}
+
+template <typename Scalar>
+bool TSolution<Scalar>::usesPipelinedAssembly() const
+{
+  return _usePipelinedAssembly;
+}
+
+template <typename Scalar>
+int TSolution<Scalar>::pipelinedAssemblyHaloCellCount() const
+{
+  return _pipelinedHaloCellCount;
+}
+
+template <typename Scalar>
+int TSolution<Scalar>::pipelinedAssemblySentEntryCount() const
+{
+  return _pipelinedSentEntryCount;
+}
+
 template <typename Scalar>
 void TSolution<Scalar>::reverseParitiesForLocalCoefficients(GlobalIndexType cellID, const vector<int> &sidesWithChangedParities, int solutionOrdinal)
 {
@@ -0,0 +1,194 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  SpaceTimeSlabSolver.cpp
+//  Camellia
+//
+
+#include "SpaceTimeSlabSolver.h"
+
+#include "BC.h"
+#include "BF.h"
+#include "Function.h"
+#include "Mesh.h"
+#include "MeshFactory.h"
+#include "MeshTransferFunction.h"
+#include "RHS.h"
+#include "Solution.h"
+#include "Solver.h"
+#include "SpatialFilter.h"
+#include "Var.h"
+
+using namespace Camellia;
+using namespace std;
+
+SpaceTimeSlabSolver::SpaceTimeSlabSolver(BFPtr bf, MeshTopologyPtr spatialMeshTopo, double t0, double slabDuration,
+                                         vector<int> H1Order, int delta_k, int temporalDivisions, Epetra_CommPtr Comm)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(slabDuration <= 0, std::invalid_argument, "slabDuration must be positive");
+  TEUCHOS_TEST_FOR_EXCEPTION(H1Order.size() != 2, std::invalid_argument, "H1Order must have a spatial and a temporal order");
+  _bf = bf;
+  _spatialMeshTopo = spatialMeshTopo;
+  _t0 = t0;
+  _slabDuration = slabDuration;
+  _H1Order = H1Order;
+  _delta_k = delta_k;
+  _temporalDivisions = temporalDivisions;
+  _Comm = Comm;
+}
+
+void SpaceTimeSlabSolver::addInitialData(VarPtr trace, FunctionPtr initialValue)
+{
+  TEUCHOS_TEST_FOR_EXCEPTION(trace->varType() != TRACE, std::invalid_argument, "initial data may only be imposed on trace variables");
+  _initialData.push_back({trace, initialValue});
+}
+
+double SpaceTimeSlabSolver::currentTime() const
+{
+  return _t0 + _slabCount * _slabDuration;
+}
+
+MeshPtr SpaceTimeSlabSolver::mesh()
+{
+  return _mesh;
+}
+
+bool SpaceTimeSlabSolver::reuseFactorization() const
+{
+  return _reuseFactorization;
+}
+
+void SpaceTimeSlabSolver::setBCFactory(BCFactory bcFactory)
+{
+  _bcFactory = bcFactory;
+}
+
+void SpaceTimeSlabSolver::setIP(IPPtr ip)
+{
+  _ip = ip;
+}
+
+void SpaceTimeSlabSolver::setReuseFactorization(bool value)
+{
+  _reuseFactorization = value;
+}
+
+void SpaceTimeSlabSolver::setRHS(RHSPtr rhs)
+{
+  _rhs = rhs;
+}
+
+void SpaceTimeSlabSolver::setSolverFactory(SolverFactory solverFactory)
+{
+  _solverFactory = solverFactory;
+}
+
+int SpaceTimeSlabSolver::slabCount() const
+{
+  return _slabCount;
+}
+
+SolutionPtr SpaceTimeSlabSolver::solution()
+{
+  return _solution;
+}
+
+bool SpaceTimeSlabSolver::solverCanBeReused(MeshPtr mesh)
+{
+  if ((_solver == Teuchos::null) || (_setUpMesh == Teuchos::null)) return false;
+  // the slab meshes are built identically, so with the same cells on each rank they have the same global dof numbering;
+  // a refinement of the set-up mesh since its solve shows up in the counts
+  if (mesh->numActiveElements() != _setUpMesh->numActiveElements()) return false;
+  if (mesh->numGlobalDofs() != _setUpMesh->numGlobalDofs()) return false;
+  int localMatch = (mesh->cellIDsInPartition() == _setUpMesh->cellIDsInPartition()) ? 1 : 0;
+  int globalMatch;
+  mesh->Comm()->MinAll(&localMatch, &globalMatch, 1);
+  return (globalMatch == 1);
+}
+
+int SpaceTimeSlabSolver::solverReuseCount() const
+{
+  return _reuseCount;
+}
+
+int SpaceTimeSlabSolver::solveSlab()
+{
+  double t0 = currentTime();
+  double t1 = t0 + _slabDuration;
+
+  MeshTopologyPtr meshTopo = MeshFactory::spaceTimeMeshTopology(_spatialMeshTopo, t0, t1, _temporalDivisions);
+  map<int,int> emptyMap;
+  MeshPartitionPolicyPtr nullPartitionPolicy = Teuchos::null;
+  MeshPtr mesh = Teuchos::rcp( new Mesh(meshTopo, _bf, _H1Order, _delta_k, emptyMap, emptyMap, nullPartitionPolicy, _Comm) );
+  mesh->enforceOneIrregularity();
+
+  BCPtr bc = _bcFactory ? _bcFactory(t0, t1) : BC::bc();
+  SpatialFilterPtr initialTime = SpatialFilter::matchingT(t0);
+  for (auto entry : _initialData)
+  {
+    VarPtr trace = entry.first;
+    FunctionPtr initialValue;
+    if (_solution == Teuchos::null)
+    {
+      initialValue = entry.second;
+    }
+    else
+    {
+      // the previous slab's values of the trace on its final-time sides
+      FunctionPtr finalValue = Function::solution(trace, _solution);
+      initialValue = Teuchos::rcp( new MeshTransferFunction(finalValue, _mesh, mesh, t0) );
+    }
+    bc->addDirichlet(trace, initialTime, initialValue);
+  }
+
+  IPPtr ip = (_ip != Teuchos::null) ? _ip : _bf->graphNorm();
+  RHSPtr rhs = (_rhs != Teuchos::null) ? _rhs : RHS::rhs();
+  SolutionPtr solution = Solution::solution(_bf, mesh, bc, rhs, ip);
+
+  int result;
+  if (_reuseFactorization && solverCanBeReused(mesh))
+  {
+    // same matrix as the slab the solver was set up on: assemble, then hand only the new vectors to the solver
+    solution->initializeLHSVector();
+    solution->initializeStiffnessAndLoad();
+    solution->applyDGJumpTerms();
+    solution->populateStiffnessAndLoad();
+    _solver->setLHS(solution->getLHSVector());
+    _solver->setRHS(solution->getRHSVector());
+    bool callResolveInstead = true;
+    result = solution->solveWithPrepopulatedStiffnessAndLoad(_solver, callResolveInstead);
+    solution->importSolution();
+    solution->clearComputedResiduals();
+    _reuseCount++;
+  }
+  else
+  {
+    _solver = _solverFactory ? _solverFactory(solution) : Solver::getDirectSolver(true);
+    result = solution->solve(_solver);
+    _setUpMesh = mesh;
+  }
+
+  if (_solution != Teuchos::null)
+  {
+    // the previous slab's BCs refer to the slab before it; drop them so that only two slabs are kept alive
+    _solution->setBC(BC::bc());
+  }
+  _mesh = mesh;
+  _solution = solution;
+  _slabCount++;
+
+  return result;
+}
+
+int SpaceTimeSlabSolver::solveSlabs(int numSlabs)
+{
+  for (int i=0; i<numSlabs; i++)
+  {
+    int result = solveSlab();
+    if (result != 0) return result;
+  }
+  return 0;
+}
@@ -0,0 +1,72 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  AgglomeratedSolver.h
+//  Camellia
+//
+
+#ifndef Camellia_AgglomeratedSolver_h
+#define Camellia_AgglomeratedSolver_h
+
+#include "Solver.h"
+
+#include "Epetra_Import.h"
+#include "Epetra_Map.h"
+
+namespace Camellia
+{
+/*!
+ AgglomeratedSolver: gathers a distributed system onto a subset of the ranks and solves it there with another Solver.
+
+ Intended for small systems, such as the coarsest level of a GMGOperator, for which a solve spread across every rank is
+ dominated by latency.  solve() moves the matrix rows onto the first few ranks and solves there, on a communicator
+ containing only those ranks.  resolve() then moves only the right-hand side in and the solution back out.  For the
+ factorization to be computed once per setup, the wrapped solver should save its factorization (e.g. getDirectSolver(true)).
+ */
+class AgglomeratedSolver : public Solver
+{
+  SolverPtr _solver;
+  int _rankCount;        // requested number of ranks; <= 0 means choose from the global dof count
+  int _dofsPerRank;      // used when choosing the rank count
+
+  // set up by solve(); cleared when the stiffness matrix changes
+  bool _haveAgglomeratedProblem = false;
+  int _agglomeratedRankCount = 0;
+  Teuchos::RCP<Epetra_Map> _agglomeratedMap;   // rows gathered onto the first _agglomeratedRankCount ranks
+  Teuchos::RCP<Epetra_Import> _importer;       // from the stiffness matrix's row map to _agglomeratedMap
+  Epetra_CommPtr _subComm;                     // null on ranks outside the agglomeration
+  Teuchos::RCP<Epetra_CrsMatrix> _subMatrix;   // on _subComm
+  Teuchos::RCP<Epetra_MultiVector> _subLHS, _subRHS;
+
+  void setUpAgglomeratedProblem();
+  void clearAgglomeratedProblem();
+  int solveAgglomerated(bool callResolveInsteadOfSolve);
+public:
+  //! solver: used on the agglomerated ranks.  rankCount: number of ranks to gather onto; if <= 0, chosen at solve time by
+  //! agglomeratedRankCount() so that each rank gets about dofsPerRank rows.
+  AgglomeratedSolver(SolverPtr solver, int rankCount = -1, int dofsPerRank = 10000);
+  ~AgglomeratedSolver();
+
+  int solve();
+  int resolve();
+  void stiffnessMatrixChanged();
+
+  void setTolerance(double tol);
+  double tolerance();
+  bool isIterative();
+
+  //! The solver applied on the agglomerated ranks.
+  SolverPtr getSolver();
+
+  //! Number of ranks used by the last solve(); 0 before any solve.
+  int getAgglomeratedRankCount() const;
+
+  //! Number of ranks to gather globalDofCount rows onto so that each gets about dofsPerRank: between 1 and numRanks.
+  static int agglomeratedRankCount(GlobalIndexType globalDofCount, int numRanks, int dofsPerRank);
+};
+}
+
+#endif
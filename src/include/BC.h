@@ -35,12 +35,14 @@ class TBC
   
   map< int, pair< vector<double>, Scalar> > _singlePointBCs; // variables on which single-point conditions imposed
 
+  bool _cacheImposedValues = false;
+
 protected:
   map< int, TDirichletBC<Scalar> > &dirichletBCs();
   double _time;
 
 public:
-  TBC(bool legacySubclass) : _legacyBCSubclass(legacySubclass) {}
+  TBC(bool legacySubclass) : _legacyBCSubclass(legacySubclass), _time(0.0) {}
   virtual bool bcsImposed(int varID); // returns true if there are any BCs anywhere imposed on varID
   virtual void imposeBC(Intrepid::FieldContainer<Scalar> &dirichletValues, Intrepid::FieldContainer<bool> &imposeHere,
                         int varID, Intrepid::FieldContainer<double> &unitNormals, BasisCachePtr basisCache);
@@ -93,6 +95,12 @@ public:
     return _time;
   }
 
+  // ! If true, the projections of the Dirichlet BCs added with addDirichlet(var, spatialPoints, valueFunction) are reused across
+  // ! solves until the mesh changes, the BC's time changes, or a condition is added for the variable.  Only safe when the BC
+  // ! functions do not otherwise change: leave false (the default) for functions that depend on a ParameterFunction or a Solution.
+  void setCacheImposedValues(bool value);
+  bool cacheImposedValues() const;
+
   pair< SpatialFilterPtr, TFunctionPtr<Scalar> > getDirichletBC(int varID);
 
   TFunctionPtr<Scalar> getSpatiallyFilteredFunctionForDirichletBC(int varID);
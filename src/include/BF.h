@@ -12,6 +12,7 @@
 
 #include "TypeDefs.h"
 
+#include "CellTopology.h"
 #include "LinearTerm.h"
 
 #include "VarFactory.h"
@@ -20,6 +21,8 @@
 
 namespace Camellia
 {
+class SubgridTestSpace;
+
 template <typename Scalar>
 class TBF
 {
@@ -29,7 +32,8 @@ public:
     CHOLESKY,
     FACTORED_CHOLESKY,
     LU,
-    QR
+    QR,
+    SUBGRID // test space on a once-refined element, at about half the degree; sparse Gram solve (see SubgridTestSpace)
   };
 private:
   vector< TBilinearTerm<Scalar> > _terms;
@@ -41,6 +45,37 @@ private:
   std::function<void(int numElements, double timeRHS, ElementTypePtr elemType)> _rhsTimingCallback;
   
   bool _isLegacySubclass;
+
+  // similar-cell stiffness reuse; see setUseStiffnessReuseForSimilarCells()
+  struct SimilarCellKey
+  {
+    ElementTypePtr elemType; // held by RCP so that its address cannot be reused while the key is cached
+    std::vector<long> values; // cubature degrees and point counts; quantized Jacobian entries; cell side parities
+    bool operator<(const SimilarCellKey &other) const
+    {
+      if (elemType.get() != other.elemType.get()) return elemType.get() < other.elemType.get();
+      return values < other.values;
+    }
+  };
+  struct SimilarCellFactors
+  {
+    Intrepid::FieldContainer<Scalar> gramFactor;              // Cholesky factor of the Gram matrix
+    Intrepid::FieldContainer<Scalar> stiffnessEnrichedSolved; // enriched stiffness after back-substitution with gramFactor
+    Intrepid::FieldContainer<Scalar> stiffness;
+  };
+  std::map< SimilarCellKey, SimilarCellFactors > _similarCellFactors;
+  TIPPtr<Scalar> _similarCellFactorsIP; // IP for which _similarCellFactors were computed
+  int _similarCellHitCount = 0, _similarCellMissCount = 0;
+
+  bool stiffnessReuseApplies(TIPPtr<Scalar> ip, BasisCachePtr ipBasisCache, BasisCachePtr basisCache);
+  void localStiffnessMatrixAndRHSReusingSimilarCells(Intrepid::FieldContainer<Scalar> &localStiffness,
+                                                      Intrepid::FieldContainer<Scalar> &rhsVector,
+                                                      TIPPtr<Scalar> ip, BasisCachePtr ipBasisCache,
+                                                      TRHSPtr<Scalar> rhs, BasisCachePtr basisCache, ElementTypePtr elemType);
+
+  // subgrid test spaces for the SUBGRID solver, keyed by cell topology and subcell H1 order
+  std::map< std::pair<CellTopologyKey,int>, Teuchos::RCP<SubgridTestSpace> > _subgridTestSpaces;
+  Teuchos::RCP<SubgridTestSpace> subgridTestSpace(ElementTypePtr elemType);
   //members that used to be part of BilinearForm:
 protected:
   vector< int > _trialIDs, _testIDs;
@@ -50,7 +85,7 @@ protected:
   
   bool _useIterativeRefinementsWithSPDSolve = false;
   bool _warnAboutZeroRowsAndColumns = true;
-  bool _useSubgridMeshForOptimalTestSolve = false;
+  bool _useStiffnessReuseForSimilarCells = false;
   
   bool checkSymmetry(Intrepid::FieldContainer<Scalar> &innerProductMatrix);
 public:
@@ -178,9 +213,21 @@ public:
   void setOptimalTestSolver(OptimalTestSolver choice);
   void setUseIterativeRefinementsWithSPDSolve(bool value);
   void setUseExtendedPrecisionSolveForOptimalTestFunctions(bool value);
+  // ! true selects the SUBGRID optimal test solver; false restores FACTORED_CHOLESKY if SUBGRID was selected.
   void setUseSubgridMeshForOptimalTestFunctions(bool value);
   void setWarnAboutZeroRowsAndColumns(bool value);
 
+  // ! When true, cells that are translations of one another -- same ElementType, same (constant) Jacobian, and same cell side
+  // ! parities -- share a Gram factorization and local stiffness matrix, so only the load is computed for each.  Takes effect
+  // ! with the FACTORED_CHOLESKY solver on affine cells, when the weights in both the BF and the IP are translation-invariant.
+  void setUseStiffnessReuseForSimilarCells(bool value);
+  bool useStiffnessReuseForSimilarCells() const;
+  // ! Cells whose local stiffness was copied from a similar cell, and cells for which it was computed, respectively, under stiffness reuse.
+  int similarCellHitCount() const;
+  int similarCellMissCount() const;
+  // ! Discards the cached factorizations (they are also discarded when a term is added, or a different IP is used).
+  void clearSimilarCellCache();
+
   const vector< int > & trialIDs();
   const vector< int > & testIDs();
 
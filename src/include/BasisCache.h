@@ -65,6 +65,7 @@ private:
   Intrepid::FieldContainer<double> _physicalCellNodes;
 
   bool _cellJacobianIsValid, _cellJacobianInverseIsValid, _cellJacobianDeterminantIsValid;
+  bool _physicalCellsAreAffine = false; // when true (and there is no transformation function), Jacobians are constant on each cell
   bool _sideNormalsIsValid, _weightedMeasureIsValid, _physCubPointsIsValid;
   
   TFunctionPtr<double> _transformationFxn;
@@ -79,6 +80,8 @@ private:
   // (_cubDegree == -1) <=> (_cubDegrees.size() > 0)
   int _cubDegree;
   vector<int> _cubDegrees;
+  
+  int _referenceRuleID = -1; // ReferenceValueRegistry rule that _cubPoints came from; -1 when the points were set directly
 
   // containers specifically for sides:
   Intrepid::FieldContainer<double> _cubPointsSideRefCell; // the _cubPoints is the one in the side coordinates; this one in volume coords
@@ -93,6 +96,10 @@ private:
   void initVolumeCache(bool createSideCacheToo, bool interpretTensorTopologyAsSpaceTime);
   void initVolumeCache(const Intrepid::FieldContainer<double> &refPoints, const Intrepid::FieldContainer<double> &cubWeights);
 
+  // ! Reference values, from the ReferenceValueRegistry when our points are those of a registered cubature rule
+  constFCPtr referenceValues(BasisPtr basis, Camellia::EOperator op, bool useCubPointsSideRefCell,
+                             const Intrepid::FieldContainer<double> &cubPoints);
+  
   void determineJacobian();
   void determineJacobianInverseAndDeterminant();
   void determinePhysicalPoints();
@@ -103,6 +110,10 @@ private:
   
   void recomputeMeasures();
   void determineSideNormals();
+
+  // side caches are created, and brought up to date with the volume's physical nodes, lazily -- on first side query:
+  bool _sideCachesRequested = false;
+  std::vector<bool> _sideCacheIsCurrent;
 protected:
   BasisCache()
   {
@@ -129,6 +140,9 @@ protected:
 
   virtual void createSideCaches();
 
+  // ! Returns the side cache for sideOrdinal, creating the side caches and/or updating this side's physical nodes if needed.
+  BasisCachePtr sideCache(int sideOrdinal);
+
   // protected side cache constructor:
   BasisCache(int sideIndex, BasisCachePtr volumeCache, int trialDegree, int testDegree, BasisPtr multiBasisIfAny);
 
@@ -213,6 +227,10 @@ public:
 
   // ! Returns true if the second-order derivatives of the reference-to-physical transformation may be ignored.
   bool neglectHessian() const;
+
+  // ! Returns true if the reference-to-physical map is affine on every cell (straight-sided simplices, parallelograms,
+  // ! parallelepipeds, with no transformation function).  In this case, Jacobians are computed and inverted once per cell.
+  bool usesAffineGeometry();
   
   Intrepid::FieldContainer<double> computeParametricPoints();
 
@@ -225,8 +243,17 @@ public:
   const Intrepid::FieldContainer<double> & getSideUnitNormals(int sideOrdinal);
 
   const Intrepid::FieldContainer<double> &getPhysicalCellNodes();
+  // ! When createSideCacheToo is true, side caches are not built here; they are created and given the new physical nodes
+  // ! on the first query for each side.  Volume-only computations therefore never pay for side caches.
   virtual void setPhysicalCellNodes(const Intrepid::FieldContainer<double> &physicalCellNodes,
                                     const std::vector<GlobalIndexType> &cellIDs, bool createSideCacheToo);
+  // ! Brings all requested side caches up to date immediately.  Needed only by callers that hold on to side caches
+  // ! directly (rather than requesting them via getSideBasisCache()) across calls to setPhysicalCellNodes().
+  void updateSideCaches();
+
+  // ! Returns the number of cells per batch for which the local stiffness, Gram, and load storage for elemType,
+  // ! together with this cache's geometry and transformed basis values, fit within maxBytes.  Never returns less than minCells.
+  int maxCellBatchSize(ElementTypePtr elemType, int maxBytes, int minCells = 1);
 
   /*** Methods added for BC support below ***/
   // setRefCellPoints overwrites _cubPoints -- for when cubature is not your interest
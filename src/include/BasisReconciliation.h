@@ -21,6 +21,7 @@
 #include "Basis.h"
 
 #include "LinearTerm.h"
+#include "LRUCache.h"
 
 namespace Camellia
 {
@@ -37,24 +38,30 @@ class BasisReconciliation
 {
   bool _cacheResults;
 
-  // TODO: simplify this: eliminate simple reconciliation weights, and the h/p distinction.  Everything can happen in terms of subcell reconciliation.  (Simple is just subcdim = domain dimension, subcord = 0.  The non-h variant is just an empty RefinementBranch.)
+  // TODO: simplify this: eliminate the h/p distinction in the constrainedWeights() interface.  Everything can happen in terms of subcell reconciliation.  (Simple is just subcdim = domain dimension, subcord = 0.  The non-h variant is just an empty RefinementBranch.)
 
-  typedef pair< Camellia::Basis<>*, pair<unsigned, unsigned> > SubcellBasisRestriction;  // second pair is (subcdim, subcord)
-  typedef pair< Camellia::Basis<>*, int > SideBasisRestriction;
+  // keys hold the basis, so that a basis freed while its weights are cached cannot be replaced by another at the same address
+  struct BasisKey
+  {
+    BasisPtr basis;
+    bool operator<(const BasisKey &other) const
+    {
+      return basis.get() < other.basis.get();
+    }
+  };
+  typedef pair< BasisKey, pair<unsigned, unsigned> > SubcellBasisRestriction;  // second pair is (subcdim, subcord)
   // cached values:
   typedef unsigned Permutation;
-  typedef pair< Camellia::Basis<>*, Camellia::Basis<>*> BasisPair; // fineBasis first.
-  map< pair<BasisPair, Permutation>, Intrepid::FieldContainer<double> > _simpleReconciliationWeights; // simple: no sides involved
-  map< pair< pair< SideBasisRestriction, SideBasisRestriction >, Permutation >, SubBasisReconciliationWeights > _sideReconciliationWeights;
 private:
-  typedef pair< BasisPair, RefinementBranch > RefinedBasisPair; // fineBasis (the one on the refined element) is first in the BasisPair
-  typedef pair< pair< SideBasisRestriction, SideBasisRestriction >, RefinementBranch > SideRefinedBasisPair;
   typedef pair< pair< SubcellBasisRestriction, SubcellBasisRestriction >, RefinementBranch > SubcellRefinedBasisPair;
-  map< pair<RefinedBasisPair, Permutation>, Intrepid::FieldContainer<double> > _simpleReconcilationWeights_h;
-  map< pair< SideRefinedBasisPair, Permutation> , SubBasisReconciliationWeights > _sideReconcilationWeights_h;
 
-  // this is the only map that actually needs to remain, after the code simplification described above...
-  map< pair< SubcellRefinedBasisPair, Permutation> , SubBasisReconciliationWeights > _subcellReconcilationWeights;
+  // subcell weights depend only on the bases, the refinement patterns, and the permutation, so they are shared by all
+  // BasisReconciliation instances in the process; see sharedSubcellWeightsCache()
+  typedef pair< SubcellRefinedBasisPair, Permutation> SubcellWeightsCacheKey;
+  typedef LRUCache<SubcellWeightsCacheKey, SubBasisReconciliationWeights> SubcellWeightsCache;
+  Teuchos::RCP<SubcellWeightsCache> _subcellReconcilationWeights;
+
+  static Teuchos::RCP<SubcellWeightsCache> sharedSubcellWeightsCache();
 
 //  // trace to field reconciliation:
 //  // we do need a separate container for maps from fields to traces, because each can have a distinct LinearTerm describing
@@ -73,16 +80,26 @@ private:
   typedef pair< PermutedRefinedBasisPair, FineCoarseDomainOrdinalPair > PermutedRefinedBasisPairDomainOrdinals;
   typedef vector<pair<Function*, Camellia::EOperator>> FieldOps; // the Function* thing is *NOT* perfectly safe; this is a reason that BasisReconciliation's cache should not live too long -- Function could change underneath (as with Solution functions) or could even be deleted and replaced by a different function in the same memory location.
   typedef pair<PermutedRefinedBasisPairDomainOrdinals, FieldOps> TermTracedCacheKey;
-  map<TermTracedCacheKey, SubBasisReconciliationWeights> _termsTraced;
+  LRUCache<TermTracedCacheKey, SubBasisReconciliationWeights> _termsTraced; // not shared, because of the Function* in the key
   
   static Intrepid::FieldContainer<double> filterBasisValues(const Intrepid::FieldContainer<double> &basisValues, std::set<int> &filter);
 
   static SubBasisReconciliationWeights filterToInclude(std::set<int> &rowOrdinals, std::set<int> &colOrdinals, const SubBasisReconciliationWeights &weights);
 public:
-  BasisReconciliation(bool cacheResults = true)
-  {
-    _cacheResults = cacheResults;
-  }
+  BasisReconciliation(bool cacheResults = true);
+
+  //! Approximate memory costs, in bytes, of the cached reconciliation weights, keyed by member variable.  Includes the shared subcell weights.
+  std::map<std::string, long long> approximateMemoryCosts() const;
+
+  //! Memory budget, in bytes, for the term-traced weights cached by this instance; least recently used weights are evicted beyond it.  -1 (the default) means unbounded.
+  void setTermTracedWeightsMemoryBudget(long long bytes);
+  LRUCacheStatistics termTracedWeightsCacheStatistics() const;
+
+  //! Memory budget, in bytes, for the subcell weights shared by the BasisReconciliation instances in this process.  -1 (the default) means unbounded.
+  static void setSharedSubcellWeightsMemoryBudget(long long bytes);
+  static LRUCacheStatistics sharedSubcellWeightsCacheStatistics();
+  //! Drops the shared subcell weights (statistics are retained).
+  static void clearSharedSubcellWeights();
 
   // p
   const SubBasisReconciliationWeights &constrainedWeights(BasisPtr finerBasis, BasisPtr coarserBasis, unsigned vertexNodePermutation); // requires these to be defined on the same topology
@@ -33,7 +33,38 @@ class Boundary
 {
   std::set<std::pair<GlobalIndexType,unsigned>> _boundaryElements; // first arg is cellID, second arg is sideOrdinal
 
+  // boundary sides of rank-local cells, grouped by element type and side ordinal so that each group is projected in one BasisCache
+  struct BoundarySideGroup
+  {
+    ElementTypePtr elemType;
+    unsigned sideOrdinal;
+    std::vector<GlobalIndexType> cellIDs;
+    Intrepid::FieldContainer<double> physicalCellNodes;
+  };
+  std::vector<BoundarySideGroup> _boundarySideGroups;
+
+  // projection of a variable's Dirichlet BC onto the sides of one BoundarySideGroup
+  struct SideGroupCoefficients
+  {
+    Intrepid::FieldContainer<double> coefficients; // (C,F); empty if the variable has no basis on the group's side
+    std::vector<bool> imposeOnCell;
+  };
+
+  // projections for a BC that allows caching (see TBC::setCacheImposedValues()), along with what they were computed from
+  struct CachedDirichletCoefficients
+  {
+    const void* bc;
+    SpatialFilterPtr spatialFilter;
+    TFunctionPtr<double> function; // held, so that the pointer continues to identify the function the projections came from
+    double time;
+    std::vector<SideGroupCoefficients> sideGroupCoefficients; // same indexing as _boundarySideGroups
+  };
+  std::map<int, CachedDirichletCoefficients> _cachedDirichletCoefficients; // key: trialID.  Cleared by buildLookupTables().
+
   MeshPtr _mesh;
+
+  template <typename Scalar>
+  std::vector<SideGroupCoefficients> dirichletCoefficients(TBC<Scalar> &bc, int trialID);
 public:
   Boundary();
   void setMesh(MeshPtr mesh);
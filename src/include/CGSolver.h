@@ -20,6 +20,8 @@
 
 #include "Solver.h"
 
+#include "Epetra_Operator.h"
+
 namespace Camellia
 {
 class CGSolver : public Solver
@@ -27,11 +29,21 @@ class CGSolver : public Solver
   int _maxIters;
   bool _printToConsole;
   double _tol;
+  Teuchos::RCP<Epetra_Operator> _operator;
 public:
   CGSolver(int maxIters, double tol);
   void setPrintToConsole(bool printToConsole);
   int solve();
   void setTolerance(double tol);
+  double tolerance();
+  bool isIterative()
+  {
+    return true;
+  }
+
+  // ! If set, the solve applies op in place of the stiffness matrix (e.g. a matrix-free CondensedElementOperator).
+  // ! No preconditioner is used in that case, since Aztec's preconditioners require matrix entries.
+  void setOperator(Teuchos::RCP<Epetra_Operator> op);
 };
 }
 
@@ -15,6 +15,13 @@
 #ifndef Camellia_CamelliaMemoryUtility_h
 #define Camellia_CamelliaMemoryUtility_h
 
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Intrepid_FieldContainer.hpp"
+
 namespace Camellia {
   const static int MAP_NODE_OVERHEAD = 32;  // according to http://info.prelert.com/blog/stl-container-memory-usage, this appears to be basically universal
   
@@ -29,7 +36,7 @@ namespace Camellia {
     
     int MAP_OVERHEAD = sizeof(emptyMap);
     
-    return MAP_OVERHEAD + (MAP_NODE_OVERHEAD + sizeof(pair<A,B>)) * someMap.size();
+    return MAP_OVERHEAD + (MAP_NODE_OVERHEAD + sizeof(std::pair<A,B>)) * someMap.size();
   }
   
   template<typename A>
@@ -54,6 +61,45 @@ namespace Camellia {
     
     return VECTOR_OVERHEAD + sizeof(A) * someVector.size();
   }
+  
+  template<typename Scalar>
+  long long approximateFieldContainerSize(const Intrepid::FieldContainer<Scalar> &fc)   // in bytes
+  {
+    // the FieldContainer object (dimensions and an ArrayRCP) plus its values
+    return sizeof(fc) + sizeof(Scalar) * fc.size();
+  }
+  
+  template<typename A, typename Scalar>
+  long long approximateFieldContainerMapSize(const std::map<A,Intrepid::FieldContainer<Scalar>> &someMap)   // in bytes
+  {
+    long long mapSize = approximateMapSizeLLVM(someMap);
+    for (auto &entry : someMap)
+    {
+      mapSize += sizeof(Scalar) * entry.second.size(); // the FieldContainer object itself is counted by approximateMapSizeLLVM
+    }
+    return mapSize;
+  }
+  
+  //! Sum of the entries of a memory cost map, such as is returned by approximateMemoryCosts() methods.
+  inline long long totalMemoryCost(const std::map<std::string, long long> &variableCost)
+  {
+    long long memSize = 0;
+    for (auto &entry : variableCost)
+    {
+      memSize += entry.second;
+    }
+    return memSize;
+  }
+  
+  //! Adds the entries of subCosts to variableCost, with keys prefixed by prefix (e.g. "_gda.").
+  inline void addMemoryCosts(std::map<std::string, long long> &variableCost, const std::string &prefix,
+                             const std::map<std::string, long long> &subCosts)
+  {
+    for (auto &entry : subCosts)
+    {
+      variableCost[prefix + entry.first] += entry.second;
+    }
+  }
 }
 
 #endif
@@ -0,0 +1,79 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  CellHalo.h
+//  Camellia
+//
+
+#ifndef Camellia_CellHalo_h
+#define Camellia_CellHalo_h
+
+#include "Epetra_Distributor.h"
+
+#include "Intrepid_FieldContainer.hpp"
+#include "Teuchos_RCP.hpp"
+
+#include "TypeDefs.h"
+
+#include <map>
+#include <vector>
+
+namespace Camellia
+{
+/*!
+ CellHalo: a communication plan for per-cell data between the cells a rank owns and their active neighbors owned by other
+ ranks ("ghost" cells).
+
+ The halo's cells are the rank-local cells (in cellIDsInPartition() order) followed by the ghost cells.  Data with a fixed
+ number of values per cell is stored in a (cellCount(), width) FieldContainer in that order; exchange() fills in the ghost
+ rows from their owners in a single packed round.  The plan is built once, and reused until the mesh is repartitioned; use
+ Mesh::cellHalo() to get the current one.
+ */
+class CellHalo
+{
+public:
+  //! MPI-collective.
+  CellHalo(Mesh &mesh);
+  ~CellHalo();
+
+  CellHalo(const CellHalo &) = delete;
+  CellHalo & operator=(const CellHalo &) = delete;
+
+  int ownedCellCount() const;
+  int ghostCellCount() const;
+  int cellCount() const;
+
+  //! Owned cells, followed by ghost cells.
+  const std::vector<GlobalIndexType> &cellIDs() const;
+  //! Ordinal of cellID in cellIDs(), or -1 if cellID is neither owned nor a ghost.
+  int ordinalForCell(GlobalIndexType cellID) const;
+  //! Ordinals in cellIDs() of the active neighbors of the owned cell with ordinal ownedOrdinal.
+  const std::vector<int> &neighborOrdinals(int ownedOrdinal) const;
+
+  //! Posts the sends of the owned rows of values, a (cellCount(), width) container, to the ranks that ghost them.  MPI-collective.
+  void beginExchange(const Intrepid::FieldContainer<double> &values);
+  //! Completes the exchange posted by beginExchange(), filling in the ghost rows of values.
+  void endExchange(Intrepid::FieldContainer<double> &values);
+  //! beginExchange() followed by endExchange().
+  void exchange(Intrepid::FieldContainer<double> &values);
+private:
+  std::vector<GlobalIndexType> _cellIDs;
+  std::map<GlobalIndexType,int> _ordinalForCell;
+  int _ownedCellCount;
+  std::vector<std::vector<int>> _neighborOrdinals;
+
+  Teuchos::RCP<Epetra_Distributor> _distributor; // null on a single rank; otherwise created on every rank, even one without ghosts
+  std::vector<int> _sendOrdinals;    // owned cell ordinals, in the order their rows are packed for sending
+  std::vector<int> _receiveOrdinals; // ghost cell ordinals, in the order their rows arrive
+  std::vector<double> _exportBuffer;
+  char* _importBuffer = NULL;        // allocated by the Epetra_Distributor; we are responsible for deleting it
+  int _importBufferLength = 0;       // in bytes
+  int _width = 0;
+  bool _exchangeInFlight = false;
+};
+}
+
+#endif
@@ -102,6 +102,9 @@ public:
   // ! Storage cost in bytes.  (This neglects the STL map overhead.)
   long long approximateStiffnessAndLoadMemoryCost();
   
+  // ! Approximate memory costs, in bytes, keyed by member variable; includes the stored local stiffness matrices and load vectors.
+  std::map<std::string, long long> approximateMemoryCosts() const;
+  
   void clearStiffnessAndLoad();
   
   void computeAndStoreLocalStiffnessAndLoad(GlobalIndexType cellID);
@@ -119,6 +122,7 @@ public:
   
   GlobalIndexType globalDofCount();
   set<GlobalIndexType> globalDofIndicesForPartition(PartitionIndexType rank);
+  bool globalDofRangeForPartition(PartitionIndexType rank, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount); // rank must be the local MPI rank (or -1)
 
   void importInterpretedMapForNeighborGlobalIndices(const map<PartitionIndexType,set<GlobalIndexType>> &partitionToMeshGlobalIndices);
   
@@ -143,6 +147,7 @@ public:
   bool isLocallyOwnedGlobalDofIndex(GlobalIndexType globalDofIndex) const;
   
   set<GlobalIndexType> globalDofIndicesForCell(GlobalIndexType cellID);
+  void sortedGlobalDofIndicesForCell(GlobalIndexType cellID, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
   set<GlobalIndexType> globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal);
 
   GlobalIndexType condensedGlobalIndex(GlobalIndexType meshGlobalIndex); // meshGlobalIndex aka interpretedGlobalIndex
@@ -0,0 +1,92 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  CondensedElementOperator.h
+//  Camellia
+//
+
+#ifndef Camellia_CondensedElementOperator_h
+#define Camellia_CondensedElementOperator_h
+
+#include "Epetra_Import.h"
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+#include "Epetra_Operator.h"
+
+#include "Teuchos_RCP.hpp"
+
+#include "CondensedDofInterpreter.h"
+#include "TypeDefs.h"
+
+#include <vector>
+
+namespace Camellia
+{
+/*!
+ CondensedElementOperator: matrix-free application of the statically condensed global stiffness matrix.
+
+ The condensed (Schur complement) element matrices are computed once from the local stiffness matrices stored by the
+ Solution's CondensedDofInterpreter, and kept unassembled.  Apply() then gathers the element coefficients from an
+ overlapping vector, applies each element matrix to all vectors at once with a dense matrix-matrix product, and sums
+ the results back into the owning ranks.  No global CRS matrix is built or read.
+
+ Dirichlet boundary conditions are applied as Solution::imposeBCs() applies them to the assembled matrix: BC rows and
+ columns are zeroed and the diagonal set to 1.  Systems with Lagrange constraints or zero-mean constraints (which add
+ rows beyond the condensed dofs) are not supported.
+
+ The Solution must use a condensed solve, and must have populated its stiffness (so that the local matrices are stored).
+ */
+class CondensedElementOperator : public Epetra_Operator
+{
+public:
+  //! Computes and stores the condensed element matrices; MPI-collective.
+  CondensedElementOperator(SolutionPtr solution);
+
+  virtual ~CondensedElementOperator() {}
+
+  //! Recomputes the condensed element matrices from the local stiffness matrices currently stored by the dof interpreter
+  //! (e.g. after the Solution has reassembled).  MPI-collective.
+  void update();
+
+  //! Applies the condensed stiffness to X, placing the result in Y.  X and Y may alias.  MPI-collective.
+  int Apply(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const;
+
+  //! Not supported; returns -1.
+  int ApplyInverse(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const;
+
+  //! Storage cost of the element matrices, in bytes.
+  long long elementMatrixMemoryCost() const;
+
+  //! Number of element matrices stored on this rank.
+  int NumMyElements() const;
+
+  //! Not supported; returns -1.
+  int SetUseTranspose(bool UseTranspose);
+  double NormInf() const;
+  const char * Label() const;
+  bool UseTranspose() const;
+  bool HasNormInf() const;
+  const Epetra_Comm & Comm() const;
+  const Epetra_Map & OperatorDomainMap() const;
+  const Epetra_Map & OperatorRangeMap() const;
+private:
+  SolutionPtr _solution;
+  Teuchos::RCP<CondensedDofInterpreter<double>> _dofInterpreter;
+  Epetra_Map _partitionMap;
+
+  Teuchos::RCP<Epetra_Map> _overlapMap;  // all condensed dofs touched by rank-local cells
+  Teuchos::RCP<Epetra_Import> _importer; // partition map -> overlap map
+
+  std::vector<int> _elementOffsets;        // offset of each element's overlap LIDs in _elementLIDs
+  std::vector<int> _elementLIDs;           // overlap map LIDs of each element's condensed dofs
+  std::vector<int> _elementMatrixOffsets;  // offset of each element's matrix in _elementMatrices
+  std::vector<double> _elementMatrices;    // row-major condensed element matrices
+
+  std::vector<int> _bcLIDs; // partition map LIDs of rank-owned Dirichlet dofs
+};
+}
+
+#endif
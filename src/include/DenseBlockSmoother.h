@@ -0,0 +1,101 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  DenseBlockSmoother.h
+//  Camellia
+//
+
+#ifndef Camellia_DenseBlockSmoother_h
+#define Camellia_DenseBlockSmoother_h
+
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+#include "Epetra_Operator.h"
+#include "Epetra_RowMatrix.h"
+
+#include "Teuchos_RCP.hpp"
+
+#include "DofInterpreter.h"
+#include "TypeDefs.h"
+
+#include <vector>
+
+namespace Camellia
+{
+/*!
+ DenseBlockSmoother: block Jacobi / symmetric block Gauss-Seidel smoother whose blocks are the (rank-local) degrees of
+ freedom of each cell, or of each cell's overlap patch when the overlap level is positive.
+
+ Block structure comes directly from the DofInterpreter, so no graph partitioning is required.  Since in DPG these blocks
+ are dense, each is extracted into a dense matrix and explicitly inverted with LAPACK during Compute(); ApplyInverse()
+ then costs one dense matrix-matrix product per block, applied to all vectors at once.
+
+ Blocks are restricted to rows owned by this rank; rows belonging to no cell (e.g. Lagrange constraints) form 1x1 blocks.
+ Overlap patches are defined as in Camellia::AdditiveSchwarz (see OverlappingRowMatrix::overlappingCells()).
+ */
+class DenseBlockSmoother : public Epetra_Operator
+{
+public:
+  enum SweepType
+  {
+    JACOBI,                // blocks applied additively
+    SYMMETRIC_GAUSS_SEIDEL // forward then backward multiplicative sweep over the blocks
+  };
+
+  DenseBlockSmoother(Epetra_RowMatrix* A, MeshPtr mesh, Teuchos::RCP<DofInterpreter> dofInterpreter, SweepType sweepType,
+                     int overlapLevel, bool hierarchical, int dimensionForNeighborRelationship);
+
+  virtual ~DenseBlockSmoother() {}
+
+  //! Determines the blocks, and extracts and inverts them.  MPI-communicating when the overlap level is positive: must then be called on all ranks.
+  //! Returns a non-zero error code if some block was singular.
+  int Compute();
+
+  //! Applies the smoother (an approximate inverse of A) to X, placing the result in Y.  X and Y may alias.
+  int ApplyInverse(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const;
+
+  //! Not supported; returns -1.
+  int Apply(const Epetra_MultiVector& X, Epetra_MultiVector& Y) const;
+
+  //! For each locally owned row, the number of blocks that contain it.
+  const std::vector<int> & LocalIncidenceCounts() const;
+
+  //! Number of rank-local blocks (including 1x1 blocks for rows belonging to no cell).
+  int NumBlocks() const;
+
+  //! Not supported; returns -1.
+  int SetUseTranspose(bool UseTranspose);
+  double NormInf() const;
+  const char * Label() const;
+  bool UseTranspose() const;
+  bool HasNormInf() const;
+  const Epetra_Comm & Comm() const;
+  const Epetra_Map & OperatorDomainMap() const;
+  const Epetra_Map & OperatorRangeMap() const;
+private:
+  Epetra_RowMatrix* _A;
+  MeshPtr _mesh;
+  Teuchos::RCP<DofInterpreter> _dofInterpreter;
+  SweepType _sweepType;
+  int _overlapLevel;
+  bool _hierarchical;
+  int _dimensionForNeighborRelationship;
+
+  // rank-local copy of A, with columns restricted to locally owned rows (column indices are row LIDs)
+  std::vector<int> _rowOffsets;
+  std::vector<int> _rowColumns;
+  std::vector<double> _rowValues;
+
+  std::vector<std::vector<int>> _blockRows; // row LIDs for each block
+  std::vector<int> _blockInverseOffsets;    // offset of each block's inverse in _blockInverses
+  std::vector<double> _blockInverses;       // column-major dense inverses
+  std::vector<int> _incidenceCounts;
+
+  void applyBlock(int blockOrdinal, const Epetra_MultiVector &R, Epetra_MultiVector &Y, bool useResidual) const;
+};
+}
+
+#endif
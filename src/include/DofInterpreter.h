@@ -30,7 +30,9 @@
 #include "Intrepid_FieldContainer.hpp"
 #include "Epetra_Vector.h"
 
+#include <map>
 #include <set>
+#include <string>
 
 using namespace std;
 
@@ -60,6 +62,17 @@ public:
   DofInterpreter(MeshPtr mesh) : _mesh(mesh) {}
   virtual GlobalIndexType globalDofCount() = 0;
   virtual set<GlobalIndexType> globalDofIndicesForPartition(PartitionIndexType rank) = 0;
+
+  //!! If the global dof indices owned by the partition form the contiguous range [firstDofIndex, firstDofIndex + dofCount), sets these
+  //!! and returns true.  Returns false otherwise; the default implementation always returns false.
+  virtual bool globalDofRangeForPartition(PartitionIndexType rank, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount);
+
+  //!! Number of global dof indices owned by the partition.
+  virtual GlobalIndexType globalDofCountForPartition(PartitionIndexType rank);
+
+  //!! Fills sortedGlobalDofIndices with the global dof indices owned by the partition, in ascending order.  Unlike globalDofIndicesForPartition(),
+  //!! does not build a std::set.
+  virtual void sortedGlobalDofIndicesForPartition(PartitionIndexType rank, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
   virtual bool isLocallyOwnedGlobalDofIndex(GlobalIndexType globalDofIndex) const = 0;
 
   virtual void interpretLocalData(GlobalIndexType cellID, const Intrepid::FieldContainer<double> &localData,
@@ -85,21 +98,34 @@ public:
 
   //!! Returns the global dof indices for the cell.  Only guaranteed to provide correct values for cells that belong to the local partition.
   virtual set<GlobalIndexType> globalDofIndicesForCell(GlobalIndexType cellID) = 0;
+
+  //!! Fills sortedGlobalDofIndices with the global dof indices for the cell, in ascending order and without duplicates.  Same guarantees as globalDofIndicesForCell().
+  virtual void sortedGlobalDofIndicesForCell(GlobalIndexType cellID, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
   
   //!! Returns the global dof indices for the indicated subcell.  Only guaranteed to provide correct values for cells that belong to the local partition.
   virtual set<GlobalIndexType> globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal) = 0;
 
+  // ! Greedy distance-2 coloring of the given (rank-local) cells: no two cells in the same color share a global dof index, so that
+  // ! the cells of one color may be scattered into a global matrix concurrently, without locks.  Cells are visited in the order given.
+  virtual std::vector<std::vector<GlobalIndexType>> cellColorsForAssembly(const std::vector<GlobalIndexType> &cellIDs);
+  
   // ! get the global dof indices corresponding to the specified cellID/varID/sideOrdinal.  GDAMinimumRule's implementation overrides to return only "fittable" dof indices, as required by CondensedDofInterpreter.
   virtual std::set<GlobalIndexType> getGlobalDofIndices(GlobalIndexType cellID, int varID, int sideOrdinal);
   
   //!! MPI-communicating method.  Must be called on all ranks.
   virtual std::set<GlobalIndexType> importGlobalIndicesForCells(const std::vector<GlobalIndexType> &cellIDs);
 
+  //!! MPI-communicating method.  Must be called on all ranks.  As importGlobalIndicesForCells(), but fills a sorted vector (without duplicates).
+  virtual void importSortedGlobalIndicesForCells(const std::vector<GlobalIndexType> &cellIDs, std::vector<GlobalIndexType> &sortedGlobalIndices);
+
   //!! MPI-communicating method.  Must be called on all ranks.  Keys are cellIDs (the ones requested), values the global dof indices with support on that cell.
   virtual std::map<GlobalIndexType,std::set<GlobalIndexType>> importGlobalIndicesMap(const std::set<GlobalIndexType> &cellIDs);
   
   virtual PartitionIndexType partitionForGlobalDofIndex( GlobalIndexType globalDofIndex ) = 0;
   
+  //!! Approximate memory costs, in bytes, of the data stored on this rank, keyed by member variable.  The default implementation returns an empty map.
+  virtual std::map<std::string, long long> approximateMemoryCosts() const;
+  
   virtual ~DofInterpreter() {}
 };
 }
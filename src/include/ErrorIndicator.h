@@ -32,6 +32,15 @@ namespace Camellia {
   protected:
     MeshPtr _mesh;
     std::map<GlobalIndexType,double> _localErrorMeasures; // cellID -> error measure
+    
+    //! BasisCache whose points are the centroids of the given cells, which must all be of type elemType, so that Functions can
+    //! be evaluated at every centroid in one pass.
+    static BasisCachePtr centroidBasisCache(MeshPtr mesh, ElementTypePtr elemType, const Intrepid::FieldContainer<double> &physicalCellNodes,
+                                            const std::vector<GlobalIndexType> &cellIDs);
+    
+    //! Measures of the given cells, which must all be of type elemType, computed together with the mesh's cubature for elemType.
+    static Intrepid::FieldContainer<double> cellMeasures(MeshPtr mesh, ElementTypePtr elemType, const Intrepid::FieldContainer<double> &physicalCellNodes,
+                                                         const std::vector<GlobalIndexType> &cellIDs);
   public:
     ErrorIndicator(MeshPtr mesh);
     
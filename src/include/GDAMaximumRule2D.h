@@ -115,6 +115,8 @@ public:
   //!! Returns the global dof indices for the indicated subcell.  Only guaranteed to provide correct values for cells that belong to the local partition.
   set<GlobalIndexType> globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal);
   set<GlobalIndexType> globalDofIndicesForPartition(PartitionIndexType partitionNumber);
+  GlobalIndexType globalDofCountForPartition(PartitionIndexType partitionNumber);
+  void sortedGlobalDofIndicesForPartition(PartitionIndexType partitionNumber, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
 
   GlobalIndexType globalDofCount();
   void interpretLocalData(GlobalIndexType cellID, const Intrepid::FieldContainer<double> &localDofs, Intrepid::FieldContainer<double> &globalDofs, Intrepid::FieldContainer<GlobalIndexType> &globalDofIndices);
@@ -18,6 +18,7 @@
 #include <iostream>
 
 #include "BasisReconciliation.h"
+#include "LRUCache.h"
 #include "GlobalDofAssignment.h"
 #include "LocalDofMapper.h"
 #include "SubcellDofIndices.h"
@@ -119,10 +120,12 @@ class GDAMinimumRule : public GlobalDofAssignment
   
   map< GlobalIndexType, CellConstraints > _constraintsCache;
   map< GlobalIndexType, LocalDofMapperPtr > _dofMapperCache;
-  map< GlobalIndexType, map<int, map<int, LocalDofMapperPtr> > > _dofMapperForVariableOnSideCache; // cellID --> side --> variable --> LocalDofMapper
+  typedef pair< GlobalIndexType, pair<int, int> > DofMapperForVariableOnSideKey; // (cellID, (sideOrdinal, varID))
+  LRUCache< DofMapperForVariableOnSideKey, LocalDofMapperPtr > _dofMapperForVariableOnSideCache;
   map< GlobalIndexType, SubcellDofIndices> _ownedGlobalDofIndicesCache; // (cellID --> SubcellDofIndices)
   map< GlobalIndexType, SubcellDofIndices> _globalDofIndicesForCellCache; // (cellID --> SubcellDofIndices) -- this has a lot of overlap in its data with the _ownedGlobalDofIndicesCache; could save some memory by only storing the difference
-  map< pair<GlobalIndexType,pair<int,unsigned>>, set<GlobalIndexType>> _fittableGlobalIndicesCache; // keys: (cellID,(varID,sideOrdinal))
+  typedef pair<GlobalIndexType,pair<int,unsigned>> FittableGlobalIndicesKey; // (cellID,(varID,sideOrdinal))
+  LRUCache< FittableGlobalIndicesKey, set<GlobalIndexType> > _fittableGlobalIndicesCache;
   
   vector<unsigned> allBasisDofOrdinalsVector(int basisCardinality);
 
@@ -180,6 +183,19 @@ public:
   GDAMinimumRule(MeshPtr mesh, VarFactoryPtr varFactory, DofOrderingFactoryPtr dofOrderingFactory, MeshPartitionPolicyPtr partitionPolicy,
                  vector<int> initialH1OrderTrial, unsigned testOrderEnhancement);
   
+  // ! Approximate memory costs, in bytes, keyed by member variable; includes the constraint, dof mapper and dof index caches, and the BasisReconciliation weights.
+  std::map<std::string, long long> approximateMemoryCosts() const;
+  
+  // ! Memory budgets, in bytes, for the caches of per-variable/side dof mappers and of fittable global dof indices.  Least recently used
+  // ! entries are evicted beyond these.  -1 (the default) means unbounded.
+  void setDofMapperForVariableOnSideCacheMemoryBudget(long long bytes);
+  void setFittableGlobalIndicesCacheMemoryBudget(long long bytes);
+  LRUCacheStatistics dofMapperForVariableOnSideCacheStatistics() const;
+  LRUCacheStatistics fittableGlobalIndicesCacheStatistics() const;
+  
+  // ! The BasisReconciliation that supplies constraint weights; use it to set budgets for the weight caches.
+  BasisReconciliation & basisReconciliation();
+  
   // ! Default is false.  Checking constraint consistency is useful for debugging purposes, though.
   void setCheckConstraintConsistency(bool value);
   void setCellPRefinements(const map<GlobalIndexType,int>& pRefinements);
@@ -198,6 +214,7 @@ public:
   
   //!! Returns the global dof indices for the indicated cell.  Only guaranteed to provide correct values for cells that belong to the local partition.
   set<GlobalIndexType> globalDofIndicesForCell(GlobalIndexType cellID);
+  void sortedGlobalDofIndicesForCell(GlobalIndexType cellID, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
   
   //!! Returns the global dof indices for the indicated subcell.  Only guaranteed to provide correct values for cells that belong to the local partition.
   set<GlobalIndexType> globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal);
@@ -208,6 +225,7 @@ public:
   
   //!! Returns the global dof indices for the partition.
   set<GlobalIndexType> globalDofIndicesForPartition(PartitionIndexType partitionNumber);
+  bool globalDofRangeForPartition(PartitionIndexType partitionNumber, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount); // always true: owned dofs are contiguous
 
   bool isLocallyOwnedGlobalDofIndex(GlobalIndexType globalDofIndex) const;
 
@@ -45,8 +45,8 @@ public:
   {
     POINT_JACOBI,
     POINT_SYMMETRIC_GAUSS_SEIDEL,
-    BLOCK_JACOBI,
-    BLOCK_SYMMETRIC_GAUSS_SEIDEL,
+    BLOCK_JACOBI,                 // dense cell blocks (cell patches, with overlap); see DenseBlockSmoother
+    BLOCK_SYMMETRIC_GAUSS_SEIDEL, // dense cell blocks (cell patches, with overlap); see DenseBlockSmoother
     IFPACK_ADDITIVE_SCHWARZ,
     CAMELLIA_ADDITIVE_SCHWARZ,
     NONE
@@ -103,6 +103,7 @@ private:
   mutable map< pair< pair<int,int>, RefinementBranch >, LocalDofMapperPtr > _localCoefficientMap; // pair(fineH1Order,coarseH1Order)
 
   Epetra_CrsMatrix* _fineStiffnessMatrix;
+  Teuchos::RCP<Epetra_Operator> _fineStiffnessOperator; // if set, used in place of _fineStiffnessMatrix when computing residuals
   
   mutable double _timeMapFineToCoarse, _timeMapCoarseToFine, _timeCoarseImport, _timeConstruction, _timeCoarseSolve, _timeLocalCoefficientMapConstruction, _timeComputeCoarseStiffnessMatrix, _timeProlongationOperatorConstruction,
       _timeSetUpSmoother, _timeUpdateCoarseOperator, _timeApplyFineStiffness, _timeApplySmoother; // totals over the life of the object
@@ -297,6 +298,11 @@ public:
   
   //! set the coarse Solver
   void setCoarseSolver(SolverPtr coarseSolver);
+
+  //! Coarsest level only: when rankCount is nonzero, the coarse system is gathered onto rankCount ranks and solved there
+  //! (see AgglomeratedSolver); a negative rankCount chooses the number of ranks from the coarse dof count.  Zero restores
+  //! the coarse solve across all ranks.
+  void setCoarseSolveAgglomeration(int rankCount);
   
   //! sets debug mode for verbose console output on rank 0.
   void setDebugMode(bool value);
@@ -315,10 +321,10 @@ public:
   // ! When set to MULTIPLICATIVE, will compute new residuals before and after the coarse solve.  Done in such a way as to preserve symmetry.
   void setSmootherApplicationType(SmootherApplicationType value);
   
-  // ! When set to true, will weight (symmetrically) according to the inverse of the number of Schwarz blocks each dof participates in.  Currently only supported for CAMELLIA_ADDITIVE_SCHWARZ smoothers.
+  // ! When set to true, will weight (symmetrically) according to the inverse of the number of Schwarz blocks each dof participates in.  Currently only supported for CAMELLIA_ADDITIVE_SCHWARZ and block smoothers.
   void setUseSchwarzDiagonalWeight(bool value);
   
-  // ! When set to true, will scale using the inverse of the maximum eigenvalue of the Schwarz smoother times the fine matrix.  Currently only supported for CAMELLIA_ADDITIVE_SCHWARZ smoothers.
+  // ! When set to true, will scale using the inverse of the maximum eigenvalue of the Schwarz smoother times the fine matrix.  Currently only supported for CAMELLIA_ADDITIVE_SCHWARZ and BLOCK_JACOBI smoothers.
   void setUseSchwarzScalingWeight(bool value);
   
   Teuchos::RCP<Epetra_Operator> getSmoother() const;
@@ -375,6 +381,10 @@ public:
   //! Set the fine stiffness matrix; calls computeCoarseStiffnessMatrix() and setUpSmoother()
   void setFineStiffnessMatrix(Epetra_CrsMatrix* fineStiffnessMatrix);
 
+  //! Set an operator (e.g. a matrix-free CondensedElementOperator) to apply in place of the fine stiffness matrix when computing
+  //! residuals.  The fine stiffness matrix is still required for the smoother and coarse stiffness matrix.
+  void setFineStiffnessOperator(Teuchos::RCP<Epetra_Operator> fineStiffnessOperator);
+
   //! Returns the coarse operator applied in the coarse solve.
   Teuchos::RCP<GMGOperator> getCoarseOperator();
   
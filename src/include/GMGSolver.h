@@ -34,6 +34,8 @@ class GMGSolver : public Solver, public Narrator
 
   Teuchos::RCP<GMGOperator> _gmgOperator;
 
+  Teuchos::RCP<Epetra_Operator> _fineOperator; // if set, used in place of the stiffness matrix as the Krylov operator
+
   bool _computeCondest;
 
   int _azOutput;
@@ -84,6 +86,11 @@ public:
   void setComputeConditionNumberEstimate(bool value);
 
   void setTolerance(double tol);
+  double tolerance();
+  bool isIterative()
+  {
+    return true;
+  }
 
   Teuchos::RCP<GMGOperator> gmgOperator()
   {
@@ -106,6 +113,14 @@ public:
   void setSmootherApplicationCount(int count);
   
   void setSmootherType(GMGOperator::SmootherChoice smootherType);
+
+  // ! Gathers the coarsest-level system onto rankCount ranks for the coarse solve; see GMGOperator::setCoarseSolveAgglomeration().
+  void setCoarseSolveAgglomeration(int rankCount);
+
+  // ! Sets an operator (e.g. a matrix-free CondensedElementOperator) to apply in place of the fine stiffness matrix in the Krylov
+  // ! iteration and in the GMG residual computations.  The assembled stiffness matrix is still used to set up the smoother and coarse
+  // ! operator.  Only supported in the Belos code path.
+  void setFineOperator(Teuchos::RCP<Epetra_Operator> fineOperator);
   
   vector<int> getIterationCountLog();
   
@@ -68,6 +68,8 @@ protected:
 
   unsigned _numPartitions;
 
+  unsigned _dofNumberingVersion = 0; // subclasses increment in rebuildLookups()
+
   vector< TSolutionPtr<double> > _registeredSolutions; // solutions that should be modified upon refinement (by subclasses--maximum rule has to worry about cell side upgrades, whereas minimum rule does not, so there's not a great way to do this in the abstract superclass.)
   
   void constructActiveCellMap();
@@ -90,6 +92,9 @@ public:
   virtual ~GlobalDofAssignment() {}
 
   GlobalIndexType activeCellOffset();
+  
+  // ! Approximate memory costs, in bytes, keyed by member variable.  Subclasses should call super.
+  std::map<std::string, long long> approximateMemoryCosts() const;
   Teuchos::RCP<Epetra_Map> getActiveCellMap();
   MapPtr getActiveCellMap2();
 
@@ -193,6 +198,9 @@ public:
   void projectParentCoefficientsOntoUnsetChildren();
   
   virtual void rebuildLookups() = 0;
+
+  // ! Incremented each time rebuildLookups() renumbers the global dofs (after refinement or repartitioning); lets clients cache data derived from the numbering.
+  unsigned dofNumberingVersion() const;
   
   void repartitionAndMigrate();
 
@@ -0,0 +1,82 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  HaloImportPlan.h
+//  Camellia
+//
+
+#ifndef Camellia_HaloImportPlan_h
+#define Camellia_HaloImportPlan_h
+
+#include "Epetra_BlockMap.h"
+#include "Epetra_Import.h"
+#include "Epetra_Map.h"
+#include "Epetra_MultiVector.h"
+
+#include "Teuchos_RCP.hpp"
+
+#include "DofInterpreter.h"
+#include "TypeDefs.h"
+
+#include <set>
+#include <vector>
+
+namespace Camellia
+{
+/*!
+ HaloImportPlan: a reusable plan for bringing the global coefficients of a set of cells onto this rank.
+
+ The plan is built once for a given dof numbering: it records the target map (the global dofs of the cells), the
+ Epetra_Import from the source (partition) map, and which of the cells have all their coefficients owned locally.
+ beginImport() copies the locally owned entries and posts nonblocking sends and receives of packed buffers to and
+ from the ranks that share halo dofs; endImport() waits for them and unpacks.  Between the two, coefficients for the
+ cells listed by ownedCellIDs() are already available in the target vector, so they can be interpreted while the
+ halo exchange is in flight.
+ */
+class HaloImportPlan
+{
+public:
+  //! Builds the plan for importing the global coefficients of cellIDs, as interpreted by dofInterpreter, from vectors
+  //! distributed according to sourceMap.  MPI-collective.
+  HaloImportPlan(const std::set<GlobalIndexType> &cellIDs, DofInterpreter* dofInterpreter, const Epetra_BlockMap &sourceMap);
+  ~HaloImportPlan();
+
+  HaloImportPlan(const HaloImportPlan &) = delete;
+  HaloImportPlan & operator=(const HaloImportPlan &) = delete;
+
+  //! Map containing the global dofs of all the plan's cells; vectors passed to beginImport() as target should use this map.
+  const Epetra_Map & targetMap() const;
+
+  //! Returns true if map has the same global elements on this rank as the plan's source map.  Local check only.
+  bool isCompatibleSource(const Epetra_BlockMap &map) const;
+
+  //! Cells whose coefficients are all owned by this rank; these are available in the target once beginImport() returns.
+  const std::vector<GlobalIndexType> & ownedCellIDs() const;
+  //! Cells with some coefficients owned by other ranks; these are available in the target once endImport() returns.
+  const std::vector<GlobalIndexType> & haloCellIDs() const;
+
+  //! Number of target entries received from other ranks.
+  int remoteEntryCount() const;
+
+  //! Copies locally owned entries of source into target, and posts the exchange of the rest.  MPI-collective.
+  void beginImport(const Epetra_MultiVector &source, Epetra_MultiVector &target);
+  //! Completes the exchange posted by beginImport(), unpacking the received entries into target.
+  void endImport(Epetra_MultiVector &target);
+private:
+  Teuchos::RCP<Epetra_Map> _targetMap;
+  Teuchos::RCP<Epetra_Import> _importer; // source map -> target map
+
+  std::vector<GlobalIndexType> _ownedCellIDs;
+  std::vector<GlobalIndexType> _haloCellIDs;
+
+  std::vector<double> _exportBuffer; // packed by export entry, then by vector
+  char* _importBuffer = NULL;        // allocated by the Epetra_Distributor; we are responsible for deleting it
+  int _importBufferLength = 0;       // in bytes
+  int _numVectorsInFlight = -1;      // -1 when no exchange is in flight
+};
+}
+
+#endif
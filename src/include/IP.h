@@ -85,6 +85,9 @@ public:
 
   virtual bool hasBoundaryTerms();
 
+  // ! Returns true if every term has translation-invariant weights (see LinearTerm::hasTranslationInvariantWeights()).
+  virtual bool hasTranslationInvariantWeights();
+
   int nonZeroEntryCount(DofOrderingPtr testOrdering);
   
   virtual void operators(int testID1, int testID2,
@@ -0,0 +1,175 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+
+//
+//  LRUCache.h
+//  Camellia
+//
+
+#ifndef Camellia_LRUCache_h
+#define Camellia_LRUCache_h
+
+#include <functional>
+#include <iterator>
+#include <list>
+#include <map>
+
+#include "CamelliaMemoryUtility.h"
+
+namespace Camellia {
+  struct LRUCacheStatistics
+  {
+    long long size = 0;       // number of entries
+    long long memoryCost = 0; // in bytes, as estimated by the cache's cost function
+    long long hits = 0;
+    long long misses = 0;
+    long long evictions = 0;
+  };
+
+  /*!
+   LRUCache: a map with an optional memory budget.  Each entry's cost (in bytes, including the key and value themselves) is
+   estimated by a user-supplied function when the entry is inserted; once the total exceeds the budget, least recently used
+   entries are evicted.  The most recently used entry is never evicted, so a reference returned by find() or insert() remains
+   valid until the next insert() or clear().
+   */
+  template<typename Key, typename Value>
+  class LRUCache
+  {
+  public:
+    typedef std::function<long long(const Key &, const Value &)> CostFunction;
+  private:
+    struct Entry
+    {
+      Key key;
+      Value value;
+      long long cost;
+    };
+    typedef std::list<Entry> EntryList;
+
+    EntryList _entries; // most recently used first
+    std::map<Key, typename EntryList::iterator> _lookup;
+    CostFunction _cost;
+    long long _memoryBudget = -1; // -1: unbounded
+    LRUCacheStatistics _stats;
+
+    void evictToBudget()
+    {
+      if (_memoryBudget < 0) return;
+      while ((_stats.memoryCost > _memoryBudget) && (_entries.size() > 1))
+      {
+        Entry &lruEntry = _entries.back();
+        _stats.memoryCost -= lruEntry.cost;
+        _lookup.erase(lruEntry.key);
+        _entries.pop_back();
+        _stats.evictions++;
+      }
+      _stats.size = _entries.size();
+    }
+  public:
+    LRUCache(CostFunction cost) : _cost(cost) {}
+
+    LRUCache(const LRUCache &other) : _cost(other._cost), _memoryBudget(other._memoryBudget), _stats(other._stats)
+    {
+      for (const Entry &entry : other._entries)
+      {
+        _entries.push_back(entry);
+        _lookup[entry.key] = std::prev(_entries.end());
+      }
+    }
+
+    LRUCache & operator=(const LRUCache &other)
+    {
+      if (this == &other) return *this;
+      _entries.clear();
+      _lookup.clear();
+      _cost = other._cost;
+      _memoryBudget = other._memoryBudget;
+      _stats = other._stats;
+      for (const Entry &entry : other._entries)
+      {
+        _entries.push_back(entry);
+        _lookup[entry.key] = std::prev(_entries.end());
+      }
+      return *this;
+    }
+
+    //! Returns the cached value for key (marking it most recently used), or NULL if there is none.  Counts a hit or a miss.
+    Value* find(const Key &key)
+    {
+      auto lookupEntry = _lookup.find(key);
+      if (lookupEntry == _lookup.end())
+      {
+        _stats.misses++;
+        return NULL;
+      }
+      _stats.hits++;
+      _entries.splice(_entries.begin(), _entries, lookupEntry->second);
+      return &lookupEntry->second->value;
+    }
+
+    //! Caches value for key, replacing any existing value, and evicts least recently used entries as required by the budget.
+    Value & insert(const Key &key, const Value &value)
+    {
+      auto lookupEntry = _lookup.find(key);
+      if (lookupEntry != _lookup.end())
+      {
+        _stats.memoryCost -= lookupEntry->second->cost;
+        _entries.erase(lookupEntry->second);
+        _lookup.erase(lookupEntry);
+      }
+      long long cost = _cost(key, value);
+      _entries.push_front({key, value, cost});
+      _lookup[key] = _entries.begin();
+      _stats.memoryCost += cost;
+      evictToBudget();
+      return _entries.front().value;
+    }
+
+    //! Drops all entries.  Hit, miss, and eviction counts are retained.
+    void clear()
+    {
+      _entries.clear();
+      _lookup.clear();
+      _stats.size = 0;
+      _stats.memoryCost = 0;
+    }
+
+    long long memoryBudget() const
+    {
+      return _memoryBudget;
+    }
+
+    //! Sets the budget, in bytes, evicting entries if necessary.  -1 means unbounded.
+    void setMemoryBudget(long long bytes)
+    {
+      _memoryBudget = bytes;
+      evictToBudget();
+    }
+
+    LRUCacheStatistics statistics() const
+    {
+      return _stats;
+    }
+
+    //! Resets hit, miss, and eviction counts.
+    void resetStatistics()
+    {
+      _stats.hits = 0;
+      _stats.misses = 0;
+      _stats.evictions = 0;
+    }
+
+    //! Entry costs plus the bookkeeping overhead of the cache, in bytes.
+    long long approximateMemoryFootprint() const
+    {
+      long long LIST_NODE_OVERHEAD = 2 * sizeof(void*);
+      return sizeof(*this) + _stats.memoryCost + (LIST_NODE_OVERHEAD + sizeof(long long)) * _entries.size()
+             + approximateMapSizeLLVM(_lookup) - sizeof(_lookup);
+    }
+  };
+}
+
+#endif
@@ -63,6 +63,14 @@ class TLinearTerm
                         BasisCachePtr basisCache, bool sumInto=true);
   static void multiplyFluxValuesByParity(Intrepid::FieldContainer<Scalar> &fluxValues, BasisCachePtr sideBasisCache);
 
+  // integrates the summands involving varID against basis, adding into values(cellIndex, varDofIndices[basisOrdinal]).
+  // Summands sharing (op, coordinate choice) have their weight functions summed, and are then contracted against the weighted
+  // basis values in a single pass.  Weight function values are stored in functionValues, keyed by (function, basisCache), so
+  // that a function shared by several summands or variables is evaluated once per basis cache.
+  void integrateVar(Intrepid::FieldContainer<Scalar> &values, const std::vector<int> &varDofIndices, int varID, BasisPtr basis,
+                    BasisCachePtr basisCache, bool naturalBoundaryTermsOnly, bool applyFluxParity,
+                    std::map<std::pair<TFunction<Scalar>*,BasisCache*>, Intrepid::FieldContainer<Scalar>> &functionValues);
+
   // poor man's templating: just provide both versions of the values argument, making the other version null or size 0
   void integrate(Epetra_CrsMatrix *valuesCrsMatrix, Intrepid::FieldContainer<double> &valuesFC, DofOrderingPtr thisDofOrdering,
                  TLinearTermPtr<double> otherTerm, DofOrderingPtr otherDofOrdering,
@@ -110,6 +118,10 @@ public:
   bool isPureBoundaryTerm() const;
   bool isPureVolumeTerm() const;
 
+  // ! Returns true if each weight is a constant, a unit normal, or a side parity -- i.e., if the weights' values on a cell
+  // ! are determined by the cell's Jacobian and side parities, so that they agree on cells that are translations of one another.
+  bool hasTranslationInvariantWeights() const;
+
   // integrate into values FieldContainers:
   void integrate(Intrepid::FieldContainer<Scalar> &values, DofOrderingPtr thisOrdering,
                  BasisCachePtr basisCache, bool forceBoundaryTerm = false, bool sumInto = true);
@@ -120,7 +132,8 @@ public:
                  TLinearTermPtr<Scalar> otherTerm, VarPtr otherVarID, TFunctionPtr<Scalar> fxn,
                  BasisCachePtr basisCache, bool forceBoundaryTerm = false);
 
-  // CrsMatrix versions (for the two-LT (matrix) variants of integrate)
+  // CrsMatrix versions (for the two-LT (matrix) variants of integrate).  These sum into the rows given by the DofOrdering indices of a single cell;
+  // concurrent callers must not share rows -- see DofInterpreter::cellColorsForAssembly() for grouping cells whose global dofs are disjoint.
   void integrate(Epetra_CrsMatrix *values, DofOrderingPtr thisDofOrdering,
                  TLinearTermPtr<double> otherTerm, DofOrderingPtr otherDofOrdering,
                  BasisCachePtr basisCache, bool forceBoundaryTerm = false, bool sumInto = true);
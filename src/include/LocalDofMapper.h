@@ -97,6 +97,9 @@ public:
   const vector<GlobalIndexType> &globalIndices();
   set<GlobalIndexType> globalIndicesForSubcell(int varID, unsigned d, unsigned subcord);
 
+  // ! Approximate storage for the mapper, in bytes.  Sub-basis mappers, which may be shared between LocalDofMappers, are counted by pointer only.
+  long long approximateMemoryFootprint() const;
+  
   void printMappingReport();
 
   void reverseParity(set<int> fluxVarIDs, set<unsigned> sideOrdinals); // multiplies corresponding sideMaps by -1
@@ -0,0 +1,59 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+
+//
+//  MemoryReport.h
+//  Camellia
+//
+
+#ifndef Camellia_MemoryReport_h
+#define Camellia_MemoryReport_h
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#include "TypeDefs.h"
+
+namespace Camellia {
+  /*!
+   MemoryReport: collects the approximate memory costs (in bytes) reported by the approximateMemoryCosts() methods of Mesh,
+   Solution, DofInterpreter, etc., and reports them for this rank and reduced across ranks.  Meant to be emitted by drivers
+   (e.g. after each refinement) to help size jobs and to decide which caches to trade for recomputation.
+
+   Like the methods it draws on, the costs are estimates, typically within a factor of 2 or so.
+   */
+  class MemoryReport
+  {
+    Epetra_CommPtr _Comm;
+    std::map<std::string, long long> _localCosts;
+  public:
+    MemoryReport(Epetra_CommPtr Comm);
+
+    //! Adds costs to the report, with keys prefixed by prefix.  Costs for keys already present are accumulated.
+    void addCosts(const std::string &prefix, const std::map<std::string, long long> &costs);
+
+    //! Adds mesh->approximateMemoryCosts(), with keys prefixed by prefix.
+    void addMesh(MeshPtr mesh, const std::string &prefix = "Mesh.");
+    //! Adds solution->approximateMemoryCosts(), with keys prefixed by prefix.
+    void addSolution(SolutionPtr solution, const std::string &prefix = "Solution.");
+
+    //! Costs on this rank.
+    const std::map<std::string, long long> & localCosts() const;
+    long long localTotal() const;
+
+    //! MPI-collective.  For each entry reported on any rank, the minimum, maximum, and sum over ranks; a rank that does not report
+    //! an entry counts as zero for it.  The key "Total" holds the corresponding statistics for the per-rank totals.
+    void globalCosts(std::map<std::string, long long> &minCosts, std::map<std::string, long long> &maxCosts,
+                     std::map<std::string, long long> &sumCosts) const;
+
+    //! MPI-collective.  On rank 0, prints the minimum, maximum, and sum over ranks for each entry, largest sum first.
+    //! Entries whose sum is less than minBytesToReport are omitted (the totals always include them).
+    void print(std::ostream &out = std::cout, long long minBytesToReport = 0) const;
+  };
+}
+
+#endif
@@ -53,6 +53,8 @@ class Mesh : public RefinementObserver, public DofInterpreter
 
   Teuchos::RCP<GlobalDofAssignment> _gda;
 
+  CellHaloPtr _cellHalo; // built on demand; cleared whenever the mesh is repartitioned
+
   int _pToAddToTest;
   bool _enforceMBFluxContinuity; // default to false (the historical value)
   bool _usePatchBasis; // use MultiBasis if this is false.
@@ -175,6 +177,10 @@ public:
   vector< GlobalIndexType > cellIDsOfTypeGlobal(ElementTypePtr elemTypePtr);
 
   const set<GlobalIndexType> & cellIDsInPartition(); // rank-local cellIDs
+
+  //! Communication plan for per-cell data between rank-local cells and their off-rank neighbors.  MPI-collective when the
+  //! plan must be built (the first call after each repartition).
+  CellHaloPtr cellHalo();
   
   int cellPolyOrder(GlobalIndexType cellID);
   vector<int> cellTensorPolyOrder(GlobalIndexType cellID);
@@ -201,6 +207,9 @@ public:
   GlobalIndexType globalDofCount();
   GlobalIndexType globalDofIndex(GlobalIndexType cellID, IndexType localDofIndex);
   set<GlobalIndexType> globalDofIndicesForPartition(PartitionIndexType partitionNumber);
+  bool globalDofRangeForPartition(PartitionIndexType partitionNumber, GlobalIndexType &firstDofIndex, GlobalIndexType &dofCount);
+  GlobalIndexType globalDofCountForPartition(PartitionIndexType partitionNumber);
+  void sortedGlobalDofIndicesForPartition(PartitionIndexType partitionNumber, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
 
   GlobalDofAssignmentPtr globalDofAssignment();
 
@@ -209,6 +218,9 @@ public:
 
   ElementPtr ancestralNeighborForSide(ElementPtr elem, int sideOrdinal, int &elemSideOrdinalInNeighbor);
 
+  // ! Approximate memory costs, in bytes, of the mesh topology and global dof assignment on this rank.  Keys are prefixed by member ("_meshTopology.", "_gda.").
+  std::map<std::string, long long> approximateMemoryCosts() const;
+
   vector< ElementPtr > elementsOfType(PartitionIndexType partitionNumber, ElementTypePtr elemTypePtr);
   vector< ElementPtr > elementsOfTypeGlobal(ElementTypePtr elemTypePtr); // may want to deprecate in favor of cellIDsOfTypeGlobal()
 
@@ -216,6 +228,7 @@ public:
 
   int getDimension(); // spatial dimension of the mesh
   set<GlobalIndexType> globalDofIndicesForCell(GlobalIndexType cellID);
+  void sortedGlobalDofIndicesForCell(GlobalIndexType cellID, std::vector<GlobalIndexType> &sortedGlobalDofIndices);
   
   //!! Returns the global dof indices for the indicated subcell.  Only guaranteed to provide correct values for cells that belong to the local partition.
   set<GlobalIndexType> globalDofIndicesForVarOnSubcell(int varID, GlobalIndexType cellID, unsigned dim, unsigned subcellOrdinal);
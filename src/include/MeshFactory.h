@@ -111,14 +111,17 @@ public:
                                           double x0=0.0, double y0=0.0,
                                           vector<PeriodicBCPtr> periodicBCs=vector<PeriodicBCPtr>());
 
+  // ! If Comm is non-null, the mesh is built on a distributed rectilinearMeshTopology(), partitioned with the default MeshPartitionPolicy.
   static MeshPtr rectilinearMesh(TBFPtr<double> bf, vector<double> dimensions, vector<int> elementCounts,
                                  int H1Order, int pToAddTest=-1, vector<double> x0 = vector<double>(),
                                  map<int,int> trialOrderEnhancements = map<int,int>(),
                                  map<int,int> testOrderEnhancements = map<int,int>(),
                                  Epetra_CommPtr Comm = Teuchos::null);
 
+  // ! Vertices and cells are generated directly from grid indices.  If Comm is non-null, the returned MeshTopology is distributed: each rank
+  // ! builds only a contiguous chunk of cells (the ones it owns) and their halo, instead of building the global topology and pruning it.
   static MeshTopologyPtr rectilinearMeshTopology(vector<double> dimensions, vector<int> elementCounts,
-      vector<double> x0 = vector<double>());
+      vector<double> x0 = vector<double>(), Epetra_CommPtr Comm = Teuchos::null);
 
   static MeshPtr readMesh(string filePath, TBFPtr<double> bilinearForm, int H1Order, int pToAdd);
 
@@ -90,6 +90,7 @@ class MeshTopology : public MeshTopologyView
   void addEdgeCurve(pair<IndexType,IndexType> edge, ParametricCurvePtr curve);
   //  IndexType addEntity(const shards::CellTopology &entityTopo, const vector<IndexType> &entityVertices, unsigned &entityPermutation); // returns the entityIndex
   IndexType addEntity(CellTopoPtr entityTopo, const vector<IndexType> &entityVertices, unsigned &entityPermutation); // returns the entityIndex
+  IndexType addVertexWithoutMatching(const vector<double> &vertex); // caller guarantees vertex is new and not subject to periodic BCs; returns the vertexIndex
 
   void deactivateCell(CellPtr cell);
   set<IndexType> descendants(unsigned d, IndexType entityIndex) const;
@@ -113,8 +114,6 @@ class MeshTopology : public MeshTopologyView
 
   GlobalDofAssignment* _gda; // for cubature degree lookups
 
-  map<string, long long> approximateMemoryCosts() const; // for each private variable
-
   void addSideForEntity(unsigned entityDim, IndexType entityIndex, IndexType sideEntityIndex); // maintains _sidesForEntities container
 
   // ! private method for deep-copying Cells during MeshToplogy::deepCopy()
@@ -127,6 +126,12 @@ public:
   MeshTopology(unsigned spaceDim, vector<PeriodicBCPtr> periodicBCs=vector<PeriodicBCPtr>());
   MeshTopology(MeshGeometryPtr meshGeometry, vector<PeriodicBCPtr> periodicBCs=vector<PeriodicBCPtr>());
   MeshTopology(Epetra_CommPtr Comm, const MeshGeometryInfo &meshGeometryInfo);
+  
+  // ! Bulk constructor for tensor-product grids of lines, quads, or hexahedra.  Vertices and cells are generated directly from grid indices,
+  // ! without coordinate-based vertex matching; cell indices and vertex orderings match those of MeshFactory::rectilinearMeshTopology().
+  // ! If Comm is null, the whole grid is constructed.  Otherwise, each rank owns a contiguous chunk of cell indices (as in the default
+  // ! MeshPartitionPolicy), and only the owned cells and their vertex-neighbor halo are constructed.
+  MeshTopology(Epetra_CommPtr Comm, const vector<double> &dimensions, const vector<int> &elementCounts, const vector<double> &x0);
   virtual ~MeshTopology() {}
 
   CellPtr addCell(CellTopoPtr cellTopo, const vector< vector<double> > &cellVertices);
@@ -140,6 +145,9 @@ public:
 
   void applyTag(std::string tagName, int tagID, EntitySetPtr entitySet);
   
+  // ! Approximate memory costs (in bytes) for each private variable; approximateMemoryFootprint() is their sum
+  map<string, long long> approximateMemoryCosts() const;
+  
   // ! This method only gets within a factor of 2 or so, but can give a rough estimate (in bytes)
   long long approximateMemoryFootprint() const;
 
@@ -30,6 +30,7 @@ class MeshTransformationFunction : public TFunction<double>
   Camellia::EOperator _op;
   MeshPtr _mesh;
   int _maxPolynomialDegree;
+  TFunctionPtr<double> _dx, _dy, _dz; // created on first request (BasisCache asks for them whenever it computes Jacobians); cleared by updateCells()
 protected:
   MeshTransformationFunction(MeshPtr mesh, map< GlobalIndexType, TFunctionPtr<double> > cellTransforms, Camellia::EOperator op);
 public:
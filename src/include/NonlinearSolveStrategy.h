@@ -23,11 +23,24 @@ class NonlinearSolveStrategy
 {
   Teuchos::RCP<NonlinearStepSize> _stepSize;
   TSolutionPtr<double> _backgroundFlow, _solution;
+  SolverPtr _solver; // if null, each step uses _solution->solve(false)
   double _relativeEnergyTolerance;
   bool _usePicardIteration; // instead of Newton-Raphson (will just do background = new at each step)
+  bool _useInexactNewton;
+  double _finalLinearTolerance, _maxForcingTerm; // bounds on the linear tolerance in inexact-Newton mode
+
+  void solveInexactNewton(bool printToConsole);
 public:
   NonlinearSolveStrategy(TSolutionPtr<double> backgroundFlow, TSolutionPtr<double> solution, Teuchos::RCP<NonlinearStepSize> stepSize, double relativeEnergyTolerance);
   void setUsePicardIteration(bool value);
+  //! Solver for the linear system of each nonlinear step.  If not set, a direct solver is used.
+  void setSolver(SolverPtr solver);
+  //! Inexact Newton: for Newton iteration with an iterative solver (see setSolver()), sets the solver's tolerance for each step from the
+  //! reduction in the nonlinear residual (Eisenstat-Walker forcing terms), between finalLinearTolerance and maxForcingTerm.  The nonlinear
+  //! residual is the norm of the assembled right-hand side, which for the Newton increment is the DPG residual at the background flow;
+  //! convergence is declared when it falls below relativeEnergyTolerance times its initial value, so no energy error is computed.
+  //! The solver's own tolerance is restored when solve() returns.
+  void setUseInexactNewton(bool value, double finalLinearTolerance = 1e-10, double maxForcingTerm = 0.9);
   void solve(bool printToConsole=false);
 };
 }
@@ -0,0 +1,88 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  OffRankAssemblyExchange.h
+//  Camellia
+//
+
+#ifndef Camellia_OffRankAssemblyExchange_h
+#define Camellia_OffRankAssemblyExchange_h
+
+#include "Epetra_Distributor.h"
+#include "Epetra_FECrsMatrix.h"
+#include "Epetra_FEVector.h"
+#include "Epetra_Map.h"
+
+#include "Teuchos_RCP.hpp"
+
+#include "TypeDefs.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace Camellia
+{
+/*!
+ OffRankAssemblyExchange: sends the contributions to a global matrix and vector that belong to rows owned by other ranks,
+ so that the exchange can overlap with further local assembly.
+
+ Epetra_FECrsMatrix and Epetra_FEVector buffer off-rank contributions until GlobalAssemble(), which communicates them
+ all at once.  Contributions summed in through this class instead go directly into the rows this rank owns; the rest are
+ combined locally and sent by beginExchange() with nonblocking receives.  endExchange() waits for the contributions sent to
+ this rank and sums them in.  GlobalAssemble() must still be called afterward (to complete the fill), but has nothing
+ left to communicate for the rows assembled here.
+ */
+class OffRankAssemblyExchange
+{
+public:
+  //! rowMap: the distribution of the matrix rows and vector entries to be assembled.
+  OffRankAssemblyExchange(const Epetra_Map &rowMap);
+  ~OffRankAssemblyExchange();
+
+  OffRankAssemblyExchange(const OffRankAssemblyExchange &) = delete;
+  OffRankAssemblyExchange & operator=(const OffRankAssemblyExchange &) = delete;
+
+  bool ownsRow(GlobalIndexType globalRow) const;
+
+  //! Sums the numDofs x numDofs block values, stored column-major (as Epetra_FECrsMatrix::InsertGlobalValues() expects by
+  //! default), into matrix at the rows and columns given by dofIndices.  Rows owned by other ranks are buffered for the exchange.
+  void sumIntoMatrix(Epetra_FECrsMatrix &matrix, int numDofs, const GlobalIndexTypeToCast* dofIndices, const double* values);
+  //! Sums values into the vectorOrdinal column of feVector at the rows given by dofIndices.  Rows owned by other ranks are buffered for the exchange.
+  void sumIntoVector(Epetra_FEVector &feVector, int vectorOrdinal, int numDofs, const GlobalIndexTypeToCast* dofIndices, const double* values);
+
+  //! Number of distinct matrix and vector entries buffered for other ranks since the last beginExchange().
+  int bufferedEntryCount() const;
+
+  //! Posts the exchange of the buffered entries with their owning ranks.  MPI-collective.
+  void beginExchange();
+  //! Completes the exchange posted by beginExchange(), summing the received entries into matrix and feVector.
+  void endExchange(Epetra_FECrsMatrix &matrix, Epetra_FEVector &feVector);
+
+  //! Number of entries sent to other ranks and received from them by the last exchange.
+  int sentEntryCount() const;
+  int receivedEntryCount() const;
+private:
+  struct Entry
+  {
+    GlobalIndexTypeToCast row;
+    GlobalIndexTypeToCast col; // for vector entries, -1 - vectorOrdinal
+    double value;
+  };
+
+  Epetra_Map _rowMap;
+  std::map<std::pair<GlobalIndexTypeToCast,GlobalIndexTypeToCast>, double> _offRankEntries; // (row, col) -> value
+
+  Teuchos::RCP<Epetra_Distributor> _distributor;
+  std::vector<Entry> _exportBuffer; // grouped by destination rank
+  char* _importBuffer = NULL;       // allocated by the Epetra_Distributor; we are responsible for deleting it
+  int _importBufferLength = 0;      // in bytes
+  bool _exchangeInFlight = false;
+  int _sentEntryCount = 0, _receivedEntryCount = 0;
+};
+}
+
+#endif
@@ -44,6 +44,8 @@ protected:
 public:
   ParametricFunction(TFunctionPtr<double> fxn);
   void value(double t, double &x);
+  //! Evaluates at each of the parameter values in tValues (P), filling xValues (P), with a single evaluation of the underlying Function.
+  void valuesAtParameters(const Intrepid::FieldContainer<double> &tValues, Intrepid::FieldContainer<double> &xValues);
   void values(Intrepid::FieldContainer<double> &values, BasisCachePtr basisCache);
 
   TFunctionPtr<double> dx(); // same function as dt_parametric()
@@ -62,6 +64,7 @@ public:
   typedef Teuchos::RCP<ParametricCurve> ParametricCurvePtr;
 private:
   ParametricFunctionPtr _xFxn, _yFxn, _zFxn; // parametric functions (defined on ref line mapped to [0,1])
+  ParametricCurvePtr _dtCurve; // dt_parametric(), created on first request for derivatives in valuesAtParameters()
   TFunctionPtr<double> argumentMap();
 
   //  void mapRefCellPointsToParameterSpace(Intrepid::FieldContainer<double> &refPoints);
@@ -87,6 +90,13 @@ public:
 
   virtual void values(Intrepid::FieldContainer<double> &values, BasisCachePtr basisCache);
 
+  //! Evaluates the curve at each of the parameter values in tValues (P), filling points, sized (P,D) by the caller, and, if
+  //! dPointsdt is not NULL, the derivative with respect to t, also (P,D).  Curves defined by Functions evaluate each Function
+  //! once for all the points; other subclasses should override this along with value().  The default for those falls back
+  //! on one value() call per point.
+  virtual void valuesAtParameters(const Intrepid::FieldContainer<double> &tValues, Intrepid::FieldContainer<double> &points,
+                                  Intrepid::FieldContainer<double>* dPointsdt = NULL);
+
   virtual ParametricCurvePtr dt_parametric(); // the curve differentiated in t in each component.
 
   virtual TFunctionPtr<double> x();
@@ -43,6 +43,10 @@ public:
   virtual void value(double t1, double t2, double &x, double &y) = 0;
   virtual void values(Intrepid::FieldContainer<double> &values, BasisCachePtr basisCache);
 
+  //! Evaluates the surface at parametricPoints (P,2), filling points (P,2).  The default calls value() for each point;
+  //! subclasses defined in terms of ParametricCurves override this to evaluate each curve once for all the points.
+  virtual void valuesAtParameters(const Intrepid::FieldContainer<double> &parametricPoints, Intrepid::FieldContainer<double> &points);
+
   static Intrepid::FieldContainer<double> &parametricQuadNodes(); // for CellTools cellWorkset argument
 
   static void basisWeightsForEdgeInterpolant(Intrepid::FieldContainer<double> &basisCoefficients,
@@ -0,0 +1,62 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+
+//
+//  ReferenceValueRegistry.h
+//  Camellia
+//
+
+#ifndef Camellia_ReferenceValueRegistry_h
+#define Camellia_ReferenceValueRegistry_h
+
+#include "TypeDefs.h"
+
+#include "Intrepid_FieldContainer.hpp"
+
+#include "Basis.h"
+#include "CamelliaIntrepidExtendedTypes.h"
+#include "CellTopology.h"
+
+namespace Camellia
+{
+//! ReferenceValueRegistry: process-wide store of cubature rules and of basis values on the reference cell.
+/*!
+ Reference-cell quantities depend only on the cell topology, the cubature degree, the side (if any), the basis, and the
+ operator -- not on the physical cells.  BasisCache consults the registry before evaluating, so that short-lived caches
+ (one per cell, as in Riesz representation or solution evaluation) do not repeat the reference work.
+
+ Values handed out are shared and must be treated as read-only.  Registry access is serialized by a mutex; the RCPs
+ themselves follow the usual Teuchos rules for sharing across threads.
+
+ Entries hold a reference to their Basis, so that the Basis address used in the key stays valid for the life of the entry.
+ */
+class ReferenceValueRegistry
+{
+public:
+  //! Returns an identifier for the cubature rule of the given degree on cellTopo (on side sideOrdinal, or in the volume
+  //! if sideOrdinal == -1), and fills cubPoints and cubWeights with its points (in side coordinates for sides) and weights.
+  //! Exactly one of cubDegree (>= 0) and cubDegrees (non-empty) is used, following BasisCache's convention.
+  static int cubatureRule(CellTopoPtr cellTopo, int cubDegree, const std::vector<int> &cubDegrees, int sideOrdinal,
+                          Intrepid::FieldContainer<double> &cubPoints, Intrepid::FieldContainer<double> &cubWeights);
+
+  //! Returns the values of basis under op at points, computing and storing them on first request.  points must be the
+  //! points of cubatureRule ruleID -- mapped into the volume reference cell when useSideRefCellPoints is true.
+  //! op must be an operator understood by BasisEvaluation::getValues().
+  static constFCPtr referenceValues(BasisPtr basis, Camellia::EOperator op, int ruleID, bool useSideRefCellPoints,
+                                    const Intrepid::FieldContainer<double> &points);
+
+  //! Number of referenceValues() requests answered from the registry.
+  static long hitCount();
+  //! Number of referenceValues() requests that required evaluation.
+  static long missCount();
+  static void resetCounters();
+
+  //! Releases all stored values and bases.  Rule identifiers handed out earlier remain valid.
+  static void clearValues();
+};
+}
+
+#endif
@@ -51,6 +51,7 @@ private:
   bool _repsNotComputed;
 
   bool _distributeDofs = false; // old behavior corresponds to "true" value.
+  bool _useMixedPrecisionGramSolve = false;
   
 public:
   TRieszRep(MeshPtr mesh, TIPPtr<Scalar> ip, TLinearTermPtr<Scalar> functional)
@@ -67,6 +68,14 @@ public:
     _printAll = printAll;
   }
 
+  // ! When true, the Gram matrices are factored in single precision, with iterative refinement to double-precision accuracy
+  // ! (see SerialDenseWrapper::solveSPDSystemMixedPrecision()).  Each cell's Gram solve here has a single right-hand side, which
+  // ! is the case where the single-precision factorization saves time.
+  void setUseMixedPrecisionGramSolve(bool value)
+  {
+    _useMixedPrecisionGramSolve = value;
+  }
+
   void setFunctional(TLinearTermPtr<Scalar> functional)
   {
     _functional = functional;
@@ -30,6 +30,11 @@ public:
   void setPrintToConsole(bool printToConsole);
   int solve();
   void setTolerance(double tol);
+  double tolerance();
+  bool isIterative()
+  {
+    return true;
+  }
 };
 }
 
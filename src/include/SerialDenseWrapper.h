@@ -94,6 +94,18 @@ namespace Camellia
     // ! A_SPD is left as in lower-triangular factored format; bx on input is the RHS b; on output, it's the solution x = A \ b.
     static int solveSPDSystemLAPACKCholesky(Intrepid::FieldContainer<double> &bx, Intrepid::FieldContainer<double> &A_SPD);
     
+    // ! Solves A x = b by factoring the (equilibrated) matrix in single precision and recovering double-precision accuracy by
+    // ! iterative refinement, with residuals computed in double.  Falls back to a double-precision Cholesky factorization when
+    // ! the condition number estimated from the single-precision factor exceeds maxConditionNumber, or when refinement has not
+    // ! converged after maxRefinements steps.  bx holds one or more right-hand sides of length N, each stored contiguously; on
+    // ! output, it holds the solutions.  A_SPD is overwritten.  If usedSinglePrecision is non-null, it records which path was taken.
+    // ! Each refinement step computes residuals in double, at O(N^2) per right-hand side, so this only pays off for a few
+    // ! right-hand sides; for about N of them (e.g. the optimal test solve), a double-precision Cholesky solve is cheaper.
+    // ! See drivers/Benchmarks/GramSolveBenchmark.cpp.
+    static int solveSPDSystemMixedPrecision(Intrepid::FieldContainer<double> &bx, Intrepid::FieldContainer<double> &A_SPD,
+                                            double maxConditionNumber = 1e6, int maxRefinements = 10,
+                                            bool* usedSinglePrecision = NULL);
+    
     static int solveSPDSystemMultipleRHS(Intrepid::FieldContainer<double> &x, Intrepid::FieldContainer<double> &A_SPD,
                                          Intrepid::FieldContainer<double> &b, bool allowOverwriteOfA = false);
     
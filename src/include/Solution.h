@@ -24,6 +24,7 @@
 #include <Epetra_Map.h>
 
 #include "Epetra_Comm.h"
+#include "Epetra_Distributor.h"
 #include "Epetra_FECrsMatrix.h"
 #include "Epetra_FEVector.h"
 #include "Epetra_Operator.h"
@@ -33,10 +34,14 @@
 #include "BasisCache.h"
 #include "DofInterpreter.h"
 #include "ElementType.h"
+#include "HaloImportPlan.h"
 #include "LocalStiffnessMatrixFilter.h"
 #include "Narrator.h"
+#include "RefinementPattern.h"
 #include "Solver.h"
 
+#include <tuple>
+
 namespace Camellia
 {
 template <typename Scalar>
@@ -76,6 +81,37 @@ private:
   TVectorPtr<Scalar> _rhsVector2;
   TVectorPtr<Scalar> _lhsVector2;
 
+  // parent-to-child coefficient maps used by projectOldCellOntoNewCells(), keyed by
+  // (parent basis, child basis, refinement pattern, child ordinal, child side ordinal, parent side ordinal, cubature degree).
+  // Side ordinals are -1 for volume bases; the refinement pattern's ordinal is -1 when the cell is its own "child" (p-refinement).
+  // Bases are owned by BasisFactory, which outlives the cache.
+  typedef std::tuple<Camellia::Basis<>*, Camellia::Basis<>*, RefinementPatternKey, int, int, int, int> RefinementTransferKey;
+  std::map<RefinementTransferKey, Intrepid::FieldContainer<Scalar>> _refinementTransferMatrices;
+  bool _useRefinementTransferMatrices = true;
+
+  const Intrepid::FieldContainer<Scalar> & refinementTransferMatrix(const RefinementTransferKey &key, BasisPtr parentBasis, BasisCachePtr parentBasisCache,
+                                                                     BasisPtr childBasis, BasisCachePtr childBasisCache);
+
+  // plan used by importSolution(); valid for the dof interpreter and global dof numbering recorded alongside it
+  Teuchos::RCP<HaloImportPlan> _importPlan;
+  Teuchos::RCP<DofInterpreter> _importPlanDofInterpreter;
+  GlobalDofAssignmentPtr _importPlanGDA;
+  unsigned _importPlanDofNumberingVersion = 0;
+  bool _reuseImportPlan = true;
+
+  bool _usePipelinedAssembly = false;
+  int _pipelinedHaloCellCount = 0, _pipelinedSentEntryCount = 0; // on this rank, for the last pipelined assembly
+
+  // communication plan used by importSolutionForOffRankCells(), valid for the cells and numbering recorded alongside it
+  Teuchos::RCP<Epetra_Distributor> _offRankImportDistributor;
+  std::set<GlobalIndexType> _offRankImportCellIDs;
+  std::vector<GlobalIndexTypeToCast> _offRankImportRequest;     // cells requested from other ranks, sorted by owning rank
+  std::vector<GlobalIndexTypeToCast> _offRankImportCellsToExport; // cells other ranks have requested from us
+  GlobalDofAssignmentPtr _offRankImportGDA;
+  unsigned _offRankImportDofNumberingVersion = 0;
+
+  void importCellCoefficients(GlobalIndexType cellID, const Epetra_MultiVector &globalCoefficients);
+
   bool _residualsComputed;
   bool _energyErrorComputed;
   bool _rankLocalEnergyErrorComputed;
@@ -93,6 +129,9 @@ private:
   double _maxTimeLocalStiffness, _maxTimeGlobalAssembly, _maxTimeBCImposition, _maxTimeSolve, _maxTimeDistributeSolution;
   double _minTimeLocalStiffness, _minTimeGlobalAssembly, _minTimeBCImposition, _minTimeSolve, _minTimeDistributeSolution;
   double _totalTimeApplyJumpTerms, _meanTimeApplyJumpTerms, _maxTimeApplyJumpTerms, _minTimeApplyJumpTerms;
+  // pipelined assembly: interior assembly overlapping the off-rank exchange, and the wait for the exchange afterward
+  double _totalTimeExchangeOverlap = 0, _meanTimeExchangeOverlap = 0, _maxTimeExchangeOverlap = 0, _minTimeExchangeOverlap = 0;
+  double _totalTimeExchangeWait = 0, _meanTimeExchangeWait = 0, _maxTimeExchangeWait = 0, _minTimeExchangeWait = 0;
 
   bool _reportConditionNumber, _reportTimingResults;
   bool _saveMeshOnSolveError = true; // if there is a solve error, save the mesh to disk for potential analysis
@@ -131,16 +170,26 @@ public:
                                                                    int solutionNumber=0); // coefficients for all solution variables
   void setLocalCoefficientsForCell(GlobalIndexType cellID, const Intrepid::FieldContainer<Scalar> &coefficients, int solutionNumber);
 
+  // ! Approximate memory costs, in bytes, of the data stored on this rank, keyed by member variable.  When a dof interpreter other than
+  // ! the mesh is in use (e.g. for condensed solves), its costs are included, with keys prefixed by "_dofInterpreter.".  The mesh's costs are not included.
+  std::map<std::string, long long> approximateMemoryCosts() const;
+  
   Teuchos::RCP<DofInterpreter> getDofInterpreter() const;
   void setDofInterpreter(Teuchos::RCP<DofInterpreter> dofInterpreter);
 
   Epetra_Map getPartitionMap();
   Epetra_Map getPartitionMap(PartitionIndexType rank, std::set<GlobalIndexType> &myGlobalIndicesSet,
                              GlobalIndexType numGlobalDofs, int zeroMeanConstraintsSize, Epetra_Comm* Comm );
+  //! As above, but takes the partition's global dof indices as a sorted vector.
+  Epetra_Map getPartitionMap(PartitionIndexType rank, const std::vector<GlobalIndexType> &myGlobalIndices,
+                             GlobalIndexType numGlobalDofs, int zeroMeanConstraintsSize, Epetra_Comm* Comm );
 
   MapPtr getPartitionMap2();
   MapPtr getPartitionMap2(PartitionIndexType rank, std::set<GlobalIndexType> &myGlobalIndicesSet,
                           GlobalIndexType numGlobalDofs, int zeroMeanConstraintsSize, Teuchos_CommPtr Comm );
+  //! As above, but takes the partition's global dof indices as a sorted vector.
+  MapPtr getPartitionMap2(PartitionIndexType rank, const std::vector<GlobalIndexType> &myGlobalIndices,
+                          GlobalIndexType numGlobalDofs, int zeroMeanConstraintsSize, Teuchos_CommPtr Comm );
 
   Epetra_MultiVector* getGlobalCoefficients();
   TVectorPtr<Scalar> getGlobalCoefficients2();
@@ -171,6 +220,10 @@ public:
 
   int solve( TSolverPtr<Scalar> solver );
 
+  // solve( solver ), in two halves, so that callers can examine the assembled system (e.g. its residual) before solving:
+  void assembleSystem( TSolverPtr<Scalar> solver ); // initializes, assembles, and imposes BCs on the global system, and hands it to solver
+  int solveAssembledSystem( TSolverPtr<Scalar> solver ); // solves the system from assembleSystem(), and imports the solution
+
   void addSolution(TSolutionPtr<Scalar> soln, double weight, bool allowEmptyCells = false, bool replaceBoundaryTerms=false); // thisSoln += weight * soln
 
   void addSolution(TSolutionPtr<Scalar> soln, double weight, set<int> varsToAdd, bool allowEmptyCells = false); // thisSoln += weight * soln
@@ -233,6 +286,26 @@ public:
   void projectOldCellOntoNewCells(GlobalIndexType cellID, ElementTypePtr oldElemType,
                                   const Intrepid::FieldContainer<Scalar> &oldData,
                                   const std::vector<GlobalIndexType> &childIDs, int solutonOrdinal);
+  //! When true (the default), projectOldCellOntoNewCells() applies cached parent-to-child transfer matrices for field variables and
+  //! for traces on sides the child shares with its parent, in place of projecting each cell's solution.  (Traces on sides interior
+  //! to the parent are always projected.)  Either way, the projection is carried out in reference space.
+  void setUseRefinementTransferMatrices(bool value);
+
+  //! When true (the default), importSolution() reuses its import plan until the global dof numbering or the dof interpreter
+  //! changes.  When false, the plan is rebuilt on every call.
+  void setReuseImportPlan(bool value);
+
+  //! When true, populateStiffnessAndLoad() assembles cells with global dofs owned by other ranks first, and sends their
+  //! off-rank contributions while the remaining cells are assembled, rather than communicating everything in GlobalAssemble().
+  //! The time spent assembling during the exchange and waiting for it afterward is reported by the ExchangeOverlap and
+  //! ExchangeWait timing accessors.  Default is false.
+  void setUsePipelinedAssembly(bool value);
+  bool usesPipelinedAssembly() const;
+  //! For the last pipelined assembly on this rank: the number of cells assembled in the first (halo) phase, and the number
+  //! of off-rank matrix and vector entries sent during the exchange.
+  int pipelinedAssemblyHaloCellCount() const;
+  int pipelinedAssemblySentEntryCount() const;
+
   void reverseParitiesForLocalCoefficients(GlobalIndexType cellID, const vector<int> &sidesWithChangedParities, int solutionOrdinal);
 
   void setLagrangeConstraints( Teuchos::RCP<LagrangeConstraints> lagrangeConstraints);
@@ -309,6 +382,8 @@ public:
   double totalTimeBCImposition();
   double totalTimeSolve();
   double totalTimeDistributeSolution();
+  double totalTimeExchangeOverlap();
+  double totalTimeExchangeWait();
 
   double meanTimeApplyJumpTerms();
   double meanTimeLocalStiffness();
@@ -316,6 +391,8 @@ public:
   double meanTimeBCImposition();
   double meanTimeSolve();
   double meanTimeDistributeSolution();
+  double meanTimeExchangeOverlap();
+  double meanTimeExchangeWait();
 
   double maxTimeApplyJumpTerms();
   double maxTimeLocalStiffness();
@@ -323,6 +400,8 @@ public:
   double maxTimeBCImposition();
   double maxTimeSolve();
   double maxTimeDistributeSolution();
+  double maxTimeExchangeOverlap();
+  double maxTimeExchangeWait();
 
   double minTimeApplyJumpTerms();
   double minTimeLocalStiffness();
@@ -330,6 +409,8 @@ public:
   double minTimeBCImposition();
   double minTimeSolve();
   double minTimeDistributeSolution();
+  double minTimeExchangeOverlap();
+  double minTimeExchangeWait();
 
   void reportTimings();
 
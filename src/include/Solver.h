@@ -101,6 +101,20 @@ public:
     
   }
   virtual int solve() = 0; // solve with an error code response
+  //! Iterative solvers: sets the residual tolerance, relative to the initial residual, used by subsequent solves.  Direct solvers ignore this.
+  virtual void setTolerance(double tol)
+  {
+  }
+  //! Iterative solvers: the tolerance set by setTolerance().  Direct solvers return 0.
+  virtual double tolerance()
+  {
+    return 0.0;
+  }
+  //! True for solvers whose accuracy is controlled by setTolerance().
+  virtual bool isIterative()
+  {
+    return false;
+  }
   virtual int resolve()
   {
     // must be preceded by a call to solve(); caller attests that the system matrix has not been altered since last call to solve()
@@ -180,6 +194,9 @@ public:
   {
     if (_savedSolver.get() != NULL)
     {
+      // setLHS() and setRHS() may have supplied new vectors since the factorization was computed
+      _savedSolver->setX(this->_lhs);
+      _savedSolver->setB(this->_rhs);
       _savedSolver->solve();
     }
     else
@@ -347,6 +364,9 @@ public:
 //    return _savedSolver->Solve();
     if (_savedSolver.get() != NULL)
     {
+      // setLHS() and setRHS() may have supplied new vectors since the factorization was computed
+      _savedProblem->SetLHS(this->_lhs.get());
+      _savedProblem->SetRHS(this->_rhs.get());
       return _savedSolver->Solve();
     }
     else
@@ -0,0 +1,111 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  SpaceTimeSlabSolver.h
+//  Camellia
+//
+
+#ifndef Camellia_SpaceTimeSlabSolver_h
+#define Camellia_SpaceTimeSlabSolver_h
+
+#include "TypeDefs.h"
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Camellia
+{
+/*!
+ SpaceTimeSlabSolver: solves a space-time formulation on a sequence of time slabs [t_k, t_{k+1}], each a space-time mesh
+ built with MeshFactory::spaceTimeMeshTopology() from the same spatial MeshTopology.
+
+ The initial data for each slab are Dirichlet conditions on trace variables at t_k: for the first slab, the functions
+ provided to addInitialData(); for later slabs, the previous slab's values of the same traces at t_k, transferred with
+ MeshTransferFunction.
+
+ Because every slab's mesh comes from the same spatial mesh, the global systems of successive slabs differ only in their
+ right-hand sides, provided the bilinear form and inner product do not depend on t.  When setReuseFactorization() is on (the
+ default) and the new slab's partition and dof count match those of the slab on which the solver was last set up, the new
+ slab's system is solved with the previous slab's solver by resolve(), so that a saved direct factorization or a GMG
+ hierarchy is set up only once.
+ */
+class SpaceTimeSlabSolver
+{
+public:
+  //! Returns the BCs (other than initial data) for the slab [t0, t1]; called once per slab, and should return a fresh BC.
+  typedef std::function<BCPtr(double t0, double t1)> BCFactory;
+  //! Returns a solver for the given slab's Solution; called whenever the solver must be set up anew.
+  typedef std::function<SolverPtr(SolutionPtr solution)> SolverFactory;
+private:
+  BFPtr _bf;
+  IPPtr _ip;
+  RHSPtr _rhs;
+  BCFactory _bcFactory;
+  SolverFactory _solverFactory;
+  std::vector< std::pair<VarPtr, FunctionPtr> > _initialData; // (trace, values at the first slab's start time)
+
+  MeshTopologyPtr _spatialMeshTopo;
+  std::vector<int> _H1Order; // spatial, temporal
+  int _delta_k;
+  int _temporalDivisions;
+  Epetra_CommPtr _Comm;
+
+  double _t0, _slabDuration;
+  int _slabCount = 0; // slabs solved so far
+
+  MeshPtr _mesh;
+  SolutionPtr _solution;
+
+  bool _reuseFactorization = true;
+  SolverPtr _solver; // set up on _setUpMesh; null until the first slab is solved
+  MeshPtr _setUpMesh;
+  int _reuseCount = 0;
+
+  bool solverCanBeReused(MeshPtr mesh);
+public:
+  //! The slabs are [t0 + k * slabDuration, t0 + (k+1) * slabDuration], each temporalDivisions elements thick.  H1Order and
+  //! delta_k are as in the Mesh constructor; H1Order has the spatial order, then the temporal order.
+  SpaceTimeSlabSolver(BFPtr bf, MeshTopologyPtr spatialMeshTopo, double t0, double slabDuration,
+                      std::vector<int> H1Order, int delta_k, int temporalDivisions = 1, Epetra_CommPtr Comm = Teuchos::null);
+
+  //! Initial data for the first slab: the values of trace at t0.  trace must be a TRACE variable of the bilinear form.
+  void addInitialData(VarPtr trace, FunctionPtr initialValue);
+
+  //! Default: the bilinear form's graph norm.
+  void setIP(IPPtr ip);
+  //! Default: zero right-hand side.
+  void setRHS(RHSPtr rhs);
+  //! Default: no BCs other than initial data.
+  void setBCFactory(BCFactory bcFactory);
+  //! Default: Solver::getDirectSolver(true), which saves its factorization.
+  void setSolverFactory(SolverFactory solverFactory);
+
+  //! When true, a slab whose mesh matches that of the slab on which the solver was set up is solved by the solver's resolve().
+  //! Only valid when the bilinear form and inner product do not depend on t, and the BC factory selects the same boundary
+  //! dofs for every slab.
+  void setReuseFactorization(bool value);
+  bool reuseFactorization() const;
+
+  //! Builds the next slab and solves on it; returns the solver's error code.
+  int solveSlab();
+  //! Calls solveSlab() numSlabs times, stopping at the first error.
+  int solveSlabs(int numSlabs);
+
+  //! Number of slabs solved so far.
+  int slabCount() const;
+  //! Number of slabs solved with a reused solver.
+  int solverReuseCount() const;
+  //! The end time of the last slab solved (t0 before any are solved).
+  double currentTime() const;
+
+  //! The mesh and solution for the last slab solved; null before any are solved.
+  MeshPtr mesh();
+  SolutionPtr solution();
+};
+}
+
+#endif
@@ -42,16 +42,16 @@ namespace Camellia {
       }
     }
     
-    long long approximateMemoryFootprint() // in bytes
+    long long approximateMemoryFootprint() const // in bytes
     {
-      int myFootprint = sizeof(subcellDofIndices); // for the overhead of vector
-      for (auto outerMap : subcellDofIndices)
+      long long myFootprint = sizeof(subcellDofIndices); // for the overhead of vector
+      for (auto &outerMap : subcellDofIndices)
       {
         myFootprint += sizeof(outerMap); // overhead for the NewSubCellOrdinalToMap vector
-        for (auto outerMapEntry : outerMap)
+        for (auto &outerMapEntry : outerMap)
         {
           myFootprint += sizeof(outerMapEntry); // overhead for NewVarIDToDofIndices vector
-          for (auto innerMapEntry : outerMapEntry)
+          for (auto &innerMapEntry : outerMapEntry)
           {
             myFootprint += sizeof(innerMapEntry);
           }
@@ -0,0 +1,92 @@
+// @HEADER
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+// @HEADER
+//
+//  SubgridTestSpace.h
+//  Camellia
+//
+
+#ifndef Camellia_SubgridTestSpace_h
+#define Camellia_SubgridTestSpace_h
+
+#include "TypeDefs.h"
+
+#include "CellTopology.h"
+
+#include "Intrepid_FieldContainer.hpp"
+
+#include <utility>
+#include <vector>
+
+class Epetra_CrsMatrix;
+class Epetra_FECrsMatrix;
+class Epetra_Map;
+class Epetra_MultiVector;
+
+namespace Amesos2
+{
+template <class Matrix, class Vector> class Solver;
+}
+
+namespace Camellia
+{
+/*!
+ SubgridTestSpace: a conforming test space on a regular refinement of a reference cell, used by the SUBGRID optimal test
+ solver in TBF.
+
+ Rather than enriching the polynomial degree of the test space on the whole element, the test functions are represented by
+ lower-degree polynomials on the subcells of a once-refined element.  The local Gram matrix is then sparse, with one dense
+ block per subcell, so its factorization costs much less than that of the dense Gram matrix of a high-degree enriched test space.
+
+ The test space is defined by a serial Mesh on the reference cell whose field variables mirror the test variables of a
+ bilinear form; its global dofs are the subgrid test dofs.  Physical cells are then handled by mapping the subcells through
+ the cell's reference-to-physical map, so one SubgridTestSpace serves every cell of a given topology.  This requires cells
+ without curvilinear geometry; see supportsCells().
+ */
+class SubgridTestSpace
+{
+  struct Subcell
+  {
+    GlobalIndexType cellID;                                 // in the subgrid mesh
+    Intrepid::FieldContainer<double> refNodes;              // (1,V,D): subcell vertices in the parent's reference coordinates
+    Intrepid::FieldContainer<double> localToGlobal;         // (local dofs, global dofs of the subcell): the subgrid's constraints
+    std::vector<GlobalIndexTypeToCast> globalDofIndices;
+    std::vector< std::pair<unsigned, unsigned> > parentSides; // (subcell side, parent side) for the subcell sides on the parent boundary
+  };
+
+  CellTopoPtr _cellTopo;
+  MeshPtr _subgridMesh;
+  std::vector<Subcell> _subcells;
+
+  // the subgrid Gram matrix has the same sparsity on every cell, so its graph and KLU symbolic factorization are built once;
+  // localStiffnessMatrixAndRHS() only refills the values and refactors numerically
+  Teuchos::RCP<Epetra_Map> _subgridMap;
+  Teuchos::RCP<Epetra_FECrsMatrix> _gramMatrix;
+  Teuchos::RCP< Amesos2::Solver<Epetra_CrsMatrix,Epetra_MultiVector> > _gramSolver;
+public:
+  //! testVarFactory: supplies the test variables (its trial variables are ignored).  subcellH1Order: the polynomial order
+  //! of the subgrid test space, in the same sense as a Mesh's H1Order.
+  SubgridTestSpace(CellTopoPtr cellTopo, VarFactoryPtr testVarFactory, int subcellH1Order);
+
+  int subcellCount() const;
+  GlobalIndexType dofCount() const;
+
+  //! The subgrid mesh, on the reference cell; its trial orderings are the subcells' test orderings.
+  MeshPtr subgridMesh();
+
+  //! Computes the local stiffness matrix B G^{-1} B^T and load B G^{-1} l, where G is the subgrid Gram matrix for ip, B the
+  //! bilinear form's terms tested against the subgrid test space, and l the load rhs.  localStiffness has dimensions (C,trial,trial),
+  //! and rhsVector (C,trial), where C is the number of cells in basisCache.
+  void localStiffnessMatrixAndRHS(Intrepid::FieldContainer<double> &localStiffness, Intrepid::FieldContainer<double> &rhsVector,
+                                  const std::vector< TBilinearTerm<double> > &terms, IPPtr ip, LinearTermPtr rhs,
+                                  DofOrderingPtr trialOrder, BasisCachePtr basisCache);
+
+  //! True if the cells in basisCache can use a subgrid test space: they must be spatial cells of dimension 2 or 3, with no
+  //! curvilinear geometry.
+  static bool supportsCells(BasisCachePtr basisCache);
+};
+}
+
+#endif
@@ -96,6 +96,9 @@ namespace Camellia {
     int resolve() {
       if (_savedSolver.get() != NULL)
       {
+        // setLHS() and setRHS() may have supplied new vectors since the factorization was computed
+        _savedProblem->SetLHS(this->_lhs.get());
+        _savedProblem->SetRHS(this->_rhs.get());
         return _savedSolver->Solve();
       }
       else
@@ -52,6 +52,7 @@ typedef Teuchos::RCP< const Intrepid::FieldContainer<double> > constFCPtr;
 class BasisCache;
 class BasisFactory;
 class Cell;
+class CellHalo;
 class DofOrdering;
 class DofOrderingFactory;
 class Element;
@@ -94,6 +95,7 @@ class TSolver;
 typedef Teuchos::RCP<BasisCache> BasisCachePtr;
 typedef Teuchos::RCP<BasisFactory> BasisFactoryPtr;
 typedef Teuchos::RCP<Cell> CellPtr;
+typedef Teuchos::RCP<CellHalo> CellHaloPtr;
 typedef Teuchos::RCP<DofOrdering> DofOrderingPtr;
 typedef Teuchos::RCP<DofOrderingFactory> DofOrderingFactoryPtr;
 typedef Teuchos::RCP<Element> ElementPtr;
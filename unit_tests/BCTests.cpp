@@ -166,6 +166,154 @@ void testSpaceTimeTraceBCFunction(int spaceDim, Teuchos::FancyOStream &out, bool
     }
   }
 
+  // compares the bulk bcsToImpose(), which projects onto groups of boundary sides, with the per-cell variant, with and
+  // without cached projections
+  void testBulkImposedValuesMatchPerCell(MeshPtr mesh, BCPtr bc, DofInterpreter* dofInterpreter,
+                                         Teuchos::FancyOStream &out, bool &success)
+  {
+    map<GlobalIndexType,double> perCellValues;
+    for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+    {
+      vector<pair<GlobalIndexType,double>> cellValues;
+      mesh->boundary().bcsToImpose(cellValues, *bc, cellID, dofInterpreter);
+      for (auto &entry : cellValues)
+      {
+        perCellValues[entry.first] = entry.second;
+      }
+    }
+    TEST_ASSERT(perCellValues.size() > 0);
+
+    for (bool cacheImposedValues : {false, true})
+    {
+      bc->setCacheImposedValues(cacheImposedValues);
+      Intrepid::FieldContainer<GlobalIndexType> bcGlobalIndices;
+      Intrepid::FieldContainer<double> bcGlobalValues;
+      mesh->boundary().bcsToImpose(bcGlobalIndices, bcGlobalValues, *bc, dofInterpreter);
+      if (mesh->Comm()->NumProc() == 1)
+      {
+        TEST_EQUALITY(bcGlobalIndices.size(), perCellValues.size());
+      }
+      double tol = 1e-12;
+      for (int i=0; i<bcGlobalIndices.size(); i++)
+      {
+        auto perCellEntry = perCellValues.find(bcGlobalIndices[i]);
+        if (perCellEntry == perCellValues.end())
+        {
+          out << "Dof Index " << bcGlobalIndices[i] << " not found in per-cell BC values.\n";
+          success = false;
+          continue;
+        }
+        TEST_FLOATING_EQUALITY(perCellEntry->second, bcGlobalValues[i], tol);
+      }
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( BC, BulkImposedValuesMatchPerCell_Spatial )
+  {
+    int spaceDim = 2;
+    bool conformingTraces = true;
+    PoissonFormulation form(spaceDim,conformingTraces);
+
+    int H1Order = 3, delta_k = 1;
+    MeshTopologyPtr meshTopo = MeshFactory::rectilinearMeshTopology(vector<double>(spaceDim,1.0), vector<int>(spaceDim,2));
+    MeshPtr mesh = Teuchos::rcp( new Mesh(meshTopo, form.bf(), H1Order, delta_k) );
+    mesh->pRefine(vector<GlobalIndexType>{0});
+
+    FunctionPtr x = Function::xn(1);
+    FunctionPtr y = Function::yn(1);
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), x * x + y);
+
+    SolutionPtr soln = Solution::solution(form.bf(), mesh, bc);
+    testBulkImposedValuesMatchPerCell(mesh, bc, soln->getDofInterpreter().get(), out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( BC, BulkImposedValuesMatchPerCell_SpaceTime )
+  {
+    // space-time cells are projected with a SpaceTimeBasisCache
+    int spaceDim = 1;
+    double epsilon = 0.1;
+    bool useConformingTraces = true;
+    SpaceTimeHeatFormulation form(spaceDim, epsilon, useConformingTraces);
+
+    MeshTopologyPtr spatialMeshTopo = MeshFactory::rectilinearMeshTopology({1.0}, {3});
+    double t0 = 0.0, t1 = 1.0;
+    int temporalDivisions = 2;
+    MeshTopologyPtr spaceTimeMeshTopo = MeshFactory::spaceTimeMeshTopology(spatialMeshTopo, t0, t1, temporalDivisions);
+    int H1Order = 3, delta_k = 1;
+    MeshPtr mesh = Teuchos::rcp( new Mesh(spaceTimeMeshTopo, form.bf(), H1Order, delta_k) );
+
+    FunctionPtr x = Function::xn(1);
+    FunctionPtr t = Function::tn(1);
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace() | SpatialFilter::matchingT(t0), x * x + x * t + t * t);
+
+    SolutionPtr soln = Solution::solution(form.bf(), mesh, bc);
+    testBulkImposedValuesMatchPerCell(mesh, bc, soln->getDofInterpreter().get(), out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( BC, CachedImposedValuesMatchUncached )
+  {
+    int spaceDim = 2;
+    bool conformingTraces = true;
+    PoissonFormulation form(spaceDim,conformingTraces);
+    VarPtr u_hat = form.u_hat();
+
+    int H1Order = 3, delta_k = 1;
+    MeshTopologyPtr meshTopo = MeshFactory::rectilinearMeshTopology(vector<double>(spaceDim,1.0), vector<int>(spaceDim,2));
+    MeshPtr mesh = Teuchos::rcp( new Mesh(meshTopo, form.bf(), H1Order, delta_k) );
+    mesh->pRefine(vector<GlobalIndexType>{0}); // so that the boundary sides span more than one element type
+
+    FunctionPtr x = Function::xn(1);
+    FunctionPtr y = Function::yn(1);
+    BCPtr uncachedBC = BC::bc();
+    uncachedBC->addDirichlet(u_hat, SpatialFilter::matchingX(0.0), x * x + y);
+    BCPtr cachedBC = BC::bc();
+    cachedBC->setCacheImposedValues(true);
+    cachedBC->addDirichlet(u_hat, SpatialFilter::matchingX(0.0), x * x + y);
+
+    SolutionPtr soln = Solution::solution(form.bf(), mesh, uncachedBC);
+    Teuchos::RCP<DofInterpreter> dofInterpreter = soln->getDofInterpreter();
+
+    auto bcValueMap = [&mesh, &dofInterpreter] (BCPtr bc) -> map<GlobalIndexType,double>
+    {
+      Intrepid::FieldContainer<GlobalIndexType> bcGlobalIndices;
+      Intrepid::FieldContainer<double> bcGlobalValues;
+      mesh->boundary().bcsToImpose(bcGlobalIndices, bcGlobalValues, *bc, dofInterpreter.get());
+      map<GlobalIndexType,double> valueMap;
+      for (int i=0; i<bcGlobalIndices.size(); i++)
+      {
+        valueMap[bcGlobalIndices[i]] = bcGlobalValues[i];
+      }
+      return valueMap;
+    };
+
+    auto compareValueMaps = [&out, &success] (const map<GlobalIndexType,double> &expected, const map<GlobalIndexType,double> &actual)
+    {
+      TEST_EQUALITY(expected.size(), actual.size());
+      double tol = 1e-14;
+      for (auto &entry : expected)
+      {
+        if (actual.find(entry.first) == actual.end())
+        {
+          out << "Dof Index " << entry.first << " not found in cached BC values.\n";
+          success = false;
+          continue;
+        }
+        TEST_FLOATING_EQUALITY(entry.second, actual.find(entry.first)->second, tol);
+      }
+    };
+
+    compareValueMaps(bcValueMap(uncachedBC), bcValueMap(cachedBC));
+    // second call uses the cached projections
+    compareValueMaps(bcValueMap(uncachedBC), bcValueMap(cachedBC));
+
+    // extending the condition to the rest of the boundary must invalidate the cached projections
+    uncachedBC->addDirichlet(u_hat, SpatialFilter::allSpace(), y * y - x);
+    cachedBC->addDirichlet(u_hat, SpatialFilter::allSpace(), y * y - x);
+    compareValueMaps(bcValueMap(uncachedBC), bcValueMap(cachedBC));
+  }
+
   TEUCHOS_UNIT_TEST( BC, FieldBCsMinRule_1D)
   {
     MPIWrapper::CommWorld()->Barrier();
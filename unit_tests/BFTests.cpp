@@ -11,11 +11,15 @@
 
 #include "Teuchos_UnitTestHarness.hpp"
 
+#include "BC.h"
 #include "BF.h"
+#include "Function.h"
 #include "MeshFactory.h"
 #include "PoissonFormulation.h"
 #include "RHS.h"
 #include "Solution.h"
+#include "SpatialFilter.h"
+#include "TrigFunctions.h"
 #include "TypeDefs.h"
 
 #include "Intrepid_FieldContainer.hpp"
@@ -133,6 +137,186 @@ namespace
     }
   }
 
+  void testValuesAgree(const FieldContainer<double> &expected, const FieldContainer<double> &actual, double tol,
+                       Teuchos::FancyOStream &out, bool &success)
+  {
+    TEST_EQUALITY(expected.size(), actual.size());
+    if (expected.size() != actual.size()) return;
+    for (int i=0; i<expected.size(); i++)
+    {
+      if (abs(expected[i]) > tol)
+      {
+        TEST_FLOATING_EQUALITY(expected[i], actual[i], tol);
+      }
+      else
+      {
+        TEST_COMPARE(abs(actual[i]), <, tol);
+      }
+    }
+  }
+  
+  TEUCHOS_UNIT_TEST( BF, StiffnessReuseForSimilarCells_2D )
+  {
+    // on a uniform mesh, stiffness reuse should reproduce the local stiffness and load exactly, copying the stiffness for most cells
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    BFPtr bf = form.bf();
+    IPPtr ip = bf->graphNorm();
+    
+    int H1Order = 2;
+    MeshPtr mesh = MeshFactory::rectilinearMesh(bf, {1.0,2.0}, {4,3}, H1Order);
+    RHSPtr rhsPtr = RHS::rhs();
+    FunctionPtr x = Function::xn(1);
+    rhsPtr->addTerm(x * form.v()); // a load that differs from cell to cell
+    
+    int rank = mesh->Comm()->MyPID();
+    vector<ElementTypePtr> elemTypes = mesh->elementTypes(rank);
+    for (ElementTypePtr elemType : elemTypes)
+    {
+      vector<GlobalIndexType> cellIDs = mesh->cellIDsOfType(elemType);
+      int numCells = cellIDs.size();
+      if (numCells == 0) continue;
+      int trialCount = elemType->trialOrderPtr->totalDofs();
+      
+      bool testVsTest = true;
+      BasisCachePtr basisCache = BasisCache::basisCacheForCellType(mesh, elemType);
+      BasisCachePtr ipBasisCache = BasisCache::basisCacheForCellType(mesh, elemType, testVsTest);
+      FieldContainer<double> cellSideParities = mesh->cellSideParities(elemType);
+      basisCache->setCellSideParities(cellSideParities);
+      ipBasisCache->setCellSideParities(cellSideParities);
+      
+      FieldContainer<double> stiffnessExpected(numCells,trialCount,trialCount), rhsExpected(numCells,trialCount);
+      bf->setUseStiffnessReuseForSimilarCells(false);
+      bf->localStiffnessMatrixAndRHS(stiffnessExpected, rhsExpected, ip, ipBasisCache, rhsPtr, basisCache);
+      
+      FieldContainer<double> stiffness(numCells,trialCount,trialCount), rhs(numCells,trialCount);
+      bf->setUseStiffnessReuseForSimilarCells(true);
+      int hitCountBefore = bf->similarCellHitCount();
+      bf->localStiffnessMatrixAndRHS(stiffness, rhs, ip, ipBasisCache, rhsPtr, basisCache);
+      // interior cells all share parities, so there should be at least one hit whenever there are more cells than parity patterns
+      if (numCells > 4)
+      {
+        TEST_COMPARE(bf->similarCellHitCount(), >, hitCountBefore);
+      }
+      
+      double tol = 1e-10;
+      testValuesAgree(stiffnessExpected, stiffness, tol, out, success);
+      testValuesAgree(rhsExpected, rhs, tol, out, success);
+      
+      // a second pass should be served from the cache entirely
+      int missCountBefore = bf->similarCellMissCount();
+      bf->localStiffnessMatrixAndRHS(stiffness, rhs, ip, ipBasisCache, rhsPtr, basisCache);
+      TEST_EQUALITY(bf->similarCellMissCount(), missCountBefore);
+      testValuesAgree(stiffnessExpected, stiffness, tol, out, success);
+      testValuesAgree(rhsExpected, rhs, tol, out, success);
+    }
+  }
+  
+  // computes local stiffness and load on each of mesh's local element types using bf, which should have stiffness reuse
+  // turned on, and using referenceBF, which should not, and checks that they agree.  The cubature enrichment applies to the
+  // trial-vs-test integrals; the Gram matrix is integrated exactly, so that it stays positive definite.  On return,
+  // referenceStiffness holds referenceBF's local stiffness for the first element type.  Returns the number of cache misses
+  // incurred by bf.
+  int testStiffnessReuseAgrees(BFPtr bf, IPPtr ip, RHSPtr rhsPtr, BFPtr referenceBF, IPPtr referenceIP, RHSPtr referenceRHS,
+                               MeshPtr mesh, int cubatureEnrichment, FieldContainer<double> &referenceStiffness,
+                               Teuchos::FancyOStream &out, bool &success)
+  {
+    int missCountBefore = bf->similarCellMissCount();
+    int rank = mesh->Comm()->MyPID();
+    vector<ElementTypePtr> elemTypes = mesh->elementTypes(rank);
+    bool isFirstType = true;
+    for (ElementTypePtr elemType : elemTypes)
+    {
+      vector<GlobalIndexType> cellIDs = mesh->cellIDsOfType(elemType);
+      int numCells = cellIDs.size();
+      if (numCells == 0) continue;
+      int trialCount = elemType->trialOrderPtr->totalDofs();
+      
+      bool testVsTest = true;
+      int ipCubatureEnrichment = 0;
+      BasisCachePtr basisCache = BasisCache::basisCacheForCellType(mesh, elemType, false, cubatureEnrichment);
+      BasisCachePtr ipBasisCache = BasisCache::basisCacheForCellType(mesh, elemType, testVsTest, ipCubatureEnrichment);
+      FieldContainer<double> cellSideParities = mesh->cellSideParities(elemType);
+      basisCache->setCellSideParities(cellSideParities);
+      ipBasisCache->setCellSideParities(cellSideParities);
+      
+      FieldContainer<double> stiffnessExpected(numCells,trialCount,trialCount), rhsExpected(numCells,trialCount);
+      referenceBF->localStiffnessMatrixAndRHS(stiffnessExpected, rhsExpected, referenceIP, ipBasisCache, referenceRHS, basisCache);
+      
+      FieldContainer<double> stiffness(numCells,trialCount,trialCount), rhs(numCells,trialCount);
+      bf->localStiffnessMatrixAndRHS(stiffness, rhs, ip, ipBasisCache, rhsPtr, basisCache);
+      
+      double tol = 1e-10;
+      testValuesAgree(stiffnessExpected, stiffness, tol, out, success);
+      testValuesAgree(rhsExpected, rhs, tol, out, success);
+      
+      if (isFirstType) referenceStiffness = stiffnessExpected;
+      isFirstType = false;
+    }
+    return bf->similarCellMissCount() - missCountBefore;
+  }
+  
+  TEUCHOS_UNIT_TEST( BF, StiffnessReuseForSimilarCells_TwoMeshesAndCubatures )
+  {
+    // the same BF and IP used on meshes of different order, and with different cubature, should not be served stale factors.
+    // The cache is kept throughout, so each pass runs against the entries left by the previous one; the reference values
+    // come from a second BF that does not reuse stiffness.
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    BFPtr bf = form.bf();
+    IPPtr ip = bf->graphNorm();
+    RHSPtr rhsPtr = RHS::rhs();
+    FunctionPtr x = Function::xn(1);
+    rhsPtr->addTerm(x * form.v());
+    bf->setUseStiffnessReuseForSimilarCells(true);
+    
+    PoissonFormulation referenceForm(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    BFPtr referenceBF = referenceForm.bf();
+    IPPtr referenceIP = referenceBF->graphNorm();
+    RHSPtr referenceRHS = RHS::rhs();
+    referenceRHS->addTerm(x * referenceForm.v());
+    
+    // the meshes have identical geometry, so only the element types and cubature distinguish their cells
+    int H1Order = 2;
+    MeshPtr mesh = MeshFactory::rectilinearMesh(bf, {1.0,1.0}, {3,3}, H1Order);
+    int cubatureEnrichment = 0;
+    FieldContainer<double> exactCubatureStiffness, reducedCubatureStiffness, higherOrderStiffness;
+    int missCount = testStiffnessReuseAgrees(bf, ip, rhsPtr, referenceBF, referenceIP, referenceRHS, mesh, cubatureEnrichment,
+                                             exactCubatureStiffness, out, success);
+    TEST_COMPARE(missCount, >, 0);
+    
+    // reduced cubature on the same mesh does not integrate the stiffness exactly, so factors cached for the exact cubature
+    // would give the wrong values: they must be recomputed
+    cubatureEnrichment = -2;
+    missCount = testStiffnessReuseAgrees(bf, ip, rhsPtr, referenceBF, referenceIP, referenceRHS, mesh, cubatureEnrichment,
+                                         reducedCubatureStiffness, out, success);
+    TEST_COMPARE(missCount, >, 0);
+    TEST_EQUALITY(reducedCubatureStiffness.size(), exactCubatureStiffness.size());
+    double maxValue = 0, maxDiff = 0;
+    for (int i=0; i<min(reducedCubatureStiffness.size(), exactCubatureStiffness.size()); i++)
+    {
+      maxValue = max(maxValue, abs(exactCubatureStiffness[i]));
+      maxDiff = max(maxDiff, abs(exactCubatureStiffness[i] - reducedCubatureStiffness[i]));
+    }
+    out << "max difference between exact and reduced cubature stiffness: " << maxDiff << endl;
+    TEST_COMPARE(maxDiff, >, 1e-6 * maxValue);
+    
+    // a higher-order mesh, built after the first is released (its element types might reuse the freed addresses); the
+    // entries cached for the first mesh have the wrong dimensions, so would also give the wrong values
+    mesh = Teuchos::null;
+    H1Order = 3;
+    MeshPtr higherOrderMesh = MeshFactory::rectilinearMesh(bf, {1.0,1.0}, {3,3}, H1Order);
+    cubatureEnrichment = 0;
+    missCount = testStiffnessReuseAgrees(bf, ip, rhsPtr, referenceBF, referenceIP, referenceRHS, higherOrderMesh, cubatureEnrichment,
+                                         higherOrderStiffness, out, success);
+    TEST_COMPARE(missCount, >, 0);
+    TEST_COMPARE(higherOrderStiffness.size(), >, exactCubatureStiffness.size());
+  }
+  
   TEUCHOS_UNIT_TEST( BF, FactoredCholeskySolve_SimpleRectangularMatrices )
   {
     int testCount = 3, trialCount = 2;
@@ -379,4 +563,142 @@ namespace
       }
     }
   }
+
+  // a linear solution lies in the trial space, so any stable test space should recover it exactly
+  void testSubgridSolveReproducesLinearSolution(int spaceDim, Teuchos::FancyOStream &out, bool &success)
+  {
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    BFPtr bf = form.bf();
+
+    FunctionPtr x = Function::xn(1), y = Function::yn(1), z = Function::zn(1);
+    FunctionPtr u_exact = (spaceDim == 2) ? x + 2.0 * y : x + 2.0 * y + 3.0 * z;
+
+    RHSPtr rhs = form.rhs(Function::zero());
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), u_exact);
+
+    int H1Order = 2;
+    vector<double> dimensions(spaceDim, 1.0);
+    vector<int> elementCounts = (spaceDim == 2) ? vector<int>{2,2} : vector<int>{2,1,1};
+    MeshPtr mesh = MeshFactory::rectilinearMesh(bf, dimensions, elementCounts, H1Order);
+
+    bf->setOptimalTestSolver(TBF<>::FACTORED_CHOLESKY);
+    SolutionPtr standardSolution = Solution::solution(bf, mesh, bc, rhs, bf->graphNorm());
+    standardSolution->solve();
+
+    bf->setOptimalTestSolver(TBF<>::SUBGRID);
+    SolutionPtr subgridSolution = Solution::solution(bf, mesh, bc, rhs, bf->graphNorm());
+    subgridSolution->solve();
+
+    double tol = 1e-10;
+    FunctionPtr u_standard = Function::solution(form.u(), standardSolution);
+    FunctionPtr u_subgrid = Function::solution(form.u(), subgridSolution);
+    TEST_COMPARE((u_standard - u_exact)->l2norm(mesh), <, tol);
+    TEST_COMPARE((u_subgrid - u_exact)->l2norm(mesh), <, tol);
+    TEST_COMPARE((u_subgrid - u_standard)->l2norm(mesh), <, tol);
+  }
+
+  TEUCHOS_UNIT_TEST( BF, SubgridSolve_ReproducesLinearSolution_2D )
+  {
+    testSubgridSolveReproducesLinearSolution(2, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( BF, SubgridSolve_ReproducesLinearSolution_3D )
+  {
+    testSubgridSolveReproducesLinearSolution(3, out, success);
+  }
+
+  // solves Delta u = f for u = sin(pi x) [ sin(pi y) ] with the given optimal test solver; returns the solution, and the
+  // L2 error in u in l2Error
+  SolutionPtr solvePoissonSine(int spaceDim, TBF<>::OptimalTestSolver optimalTestSolver, int elementsPerSide, int H1Order,
+                               double &l2Error)
+  {
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    BFPtr bf = form.bf();
+    bf->setOptimalTestSolver(optimalTestSolver);
+
+    FunctionPtr u_exact = Teuchos::rcp( new Sin_ax(M_PI) );
+    if (spaceDim == 2)
+    {
+      FunctionPtr sin_y = Teuchos::rcp( new Sin_ay(M_PI) );
+      u_exact = u_exact * sin_y;
+    }
+    FunctionPtr f = (-spaceDim * M_PI * M_PI) * u_exact;
+
+    RHSPtr rhs = form.rhs(f);
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), u_exact);
+
+    vector<double> dimensions(spaceDim, 1.0);
+    vector<int> elementCounts(spaceDim, elementsPerSide);
+    MeshPtr mesh = MeshFactory::rectilinearMesh(bf, dimensions, elementCounts, H1Order);
+
+    SolutionPtr solution = Solution::solution(bf, mesh, bc, rhs, bf->graphNorm());
+    solution->solve();
+
+    FunctionPtr u_soln = Function::solution(form.u(), solution);
+    l2Error = (u_soln - u_exact)->l2norm(mesh);
+    return solution;
+  }
+
+  TEUCHOS_UNIT_TEST( BF, SubgridSolve_NonpolynomialAccuracy_2D )
+  {
+    // the subgrid test space is not the enriched space of FACTORED_CHOLESKY, so the solutions differ; the subgrid
+    // solution's L2 error in u should be within a factor of 2 of the standard solve's
+    int spaceDim = 2, elementsPerSide = 4, H1Order = 3;
+    double standardError, subgridError;
+    solvePoissonSine(spaceDim, TBF<>::FACTORED_CHOLESKY, elementsPerSide, H1Order, standardError);
+    solvePoissonSine(spaceDim, TBF<>::SUBGRID, elementsPerSide, H1Order, subgridError);
+    out << "FACTORED_CHOLESKY L2 error: " << standardError << "; SUBGRID L2 error: " << subgridError << endl;
+
+    // sanity check: the mesh resolves the solution
+    TEST_COMPARE(standardError, <, 1e-2);
+    double maxRatio = 2.0;
+    TEST_COMPARE(subgridError, <=, maxRatio * standardError);
+  }
+
+  TEUCHOS_UNIT_TEST( BF, SubgridSolve_FallsBackOnUnsupportedCells_1D )
+  {
+    // SubgridTestSpace does not support 1D cells; SUBGRID should then fall back to FACTORED_CHOLESKY, giving the same solution
+    int spaceDim = 1, elementsPerSide = 4, H1Order = 3;
+    double standardError, subgridError;
+    SolutionPtr standardSolution = solvePoissonSine(spaceDim, TBF<>::FACTORED_CHOLESKY, elementsPerSide, H1Order, standardError);
+    SolutionPtr subgridSolution = solvePoissonSine(spaceDim, TBF<>::SUBGRID, elementsPerSide, H1Order, subgridError);
+
+    TEST_COMPARE(standardError, <, 1e-2);
+    TEST_FLOATING_EQUALITY(subgridError, standardError, 1e-10);
+
+    // the two meshes are built identically, so their cells have the same IDs and dof layouts
+    double tol = 1e-12;
+    MeshPtr mesh = standardSolution->mesh();
+    for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+    {
+      const FieldContainer<double>* expectedCoefficients = &standardSolution->allCoefficientsForCellID(cellID);
+      const FieldContainer<double>* actualCoefficients = &subgridSolution->allCoefficientsForCellID(cellID);
+      TEST_EQUALITY(expectedCoefficients->size(), actualCoefficients->size());
+      if (expectedCoefficients->size() != actualCoefficients->size()) continue;
+      for (int i=0; i<expectedCoefficients->size(); i++)
+      {
+        TEST_COMPARE(abs((*expectedCoefficients)[i] - (*actualCoefficients)[i]), <, tol);
+      }
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( BF, SubgridSolve_SelectedBySetUseSubgridMesh )
+  {
+    PoissonFormulation form(2, true, PoissonFormulation::ULTRAWEAK);
+    BFPtr bf = form.bf();
+
+    bf->setUseSubgridMeshForOptimalTestFunctions(true);
+    TEST_EQUALITY(bf->optimalTestSolver(), TBF<>::SUBGRID);
+    bf->setUseSubgridMeshForOptimalTestFunctions(false);
+    TEST_EQUALITY(bf->optimalTestSolver(), TBF<>::FACTORED_CHOLESKY);
+
+    // turning the subgrid off leaves other choices alone
+    bf->setOptimalTestSolver(TBF<>::CHOLESKY);
+    bf->setUseSubgridMeshForOptimalTestFunctions(false);
+    TEST_EQUALITY(bf->optimalTestSolver(), TBF<>::CHOLESKY);
+  }
 } // namespace
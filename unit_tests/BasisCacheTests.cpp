@@ -18,6 +18,7 @@
 #include "CellTopology.h"
 #include "MeshFactory.h"
 #include "PoissonFormulation.h"
+#include "ReferenceValueRegistry.h"
 #include "SerialDenseWrapper.h"
 #include "Solution.h"
 
@@ -441,6 +442,217 @@ TEUCHOS_UNIT_TEST( BasisCache, SetRefCellPoints )
   }
 }
 
+void testAffineJacobians(CellTopoPtr cellTopo, const FieldContainer<double> &physicalCellNodes, bool expectAffine, Teuchos::FancyOStream &out, bool &success)
+{
+  double tol = 1e-13;
+  int cubDegree = 4;
+  bool createSideCache = true;
+  BasisCachePtr basisCache = Teuchos::rcp( new BasisCache(physicalCellNodes, cellTopo, cubDegree, createSideCache) );
+  
+  TEST_EQUALITY(basisCache->usesAffineGeometry(), expectAffine);
+  
+  // compare against per-point Jacobians computed directly
+  FieldContainer<double> refPoints = basisCache->getRefCellPoints();
+  int numCells = physicalCellNodes.dimension(0);
+  int numPoints = refPoints.dimension(0);
+  int cellDim = cellTopo->getDimension();
+  FieldContainer<double> jacobianExpected(numCells, numPoints, cellDim, cellDim);
+  CamelliaCellTools::setJacobian(jacobianExpected, refPoints, physicalCellNodes, cellTopo);
+  FieldContainer<double> jacobianInvExpected(numCells, numPoints, cellDim, cellDim);
+  FieldContainer<double> jacobianDetExpected(numCells, numPoints);
+  SerialDenseWrapper::determinantAndInverse(jacobianDetExpected, jacobianInvExpected, jacobianExpected);
+  
+  TEST_COMPARE_FLOATING_ARRAYS(jacobianExpected, basisCache->getJacobian(), tol);
+  TEST_COMPARE_FLOATING_ARRAYS(jacobianInvExpected, basisCache->getJacobianInv(), tol);
+  TEST_COMPARE_FLOATING_ARRAYS(jacobianDetExpected, basisCache->getJacobianDet(), tol);
+  
+  // side caches use the volume Jacobian at the side points
+  for (int sideOrdinal=0; sideOrdinal<cellTopo->getSideCount(); sideOrdinal++)
+  {
+    BasisCachePtr sideCache = basisCache->getSideBasisCache(sideOrdinal);
+    TEST_EQUALITY(sideCache->usesAffineGeometry(), expectAffine);
+    FieldContainer<double> sideRefPoints = sideCache->getSideRefCellPointsInVolumeCoordinates();
+    int numSidePoints = sideRefPoints.dimension(0);
+    FieldContainer<double> sideJacobianExpected(numCells, numSidePoints, cellDim, cellDim);
+    CamelliaCellTools::setJacobian(sideJacobianExpected, sideRefPoints, physicalCellNodes, cellTopo);
+    TEST_COMPARE_FLOATING_ARRAYS(sideJacobianExpected, sideCache->getJacobian(), tol);
+  }
+}
+
+TEUCHOS_UNIT_TEST( BasisCache, AffineJacobians_Quad )
+{
+  CellTopoPtr quad = CellTopology::quad();
+  // a sheared, stretched parallelogram
+  FieldContainer<double> parallelogramNodes(1,4,2);
+  parallelogramNodes(0,0,0) = 0.0;  parallelogramNodes(0,0,1) = 0.0;
+  parallelogramNodes(0,1,0) = 2.0;  parallelogramNodes(0,1,1) = 0.5;
+  parallelogramNodes(0,2,0) = 2.75; parallelogramNodes(0,2,1) = 1.5;
+  parallelogramNodes(0,3,0) = 0.75; parallelogramNodes(0,3,1) = 1.0;
+  bool expectAffine = true;
+  testAffineJacobians(quad, parallelogramNodes, expectAffine, out, success);
+  
+  FieldContainer<double> trapezoidNodes = parallelogramNodes;
+  trapezoidNodes(0,2,0) = 2.25;
+  expectAffine = false;
+  testAffineJacobians(quad, trapezoidNodes, expectAffine, out, success);
+}
+
+TEUCHOS_UNIT_TEST( BasisCache, AffineJacobians_Hexahedron )
+{
+  CellTopoPtr hex = CellTopology::hexahedron();
+  FieldContainer<double> refCubeNodes(hex->getNodeCount(), hex->getDimension());
+  CamelliaCellTools::refCellNodesForTopology(refCubeNodes, hex);
+  
+  // parallelepiped: a linear map of the reference cube
+  double A[3][3] = {{1.0, 0.25, 0.1},{0.2, 2.0, 0.5},{0.1, 0.3, 0.75}}; // no zero entries, so relative comparisons are meaningful
+  FieldContainer<double> parallelepipedNodes(1,hex->getNodeCount(),3);
+  for (int node=0; node<hex->getNodeCount(); node++)
+  {
+    for (int i=0; i<3; i++)
+    {
+      parallelepipedNodes(0,node,i) = 1.0;
+      for (int j=0; j<3; j++)
+      {
+        parallelepipedNodes(0,node,i) += A[i][j] * refCubeNodes(node,j);
+      }
+    }
+  }
+  bool expectAffine = true;
+  testAffineJacobians(hex, parallelepipedNodes, expectAffine, out, success);
+  
+  FieldContainer<double> distortedNodes = parallelepipedNodes;
+  distortedNodes(0,6,2) += 0.2;
+  expectAffine = false;
+  testAffineJacobians(hex, distortedNodes, expectAffine, out, success);
+}
+
+TEUCHOS_UNIT_TEST( BasisCache, AffineJacobians_Triangle )
+{
+  CellTopoPtr triangle = CellTopology::triangle();
+  FieldContainer<double> triangleNodes(2,3,2);
+  triangleNodes(0,0,0) = 0.0;  triangleNodes(0,0,1) = 0.0;
+  triangleNodes(0,1,0) = 1.0;  triangleNodes(0,1,1) = 0.2;
+  triangleNodes(0,2,0) = 0.3;  triangleNodes(0,2,1) = 0.9;
+  triangleNodes(1,0,0) = 1.0;  triangleNodes(1,0,1) = 0.2;
+  triangleNodes(1,1,0) = 1.5;  triangleNodes(1,1,1) = 1.0;
+  triangleNodes(1,2,0) = 0.3;  triangleNodes(1,2,1) = 0.9;
+  bool expectAffine = true;
+  testAffineJacobians(triangle, triangleNodes, expectAffine, out, success);
+}
+
+TEUCHOS_UNIT_TEST( BasisCache, LazySideCachesFollowPhysicalNodes )
+{
+  double tol = 1e-14;
+  
+  // side caches are brought up to date on first query; check that a reused cache agrees with a freshly constructed one
+  CellTopoPtr cellTopo = CellTopology::quad();
+  int numSides = cellTopo->getSideCount();
+  int cubDegree = 3;
+  bool createSideCache = true;
+  
+  BasisCachePtr reusedCache = BasisCache::quadBasisCache(1.0, 1.0, cubDegree, createSideCache);
+  // query sides on the original nodes, so that side caches exist before the nodes change
+  for (int sideOrdinal=0; sideOrdinal < numSides; sideOrdinal++)
+  {
+    reusedCache->getPhysicalCubaturePointsForSide(sideOrdinal);
+  }
+  
+  FieldContainer<double> shiftedNodes = reusedCache->getPhysicalCellNodes();
+  for (int nodeOrdinal=0; nodeOrdinal<shiftedNodes.dimension(1); nodeOrdinal++)
+  {
+    shiftedNodes(0,nodeOrdinal,0) = 2.0 * shiftedNodes(0,nodeOrdinal,0) + 1.0;
+    shiftedNodes(0,nodeOrdinal,1) = 3.0 * shiftedNodes(0,nodeOrdinal,1) - 1.0;
+  }
+  reusedCache->setPhysicalCellNodes(shiftedNodes, vector<GlobalIndexType>(), createSideCache);
+  
+  BasisCachePtr freshCache = Teuchos::rcp( new BasisCache(shiftedNodes, cellTopo, cubDegree, createSideCache) );
+  for (int sideOrdinal=0; sideOrdinal < numSides; sideOrdinal++)
+  {
+    FieldContainer<double> expectedPoints = freshCache->getPhysicalCubaturePointsForSide(sideOrdinal);
+    FieldContainer<double> actualPoints = reusedCache->getPhysicalCubaturePointsForSide(sideOrdinal);
+    TEST_COMPARE_FLOATING_ARRAYS(expectedPoints, actualPoints, tol);
+    
+    FieldContainer<double> expectedMeasures = freshCache->getSideBasisCache(sideOrdinal)->getWeightedMeasures();
+    FieldContainer<double> actualMeasures = reusedCache->getSideBasisCache(sideOrdinal)->getWeightedMeasures();
+    TEST_COMPARE_FLOATING_ARRAYS(expectedMeasures, actualMeasures, tol);
+  }
+  
+  // without a side-cache request, there should be no side caches
+  reusedCache->setPhysicalCellNodes(shiftedNodes, vector<GlobalIndexType>(), false);
+  TEST_ASSERT(reusedCache->getSideBasisCache(0) == Teuchos::null);
+}
+
+TEUCHOS_UNIT_TEST( BasisCache, MaxCellBatchSize )
+{
+  int spaceDim = 2;
+  bool conformingTraces = true;
+  PoissonFormulation form(spaceDim, conformingTraces);
+  
+  int H1Order = 3;
+  MeshPtr mesh = MeshFactory::quadMesh(form.bf(), H1Order);
+  GlobalIndexType cellID = 0;
+  ElementTypePtr elemType = mesh->getElementType(cellID);
+  BasisCachePtr basisCache = BasisCache::basisCacheForCell(mesh, cellID);
+  
+  int numTrialDofs = elemType->trialOrderPtr->totalDofs();
+  int numTestDofs = elemType->testOrderPtr->totalDofs();
+  int matrixBytesPerCell = 8 * (numTestDofs*numTestDofs + numTestDofs*numTrialDofs + numTrialDofs*numTrialDofs);
+  
+  int maxBytes = 3 * 1024 * 1024;
+  int batchSize = basisCache->maxCellBatchSize(elemType, maxBytes);
+  // accounting for cached values should only ever make batches smaller than the matrix-only estimate
+  TEST_ASSERT(batchSize >= 1);
+  TEST_ASSERT(batchSize <= maxBytes / matrixBytesPerCell);
+  
+  // a bigger budget should never give a smaller batch
+  TEST_ASSERT(basisCache->maxCellBatchSize(elemType, 2 * maxBytes) >= batchSize);
+  
+  // minCells overrides a too-small budget
+  int minCells = 5;
+  TEST_EQUALITY(basisCache->maxCellBatchSize(elemType, 0, minCells), minCells);
+}
+
+TEUCHOS_UNIT_TEST( BasisCache, ReferenceValuesAreShared )
+{
+  CellTopoPtr quad = CellTopology::quad();
+  int H1Order = 3, cubDegree = 2 * H1Order;
+  BasisPtr basis = BasisFactory::basisFactory()->getBasis(H1Order, quad, Camellia::FUNCTION_SPACE_HGRAD);
+  
+  bool createSideCache = true;
+  BasisCachePtr basisCache1 = BasisCache::basisCacheForReferenceCell(quad, cubDegree, createSideCache);
+  BasisCachePtr basisCache2 = BasisCache::basisCacheForReferenceCell(quad, cubDegree, createSideCache);
+  
+  // the first request may or may not be a registry hit, depending on what other tests have run; the second must be
+  constFCPtr values1 = basisCache1->getValues(basis, Camellia::OP_GRAD);
+  long hitCount = ReferenceValueRegistry::hitCount();
+  constFCPtr values2 = basisCache2->getValues(basis, Camellia::OP_GRAD);
+  TEST_EQUALITY(values1.get(), values2.get());
+  TEST_EQUALITY(ReferenceValueRegistry::hitCount(), hitCount + 1);
+  
+  int sideOrdinal = 1;
+  bool useVolumeRefPoints = true;
+  values1 = basisCache1->getValues(basis, Camellia::OP_VALUE, sideOrdinal, useVolumeRefPoints);
+  values2 = basisCache2->getValues(basis, Camellia::OP_VALUE, sideOrdinal, useVolumeRefPoints);
+  TEST_EQUALITY(values1.get(), values2.get());
+  
+  // points set directly are not registry points: values must be those at the new points
+  FieldContainer<double> refPoints(1,2);
+  refPoints(0,0) = 0.25;
+  refPoints(0,1) = -0.5;
+  basisCache2->setRefCellPoints(refPoints);
+  long missCount = ReferenceValueRegistry::missCount();
+  values2 = basisCache2->getValues(basis, Camellia::OP_VALUE);
+  TEST_EQUALITY(ReferenceValueRegistry::missCount(), missCount);
+  TEST_EQUALITY(values2->dimension(1), 1);
+  
+  FieldContainer<double> expectedValues(basis->getCardinality(), 1);
+  basis->getValues(expectedValues, refPoints, Intrepid::OPERATOR_VALUE);
+  for (int fieldOrdinal=0; fieldOrdinal<basis->getCardinality(); fieldOrdinal++)
+  {
+    TEST_FLOATING_EQUALITY((*values2)(fieldOrdinal,0), expectedValues(fieldOrdinal,0), 1e-14);
+  }
+}
+
 TEUCHOS_UNIT_TEST( BasisCache, SetRefCellPointsSpaceTimeSide )
 {
   double tol = 1e-15;
@@ -3147,6 +3147,57 @@ TEUCHOS_UNIT_TEST( BasisReconciliation, TermTraced_1D )
   }
 }
 
+TEUCHOS_UNIT_TEST( BasisReconciliation, SharedSubcellWeights )
+{
+  // subcell weights computed by one BasisReconciliation instance should be reused by another
+  int H1Order = 3;
+  BasisPtr fineBasis = BasisFactory::basisFactory()->getBasis(H1Order, CellTopology::quad(), Camellia::FUNCTION_SPACE_HGRAD);
+  BasisPtr coarseBasis = BasisFactory::basisFactory()->getBasis(H1Order - 1, CellTopology::quad(), Camellia::FUNCTION_SPACE_HGRAD);
+  unsigned permutation = 0;
+
+  BasisReconciliation::clearSharedSubcellWeights();
+
+  BasisReconciliation br1, br2;
+  SubBasisReconciliationWeights weights1 = br1.constrainedWeights(fineBasis, coarseBasis, permutation);
+  LRUCacheStatistics stats = BasisReconciliation::sharedSubcellWeightsCacheStatistics();
+  long long hits = stats.hits;
+  TEST_EQUALITY(stats.size, 1);
+
+  SubBasisReconciliationWeights weights2 = br2.constrainedWeights(fineBasis, coarseBasis, permutation);
+  stats = BasisReconciliation::sharedSubcellWeightsCacheStatistics();
+  TEST_EQUALITY(stats.hits, hits + 1);
+  TEST_EQUALITY(stats.size, 1);
+
+  TEST_ASSERT(weights1.fineOrdinals == weights2.fineOrdinals);
+  TEST_ASSERT(weights1.coarseOrdinals == weights2.coarseOrdinals);
+  double tol = 1e-15;
+  TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(weights1.weights, weights2.weights, tol);
+}
+
+TEUCHOS_UNIT_TEST( BasisReconciliation, SharedSubcellWeightsHoldBases )
+{
+  // the shared cache is keyed on the bases' addresses, so it must keep the bases alive while their weights are cached
+  int H1Order = 3;
+  BasisPtr fineBasis = BasisFactory::basisFactory()->getBasis(H1Order, CellTopology::quad(), Camellia::FUNCTION_SPACE_HGRAD);
+  BasisPtr coarseBasis = BasisFactory::basisFactory()->getBasis(H1Order - 1, CellTopology::quad(), Camellia::FUNCTION_SPACE_HGRAD);
+  unsigned permutation = 0;
+
+  BasisReconciliation::clearSharedSubcellWeights();
+  int fineCountBefore = fineBasis.strong_count();
+  int coarseCountBefore = coarseBasis.strong_count();
+
+  {
+    BasisReconciliation br;
+    br.constrainedWeights(fineBasis, coarseBasis, permutation);
+  }
+  TEST_COMPARE(fineBasis.strong_count(), >, fineCountBefore);
+  TEST_COMPARE(coarseBasis.strong_count(), >, coarseCountBefore);
+
+  BasisReconciliation::clearSharedSubcellWeights();
+  TEST_EQUALITY(fineBasis.strong_count(), fineCountBefore);
+  TEST_EQUALITY(coarseBasis.strong_count(), coarseCountBefore);
+}
+
 TEUCHOS_UNIT_TEST( BasisReconciliation, TermTraced_2D_Quad )
 {
   CellTopoPtr quadTopo = CellTopology::quad();
@@ -0,0 +1,143 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  CellHaloTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "CellHalo.h"
+#include "Function.h"
+#include "GradientErrorIndicator.h"
+#include "MeshFactory.h"
+#include "PoissonFormulation.h"
+#include "Solution.h"
+
+using namespace Camellia;
+using namespace Intrepid;
+
+namespace
+{
+  MeshPtr poissonMesh(vector<int> elementCounts)
+  {
+    int spaceDim = elementCounts.size();
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    int H1Order = 1;
+    return MeshFactory::rectilinearMesh(form.bf(), vector<double>(spaceDim,1.0), elementCounts, H1Order);
+  }
+
+  // on one rank there are no ghosts, so the exchange is only exercised on two or more ranks; unit_tests/CMakeLists.txt
+  // registers a two-rank run of the CellHalo tests
+  void testGhostsPresentOnMultipleRanks(CellHaloPtr halo, MeshPtr mesh, Teuchos::FancyOStream &out, bool &success)
+  {
+    if (mesh->Comm()->NumProc() == 1)
+    {
+      out << "NOTE: on one rank, the halo has no ghost cells; run on two or more ranks to test the exchange.\n";
+      TEST_EQUALITY(halo->ghostCellCount(), 0);
+    }
+    else if (mesh->cellIDsInPartition().size() > 0)
+    {
+      // the meshes here are connected and have at least as many cells as ranks, so every rank with cells has a ghost
+      TEST_COMPARE(halo->ghostCellCount(), >, 0);
+    }
+  }
+
+  // checks the halo's neighbor lists against the mesh topology, and that an exchange delivers each ghost cell's row
+  void testHaloMatchesMesh(MeshPtr mesh, Teuchos::FancyOStream &out, bool &success)
+  {
+    CellHaloPtr halo = mesh->cellHalo();
+    const vector<GlobalIndexType> &cellIDs = halo->cellIDs();
+    TEST_EQUALITY(halo->ownedCellCount(), mesh->cellIDsInPartition().size());
+    TEST_EQUALITY(halo->cellCount(), halo->ownedCellCount() + halo->ghostCellCount());
+    testGhostsPresentOnMultipleRanks(halo, mesh, out, success);
+
+    MeshTopologyViewPtr meshTopo = mesh->getTopology();
+    for (int cellOrdinal=0; cellOrdinal<halo->ownedCellCount(); cellOrdinal++)
+    {
+      TEST_ASSERT(mesh->myCellsInclude(cellIDs[cellOrdinal]));
+      set<GlobalIndexType> expectedNeighbors = meshTopo->getCell(cellIDs[cellOrdinal])->getActiveNeighborIndices(meshTopo);
+      set<GlobalIndexType> neighbors;
+      for (int neighborOrdinal : halo->neighborOrdinals(cellOrdinal))
+      {
+        neighbors.insert(cellIDs[neighborOrdinal]);
+      }
+      TEST_ASSERT(neighbors == expectedNeighbors);
+    }
+    for (int cellOrdinal=halo->ownedCellCount(); cellOrdinal<halo->cellCount(); cellOrdinal++)
+    {
+      TEST_ASSERT(!mesh->myCellsInclude(cellIDs[cellOrdinal]));
+      TEST_EQUALITY(halo->ordinalForCell(cellIDs[cellOrdinal]), cellOrdinal);
+    }
+
+    // owners fill in (cellID, -cellID); ghost rows start out as -1
+    FieldContainer<double> values(halo->cellCount(), 2);
+    values.initialize(-1.0);
+    for (int cellOrdinal=0; cellOrdinal<halo->ownedCellCount(); cellOrdinal++)
+    {
+      values(cellOrdinal,0) = cellIDs[cellOrdinal];
+      values(cellOrdinal,1) = -(double)cellIDs[cellOrdinal];
+    }
+    halo->exchange(values);
+    for (int cellOrdinal=0; cellOrdinal<halo->cellCount(); cellOrdinal++)
+    {
+      TEST_EQUALITY(values(cellOrdinal,0), cellIDs[cellOrdinal]);
+      TEST_EQUALITY(values(cellOrdinal,1), -(double)cellIDs[cellOrdinal]);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( CellHalo, ExchangeFillsGhosts_2D )
+  {
+    testHaloMatchesMesh(poissonMesh({4,3}), out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( CellHalo, ExchangeFillsGhosts_3D )
+  {
+    testHaloMatchesMesh(poissonMesh({2,2,3}), out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( CellHalo, GradientErrorIndicatorUsesGhostValues_2D )
+  {
+    // the least-squares gradient of a linear field is exact, so every cell should see |grad u| -- including cells whose
+    // neighbors are ghosts, whose values arrive through the halo exchange
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    int H1Order = 2;
+    MeshPtr mesh = MeshFactory::rectilinearMesh(form.bf(), {1.0,1.0}, {4,3}, H1Order);
+    testGhostsPresentOnMultipleRanks(mesh->cellHalo(), mesh, out, success);
+
+    SolutionPtr soln = Solution::solution(form.bf(), mesh);
+    FunctionPtr x = Function::xn(1), y = Function::yn(1);
+    map<int, FunctionPtr> solutionMap;
+    solutionMap[form.u()->ID()] = x + 2.0 * y;
+    const int solutionOrdinal = 0;
+    soln->projectOntoMesh(solutionMap, solutionOrdinal);
+
+    double hPower = 0; // measure the gradient alone
+    GradientErrorIndicator<double> indicator(soln, form.u(), hPower);
+    indicator.measureError();
+
+    double expectedGradientNorm = sqrt(5.0);
+    double tol = 1e-12;
+    TEST_EQUALITY(indicator.localErrorMeasures().size(), mesh->cellIDsInPartition().size());
+    for (auto entry : indicator.localErrorMeasures())
+    {
+      TEST_FLOATING_EQUALITY(entry.second, expectedGradientNorm, tol);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( CellHalo, RebuiltAfterRefinement )
+  {
+    MeshPtr mesh = poissonMesh({2,2});
+    CellHaloPtr halo = mesh->cellHalo();
+    TEST_ASSERT(mesh->cellHalo() == halo); // reused until the mesh changes
+
+    set<GlobalIndexType> cellsToRefine = {0};
+    mesh->hRefine(cellsToRefine);
+    TEST_ASSERT(mesh->cellHalo() != halo);
+    testHaloMatchesMesh(mesh, out, success); // includes a hanging-node neighbor relationship
+  }
+} // namespace
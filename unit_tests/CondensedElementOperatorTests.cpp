@@ -0,0 +1,117 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  CondensedElementOperatorTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "CGSolver.h"
+#include "CondensedElementOperator.h"
+#include "Function.h"
+#include "Mesh.h"
+#include "MeshFactory.h"
+#include "MPIWrapper.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "Solution.h"
+#include "TypeDefs.h"
+
+using namespace Camellia;
+
+namespace
+{
+  // condensed Poisson system (with Dirichlet BCs imposed) on a quad mesh; optionally refine the first cell to get hanging nodes
+  SolutionPtr condensedPoissonSolution(vector<int> meshWidths, bool refineFirstCell)
+  {
+    int spaceDim = meshWidths.size();
+    vector<double> dimensions(spaceDim,1);
+    MeshTopologyPtr meshTopo = MeshFactory::rectilinearMeshTopology(dimensions, meshWidths);
+    bool conformingTraces = true;
+    PoissonFormulation form(spaceDim, conformingTraces);
+    int delta_k = 1;
+    Epetra_CommPtr Comm = MPIWrapper::CommWorld();
+    int H1Order = 3;
+    MeshPtr mesh = MeshFactory::minRuleMesh(meshTopo, form.bf(), H1Order, delta_k, Comm);
+    if (refineFirstCell)
+    {
+      set<GlobalIndexType> cellsToRefine = {0};
+      mesh->hRefine(cellsToRefine);
+    }
+
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+    RHSPtr rhs = form.rhs(Function::constant(1.0));
+
+    SolutionPtr soln = Solution::solution(form.bf(), mesh, bc, rhs, form.bf()->graphNorm());
+    soln->setUseCondensedSolve(true);
+
+    soln->initializeLHSVector();
+    soln->initializeStiffnessAndLoad();
+    soln->populateStiffnessAndLoad();
+    soln->imposeBCs();
+    return soln;
+  }
+
+  void testApplyMatchesAssembledMatrix(vector<int> meshWidths, bool refineFirstCell, Teuchos::FancyOStream &out, bool &success)
+  {
+    SolutionPtr soln = condensedPoissonSolution(meshWidths, refineFirstCell);
+    CondensedElementOperator elementOperator(soln);
+
+    Teuchos::RCP<Epetra_CrsMatrix> A = soln->getStiffnessMatrix();
+    int numVectors = 3;
+    Epetra_MultiVector x(A->RowMap(), numVectors), Ax(A->RowMap(), numVectors), Kx(A->RowMap(), numVectors);
+    x.Random();
+    A->Apply(x, Ax);
+    int err = elementOperator.Apply(x, Kx);
+    TEST_EQUALITY(err, 0);
+
+    Kx.Update(-1.0, Ax, 1.0);
+    vector<double> diffNorms(numVectors), AxNorms(numVectors);
+    Kx.NormInf(&diffNorms[0]);
+    Ax.NormInf(&AxNorms[0]);
+    double tol = 1e-12;
+    for (int i=0; i<numVectors; i++)
+    {
+      TEST_COMPARE(diffNorms[i], <, tol * AxNorms[i]);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( CondensedElementOperator, ApplyMatchesAssembledMatrix_2D )
+  {
+    testApplyMatchesAssembledMatrix({3,2}, false, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( CondensedElementOperator, ApplyMatchesAssembledMatrixHangingNode_2D )
+  {
+    testApplyMatchesAssembledMatrix({2,2}, true, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( CondensedElementOperator, CGSolverWithOperatorSolvesSystem )
+  {
+    SolutionPtr soln = condensedPoissonSolution({2,2}, false);
+    Teuchos::RCP<CondensedElementOperator> elementOperator = Teuchos::rcp( new CondensedElementOperator(soln) );
+
+    Teuchos::RCP<Epetra_CrsMatrix> A = soln->getStiffnessMatrix();
+    Teuchos::RCP<Epetra_MultiVector> b = soln->getRHSVector();
+    Teuchos::RCP<Epetra_MultiVector> x = Teuchos::rcp( new Epetra_MultiVector(A->RowMap(), 1) );
+
+    double tol = 1e-12;
+    int maxIters = 1000;
+    CGSolver solver(maxIters, tol);
+    solver.setProblem(A, x, b);
+    solver.setOperator(elementOperator);
+    solver.solve();
+
+    // check the residual against the assembled matrix
+    Epetra_MultiVector r(A->RowMap(), 1);
+    A->Apply(*x, r);
+    r.Update(1.0, *b, -1.0);
+    double rNorm, bNorm;
+    r.Norm2(&rNorm);
+    b->Norm2(&bNorm);
+    TEST_COMPARE(rNorm, <, 1e-8 * bNorm);
+  }
+} // namespace
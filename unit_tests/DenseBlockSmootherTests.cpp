@@ -0,0 +1,135 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  DenseBlockSmootherTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "DenseBlockSmoother.h"
+#include "Mesh.h"
+#include "MeshFactory.h"
+#include "MPIWrapper.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "Solution.h"
+#include "TypeDefs.h"
+
+using namespace Camellia;
+
+namespace
+{
+  // Poisson stiffness matrix (with Dirichlet BCs imposed, so that it is SPD) on a uniform quad mesh
+  Teuchos::RCP<DenseBlockSmoother> getBlockSmoother(SolutionPtr &soln, vector<int> meshWidths, DenseBlockSmoother::SweepType sweepType,
+                                                    int overlapLevel, bool conformingTraces)
+  {
+    int spaceDim = meshWidths.size();
+    vector<double> dimensions(spaceDim,1);
+    MeshTopologyPtr meshTopo = MeshFactory::rectilinearMeshTopology(dimensions, meshWidths);
+    PoissonFormulation form(spaceDim, conformingTraces);
+    int delta_k = 1;
+    Epetra_CommPtr Comm = MPIWrapper::CommWorld();
+    int H1Order = 2;
+    MeshPtr mesh = MeshFactory::minRuleMesh(meshTopo, form.bf(), H1Order, delta_k, Comm);
+
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+    RHSPtr rhs = RHS::rhs();
+
+    soln = Solution::solution(form.bf(), mesh, bc, rhs, form.bf()->graphNorm());
+
+    soln->initializeLHSVector();
+    soln->initializeStiffnessAndLoad();
+    soln->populateStiffnessAndLoad();
+    soln->imposeBCs();
+
+    Teuchos::RCP<Epetra_RowMatrix> stiffness = soln->getStiffnessMatrix();
+    bool useHierarchicalNeighbors = false;
+    int dimensionForNeighbors = spaceDim - 1;
+
+    auto smoother = Teuchos::rcp( new DenseBlockSmoother(stiffness.get(), mesh, soln->getDofInterpreter(), sweepType, overlapLevel,
+                                                         useHierarchicalNeighbors, dimensionForNeighbors) );
+    int err = smoother->Compute();
+    TEUCHOS_TEST_FOR_EXCEPTION(err != 0, std::invalid_argument, "DenseBlockSmoother::Compute() failed");
+    return smoother;
+  }
+
+  // returns x^T A x
+  double energy(const Epetra_RowMatrix &A, const Epetra_MultiVector &x)
+  {
+    Epetra_MultiVector Ax(x.Map(), 1);
+    A.Multiply(false, x, Ax);
+    double value;
+    x.Dot(Ax, &value);
+    return value;
+  }
+
+  TEUCHOS_UNIT_TEST( DenseBlockSmoother, SingleCellJacobiIsExactInverse )
+  {
+    SolutionPtr soln; // keep reference so that stiffness matrix doesn't get deleted
+    vector<int> meshWidths = {1,1};
+    int overlapLevel = 0;
+    bool conformingTraces = true;
+    auto smoother = getBlockSmoother(soln, meshWidths, DenseBlockSmoother::JACOBI, overlapLevel, conformingTraces);
+
+    Teuchos::RCP<Epetra_CrsMatrix> A = soln->getStiffnessMatrix();
+    Epetra_MultiVector b(A->RowMap(), 2), x(A->RowMap(), 2), Ax(A->RowMap(), 2);
+    b.Random();
+    smoother->ApplyInverse(b, x);
+    A->Multiply(false, x, Ax);
+    Ax.Update(-1.0, b, 1.0);
+
+    double errNorms[2], bNorms[2];
+    Ax.Norm2(errNorms);
+    b.Norm2(bNorms);
+    double tol = 1e-10;
+    for (int i=0; i<2; i++)
+    {
+      TEST_COMPARE(errNorms[i], <, tol * bNorms[i]);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( DenseBlockSmoother, SymmetricGaussSeidelReducesEnergyError )
+  {
+    vector<int> meshWidths = {3,3};
+    bool conformingTraces = true;
+    for (int overlapLevel=0; overlapLevel<=1; overlapLevel++)
+    {
+      SolutionPtr soln;
+      auto smoother = getBlockSmoother(soln, meshWidths, DenseBlockSmoother::SYMMETRIC_GAUSS_SEIDEL, overlapLevel, conformingTraces);
+      Teuchos::RCP<Epetra_CrsMatrix> A = soln->getStiffnessMatrix();
+
+      // one smoothing step applied to an error e: e <- e - S A e.  For SPD A, this reduces the energy norm.
+      Epetra_MultiVector e(A->RowMap(), 1), Ae(A->RowMap(), 1), SAe(A->RowMap(), 1);
+      e.Random();
+      A->Multiply(false, e, Ae);
+      smoother->ApplyInverse(Ae, SAe);
+      double initialEnergy = energy(*A, e);
+      e.Update(-1.0, SAe, 1.0);
+      double finalEnergy = energy(*A, e);
+      TEST_COMPARE(finalEnergy, <, initialEnergy);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( DenseBlockSmoother, IncidenceCountingZeroOverlap )
+  {
+    SolutionPtr soln;
+    vector<int> meshWidths = {2,2};
+    bool conformingTraces = true;
+    int overlapLevel = 0;
+    auto smoother = getBlockSmoother(soln, meshWidths, DenseBlockSmoother::JACOBI, overlapLevel, conformingTraces);
+
+    int myMaxCount = 0;
+    for (int count : smoother->LocalIncidenceCounts())
+    {
+      TEST_ASSERT(count >= 1); // every row belongs to some block
+      myMaxCount = max(myMaxCount, count);
+    }
+    if (soln->mesh()->Comm()->NumProc() == 1)
+    {
+      TEST_EQUALITY(myMaxCount, 4); // center vertex sees 4 elements
+    }
+  }
+} // namespace
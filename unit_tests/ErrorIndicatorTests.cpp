@@ -85,8 +85,8 @@ namespace
   }
   
   // ! Initialize a solution with elementwise quadratic field data.  Mesh has bottom left coordinate at the origin, and each element
-  // ! is a unit square.
-  void initializeHighOrderSolutionUnitDomain(SolutionPtr &soln, VarPtr &var, int meshWidth, int meshHeight)
+  // ! is a unit square.  If pRefineFirstCell is true, cell 0 is p-refined before the projection, so that the mesh has two element types.
+  void initializeHighOrderSolutionUnitDomain(SolutionPtr &soln, VarPtr &var, int meshWidth, int meshHeight, bool pRefineFirstCell = false)
   {
     int spaceDim = 2;
     bool useConformingTraces = true; // inconsequential here
@@ -95,6 +95,11 @@ namespace
     var = form.u(); // just picking a field
     int H1Order = 3;
     MeshPtr mesh = MeshFactory::rectilinearMesh(bf, {(double)1.0, (double)1.0}, {meshWidth,meshHeight}, H1Order);
+    if (pRefineFirstCell)
+    {
+      set<GlobalIndexType> cellsToRefine = {0};
+      mesh->pRefine(cellsToRefine, 1);
+    }
     soln = Solution::solution(bf, mesh);
     map<int, FunctionPtr> functionMap;
     FunctionPtr f = highOrderFunction();
@@ -269,13 +274,13 @@ namespace
     }
   }
   
-  TEUCHOS_UNIT_TEST(ErrorIndicator, HessianHighOrder)
+  void testHessianHighOrder(bool pRefineFirstCell, Teuchos::FancyOStream &out, bool &success)
   {
     int meshWidth = 5, meshHeight = 5;
     
     SolutionPtr soln;
     VarPtr var;
-    initializeHighOrderSolutionUnitDomain(soln, var, meshWidth, meshHeight);
+    initializeHighOrderSolutionUnitDomain(soln, var, meshWidth, meshHeight, pRefineFirstCell);
     
     ErrorIndicatorPtr hessianIndicator = ErrorIndicator::hessianErrorIndicator(soln, var);
     hessianIndicator->measureError();
@@ -299,6 +304,18 @@ namespace
     }
   }
   
+  TEUCHOS_UNIT_TEST(ErrorIndicator, HessianHighOrder)
+  {
+    bool pRefineFirstCell = false;
+    testHessianHighOrder(pRefineFirstCell, out, success);
+  }
+  
+  TEUCHOS_UNIT_TEST(ErrorIndicator, HessianHighOrder_TwoElementTypes)
+  {
+    bool pRefineFirstCell = true;
+    testHessianHighOrder(pRefineFirstCell, out, success);
+  }
+  
 //  // meta-test: just to see that initializeSolution is doing what it should, by looking at it
 //  TEUCHOS_UNIT_TEST(ErrorIndicator, VisualizeInitializedSolution)
 //  {
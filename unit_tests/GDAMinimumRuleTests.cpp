@@ -1712,6 +1712,62 @@ namespace
     testCoarseBasisEqualsWeightedFineBasis(mesh, out, success);
   }
   
+  void testCellColorsForAssembly(MeshPtr mesh, Teuchos::FancyOStream &out, bool &success)
+  {
+    GlobalDofAssignmentPtr gda = mesh->globalDofAssignment();
+    const set<GlobalIndexType>* myCellIDs = &mesh->cellIDsInPartition();
+    vector<GlobalIndexType> cellIDs(myCellIDs->begin(), myCellIDs->end());
+    
+    vector<vector<GlobalIndexType>> colors = gda->cellColorsForAssembly(cellIDs);
+    
+    set<GlobalIndexType> coloredCells;
+    for (vector<GlobalIndexType> &color : colors)
+    {
+      TEST_ASSERT(color.size() > 0);
+      set<GlobalIndexType> dofsInColor;
+      for (GlobalIndexType cellID : color)
+      {
+        TEST_ASSERT(coloredCells.find(cellID) == coloredCells.end());
+        coloredCells.insert(cellID);
+        set<GlobalIndexType> cellDofs = gda->globalDofIndicesForCell(cellID);
+        for (GlobalIndexType dofIndex : cellDofs)
+        {
+          if (dofsInColor.find(dofIndex) != dofsInColor.end())
+          {
+            success = false;
+            out << "global dof " << dofIndex << " is shared by cell " << cellID << " and another cell of the same color\n";
+          }
+        }
+        dofsInColor.insert(cellDofs.begin(), cellDofs.end());
+      }
+    }
+    TEST_EQUALITY(coloredCells.size(), myCellIDs->size());
+  }
+  
+  TEUCHOS_UNIT_TEST( GDAMinimumRule, CellColorsForAssemblyPoisson2DUniform )
+  {
+    int spaceDim = 2, elementWidth = 4, H1Order = 2;
+    bool useConformingTraces = true;
+    MeshPtr mesh = poissonUniformMesh(spaceDim, elementWidth, H1Order, useConformingTraces);
+    testCellColorsForAssembly(mesh, out, success);
+    
+    // interior cells of a uniform quad mesh share a vertex with eight neighbors, so at least four colors are required
+    if (mesh->Comm()->NumProc() == 1)
+    {
+      vector<GlobalIndexType> cellIDs(mesh->cellIDsInPartition().begin(), mesh->cellIDsInPartition().end());
+      int colorCount = mesh->globalDofAssignment()->cellColorsForAssembly(cellIDs).size();
+      TEST_ASSERT(colorCount >= 4);
+    }
+  }
+  
+  TEUCHOS_UNIT_TEST( GDAMinimumRule, CellColorsForAssemblyPoisson2DHangingNode )
+  {
+    int spaceDim = 2, irregularity = 1, H1Order = 2;
+    bool useConformingTraces = true;
+    MeshPtr mesh = poissonIrregularMesh(spaceDim, irregularity, H1Order, useConformingTraces);
+    testCellColorsForAssembly(mesh, out, success);
+  }
+  
   TEUCHOS_UNIT_TEST( GDAMinimumRule, CheckConstraintsPoisson3DUniform )
   {
     MeshPtr mesh = poisson3DUniformMesh();
@@ -2338,6 +2394,103 @@ namespace
     testProjectionOntoTriangularContinuousGalerkinMesh(meshWidth, polyOrder, out, success);
   }
   
+  TEUCHOS_UNIT_TEST( GDAMinimumRule, SortedDofQueriesMatchSetQueries )
+  {
+    int spaceDim = 2, irregularity = 1, H1Order = 2;
+    bool useConformingTraces = true;
+    MeshPtr mesh = poissonIrregularMesh(spaceDim, irregularity, H1Order, useConformingTraces);
+    GlobalDofAssignmentPtr gda = mesh->globalDofAssignment();
+    int rank = mesh->Comm()->MyPID();
+
+    // owned dofs: minimum rule numbers these contiguously
+    set<GlobalIndexType> partitionDofSet = gda->globalDofIndicesForPartition(rank);
+    GlobalIndexType firstDofIndex, dofCount;
+    TEST_ASSERT(gda->globalDofRangeForPartition(rank, firstDofIndex, dofCount));
+    TEST_EQUALITY(dofCount, partitionDofSet.size());
+    TEST_EQUALITY(gda->globalDofCountForPartition(rank), partitionDofSet.size());
+    if (partitionDofSet.size() > 0)
+    {
+      TEST_EQUALITY(firstDofIndex, *partitionDofSet.begin());
+    }
+    vector<GlobalIndexType> partitionDofVector;
+    gda->sortedGlobalDofIndicesForPartition(rank, partitionDofVector);
+    TEST_ASSERT(partitionDofVector == vector<GlobalIndexType>(partitionDofSet.begin(), partitionDofSet.end()));
+
+    // cell dofs, locally and imported
+    vector<GlobalIndexType> cellDofVector;
+    set<GlobalIndexType> myCellDofs;
+    set<GlobalIndexType> myCellsAndNeighbors;
+    for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+    {
+      set<GlobalIndexType> cellDofSet = gda->globalDofIndicesForCell(cellID);
+      gda->sortedGlobalDofIndicesForCell(cellID, cellDofVector);
+      TEST_ASSERT(cellDofVector == vector<GlobalIndexType>(cellDofSet.begin(), cellDofSet.end()));
+      myCellDofs.insert(cellDofSet.begin(), cellDofSet.end());
+
+      myCellsAndNeighbors.insert(cellID);
+      set<GlobalIndexType> neighbors = mesh->getTopology()->getCell(cellID)->getActiveNeighborIndices(mesh->getTopology());
+      myCellsAndNeighbors.insert(neighbors.begin(), neighbors.end());
+    }
+    vector<GlobalIndexType> cellIDs(myCellsAndNeighbors.begin(), myCellsAndNeighbors.end());
+    vector<GlobalIndexType> importedDofs;
+    gda->importSortedGlobalIndicesForCells(cellIDs, importedDofs);
+    for (int i=1; i<importedDofs.size(); i++)
+    {
+      TEST_COMPARE(importedDofs[i-1], <, importedDofs[i]); // sorted, without duplicates
+    }
+    for (GlobalIndexType dofIndex : myCellDofs)
+    {
+      TEST_ASSERT(std::binary_search(importedDofs.begin(), importedDofs.end(), dofIndex));
+    }
+  }
+  
+  TEUCHOS_UNIT_TEST( GDAMinimumRule, ZeroCacheBudgetsGiveSameDofs )
+  {
+    int spaceDim = 2, irregularity = 1, H1Order = 2;
+    bool useConformingTraces = true;
+    MeshPtr mesh = poissonIrregularMesh(spaceDim, irregularity, H1Order, useConformingTraces);
+    GDAMinimumRule* gda = dynamic_cast<GDAMinimumRule*>(mesh->globalDofAssignment().get());
+    vector<VarPtr> traceVars = mesh->varFactory()->traceVars();
+
+    // collect the side queries with unbounded caches, then again with caches that retain only the most recent entry
+    auto sideDofs = [&] () -> map<pair<GlobalIndexType,pair<int,int>>, pair<set<GlobalIndexType>,vector<GlobalIndexType>>>
+    {
+      map<pair<GlobalIndexType,pair<int,int>>, pair<set<GlobalIndexType>,vector<GlobalIndexType>>> dofs;
+      for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+      {
+        int sideCount = mesh->getTopology()->getCell(cellID)->getSideCount();
+        for (int sideOrdinal=0; sideOrdinal<sideCount; sideOrdinal++)
+        {
+          for (VarPtr var : traceVars)
+          {
+            pair<GlobalIndexType,pair<int,int>> key = {cellID,{sideOrdinal,var->ID()}};
+            dofs[key].first = gda->getFittableGlobalDofIndices(cellID, sideOrdinal, var->ID());
+            dofs[key].second = gda->getDofMapper(cellID, var->ID(), sideOrdinal)->globalIndices();
+          }
+        }
+      }
+      return dofs;
+    };
+
+    auto unboundedDofs = sideDofs();
+
+    gda->clearCaches();
+    gda->setDofMapperForVariableOnSideCacheMemoryBudget(0);
+    gda->setFittableGlobalIndicesCacheMemoryBudget(0);
+    auto boundedDofs = sideDofs();
+    TEST_ASSERT(unboundedDofs == boundedDofs);
+
+    LRUCacheStatistics mapperStats = gda->dofMapperForVariableOnSideCacheStatistics();
+    LRUCacheStatistics fittableStats = gda->fittableGlobalIndicesCacheStatistics();
+    TEST_COMPARE(mapperStats.size, <=, 1);
+    TEST_COMPARE(fittableStats.size, <=, 1);
+    if (unboundedDofs.size() > 1)
+    {
+      TEST_COMPARE(mapperStats.evictions, >, 0);
+      TEST_COMPARE(fittableStats.evictions, >, 0);
+    }
+  }
+
   TEUCHOS_UNIT_TEST( GDAMinimumRule, SolvePoisson2DContinuousGalerkinHangingNode_Slow )
   {
     MPIWrapper::CommWorld()->Barrier();
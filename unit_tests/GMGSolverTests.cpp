@@ -13,6 +13,7 @@
 
 #include "EpetraExt_RowMatrixOut.h"
 
+#include "AgglomeratedSolver.h"
 #include "CamelliaDebugUtility.h"
 #include "GDAMinimumRule.h"
 #include "GnuPlotUtil.h"
@@ -996,6 +997,62 @@ void testOperatorIsSPD(int spaceDim, GridType gridType, GMGOperator::SmootherApp
     }
   }
 
+  TEUCHOS_UNIT_TEST( GMGSolver, PoissonTwoGridAgglomeratedCoarseSolve_2D )
+  {
+    // gathering the coarse solve onto one rank should not change the iteration: compare against the distributed coarse solve.
+    // On a single rank, AgglomeratedSolver passes the problem through, so the gather, communicator split, and export back
+    // are only exercised by running on two or more ranks; unit_tests/CMakeLists.txt registers a two-rank run of this test.
+    int spaceDim = 2;
+    FunctionPtr u_exact = getPhiExact(spaceDim);
+    Teuchos::RCP<GMGSolver> solver;
+    SolutionPtr fineSolution;
+    setupPoissonGMGSolver_TwoGrid_h(solver, fineSolution, spaceDim, u_exact);
+    fineSolution->solve(solver);
+    Epetra_FEVector expectedLHS = *fineSolution->getLHSVector();
+    int expectedIterationCount = solver->iterationCount();
+
+    setupPoissonGMGSolver_TwoGrid_h(solver, fineSolution, spaceDim, u_exact);
+    int agglomeratedRankCount = 1;
+    solver->setCoarseSolveAgglomeration(agglomeratedRankCount);
+    fineSolution->solve(solver);
+    Teuchos::RCP<Epetra_FEVector> lhs = fineSolution->getLHSVector();
+    TEST_EQUALITY(solver->iterationCount(), expectedIterationCount);
+
+    double tol = 1e-10;
+    for (int localRow=0; localRow<lhs->MyLength(); localRow++)
+    {
+      double diff = abs((*lhs)[0][localRow] - expectedLHS[0][localRow]);
+      TEST_COMPARE(diff, <, tol);
+    }
+
+    auto opStack = solver->getOperatorStack(true);
+    AgglomeratedSolver* agglomeratedSolver = dynamic_cast<AgglomeratedSolver*>(opStack[0]->getCoarseSolver().get());
+    TEST_ASSERT(agglomeratedSolver != NULL);
+    if (agglomeratedSolver != NULL)
+    {
+      TEST_EQUALITY(agglomeratedSolver->getAgglomeratedRankCount(), agglomeratedRankCount);
+      int numRanks = fineSolution->mesh()->Comm()->NumProc();
+      if (numRanks == 1)
+      {
+        out << "NOTE: on one rank, the agglomerated coarse solve is a pass-through; run on two or more ranks to test the gather.\n";
+      }
+      else
+      {
+        // the LHS comparison above then covers the gather onto fewer ranks and the export back
+        TEST_COMPARE(agglomeratedSolver->getAgglomeratedRankCount(), <, numRanks);
+      }
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( GMGSolver, AgglomeratedRankCount )
+  {
+    int dofsPerRank = 100;
+    TEST_EQUALITY(AgglomeratedSolver::agglomeratedRankCount(0, 16, dofsPerRank), 1);
+    TEST_EQUALITY(AgglomeratedSolver::agglomeratedRankCount(100, 16, dofsPerRank), 1);
+    TEST_EQUALITY(AgglomeratedSolver::agglomeratedRankCount(101, 16, dofsPerRank), 2);
+    TEST_EQUALITY(AgglomeratedSolver::agglomeratedRankCount(100000, 16, dofsPerRank), 16);
+  }
+
   TEUCHOS_UNIT_TEST( GMGSolver, PoissonTwoGridOperatorIsSPD_1D_h )
   {
     MPIWrapper::CommWorld()->Barrier();
@@ -0,0 +1,114 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  LRUCacheTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "LRUCache.h"
+
+#include <string>
+
+using namespace Camellia;
+using namespace std;
+
+namespace
+{
+  // each entry costs its value, so budgets can be stated in entries
+  LRUCache<int, int> unitCostCache()
+  {
+    return LRUCache<int, int>([] (const int &key, const int &value) -> long long { return value; });
+  }
+
+  TEUCHOS_UNIT_TEST( LRUCache, FindCountsHitsAndMisses )
+  {
+    LRUCache<int, int> cache = unitCostCache();
+    TEST_ASSERT(cache.find(0) == NULL);
+    cache.insert(0, 1);
+    TEST_ASSERT(cache.find(0) != NULL);
+    TEST_EQUALITY(*cache.find(0), 1);
+
+    LRUCacheStatistics stats = cache.statistics();
+    TEST_EQUALITY(stats.size, 1);
+    TEST_EQUALITY(stats.memoryCost, 1);
+    TEST_EQUALITY(stats.hits, 2);
+    TEST_EQUALITY(stats.misses, 1);
+    TEST_EQUALITY(stats.evictions, 0);
+
+    cache.resetStatistics();
+    stats = cache.statistics();
+    TEST_EQUALITY(stats.hits, 0);
+    TEST_EQUALITY(stats.misses, 0);
+    TEST_EQUALITY(stats.size, 1);
+  }
+
+  TEUCHOS_UNIT_TEST( LRUCache, EvictsLeastRecentlyUsed )
+  {
+    LRUCache<int, int> cache = unitCostCache();
+    cache.setMemoryBudget(3);
+    cache.insert(0, 1);
+    cache.insert(1, 1);
+    cache.insert(2, 1);
+    cache.find(0); // now 1 is least recently used
+    cache.insert(3, 1);
+
+    TEST_ASSERT(cache.find(1) == NULL);
+    TEST_ASSERT(cache.find(0) != NULL);
+    TEST_ASSERT(cache.find(2) != NULL);
+    TEST_ASSERT(cache.find(3) != NULL);
+    TEST_EQUALITY(cache.statistics().evictions, 1);
+    TEST_EQUALITY(cache.statistics().memoryCost, 3);
+
+    // lowering the budget evicts immediately
+    cache.setMemoryBudget(1);
+    TEST_EQUALITY(cache.statistics().size, 1);
+    TEST_ASSERT(cache.find(3) != NULL); // most recently used
+  }
+
+  TEUCHOS_UNIT_TEST( LRUCache, RetainsMostRecentEntryOverBudget )
+  {
+    LRUCache<int, int> cache = unitCostCache();
+    cache.setMemoryBudget(0);
+    int &value = cache.insert(0, 5);
+    TEST_EQUALITY(value, 5);
+    TEST_EQUALITY(cache.statistics().size, 1);
+    cache.insert(1, 5);
+    TEST_EQUALITY(cache.statistics().size, 1);
+    TEST_ASSERT(cache.find(0) == NULL);
+    TEST_EQUALITY(*cache.find(1), 5);
+  }
+
+  TEUCHOS_UNIT_TEST( LRUCache, InsertReplacesExistingValue )
+  {
+    LRUCache<int, int> cache = unitCostCache();
+    cache.insert(0, 2);
+    cache.insert(0, 3);
+    TEST_EQUALITY(cache.statistics().size, 1);
+    TEST_EQUALITY(cache.statistics().memoryCost, 3);
+    TEST_EQUALITY(*cache.find(0), 3);
+  }
+
+  TEUCHOS_UNIT_TEST( LRUCache, CopyIsIndependent )
+  {
+    LRUCache<int, string> cache([] (const int &key, const string &value) -> long long { return value.size(); });
+    cache.insert(0, "zero");
+    cache.insert(1, "one");
+
+    LRUCache<int, string> copy = cache;
+    copy.insert(2, "two");
+    *copy.find(0) = "ZERO";
+
+    TEST_EQUALITY(*cache.find(0), "zero");
+    TEST_ASSERT(cache.find(2) == NULL);
+    TEST_EQUALITY(copy.statistics().size, 3);
+
+    // the copy's lookup must refer to its own entries: evicting there must not disturb the original
+    copy.setMemoryBudget(0);
+    TEST_EQUALITY(copy.statistics().size, 1);
+    TEST_EQUALITY(cache.statistics().size, 2);
+    TEST_EQUALITY(*cache.find(1), "one");
+  }
+} // namespace
@@ -20,6 +20,10 @@
 #include "TensorBasis.h"
 #include "TypeDefs.h"
 
+#include "Epetra_CrsMatrix.h"
+#include "Epetra_Map.h"
+#include "Epetra_SerialComm.h"
+
 using namespace Camellia;
 using namespace Intrepid;
 
@@ -567,6 +571,118 @@ TEUCHOS_UNIT_TEST( LinearTerm, FauxSpaceTimeIntegrationByPartsInTime_2D )
   testFauxSpaceTimeIntegrationByPartsInTime(2,out,success);
 }
 
+  TEUCHOS_UNIT_TEST( LinearTerm, IntegrateCombinesSummandsSharingVariable )
+  {
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces);
+
+    MeshPtr mesh = MeshFactory::rectilinearMesh(form.bf(), {1.0,1.0}, {2,1}, 3);
+    FunctionPtr x = Function::xn(1), y = Function::yn(1);
+    FunctionPtr n = Function::normal();
+    VarPtr v = form.v(), tau = form.tau();
+
+    // several summands per (var, op), a shared weight function, and a boundary-only summand
+    vector<LinearTermPtr> summands = {x * v, y * v, x * v, Function::vectorize(y, x) * v->grad(), Function::constant({1.0,2.0}) * v->grad(),
+                                      x * tau->div(), y * tau->div(), n * tau};
+    LinearTermPtr lt = Teuchos::rcp( new LinearTerm );
+    for (LinearTermPtr summand : summands)
+    {
+      lt = lt + summand;
+    }
+
+    for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+    {
+      bool testVsTest = true;
+      BasisCachePtr basisCache = BasisCache::basisCacheForCell(mesh, cellID, testVsTest);
+      DofOrderingPtr testOrdering = mesh->getElementType(cellID)->testOrderPtr;
+      int numCells = 1;
+
+      FieldContainer<double> combinedValues(numCells, testOrdering->totalDofs());
+      lt->integrate(combinedValues, testOrdering, basisCache);
+
+      FieldContainer<double> separateValues(numCells, testOrdering->totalDofs());
+      for (LinearTermPtr summand : summands)
+      {
+        summand->integrate(separateValues, testOrdering, basisCache);
+      }
+
+      // entries may cancel to near zero, so compare relative to the largest entry
+      double maxDiff = 0, maxValue = 0;
+      for (int i=0; i<combinedValues.size(); i++)
+      {
+        maxDiff = max(maxDiff, abs(combinedValues[i] - separateValues[i]));
+        maxValue = max(maxValue, abs(separateValues[i]));
+      }
+      double tol = 1e-13;
+      TEST_COMPARE(maxDiff, <=, tol * maxValue);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( LinearTerm, IntegrateIntoCrsMatrixMatchesFieldContainer )
+  {
+    // the Epetra_CrsMatrix variant of the two-term integrate() should sum into the same entries as the FieldContainer variant
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces);
+
+    MeshPtr mesh = MeshFactory::rectilinearMesh(form.bf(), {1.0,1.0}, {2,1}, 2);
+    FunctionPtr x = Function::xn(1), y = Function::yn(1);
+    VarPtr v = form.v(), tau = form.tau();
+
+    // distinct terms, so that the matrix is not symmetric
+    LinearTermPtr thisTerm = x * v + tau->div();
+    LinearTermPtr otherTerm = 1.0 * v + y * tau->x();
+
+    for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+    {
+      bool testVsTest = true;
+      BasisCachePtr basisCache = BasisCache::basisCacheForCell(mesh, cellID, testVsTest);
+      DofOrderingPtr testOrdering = mesh->getElementType(cellID)->testOrderPtr;
+      int numCells = 1;
+      int numDofs = testOrdering->totalDofs();
+
+      FieldContainer<double> expectedValues(numCells, numDofs, numDofs);
+      thisTerm->integrate(expectedValues, testOrdering, otherTerm, testOrdering, basisCache);
+
+      // SumIntoGlobalValues() only touches existing entries, so we start with a dense, filled graph
+      Epetra_SerialComm serialComm;
+      Epetra_Map map(numDofs, 0, serialComm);
+      Epetra_CrsMatrix crsMatrix(Copy, map, numDofs);
+      vector<int> columns(numDofs);
+      vector<double> zeros(numDofs, 0.0);
+      for (int j=0; j<numDofs; j++)
+      {
+        columns[j] = j;
+      }
+      for (int i=0; i<numDofs; i++)
+      {
+        crsMatrix.InsertGlobalValues(i, numDofs, &zeros[0], &columns[0]);
+      }
+      crsMatrix.FillComplete();
+
+      thisTerm->integrate(&crsMatrix, testOrdering, otherTerm, testOrdering, basisCache);
+
+      double maxDiff = 0, maxValue = 0;
+      for (int i=0; i<numDofs; i++)
+      {
+        int numEntries;
+        vector<double> rowValues(numDofs);
+        vector<int> rowColumns(numDofs);
+        crsMatrix.ExtractGlobalRowCopy(i, numDofs, numEntries, &rowValues[0], &rowColumns[0]);
+        for (int entry=0; entry<numEntries; entry++)
+        {
+          int j = rowColumns[entry];
+          maxDiff = max(maxDiff, abs(rowValues[entry] - expectedValues(0,i,j)));
+          maxValue = max(maxValue, abs(expectedValues(0,i,j)));
+        }
+      }
+      TEST_COMPARE(maxValue, >, 0.0);
+      double tol = 1e-13;
+      TEST_COMPARE(maxDiff, <=, tol * maxValue);
+    }
+  }
+
   TEUCHOS_UNIT_TEST( LinearTerm, SolutionEvaluation_ScalarTimesScalar )
   {
     int spaceDim = 2;
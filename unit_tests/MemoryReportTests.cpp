@@ -0,0 +1,85 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  MemoryReportTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "Function.h"
+#include "MemoryReport.h"
+#include "Mesh.h"
+#include "MeshFactory.h"
+#include "MPIWrapper.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "Solution.h"
+#include "TypeDefs.h"
+
+using namespace Camellia;
+
+namespace
+{
+  SolutionPtr poissonSolution(bool useCondensedSolve)
+  {
+    int spaceDim = 2;
+    bool conformingTraces = true;
+    PoissonFormulation form(spaceDim, conformingTraces);
+    vector<double> dimensions(spaceDim,1.0);
+    vector<int> elementCounts = {2,2};
+    int H1Order = 2, delta_k = 1;
+    MeshPtr mesh = MeshFactory::rectilinearMesh(form.bf(), dimensions, elementCounts, H1Order, delta_k);
+
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+    RHSPtr rhs = form.rhs(Function::constant(1.0));
+    SolutionPtr soln = Solution::solution(form.bf(), mesh, bc, rhs, form.bf()->graphNorm());
+    soln->setUseCondensedSolve(useCondensedSolve);
+    soln->solve();
+    return soln;
+  }
+
+  TEUCHOS_UNIT_TEST( MemoryReport, GlobalCostsReduceLocalCosts )
+  {
+    SolutionPtr soln = poissonSolution(false);
+    Epetra_CommPtr Comm = soln->mesh()->Comm();
+
+    MemoryReport report(Comm);
+    report.addMesh(soln->mesh());
+    report.addSolution(soln);
+
+    const map<string, long long> &localCosts = report.localCosts();
+    TEST_ASSERT(localCosts.find("Mesh._gda._dofMapperCache") != localCosts.end());
+    TEST_ASSERT(localCosts.find("Solution._solutionForCellID") != localCosts.end());
+    TEST_COMPARE(report.localTotal(), >, 0);
+
+    map<string, long long> minCosts, maxCosts, sumCosts;
+    report.globalCosts(minCosts, maxCosts, sumCosts);
+
+    double myTotal = report.localTotal(), globalTotal;
+    Comm->SumAll(&myTotal, &globalTotal, 1);
+    TEST_EQUALITY(sumCosts["Total"], (long long) globalTotal);
+
+    for (auto &entry : localCosts)
+    {
+      TEST_COMPARE(minCosts[entry.first], <=, entry.second);
+      TEST_COMPARE(maxCosts[entry.first], >=, entry.second);
+      TEST_COMPARE(sumCosts[entry.first], >=, entry.second);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( MemoryReport, CondensedSolveReportsStoredMatrices )
+  {
+    SolutionPtr soln = poissonSolution(true);
+
+    map<string, long long> costs = soln->approximateMemoryCosts();
+    TEST_ASSERT(costs.find("_dofInterpreter._localStiffnessMatrices") != costs.end());
+
+    // the plain (non-condensed) solution does not report a separate dof interpreter
+    SolutionPtr standardSoln = poissonSolution(false);
+    costs = standardSoln->approximateMemoryCosts();
+    TEST_ASSERT(costs.find("_dofInterpreter._localStiffnessMatrices") == costs.end());
+  }
+} // namespace
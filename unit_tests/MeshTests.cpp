@@ -11,10 +11,12 @@
 #include "Teuchos_UnitTestHarness.hpp"
 
 #include "BasisCache.h"
+#include "BC.h"
 #include "GlobalDofAssignment.h"
 #include "MeshFactory.h"
 #include "MPIWrapper.h"
 #include "PoissonFormulation.h"
+#include "Solution.h"
 #include "StokesVGPFormulation.h"
 
 #include <cstdio>
@@ -157,6 +159,67 @@ MeshPtr makeTestMesh( int spaceDim, bool spaceTime )
     }
   }
   
+  TEUCHOS_UNIT_TEST( Mesh, RectilinearMeshDistributedTopology_2D )
+  {
+    MPIWrapper::CommWorld()->Barrier();
+    int spaceDim = 2;
+    int H1Order = 2;
+    vector<int> elemCounts = {4,4};
+    vector<double> dims(spaceDim,1.0);
+    
+    bool conformingTraces = true;
+    PoissonFormulation form(spaceDim,conformingTraces);
+    
+    Epetra_CommPtr Comm = MPIWrapper::CommWorld();
+    MeshPtr distributedMesh = MeshFactory::rectilinearMesh(form.bf(), dims, elemCounts, H1Order, -1, vector<double>(), map<int,int>(),
+                                                           map<int,int>(), Comm);
+    MeshPtr replicatedMesh = MeshFactory::rectilinearMesh(form.bf(), dims, elemCounts, H1Order);
+    
+    MeshTopologyViewPtr meshTopo = distributedMesh->getTopology();
+    TEST_ASSERT(meshTopo->Comm() != Teuchos::null);
+    
+    int globalCellCount = elemCounts[0] * elemCounts[1];
+    TEST_EQUALITY(distributedMesh->numActiveElements(), globalCellCount);
+    
+    // the mesh partition should be the chunk of cells the topology was built to own
+    const set<GlobalIndexType> &myCellIDs = distributedMesh->cellIDsInPartition();
+    const set<IndexType> &myTopologyCellIDs = meshTopo->getMyActiveCellIndices();
+    TEST_EQUALITY(myCellIDs.size(), myTopologyCellIDs.size());
+    for (GlobalIndexType cellID : myCellIDs)
+    {
+      TEST_ASSERT(myTopologyCellIDs.find(cellID) != myTopologyCellIDs.end());
+    }
+    int myCellCount = myCellIDs.size(), globalOwnedCellCount;
+    Comm->SumAll(&myCellCount, &globalOwnedCellCount, 1);
+    TEST_EQUALITY(globalOwnedCellCount, globalCellCount);
+    
+    if (Comm->NumProc() == 1)
+    {
+      out << "NOTE: on one rank, the distributed topology contains every cell; run on two or more ranks to test distributed construction.\n";
+    }
+    else
+    {
+      TEST_ASSERT(meshTopo->isDistributed());
+      TEST_COMPARE((int)meshTopo->getLocallyKnownActiveCellIndices().size(), <, globalCellCount);
+    }
+    
+    TEST_EQUALITY(distributedMesh->numGlobalDofs(), replicatedMesh->numGlobalDofs());
+    
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+    RHSPtr rhs = form.rhs(Function::constant(1.0));
+    
+    SolutionPtr distributedSoln = Solution::solution(form.bf(), distributedMesh, bc, rhs, form.bf()->graphNorm());
+    SolutionPtr replicatedSoln = Solution::solution(form.bf(), replicatedMesh, bc, rhs, form.bf()->graphNorm());
+    distributedSoln->solve();
+    replicatedSoln->solve();
+    
+    double tol = 1e-10;
+    int uID = form.u()->ID();
+    TEST_FLOATING_EQUALITY(distributedSoln->L2NormOfSolutionGlobal(uID), replicatedSoln->L2NormOfSolutionGlobal(uID), tol);
+    TEST_FLOATING_EQUALITY(distributedSoln->energyErrorTotal(), replicatedSoln->energyErrorTotal(), tol);
+  }
+  
   // until we find a way to simplify this test, commenting it out.  (It's pretty slow!)
 //  TEUCHOS_UNIT_TEST( Mesh, EnforceRegularityBigQuadMesh_Slow )
 //  {
@@ -389,9 +452,11 @@ MeshPtr makeTestMesh( int spaceDim, bool spaceTime )
     numActiveCellsForCentralEdge = meshTopo->getActiveCellIndices(edgeDim, centralEdgeEntityIndex).size();
     TEST_EQUALITY(numActiveCellsForCentralEdge, numActiveCellsForCentralEdgeExpected);
     
-    // now, repeat all the above, skipping the cell ID determinations
-    mesh = MeshFactory::rectilinearMesh(form.bf(), dims, elemCounts, H1Order, 0, vector<double>(), map<int,int>(),
-                                                map<int,int>(), MPIWrapper::CommWorld());
+    // now, repeat all the above, skipping the cell ID determinations.  The cell and entity indices recorded above are global ones, so
+    // build on the full topology rather than the distributed one MeshFactory::rectilinearMesh() constructs for a non-null Comm.
+    MeshTopologyPtr fullMeshTopo = MeshFactory::rectilinearMeshTopology(dims, elemCounts);
+    mesh = Teuchos::rcp( new Mesh(fullMeshTopo, form.bf(), H1Order, 0, map<int,int>(), map<int,int>(), Teuchos::null,
+                                  MPIWrapper::CommWorld()) );
     meshTopo = dynamic_cast<MeshTopology*>(mesh->getTopology().get());
     
     numActiveElementsExpected = elemCounts[0] * elemCounts[1] * elemCounts[2];
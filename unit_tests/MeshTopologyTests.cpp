@@ -536,6 +536,103 @@ void testConstraints( MeshTopology* mesh, unsigned entityDim, map<unsigned,pair<
     testPruneAddPrune(meshTopo, out, success);
   }
   
+  // ! builds a rectilinear MeshTopology cell by cell, using physical vertex coordinates (the approach that bulk construction replaces)
+  MeshTopologyPtr rectilinearMeshTopologyCellByCell(vector<double> dimensions, vector<int> elementCounts)
+  {
+    int spaceDim = dimensions.size();
+    CellTopoPtr cellTopo = (spaceDim == 2) ? CellTopology::quad() : CellTopology::hexahedron();
+    MeshTopologyPtr meshTopo = Teuchos::rcp( new MeshTopology(spaceDim) );
+    int nz = (spaceDim == 3) ? elementCounts[2] : 1;
+    for (int i=0; i<elementCounts[0]; i++)
+    {
+      for (int j=0; j<elementCounts[1]; j++)
+      {
+        for (int k=0; k<nz; k++)
+        {
+          vector<vector<int>> offsets = {{0,0,0},{1,0,0},{1,1,0},{0,1,0},{0,0,1},{1,0,1},{1,1,1},{0,1,1}};
+          vector<vector<double>> cellVertices(cellTopo->getNodeCount(), vector<double>(spaceDim));
+          for (int node=0; node<cellTopo->getNodeCount(); node++)
+          {
+            vector<int> gridCoords = {i + offsets[node][0], j + offsets[node][1], k + offsets[node][2]};
+            for (int d=0; d<spaceDim; d++)
+            {
+              cellVertices[node][d] = (dimensions[d] / elementCounts[d]) * gridCoords[d];
+            }
+          }
+          meshTopo->addCell(cellTopo, cellVertices);
+        }
+      }
+    }
+    return meshTopo;
+  }
+
+  void testBulkConstructionMatchesCellByCell(vector<double> dimensions, vector<int> elementCounts,
+                                             Teuchos::FancyOStream &out, bool &success)
+  {
+    MeshTopologyPtr cellByCellMeshTopo = rectilinearMeshTopologyCellByCell(dimensions, elementCounts);
+    MeshTopologyPtr bulkMeshTopo = MeshFactory::rectilinearMeshTopology(dimensions, elementCounts);
+    
+    int spaceDim = dimensions.size();
+    TEST_EQUALITY(bulkMeshTopo->cellCount(), cellByCellMeshTopo->cellCount());
+    for (int d=0; d<spaceDim; d++)
+    {
+      TEST_EQUALITY(bulkMeshTopo->getEntityCount(d), cellByCellMeshTopo->getEntityCount(d));
+    }
+    TEST_EQUALITY(bulkMeshTopo->getActiveBoundaryCells().size(), cellByCellMeshTopo->getActiveBoundaryCells().size());
+    
+    for (IndexType cellIndex=0; cellIndex<cellByCellMeshTopo->cellCount(); cellIndex++)
+    {
+      CellPtr expectedCell = cellByCellMeshTopo->getCell(cellIndex);
+      CellPtr cell = bulkMeshTopo->getCell(cellIndex);
+      for (int node=0; node<expectedCell->vertices().size(); node++)
+      {
+        vector<double> expectedVertex = cellByCellMeshTopo->getVertex(expectedCell->vertices()[node]);
+        vector<double> vertex = bulkMeshTopo->getVertex(cell->vertices()[node]);
+        TEST_COMPARE_FLOATING_ARRAYS(vertex, expectedVertex, 1e-15);
+      }
+      for (int sideOrdinal=0; sideOrdinal<expectedCell->getSideCount(); sideOrdinal++)
+      {
+        TEST_EQUALITY(cell->getNeighborInfo(sideOrdinal, bulkMeshTopo).first,
+                      expectedCell->getNeighborInfo(sideOrdinal, cellByCellMeshTopo).first);
+      }
+    }
+  }
+  
+  void testDistributedBulkConstruction(vector<double> dimensions, vector<int> elementCounts,
+                                       Teuchos::FancyOStream &out, bool &success)
+  {
+    Epetra_CommPtr Comm = MPIWrapper::CommWorld();
+    MeshTopologyPtr replicatedMeshTopo = MeshFactory::rectilinearMeshTopology(dimensions, elementCounts);
+    MeshTopologyPtr distributedMeshTopo = MeshFactory::rectilinearMeshTopology(dimensions, elementCounts, vector<double>(), Comm);
+    
+    TEST_ASSERT(distributedMeshTopo->isDistributed());
+    TEST_EQUALITY(distributedMeshTopo->activeCellCount(), replicatedMeshTopo->activeCellCount());
+    
+    // owned cells should be a partition of the global cells
+    const set<IndexType>* myCellIndices = &distributedMeshTopo->getMyActiveCellIndices();
+    int myCellCount = myCellIndices->size();
+    int globalCellCount = MPIWrapper::sum(*Comm, myCellCount);
+    TEST_EQUALITY(globalCellCount, replicatedMeshTopo->activeCellCount());
+    
+    // owned cells should have the same vertices and neighbors as in the replicated topology
+    for (IndexType cellIndex : *myCellIndices)
+    {
+      CellPtr expectedCell = replicatedMeshTopo->getCell(cellIndex);
+      CellPtr cell = distributedMeshTopo->getCell(cellIndex);
+      for (int node=0; node<expectedCell->vertices().size(); node++)
+      {
+        vector<double> expectedVertex = replicatedMeshTopo->getVertex(expectedCell->vertices()[node]);
+        vector<double> vertex = distributedMeshTopo->getVertex(cell->vertices()[node]);
+        TEST_COMPARE_FLOATING_ARRAYS(vertex, expectedVertex, 1e-15);
+      }
+      for (int sideOrdinal=0; sideOrdinal<expectedCell->getSideCount(); sideOrdinal++)
+      {
+        TEST_EQUALITY(cell->getNeighborInfo(sideOrdinal, distributedMeshTopo).first,
+                      expectedCell->getNeighborInfo(sideOrdinal, replicatedMeshTopo).first);
+      }
+    }
+  }
+  
   TEUCHOS_UNIT_TEST( MeshTopology, ActiveCellCount )
   {
     MPIWrapper::CommWorld()->Barrier();
@@ -1215,4 +1312,23 @@ TEUCHOS_UNIT_TEST( MeshTopology, UnrefinedSpaceTimeMeshTopologyIsUnconstrained )
     testConstraints(spaceTimeMeshTopo.get(), d, expectedConstraints, out, success);
   }
 }
+TEUCHOS_UNIT_TEST( MeshTopology, BulkConstructionMatchesCellByCell_2D )
+{
+  testBulkConstructionMatchesCellByCell({1.0,2.0}, {3,4}, out, success);
+}
+
+TEUCHOS_UNIT_TEST( MeshTopology, BulkConstructionMatchesCellByCell_3D )
+{
+  testBulkConstructionMatchesCellByCell({1.0,2.0,3.0}, {2,3,4}, out, success);
+}
+
+TEUCHOS_UNIT_TEST( MeshTopology, DistributedBulkConstruction_2D )
+{
+  testDistributedBulkConstruction({1.0,1.0}, {4,5}, out, success);
+}
+
+TEUCHOS_UNIT_TEST( MeshTopology, DistributedBulkConstruction_3D )
+{
+  testDistributedBulkConstruction({1.0,1.0,1.0}, {3,3,4}, out, success);
+}
 } // namespace
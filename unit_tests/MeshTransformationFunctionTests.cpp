@@ -17,6 +17,7 @@
 #include "MeshFactory.h"
 #include "MeshTransformationFunction.h"
 #include "MPIWrapper.h"
+#include "PoissonFormulation.h"
 #include "SpaceTimeHeatFormulation.h"
 
 using namespace Camellia;
@@ -56,6 +57,77 @@ namespace
     TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(physicalCellNodes, mappedPhysicalCellNodes, 1e-15);
   }
   
+  // a parallelogram mesh; if curvedEdges is true, its edges are given ParametricCurve lines, so that it gets a MeshTransformationFunction
+  MeshPtr parallelogramMesh(bool curvedEdges)
+  {
+    vector<vector<double>> vertices = {{0,0},{2,0},{3,1},{1,1}};
+    vector<vector<IndexType>> elementVertices = {{0,1,2,3}};
+    MeshGeometryPtr geometry = Teuchos::rcp( new MeshGeometry(vertices, elementVertices, {CellTopology::quad()}) );
+    MeshTopologyPtr meshTopo = Teuchos::rcp( new MeshTopology(geometry) );
+
+    if (curvedEdges)
+    {
+      IndexType cellIndex = 0;
+      int edgeDim = 1;
+      CellPtr cell = meshTopo->getCell(cellIndex);
+      vector<ParametricCurvePtr> edgeFxns = meshTopo->parametricEdgesForCell(cellIndex, true);
+      map<pair<IndexType,IndexType>,ParametricCurvePtr> edgeToCurveMap;
+      for (int edgeOrdinal = 0; edgeOrdinal < edgeFxns.size(); edgeOrdinal++)
+      {
+        vector<IndexType> edgeNodes = cell->getEntityVertexIndices(edgeDim, edgeOrdinal);
+        edgeToCurveMap[{edgeNodes[0],edgeNodes[1]}] = edgeFxns[edgeOrdinal];
+      }
+      meshTopo->setEdgeToCurveMap(edgeToCurveMap, Teuchos::null);
+    }
+
+    int spaceDim = 2, H1Order = 2, delta_k = 1;
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces);
+    MeshPtr mesh = MeshFactory::minRuleMesh(meshTopo, form.bf(), H1Order, delta_k);
+    if (curvedEdges) meshTopo->initializeTransformationFunction(mesh);
+    return mesh;
+  }
+
+  void testGeometryMatches(MeshPtr curvedMesh, MeshPtr straightMesh, Teuchos::FancyOStream &out, bool &success)
+  {
+    FieldContainer<double> refPoints(6,2);
+    vector<vector<double>> refPointVector = {{-1,-1},{1,-1},{1,1},{-1,1},{0,0},{0.5,-0.25}};
+    for (int ptOrdinal=0; ptOrdinal<refPointVector.size(); ptOrdinal++)
+    {
+      refPoints(ptOrdinal,0) = refPointVector[ptOrdinal][0];
+      refPoints(ptOrdinal,1) = refPointVector[ptOrdinal][1];
+    }
+    double tol = 1e-12;
+    for (GlobalIndexType cellID : straightMesh->cellIDsInPartition())
+    {
+      BasisCachePtr curvedCache = BasisCache::basisCacheForCell(curvedMesh, cellID);
+      BasisCachePtr straightCache = BasisCache::basisCacheForCell(straightMesh, cellID);
+      curvedCache->setRefCellPoints(refPoints);
+      straightCache->setRefCellPoints(refPoints);
+      TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(straightCache->getPhysicalCubaturePoints(), curvedCache->getPhysicalCubaturePoints(), tol);
+      TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(straightCache->getJacobian(), curvedCache->getJacobian(), tol);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( MeshTransformationFunction, StraightCurvesReproduceAffineGeometry )
+  {
+    // the transformation function for straight "curves" is the identity, so the geometry
+    // must match that of the untransformed mesh -- including after p- and h-refinements, which recompute the cell coefficients
+    MeshPtr curvedMesh = parallelogramMesh(true);
+    MeshPtr straightMesh = parallelogramMesh(false);
+    TEST_ASSERT(curvedMesh->getTransformationFunction() != Teuchos::null);
+    testGeometryMatches(curvedMesh, straightMesh, out, success);
+
+    set<GlobalIndexType> cellIDs = {0};
+    curvedMesh->pRefine(cellIDs);
+    straightMesh->pRefine(cellIDs);
+    testGeometryMatches(curvedMesh, straightMesh, out, success);
+
+    curvedMesh->hRefine(cellIDs);
+    straightMesh->hRefine(cellIDs);
+    testGeometryMatches(curvedMesh, straightMesh, out, success);
+  }
+
   TEUCHOS_UNIT_TEST( MeshTransformationFunction, SpaceTimeCellGetsCorrectTimeCoordinates)
   {
     MPIWrapper::CommWorld()->Barrier();
@@ -0,0 +1,112 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  NonlinearSolveStrategyTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "BC.h"
+#include "CGSolver.h"
+#include "Function.h"
+#include "MeshFactory.h"
+#include "NonlinearSolveStrategy.h"
+#include "PoissonFormulation.h"
+#include "RHS.h"
+#include "Solution.h"
+#include "SpatialFilter.h"
+#include "TypeDefs.h"
+
+using namespace Camellia;
+using namespace Intrepid;
+
+namespace
+{
+  // Newton iteration for the ultraweak form of Delta u - (u + u^3) = f, with u = 0 on the boundary.  Returns the background
+  // flow after convergence.
+  SolutionPtr solveNonlinearReactionProblem(bool useInexactNewton, double &initialSolverTolerance, double &finalSolverTolerance)
+  {
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces, PoissonFormulation::ULTRAWEAK);
+    BFPtr bf = form.bf();
+    VarPtr u = form.u(), v = form.v();
+
+    int H1Order = 2;
+    MeshPtr mesh = MeshFactory::rectilinearMesh(bf, {1.0,1.0}, {2,2}, H1Order);
+
+    SolutionPtr backgroundFlow = Solution::solution(bf, mesh);
+    // bf will refer to the background flow, which refers to bf; a weak reference avoids the cycle
+    SolutionPtr backgroundFlowWeakReference = Teuchos::rcp(backgroundFlow.get(), false);
+    FunctionPtr u_prev = Function::solution(u, backgroundFlowWeakReference);
+
+    // the residual of the linear part at the background flow; computed before the reaction term is added to bf
+    LinearTermPtr linearPartAtBackground = bf->testFunctional(backgroundFlowWeakReference);
+
+    // Newton linearization of the reaction term
+    bf->addTerm(-1.0 * (1.0 + 3.0 * u_prev * u_prev) * u, v);
+
+    FunctionPtr f = Function::constant(1.0);
+    RHSPtr rhs = RHS::rhs();
+    rhs->addTerm(f * v);
+    rhs->addTerm(-linearPartAtBackground);
+    rhs->addTerm((u_prev + u_prev * u_prev * u_prev) * v);
+
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+
+    SolutionPtr solnIncrement = Solution::solution(bf, mesh, bc, rhs, bf->graphNorm());
+
+    double stepSize = 1.0;
+    double tol = 1e-10;
+    NonlinearSolveStrategy strategy(backgroundFlow, solnIncrement, Teuchos::rcp( new NonlinearStepSize(stepSize) ), tol);
+    if (useInexactNewton)
+    {
+      int maxIters = 2000;
+      double cgTolerance = 1e-6;
+      SolverPtr cgSolver = Teuchos::rcp( new CGSolver(maxIters, cgTolerance) );
+      strategy.setSolver(cgSolver);
+      double finalLinearTolerance = 1e-12;
+      strategy.setUseInexactNewton(true, finalLinearTolerance);
+      initialSolverTolerance = cgSolver->tolerance();
+      strategy.solve();
+      finalSolverTolerance = cgSolver->tolerance();
+    }
+    else
+    {
+      strategy.solve();
+    }
+    return backgroundFlow;
+  }
+
+  TEUCHOS_UNIT_TEST( NonlinearSolveStrategy, InexactNewtonMatchesExactNewton )
+  {
+    double initialSolverTolerance = -1, finalSolverTolerance = -1;
+    SolutionPtr exactNewtonSoln = solveNonlinearReactionProblem(false, initialSolverTolerance, finalSolverTolerance);
+    SolutionPtr inexactNewtonSoln = solveNonlinearReactionProblem(true, initialSolverTolerance, finalSolverTolerance);
+
+    // the solver's tolerance is restored once the nonlinear solve is done
+    TEST_EQUALITY(finalSolverTolerance, initialSolverTolerance);
+
+    // the two meshes are built identically, so their cells have the same IDs and dof layouts
+    MeshPtr mesh = exactNewtonSoln->mesh();
+    double maxDiff = 0, maxValue = 0;
+    for (GlobalIndexType cellID : mesh->cellIDsInPartition())
+    {
+      const FieldContainer<double>* expectedCoefficients = &exactNewtonSoln->allCoefficientsForCellID(cellID);
+      const FieldContainer<double>* actualCoefficients = &inexactNewtonSoln->allCoefficientsForCellID(cellID);
+      TEST_EQUALITY(expectedCoefficients->size(), actualCoefficients->size());
+      if (expectedCoefficients->size() != actualCoefficients->size()) continue;
+      for (int i=0; i<expectedCoefficients->size(); i++)
+      {
+        maxDiff = max(maxDiff, abs((*expectedCoefficients)[i] - (*actualCoefficients)[i]));
+        maxValue = max(maxValue, abs((*expectedCoefficients)[i]));
+      }
+    }
+    TEST_COMPARE(maxValue, >, 0.0);
+    double tol = 1e-6; // both iterations stop at a 1e-10 relative tolerance, measured differently
+    TEST_COMPARE(maxDiff, <, tol * maxValue);
+  }
+} // namespace
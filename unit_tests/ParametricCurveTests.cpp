@@ -0,0 +1,168 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  ParametricCurveTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "BasisCache.h"
+#include "BasisFactory.h"
+#include "CamelliaTestingHelpers.h"
+#include "IP.h"
+#include "ParametricCurve.h"
+#include "ParametricSurface.h"
+#include "Projector.h"
+#include "VarFactory.h"
+
+using namespace Camellia;
+using namespace Intrepid;
+
+namespace
+{
+  FieldContainer<double> parameterValues()
+  {
+    vector<double> tVector = {0.0, 0.1, 0.25, 0.4, 0.5, 0.77, 0.9, 1.0};
+    FieldContainer<double> tValues(tVector.size());
+    for (int i=0; i<tVector.size(); i++)
+    {
+      tValues(i) = tVector[i];
+    }
+    return tValues;
+  }
+
+  // compares valuesAtParameters() against value() and dt_parametric()->value() at each point
+  void testBatchedValuesMatchPointwise(ParametricCurvePtr curve, bool testDerivatives, Teuchos::FancyOStream &out, bool &success)
+  {
+    FieldContainer<double> tValues = parameterValues();
+    int numPoints = tValues.size();
+    int spaceDim = 2;
+    FieldContainer<double> points(numPoints,spaceDim), expectedPoints(numPoints,spaceDim);
+    FieldContainer<double> derivatives(numPoints,spaceDim), expectedDerivatives(numPoints,spaceDim);
+    if (testDerivatives)
+      curve->valuesAtParameters(tValues, points, &derivatives);
+    else
+      curve->valuesAtParameters(tValues, points);
+
+    ParametricCurvePtr dtCurve = testDerivatives ? curve->dt_parametric() : Teuchos::null;
+    for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+    {
+      curve->value(tValues(ptOrdinal), expectedPoints(ptOrdinal,0), expectedPoints(ptOrdinal,1));
+      if (testDerivatives)
+        dtCurve->value(tValues(ptOrdinal), expectedDerivatives(ptOrdinal,0), expectedDerivatives(ptOrdinal,1));
+    }
+    double tol = 1e-13;
+    TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(expectedPoints, points, tol);
+    if (testDerivatives)
+    {
+      TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(expectedDerivatives, derivatives, tol);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( ParametricCurve, BatchedValuesLine )
+  {
+    testBatchedValuesMatchPointwise(ParametricCurve::line(0.5, 1.0, 2.0, -1.0), true, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( ParametricCurve, BatchedValuesCircularArc )
+  {
+    double PI = 3.141592653589793238462;
+    ParametricCurvePtr arc = ParametricCurve::circularArc(2.0, 1.0, 0.5, PI / 6.0, PI / 2.0);
+    testBatchedValuesMatchPointwise(arc, true, out, success);
+    testBatchedValuesMatchPointwise(ParametricCurve::reverse(arc), true, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( ParametricCurve, BatchedValuesBubble )
+  {
+    double PI = 3.141592653589793238462;
+    ParametricCurvePtr arc = ParametricCurve::circularArc(1.0, 0.0, 0.0, 0, PI / 2.0);
+    testBatchedValuesMatchPointwise(ParametricCurve::bubble(arc), true, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( ParametricCurve, BatchedValuesUnion )
+  {
+    // ParametricUnion does not support dt_parametric(), so compare derivatives to those of the constituent lines
+    vector< pair<double,double> > vertices = {{0,0},{2,0},{2,1}};
+    ParametricCurvePtr triangle = ParametricCurve::polygon(vertices);
+    testBatchedValuesMatchPointwise(triangle, false, out, success);
+
+    FieldContainer<double> tValues(2), points(2,2), derivatives(2,2);
+    double perimeter = 3.0 + sqrt(5.0);
+    tValues(0) = 1.0 / perimeter; // on the first edge, of length 2
+    tValues(1) = 2.5 / perimeter; // on the second edge, of length 1
+    triangle->valuesAtParameters(tValues, points, &derivatives);
+    double tol = 1e-13;
+    TEST_FLOATING_EQUALITY(points(0,0), 1.0, tol);
+    TEST_FLOATING_EQUALITY(points(1,1), 0.5, tol);
+    TEST_FLOATING_EQUALITY(derivatives(0,0), perimeter, tol);
+    TEST_ASSERT(abs(derivatives(0,1)) < tol);
+    TEST_ASSERT(abs(derivatives(1,0)) < tol);
+    TEST_FLOATING_EQUALITY(derivatives(1,1), perimeter, tol);
+  }
+
+  TEUCHOS_UNIT_TEST( ParametricCurve, ProjectionBasedInterpolantMatchesFunctionProjection )
+  {
+    // projectionBasedInterpolant() evaluates the curve in batches; it should agree with projecting the component Functions
+    double PI = 3.141592653589793238462;
+    ParametricCurvePtr arc = ParametricCurve::circularArc(1.0, 0.0, 0.0, 0, PI / 2.0);
+    ParametricCurvePtr bubble = ParametricCurve::bubble(arc);
+    ParametricCurvePtr line = arc->interpolatingLine();
+    double lengthScale = arc->linearLength();
+
+    int basisDegree = 4;
+    BasisPtr basis1D = BasisFactory::basisFactory()->getBasis(basisDegree, CellTopology::line(), Camellia::FUNCTION_SPACE_HGRAD);
+    BasisCachePtr basisCache = BasisCache::basisCache1D(0, lengthScale, std::max(basisDegree*2,15));
+    set<int> vertexNodeFieldIndices = {basis1D->getDofOrdinal(0, 0, 0), basis1D->getDofOrdinal(0, 1, 0)};
+
+    bool useH1 = true;
+    VarFactoryPtr vf = VarFactory::varFactory();
+    VarPtr v = vf->testVar("v", HGRAD);
+    IPPtr ip = Teuchos::rcp( new IP );
+    ip->addTerm(v);
+    ip->addTerm(v->dx());
+
+    for (int comp=0; comp<2; comp++)
+    {
+      FieldContainer<double> coefficients;
+      arc->projectionBasedInterpolant(coefficients, basis1D, comp, lengthScale, useH1);
+
+      TFunctionPtr<double> bubbleComponent = (comp == 0) ? bubble->x() : bubble->y();
+      TFunctionPtr<double> lineComponent = (comp == 0) ? line->x() : line->y();
+      FieldContainer<double> expectedCoefficients, lineCoefficients;
+      Projector<double>::projectFunctionOntoBasis(expectedCoefficients, bubbleComponent, basis1D, basisCache, ip, v, vertexNodeFieldIndices);
+      Projector<double>::projectFunctionOntoBasis(lineCoefficients, lineComponent, basis1D, basisCache, ip, v);
+      for (int i=0; i<lineCoefficients.size(); i++)
+      {
+        expectedCoefficients[i] += lineCoefficients[i];
+      }
+      expectedCoefficients.resize(basis1D->getCardinality());
+
+      double tol = 1e-12;
+      TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(expectedCoefficients, coefficients, tol);
+    }
+  }
+
+  TEUCHOS_UNIT_TEST( ParametricCurve, TransfiniteInterpolantBatchedValues )
+  {
+    double PI = 3.141592653589793238462;
+    vector<ParametricCurvePtr> edges = {ParametricCurve::line(0, 0, 1, 0),
+                                        ParametricCurve::circularArc(1.0, 0.0, 0.0, 0, PI / 2.0),
+                                        ParametricCurve::line(0, 1, 0, 0.5),
+                                        ParametricCurve::line(0, 0.5, 0, 0)};
+    ParametricSurfacePtr surface = ParametricSurface::transfiniteInterpolant(edges);
+    FieldContainer<double> tValues = parameterValues();
+    int numPoints = tValues.size();
+    FieldContainer<double> parametricPoints(numPoints,2), points(numPoints,2), expectedPoints(numPoints,2);
+    for (int ptOrdinal=0; ptOrdinal<numPoints; ptOrdinal++)
+    {
+      parametricPoints(ptOrdinal,0) = tValues(ptOrdinal);
+      parametricPoints(ptOrdinal,1) = tValues(numPoints-1-ptOrdinal);
+      surface->value(parametricPoints(ptOrdinal,0), parametricPoints(ptOrdinal,1), expectedPoints(ptOrdinal,0), expectedPoints(ptOrdinal,1));
+    }
+    surface->valuesAtParameters(parametricPoints, points);
+    double tol = 1e-13;
+    TEST_COMPARE_FLOATING_ARRAYS_CAMELLIA(expectedPoints, points, tol);
+  }
+} // namespace
@@ -19,7 +19,7 @@ using namespace Intrepid;
 #include "Teuchos_UnitTestHarness.hpp"
 namespace
 {
-TEUCHOS_UNIT_TEST( RieszRep, L2Norm )
+void testL2Norm(bool useMixedPrecisionGramSolve, double tol, Teuchos::FancyOStream &out, bool &success)
 {
   int spaceDim = 2;
   bool conformingTraces = true;
@@ -41,6 +41,7 @@ TEUCHOS_UNIT_TEST( RieszRep, L2Norm )
 
   RieszRepPtr rieszRep = Teuchos::rcp( new RieszRep(mesh, ip, lt) );
 
+  rieszRep->setUseMixedPrecisionGramSolve(useMixedPrecisionGramSolve);
   rieszRep->computeRieszRep();
 
   FunctionPtr repFxn = RieszRep::repFunction(form.v(), rieszRep);
@@ -49,7 +50,6 @@ TEUCHOS_UNIT_TEST( RieszRep, L2Norm )
 
   double err = (repFxn - expectedRepFxn)->l2norm(mesh);
 
-  double tol = 1e-14;
   TEST_COMPARE(err,<,tol);
 
   double expectedNorm = weight->l2norm(mesh);
@@ -57,4 +57,16 @@ TEUCHOS_UNIT_TEST( RieszRep, L2Norm )
 
   TEST_FLOATING_EQUALITY(expectedNorm,actualNorm, tol);
 }
+
+TEUCHOS_UNIT_TEST( RieszRep, L2Norm )
+{
+  double tol = 1e-14;
+  testL2Norm(false, tol, out, success);
+}
+
+TEUCHOS_UNIT_TEST( RieszRep, L2Norm_MixedPrecisionGramSolve )
+{
+  double tol = 1e-13;
+  testL2Norm(true, tol, out, success);
+}
 } // namespace
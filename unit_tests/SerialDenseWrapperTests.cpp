@@ -161,6 +161,80 @@ namespace
     TEST_COMPARE_ARRAYS(A, A_T);
   }
   
+  TEUCHOS_UNIT_TEST( SerialDenseWrapper, SolveSPDSystemMixedPrecision_WellConditioned )
+  {
+    // D A D, where A = tridiag(-1,4,-1) and D is a badly scaled diagonal; equilibration should make this well-conditioned
+    int N = 20, numRHS = 2;
+    FieldContainer<double> A(N,N);
+    for (int i=0; i<N; i++)
+    {
+      double d_i = pow(10.0, i % 5);
+      A(i,i) = 4.0 * d_i * d_i;
+      if (i > 0)
+      {
+        double d_j = pow(10.0, (i-1) % 5);
+        A(i,i-1) = -d_i * d_j;
+        A(i-1,i) = -d_i * d_j;
+      }
+    }
+    
+    // right-hand sides stored contiguously, one per row of x_expected and bx
+    FieldContainer<double> x_expected(numRHS,N), bx(numRHS,N);
+    for (int rhsOrdinal=0; rhsOrdinal<numRHS; rhsOrdinal++)
+    {
+      for (int i=0; i<N; i++)
+      {
+        x_expected(rhsOrdinal,i) = (rhsOrdinal == 0) ? 1.0 + i : sin(1.0 + i);
+      }
+      for (int i=0; i<N; i++)
+      {
+        for (int j=0; j<N; j++)
+        {
+          bx(rhsOrdinal,i) += A(i,j) * x_expected(rhsOrdinal,j);
+        }
+      }
+    }
+    
+    bool usedSinglePrecision;
+    int result = SerialDenseWrapper::solveSPDSystemMixedPrecision(bx, A, 1e6, 10, &usedSinglePrecision);
+    TEST_EQUALITY(result, 0);
+    TEST_ASSERT(usedSinglePrecision);
+    
+    double tol = 1e-12;
+    for (int k=0; k<bx.size(); k++)
+    {
+      TEST_COMPARE(abs(bx[k] - x_expected[k]), <=, tol * abs(x_expected[k]));
+    }
+  }
+  
+  TEUCHOS_UNIT_TEST( SerialDenseWrapper, SolveSPDSystemMixedPrecision_IllConditionedFallsBack )
+  {
+    // the 8x8 Hilbert matrix has condition number about 1.5e10: too large for single precision
+    int N = 8;
+    FieldContainer<double> H(N,N), b(N);
+    for (int i=0; i<N; i++)
+    {
+      for (int j=0; j<N; j++)
+      {
+        H(i,j) = 1.0 / (i + j + 1);
+        b(i) += H(i,j);
+      }
+    }
+    FieldContainer<double> H_copy = H, bx = b;
+    
+    bool usedSinglePrecision;
+    int result = SerialDenseWrapper::solveSPDSystemMixedPrecision(bx, H_copy, 1e6, 10, &usedSinglePrecision);
+    TEST_EQUALITY(result, 0);
+    TEST_ASSERT(!usedSinglePrecision);
+    
+    // the solution is all ones; the double-precision fallback should reach the usual accuracy for this condition number
+    double tol = 1e-5;
+    for (int i=0; i<N; i++)
+    {
+      TEST_FLOATING_EQUALITY(bx(i), 1.0, tol);
+    }
+  }
+  
 //  TEUCHOS_UNIT_TEST( SerialDenseWrapper, Multiply_HUGE_CommentMeOut_Slow )
 //  {
 //    // just timing -- multiplies a bunch of zeroes, doesn't check output
@@ -14,11 +14,14 @@
 
 #include "Intrepid_FieldContainer.hpp"
 
+#include "Epetra_CrsMatrix.h"
+
 #include "CamelliaCellTools.h"
 #include "CamelliaDebugUtility.h"
 #include "Cell.h"
 #include "GlobalDofAssignment.h"
 #include "GnuPlotUtil.h"
+#include "HaloImportPlan.h"
 #include "HDF5Exporter.h"
 #include "MeshFactory.h"
 #include "MeshTools.h"
@@ -28,6 +31,7 @@
 #include "RHS.h"
 #include "Solution.h"
 #include "StokesVGPFormulation.h"
+#include "TrigFunctions.h"
 #include "Var.h"
 
 using namespace Camellia;
@@ -1137,6 +1141,98 @@ namespace
     testImportOffRankCellSolution(spaceDim, meshWidth, out, success);
   }
   
+  // imports the coefficients for rank-local cells, returning them keyed by cellID
+  map<GlobalIndexType,FieldContainer<double>> importedCoefficients(SolutionPtr soln)
+  {
+    soln->importSolution();
+    map<GlobalIndexType,FieldContainer<double>> coefficients;
+    for (GlobalIndexType cellID : soln->mesh()->cellIDsInPartition())
+    {
+      coefficients[cellID] = soln->allCoefficientsForCellID(cellID);
+    }
+    return coefficients;
+  }
+
+  TEUCHOS_UNIT_TEST( Solution, ImportSolutionReusesPlan )
+  {
+    int spaceDim = 2;
+    int meshWidth = 2;
+    int H1Order = 2;
+    bool useConformingTraces = true;
+    MeshPtr mesh = poissonUniformMesh(spaceDim, meshWidth, H1Order, useConformingTraces);
+    SolutionPtr soln = Solution::solution(mesh);
+    soln->initializeLHSVector();
+    soln->getLHSVector()->Random();
+
+    // the plan only exchanges anything when some of a rank's cells have coefficients owned elsewhere.
+    // unit_tests/CMakeLists.txt registers a two-rank run of this test.
+    HaloImportPlan plan(mesh->cellIDsInPartition(), mesh.get(), soln->getLHSVector()->Map());
+    int localCounts[2] = {(int)plan.haloCellIDs().size(), plan.remoteEntryCount()};
+    int globalCounts[2];
+    mesh->Comm()->SumAll(localCounts, globalCounts, 2);
+    if (mesh->Comm()->NumProc() == 1)
+    {
+      out << "NOTE: on one rank, the import plan has no ghost values to exchange; run on two or more ranks to test the exchange.\n";
+      TEST_EQUALITY(globalCounts[1], 0);
+    }
+    else
+    {
+      TEST_COMPARE(globalCounts[0], >, 0); // cells with off-rank coefficients
+      TEST_COMPARE(globalCounts[1], >, 0); // ghost values received from other ranks
+    }
+
+    // a second import (which reuses the plan) should see the updated global coefficients
+    map<GlobalIndexType,FieldContainer<double>> firstCoefficients = importedCoefficients(soln);
+    soln->getLHSVector()->Scale(2.0);
+    map<GlobalIndexType,FieldContainer<double>> secondCoefficients = importedCoefficients(soln);
+    for (auto entry : firstCoefficients)
+    {
+      const FieldContainer<double>* first = &entry.second;
+      const FieldContainer<double>* second = &secondCoefficients[entry.first];
+      TEST_EQUALITY(first->size(), second->size());
+      for (int i=0; i<first->size(); i++)
+      {
+        TEST_FLOATING_EQUALITY(2.0 * (*first)[i], (*second)[i], 1e-15);
+      }
+    }
+
+    // ...and match an import through a freshly built plan exactly, ghost values included
+    soln->setReuseImportPlan(false);
+    map<GlobalIndexType,FieldContainer<double>> freshCoefficients = importedCoefficients(soln);
+    soln->setReuseImportPlan(true);
+    TEST_EQUALITY(secondCoefficients.size(), freshCoefficients.size());
+    for (auto entry : freshCoefficients)
+    {
+      const FieldContainer<double>* expected = &entry.second;
+      const FieldContainer<double>* actual = &secondCoefficients[entry.first];
+      TEST_EQUALITY(expected->size(), actual->size());
+      for (int i=0; i<min(expected->size(),actual->size()); i++)
+      {
+        TEST_EQUALITY((*expected)[i], (*actual)[i]);
+      }
+    }
+
+    // after refinement, the plan must be rebuilt; compare against a freshly built plan
+    set<GlobalIndexType> cellsToRefine = {0};
+    mesh->hRefine(cellsToRefine);
+    soln->initializeLHSVector();
+    soln->getLHSVector()->Random();
+    map<GlobalIndexType,FieldContainer<double>> reusedPlanCoefficients = importedCoefficients(soln);
+    soln->setReuseImportPlan(false);
+    map<GlobalIndexType,FieldContainer<double>> newPlanCoefficients = importedCoefficients(soln);
+    TEST_EQUALITY(reusedPlanCoefficients.size(), newPlanCoefficients.size());
+    for (auto entry : newPlanCoefficients)
+    {
+      const FieldContainer<double>* expected = &entry.second;
+      const FieldContainer<double>* actual = &reusedPlanCoefficients[entry.first];
+      TEST_EQUALITY(expected->size(), actual->size());
+      for (int i=0; i<min(expected->size(),actual->size()); i++)
+      {
+        TEST_EQUALITY((*expected)[i], (*actual)[i]);
+      }
+    }
+  }
+
   TEUCHOS_UNIT_TEST( Solution, ImposeBCs )
   {
     MPIWrapper::CommWorld()->Barrier();
@@ -1291,6 +1387,96 @@ namespace
     }
   }
   
+  TEUCHOS_UNIT_TEST( Solution, PipelinedAssemblyMatchesStandardAssembly )
+  {
+    // On a single rank every row is owned locally, so there are no halo cells and nothing to exchange; the pipelined path
+    // is only exercised on two or more ranks.  unit_tests/CMakeLists.txt registers a two-rank run of this test.
+    int spaceDim = 2;
+    bool useConformingTraces = true;
+    PoissonFormulation form(spaceDim, useConformingTraces);
+    vector<double> dimensions(spaceDim,1.0);
+    vector<int> elementCounts = {4,4};
+    int H1Order = 2, delta_k = 1;
+    MeshPtr mesh = MeshFactory::rectilinearMesh(form.bf(), dimensions, elementCounts, H1Order, delta_k);
+    set<GlobalIndexType> cellsToRefine = {0};
+    mesh->hRefine(cellsToRefine); // hanging nodes, so that constrained dofs are involved in the exchange
+
+    BCPtr bc = BC::bc();
+    bc->addDirichlet(form.u_hat(), SpatialFilter::allSpace(), Function::zero());
+    RHSPtr rhs = form.rhs(Function::constant(1.0));
+
+    SolutionPtr standardSoln = Solution::solution(form.bf(), mesh, bc, rhs, form.bf()->graphNorm());
+    SolutionPtr pipelinedSoln = Solution::solution(form.bf(), mesh, bc, rhs, form.bf()->graphNorm());
+    pipelinedSoln->setUsePipelinedAssembly(true);
+    for (SolutionPtr soln : {standardSoln, pipelinedSoln})
+    {
+      soln->initializeLHSVector();
+      soln->initializeStiffnessAndLoad();
+      soln->populateStiffnessAndLoad();
+    }
+
+    int numRanks = mesh->Comm()->NumProc();
+    int localCounts[2] = {pipelinedSoln->pipelinedAssemblyHaloCellCount(), pipelinedSoln->pipelinedAssemblySentEntryCount()};
+    int globalCounts[2];
+    mesh->Comm()->SumAll(localCounts, globalCounts, 2);
+    if (numRanks == 1)
+    {
+      out << "NOTE: on one rank, pipelined assembly has nothing to exchange; run on two or more ranks to test the exchange.\n";
+      TEST_EQUALITY(globalCounts[0], 0);
+    }
+    else
+    {
+      TEST_COMPARE(globalCounts[0], >, 0); // cells assembled in the halo phase
+      TEST_COMPARE(globalCounts[1], >, 0); // off-rank entries sent during the exchange
+    }
+
+    // compare the global matrix and load, row by row, on this rank's rows
+    double tol = 1e-12;
+    Teuchos::RCP<Epetra_CrsMatrix> standardStiffness = standardSoln->getStiffnessMatrix();
+    Teuchos::RCP<Epetra_CrsMatrix> pipelinedStiffness = pipelinedSoln->getStiffnessMatrix();
+    TEST_EQUALITY(standardStiffness->NumMyRows(), pipelinedStiffness->NumMyRows());
+    int maxEntries = max(standardStiffness->MaxNumEntries(), pipelinedStiffness->MaxNumEntries());
+    vector<double> rowValues(maxEntries);
+    vector<GlobalIndexTypeToCast> rowColumns(maxEntries);
+    for (int localRow=0; localRow<standardStiffness->NumMyRows(); localRow++)
+    {
+      GlobalIndexTypeToCast globalRow = standardStiffness->GRID(localRow);
+      map<GlobalIndexTypeToCast,double> standardRow, pipelinedRow;
+      int numEntries;
+      standardStiffness->ExtractGlobalRowCopy(globalRow, maxEntries, numEntries, &rowValues[0], &rowColumns[0]);
+      for (int i=0; i<numEntries; i++) standardRow[rowColumns[i]] += rowValues[i];
+      pipelinedStiffness->ExtractGlobalRowCopy(globalRow, maxEntries, numEntries, &rowValues[0], &rowColumns[0]);
+      for (int i=0; i<numEntries; i++) pipelinedRow[rowColumns[i]] += rowValues[i];
+      for (auto entry : standardRow)
+      {
+        TEST_COMPARE(abs(entry.second - pipelinedRow[entry.first]), <, tol);
+      }
+      for (auto entry : pipelinedRow)
+      {
+        TEST_COMPARE(abs(entry.second - standardRow[entry.first]), <, tol);
+      }
+    }
+    Epetra_FEVector* standardLoad = standardSoln->getRHSVector().get();
+    Epetra_FEVector* pipelinedLoad = pipelinedSoln->getRHSVector().get();
+    TEST_EQUALITY(standardLoad->MyLength(), pipelinedLoad->MyLength());
+    for (int i=0; i<min(standardLoad->MyLength(), pipelinedLoad->MyLength()); i++)
+    {
+      TEST_COMPARE(abs((*standardLoad)[0][i] - (*pipelinedLoad)[0][i]), <, tol);
+    }
+
+    standardSoln->solve();
+    pipelinedSoln->solve();
+
+    Epetra_MultiVector* standardCoefficients = standardSoln->getLHSVector().get();
+    Epetra_MultiVector* pipelinedCoefficients = pipelinedSoln->getLHSVector().get();
+    TEST_EQUALITY(standardCoefficients->MyLength(), pipelinedCoefficients->MyLength());
+    for (int i=0; i<min(standardCoefficients->MyLength(), pipelinedCoefficients->MyLength()); i++)
+    {
+      double diff = abs((*standardCoefficients)[0][i] - (*pipelinedCoefficients)[0][i]);
+      TEST_COMPARE(diff, <, tol);
+    }
+  }
+
   TEUCHOS_UNIT_TEST( Solution, ProjectTraceOnOneElementTensorMesh1D )
   {
     int H1Order = 2;
@@ -1584,7 +1770,54 @@ namespace
     double errAfterOneRefinement = (solnFxn - exactFxn)->l2norm(mesh);
     TEUCHOS_TEST_COMPARE(errAfterOneRefinement, <, tol, out, success);
   }
-  
+
+  TEUCHOS_UNIT_TEST( Solution, ProjectOnRefinementTransferMatricesMatchProjection )
+  {
+    int spaceDim = 2;
+    bool conformingTraces = true;
+    PoissonFormulation form(spaceDim,conformingTraces);
+
+    int H1Order = 3;
+    vector<int> elemCounts = {2,2};
+
+    FunctionPtr x = Function::xn(1), y = Function::yn(1);
+    FunctionPtr sin_x = Teuchos::rcp( new Sin_x ), cos_y = Teuchos::rcp( new Cos_y );
+    map<int, FunctionPtr> solutionMap;
+    solutionMap[form.u()->ID()] = sin_x * y;
+    solutionMap[form.sigma()->ID()] = Function::vectorize(x * x * y, cos_y);
+    solutionMap[form.u_hat()->ID()] = form.u_hat()->termTraced()->evaluate(solutionMap);
+    solutionMap[form.sigma_n_hat()->ID()] = form.sigma_n_hat()->termTraced()->evaluate(solutionMap);
+
+    // two identical meshes and solutions; one projects using transfer matrices, the other directly
+    vector<MeshPtr> meshes(2);
+    vector<SolutionPtr> solutions(2);
+    for (int i=0; i<2; i++)
+    {
+      meshes[i] = MeshFactory::rectilinearMesh(form.bf(), {1.0,1.0}, elemCounts, H1Order);
+      solutions[i] = Solution::solution(form.bf(), meshes[i]);
+      solutions[i]->setUseRefinementTransferMatrices(i==0);
+      const int solutionOrdinal = 0;
+      solutions[i]->projectOntoMesh(solutionMap, solutionOrdinal);
+      meshes[i]->registerSolution(solutions[i]);
+      // the second refinement reuses transfer matrices computed in the first
+      meshes[i]->hRefine(vector<GlobalIndexType>{0});
+      meshes[i]->hRefine(vector<GlobalIndexType>{1,3});
+    }
+
+    double tol = 1e-12;
+    for (GlobalIndexType cellID : meshes[0]->cellIDsInPartition())
+    {
+      const FieldContainer<double>* transferCoefficients = &solutions[0]->allCoefficientsForCellID(cellID);
+      const FieldContainer<double>* projectedCoefficients = &solutions[1]->allCoefficientsForCellID(cellID);
+      TEST_EQUALITY(transferCoefficients->size(), projectedCoefficients->size());
+      if (transferCoefficients->size() != projectedCoefficients->size()) continue;
+      for (int dofOrdinal=0; dofOrdinal<transferCoefficients->size(); dofOrdinal++)
+      {
+        TEST_FLOATING_EQUALITY((*transferCoefficients)[dofOrdinal] + 1.0, (*projectedCoefficients)[dofOrdinal] + 1.0, tol);
+      }
+    }
+  }
+
   TEUCHOS_UNIT_TEST( Solution, ProjectOnTensorMesh1D )
   {
     int tensorialDegree = 1;
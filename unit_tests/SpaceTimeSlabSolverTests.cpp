@@ -0,0 +1,85 @@
+//
+// © 2016 UChicago Argonne.  For licensing details, see LICENSE-Camellia in the licenses directory.
+//
+//
+//  SpaceTimeSlabSolverTests
+//  Camellia
+//
+
+#include "Teuchos_UnitTestHarness.hpp"
+
+#include "BC.h"
+#include "Function.h"
+#include "MeshFactory.h"
+#include "Solution.h"
+#include "SpaceTimeHeatFormulation.h"
+#include "SpaceTimeSlabSolver.h"
+#include "SpatialFilter.h"
+#include "TypeDefs.h"
+
+using namespace Camellia;
+
+namespace
+{
+  // u = x + t solves the heat equation u_t - epsilon u_xx = 1, and lies in the trial space, so every slab should reproduce it.
+  // The Dirichlet data are imposed only on the spatial boundary x = 0, x = 1, so this requires the initial data transferred
+  // from each slab to the next to be exact
+  void testSlabsReproduceLinearSolution(bool reuseFactorization, Teuchos::FancyOStream &out, bool &success)
+  {
+    int spaceDim = 1;
+    double epsilon = 0.1;
+    bool useConformingTraces = true;
+    SpaceTimeHeatFormulation form(spaceDim, epsilon, useConformingTraces);
+
+    vector<double> dimensions = {1.0};
+    vector<int> elementCounts = {2};
+    MeshTopologyPtr spatialMeshTopo = MeshFactory::rectilinearMeshTopology(dimensions, elementCounts);
+
+    FunctionPtr u_exact = Function::xn(1) + Function::tn(1);
+    FunctionPtr f = Function::constant(1.0);
+    VarPtr u_hat = form.u_hat();
+
+    double t0 = 0.0, slabDuration = 0.25;
+    vector<int> H1Order = {2, 2};
+    int delta_k = 1;
+    SpaceTimeSlabSolver slabSolver(form.bf(), spatialMeshTopo, t0, slabDuration, H1Order, delta_k);
+    slabSolver.setRHS(form.rhs(f));
+    slabSolver.setBCFactory([u_hat, u_exact] (double t0, double t1) -> BCPtr
+    {
+      BCPtr bc = BC::bc();
+      bc->addDirichlet(u_hat, SpatialFilter::matchingX(0.0) | SpatialFilter::matchingX(1.0), u_exact);
+      return bc;
+    });
+    slabSolver.addInitialData(u_hat, u_exact);
+    slabSolver.setReuseFactorization(reuseFactorization);
+
+    int numSlabs = 3;
+    double tol = 1e-10;
+    for (int slabOrdinal=0; slabOrdinal<numSlabs; slabOrdinal++)
+    {
+      int result = slabSolver.solveSlab();
+      TEST_EQUALITY(result, 0);
+      MeshPtr mesh = slabSolver.mesh();
+      FunctionPtr u_soln = Function::solution(form.u(), slabSolver.solution());
+      double err = (u_soln - u_exact)->l2norm(mesh);
+      out << "slab " << slabOrdinal << " error: " << err << endl;
+      TEST_COMPARE(err, <, tol);
+    }
+    TEST_EQUALITY(slabSolver.slabCount(), numSlabs);
+    TEST_FLOATING_EQUALITY(slabSolver.currentTime(), t0 + numSlabs * slabDuration, 1e-15);
+    int expectedReuseCount = reuseFactorization ? numSlabs - 1 : 0;
+    TEST_EQUALITY(slabSolver.solverReuseCount(), expectedReuseCount);
+  }
+
+  TEUCHOS_UNIT_TEST( SpaceTimeSlabSolver, ReproducesLinearSolution_1D )
+  {
+    bool reuseFactorization = false;
+    testSlabsReproduceLinearSolution(reuseFactorization, out, success);
+  }
+
+  TEUCHOS_UNIT_TEST( SpaceTimeSlabSolver, ReproducesLinearSolutionReusingFactorization_1D )
+  {
+    bool reuseFactorization = true;
+    testSlabsReproduceLinearSolution(reuseFactorization, out, success);
+  }
+} // namespace